@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Core/FileSystem.h"
+#include "Utilities/Logger.h"
+
+// Packs every file of an asset folder into one asset pack, which the engine maps once and reads the files from.
+// Caches the engine writes at runtime are left out, and so are cooked textures older than their source.
+//
+//   AssetPacker [--output <pack>] <folder>
+
+namespace {
+    namespace fs = std::filesystem;
+    using namespace Yare;
+
+    struct PackedFile {
+        fs::path    path;
+        std::string name;
+        uint64_t    size = 0;
+    };
+
+    // A source next to the cooked file that is newer than it, the engine wouldn't use the cooked file then
+    bool isStaleCookedTexture(const fs::path& path) {
+        std::string extension = path.extension().string();
+        if (extension != ".ktx2" && extension != ".dds") {
+            return false;
+        }
+        std::error_code cookedError;
+        auto            cookedTime = fs::last_write_time(path, cookedError);
+        for (const char* sourceExtension : {".png", ".jpg", ".jpeg", ".tga"}) {
+            fs::path sourcePath = path;
+            sourcePath.replace_extension(sourceExtension);
+            std::error_code sourceError;
+            auto            sourceTime = fs::last_write_time(sourcePath, sourceError);
+            if (!sourceError && !cookedError && sourceTime > cookedTime) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t alignOffset(uint64_t offset) {
+        return (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+    }
+
+    bool writePack(const fs::path& folder, const fs::path& packPath) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<PackedFile> files;
+        size_t                  skipped = 0;
+        std::error_code         error;
+        for (fs::recursive_directory_iterator it(folder, error), end; !error && it != end; it.increment(error)) {
+            if (!it->is_regular_file()) {
+                continue;
+            }
+            if (isAssetCache(it->path().string()) || isStaleCookedTexture(it->path())) {
+                skipped++;
+                continue;
+            }
+            PackedFile file;
+            file.path = it->path();
+            file.name = it->path().lexically_relative(folder).generic_string();
+            file.size = it->file_size();
+            files.push_back(file);
+        }
+        if (error) {
+            std::fprintf(stderr, "%s: %s\n", folder.string().c_str(), error.message().c_str());
+            return false;
+        }
+        // The engine finds its files by a binary search over the names
+        std::sort(files.begin(), files.end(),
+                  [](const PackedFile& a, const PackedFile& b) { return a.name < b.name; });
+
+        AssetPackHeader             header;
+        std::vector<AssetPackEntry> entries(files.size());
+        std::string                 names;
+        header.entryCount = static_cast<uint32_t>(files.size());
+        for (size_t i = 0; i < files.size(); i++) {
+            entries[i].nameOffset = static_cast<uint32_t>(names.size());
+            entries[i].nameLength = static_cast<uint32_t>(files[i].name.size());
+            names += files[i].name;
+        }
+        header.namesSize = static_cast<uint32_t>(names.size());
+
+        uint64_t offset = sizeof(header) + entries.size() * sizeof(AssetPackEntry) + names.size();
+        for (size_t i = 0; i < files.size(); i++) {
+            offset = alignOffset(offset);
+            entries[i].offset = offset;
+            entries[i].size = files[i].size;
+            offset += files[i].size;
+        }
+
+        std::ofstream pack(packPath, std::ios::binary | std::ios::trunc);
+        pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pack.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackEntry));
+        pack.write(names.data(), names.size());
+
+        std::vector<char> buffer;
+        for (size_t i = 0; i < files.size() && pack; i++) {
+            std::vector<char> padding(entries[i].offset - static_cast<uint64_t>(pack.tellp()), 0);
+            pack.write(padding.data(), padding.size());
+
+            std::ifstream file(files[i].path, std::ios::binary);
+            buffer.resize(static_cast<size_t>(files[i].size));
+            if (!file.read(buffer.data(), buffer.size())) {
+                std::fprintf(stderr, "%s: could not be read\n", files[i].path.string().c_str());
+                return false;
+            }
+            pack.write(buffer.data(), buffer.size());
+        }
+        if (!pack) {
+            std::fprintf(stderr, "%s: could not be written\n", packPath.string().c_str());
+            return false;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %zu files, %zu skipped, %.1f MB in %.2f s\n", packPath.string().c_str(), files.size(),
+                    skipped, offset / (1024.0 * 1024.0), seconds);
+        return true;
+    }
+
+    void printUsage() {
+        std::printf(
+            "AssetPacker [--output <pack>] <folder>\n"
+            "  --output  Pack to write, the folder's name with .pack next to it when not given\n");
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    Yare::Logger::init();
+
+    fs::path folder;
+    fs::path packPath;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--output" && i + 1 < argc) {
+            packPath = argv[++i];
+        } else if (argument.rfind("--", 0) == 0 || !folder.empty()) {
+            printUsage();
+            return 1;
+        } else {
+            folder = argument;
+        }
+    }
+    if (folder.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Res -> Res.pack, where the engine looks for it
+    folder = folder.lexically_normal();
+    if (!folder.has_filename()) {
+        folder = folder.parent_path();
+    }
+    if (packPath.empty()) {
+        packPath = folder;
+        packPath += ".pack";
+    }
+    return writePack(folder, packPath) ? 0 : 1;
+}
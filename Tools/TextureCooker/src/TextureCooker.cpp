@@ -0,0 +1,161 @@
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Graphics/MipGenerator.h"
+#include "Graphics/TextureCompression.h"
+#include "Graphics/TextureContainer.h"
+#include "Utilities/Logger.h"
+
+// Cooks png, jpg and tga textures into block compressed KTX2 or DDS files with their whole mip chain, written next
+// to the source so the engine picks them up in its place.
+//
+//   TextureCooker [--format bc1|bc3|bc5|bc7] [--linear] [--filter box|kaiser] [--dds] <image>...
+
+namespace {
+    using namespace Yare::Graphics;
+
+    struct CookSettings {
+        bool        autoFormat = true;
+        BlockFormat format = BlockFormat::BC7;
+        bool        linear = false;
+        MipFilter   filter = MipFilter::KAISER;
+        bool        dds = false;
+    };
+
+    VkFormat getVkFormat(BlockFormat format, bool srgb) {
+        switch (format) {
+            case BlockFormat::BC1:
+                return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case BlockFormat::BC3:
+                return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case BlockFormat::BC5:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            default:
+                return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+    }
+
+    bool cookTexture(const std::string& sourcePath, const CookSettings& settings) {
+        auto start = std::chrono::steady_clock::now();
+
+        int            width, height, channels;
+        unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            std::fprintf(stderr, "%s: %s\n", sourcePath.c_str(), stbi_failure_reason());
+            return false;
+        }
+
+        // Opaque textures take half the room as BC1, anything with alpha keeps it in BC7
+        BlockFormat format = settings.format;
+        if (settings.autoFormat) {
+            format = BlockFormat::BC1;
+            for (size_t i = 3; i < size_t(width) * height * 4; i += 4) {
+                if (pixels[i] != 255) {
+                    format = BlockFormat::BC7;
+                    break;
+                }
+            }
+        }
+
+        // Normal maps are never srgb
+        bool             srgb = !settings.linear && format != BlockFormat::BC5;
+        MipChainSettings chainSettings;
+        chainSettings.filter = settings.filter;
+        chainSettings.srgb = srgb;
+
+        uint32_t                   levelCount = getMipLevelCount(width, height);
+        std::vector<unsigned char> chain = generateMipChain(pixels, width, height, levelCount, chainSettings);
+        stbi_image_free(pixels);
+
+        TextureFile file;
+        file.format = getVkFormat(format, srgb);
+        file.width = static_cast<uint32_t>(width);
+        file.height = static_cast<uint32_t>(height);
+        file.levelCount = levelCount;
+        for (uint32_t level = 0; level < levelCount; level++) {
+            size_t                     levelWidth = (std::max)(size_t(width) >> level, size_t(1));
+            size_t                     levelHeight = (std::max)(size_t(height) >> level, size_t(1));
+            const unsigned char*       levelPixels = chain.data() + getMipLevelsSize(width, height, 0, level);
+            std::vector<unsigned char> blocks = compressLevel(levelPixels, levelWidth, levelHeight, format);
+            file.data.insert(file.data.end(), blocks.begin(), blocks.end());
+        }
+
+        std::filesystem::path cookedPath(sourcePath);
+        cookedPath.replace_extension(settings.dds ? ".dds" : ".ktx2");
+        if (!saveTextureFile(cookedPath.string(), file)) {
+            std::fprintf(stderr, "%s: could not be written\n", cookedPath.string().c_str());
+            return false;
+        }
+
+        const char* formatNames[] = {"BC1", "BC3", "BC5", "BC7"};
+        double      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %dx%d, %u levels, %s%s, %.1f KB -> %.1f KB (%.1f:1) in %.2f s\n",
+                    cookedPath.string().c_str(), width, height, levelCount, formatNames[static_cast<int>(format)],
+                    srgb ? " srgb" : "", chain.size() / 1024.0, file.data.size() / 1024.0,
+                    double(chain.size()) / file.data.size(), seconds);
+        return true;
+    }
+
+    void printUsage() {
+        std::printf(
+            "TextureCooker [--format bc1|bc3|bc5|bc7] [--linear] [--filter box|kaiser] [--dds] <image>...\n"
+            "  --format  Block format, BC7 for textures with alpha and BC1 otherwise when not given\n"
+            "  --linear  The colors aren't srgb, BC5 never is\n"
+            "  --filter  Mip filter, kaiser by default\n"
+            "  --dds     Write a .dds file instead of a .ktx2 file\n");
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    Yare::Logger::init();
+
+    CookSettings             settings;
+    std::vector<std::string> sourcePaths;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            settings.autoFormat = false;
+            if (name == "bc1") {
+                settings.format = BlockFormat::BC1;
+            } else if (name == "bc3") {
+                settings.format = BlockFormat::BC3;
+            } else if (name == "bc5") {
+                settings.format = BlockFormat::BC5;
+            } else if (name == "bc7") {
+                settings.format = BlockFormat::BC7;
+            } else {
+                printUsage();
+                return 1;
+            }
+        } else if (argument == "--filter" && i + 1 < argc) {
+            settings.filter = std::strcmp(argv[++i], "box") == 0 ? MipFilter::BOX : MipFilter::KAISER;
+        } else if (argument == "--linear") {
+            settings.linear = true;
+        } else if (argument == "--dds") {
+            settings.dds = true;
+        } else if (argument.rfind("--", 0) == 0) {
+            printUsage();
+            return 1;
+        } else {
+            sourcePaths.push_back(argument);
+        }
+    }
+    if (sourcePaths.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    int failed = 0;
+    for (const std::string& sourcePath : sourcePaths) {
+        failed += cookTexture(sourcePath, settings) ? 0 : 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+//SHADER:VERTEX
+depth_onlyVert.spv
+//end
\ No newline at end of file
@@ -0,0 +1,56 @@
+// SHADER: VERTEX
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(set = 0, binding = 0) uniform UboView {
+    mat4 view;
+    mat4 proj;
+} uboView;
+
+struct Object {
+    vec4 boundingSphere;
+    uint batchIndex;
+    uint materialIndex;
+    uint lodCount;
+    uint impostorBatch;
+    vec4 lodErrors;
+    float impostorTexelSize;
+    uint meshletCount;
+    uint padding1;
+    uint padding2;
+    vec4 positionTransform;
+};
+
+layout(set = 2, binding = 0) readonly buffer InstanceModels {
+    mat4 models[];
+} instanceModels;
+
+layout(set = 2, binding = 1) readonly buffer VisibleInstances {
+    uint ids[];
+} visibleInstances;
+
+// Left in the slots the culling wrote no object to
+const uint NO_INSTANCE = 0xFFFFFFFFu;
+
+layout(set = 2, binding = 2) readonly buffer Objects {
+    Object objects[];
+} sceneObjects;
+
+// Only the position stream is bound
+layout(location = 0) in vec3 inPosition;
+
+// The color pass compares against this depth with LESS_OR_EQUAL, so both have to compute it the exact same way
+invariant gl_Position;
+
+void main() {
+    uint objectId = visibleInstances.ids[gl_InstanceIndex];
+    // Empty slots are only drawn without drawIndirectFirstInstance, they end up outside the clip volume
+    if (objectId == NO_INSTANCE) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    mat4 model = instanceModels.models[objectId];
+    vec4 positionTransform = sceneObjects.objects[objectId].positionTransform;
+    vec3 position = positionTransform.xyz + positionTransform.w * inPosition;
+    gl_Position = uboView.proj * uboView.view * model * vec4(position, 1.0);
+}
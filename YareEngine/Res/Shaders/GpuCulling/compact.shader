@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+compactComp.spv
+//end
\ No newline at end of file
@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+cullComp.spv
+//end
\ No newline at end of file
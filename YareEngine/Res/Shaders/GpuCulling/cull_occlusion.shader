@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+cull_occlusionComp.spv
+//end
\ No newline at end of file
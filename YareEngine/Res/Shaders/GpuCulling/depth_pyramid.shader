@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+depth_pyramidComp.spv
+//end
\ No newline at end of file
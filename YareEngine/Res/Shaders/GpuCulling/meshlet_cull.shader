@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+meshlet_cullComp.spv
+//end
\ No newline at end of file
@@ -0,0 +1,59 @@
+// SHADER: FRAGMENT
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Slots of the renderer's texture array, TextureStreamer::MAX_TEXTURES at most
+layout(constant_id = 0) const uint TEXTURE_COUNT = 256;
+layout(set = 1, binding = 0) uniform sampler2D texSampler[TEXTURE_COUNT];
+
+layout(push_constant) uniform Impostor {
+    uint albedoIndex;
+    uint normalDepthIndex;
+    uint framesPerSide;
+} impostor;
+
+layout(location = 0) in vec4 fragLocalUv01;
+layout(location = 1) in vec4 fragLocalUv23;
+layout(location = 2) flat in vec4 fragWeights;
+layout(location = 3) flat in ivec4 fragFrames;
+layout(location = 4) in vec4 fragClipPosition;
+layout(location = 5) flat in vec4 fragClipToCamera;
+layout(location = 6) flat in mat3 fragNormalMatrix;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 DIRECTION_TO_LIGHT = normalize(vec3(1.0, 5.0, -1.0));
+
+vec2 atlasUv(int frame, vec2 localUv) {
+    int framesPerSide = int(impostor.framesPerSide);
+    vec2 cell = vec2(frame % framesPerSide, frame / framesPerSide);
+    // Corners projected from another view can land outside of its cell, they must not reach into the neighbours
+    return (cell + clamp(localUv, 0.0, 1.0)) / float(framesPerSide);
+}
+
+void main() {
+    vec2 localUvs[4] = vec2[4](fragLocalUv01.xy, fragLocalUv01.zw, fragLocalUv23.xy, fragLocalUv23.zw);
+
+    // The normals and depths of uncovered texels mean nothing, so they are weighted by coverage
+    vec4 albedo = vec4(0.0);
+    vec4 normalDepth = vec4(0.0);
+    for (int i = 0; i < 4; i++) {
+        vec2 uv = atlasUv(fragFrames[i], localUvs[i]);
+        vec4 color = texture(texSampler[impostor.albedoIndex], uv);
+        albedo += vec4(color.rgb, 1.0) * color.a * fragWeights[i];
+        normalDepth += texture(texSampler[impostor.normalDepthIndex], uv) * color.a * fragWeights[i];
+    }
+    if (albedo.a < 0.5) {
+        discard;
+    }
+    albedo.rgb /= albedo.a;
+    normalDepth /= albedo.a;
+
+    vec3 normal = normalize(fragNormalMatrix * (normalDepth.xyz * 2.0 - 1.0));
+    float lightIntensity = max(dot(normal, DIRECTION_TO_LIGHT), 0);
+    outColor = vec4(albedo.rgb * lightIntensity, 1.0);
+
+    // Moving the quad's fragment to the baked surface lets impostors cut into the ground like the mesh would
+    vec4 clip = fragClipPosition + fragClipToCamera * (1.0 - 2.0 * normalDepth.a);
+    gl_FragDepth = clamp(clip.z / clip.w, 0.0, 1.0);
+}
@@ -0,0 +1,6 @@
+//SHADER:VERTEX
+impostorVert.spv
+//end
+//SHADER:FRAGMENT
+impostorFrag.spv
+//end
\ No newline at end of file
@@ -0,0 +1,137 @@
+// SHADER: VERTEX
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Camera facing quad over an object's bounding sphere. The camera's direction in object space picks the four
+// nearest views on the octahedral atlas, and every corner is projected onto the plane of each of those views to
+// find where it lands in them. The quad's indices are 0 to 3, there are no vertex attributes.
+layout(set = 0, binding = 0) uniform UboView {
+    mat4 view;
+    mat4 proj;
+} uboView;
+
+struct Object {
+    vec4 boundingSphere;
+    uint batchIndex;
+    uint materialIndex;
+    uint lodCount;
+    uint impostorBatch;
+    vec4 lodErrors;
+    float impostorTexelSize;
+    uint meshletCount;
+    uint padding1;
+    uint padding2;
+    vec4 positionTransform;
+};
+
+layout(set = 2, binding = 0) readonly buffer InstanceModels {
+    mat4 models[];
+} instanceModels;
+
+layout(set = 2, binding = 1) readonly buffer VisibleInstances {
+    uint ids[];
+} visibleInstances;
+
+// Left in the slots the culling wrote no object to
+const uint NO_INSTANCE = 0xFFFFFFFFu;
+
+layout(set = 2, binding = 2) readonly buffer Objects {
+    Object objects[];
+} sceneObjects;
+
+layout(push_constant) uniform Impostor {
+    uint albedoIndex;
+    uint normalDepthIndex;
+    uint framesPerSide;
+} impostor;
+
+// Local uvs of the four views, they are clamped to their cell in the fragment shader
+layout(location = 0) out vec4 fragLocalUv01;
+layout(location = 1) out vec4 fragLocalUv23;
+layout(location = 2) flat out vec4 fragWeights;
+layout(location = 3) flat out ivec4 fragFrames;
+// The depth offset works in clip space, where moving toward the camera is linear
+layout(location = 4) out vec4 fragClipPosition;
+layout(location = 5) flat out vec4 fragClipToCamera;
+layout(location = 6) flat out mat3 fragNormalMatrix;
+
+const vec2 CORNERS[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+vec2 signNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Inverse of Impostor::octahedralDirection
+vec2 octahedralUv(vec3 direction) {
+    direction /= abs(direction.x) + abs(direction.y) + abs(direction.z);
+    vec2 p = direction.xz;
+    if (direction.y < 0.0) {
+        p = (1.0 - abs(p.yx)) * signNotZero(p);
+    }
+    return p * 0.5 + 0.5;
+}
+
+vec3 octahedralDirection(vec2 uv) {
+    vec2 p = uv * 2.0 - 1.0;
+    vec3 direction = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    if (direction.y < 0.0) {
+        direction.xz = (1.0 - abs(direction.zx)) * signNotZero(direction.xz);
+    }
+    return normalize(direction);
+}
+
+// Same basis the views were baked with
+void frameBasis(vec3 direction, out vec3 right, out vec3 up) {
+    vec3 hint = abs(direction.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    right = normalize(cross(hint, direction));
+    up = cross(direction, right);
+}
+
+void main() {
+    uint objectId = visibleInstances.ids[gl_InstanceIndex];
+    // Empty slots are only drawn without drawIndirectFirstInstance, they end up outside the clip volume
+    if (objectId == NO_INSTANCE) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    mat4 model = instanceModels.models[objectId];
+    vec4 sphere = sceneObjects.objects[objectId].boundingSphere;
+
+    // The views were baked in object space, so the quad is built there too
+    vec3 cameraPosition = -transpose(mat3(uboView.view)) * uboView.view[3].xyz;
+    vec3 viewDirection = normalize((inverse(model) * vec4(cameraPosition, 1.0)).xyz - sphere.xyz);
+    vec3 right, up;
+    frameBasis(viewDirection, right, up);
+
+    vec2 corner = CORNERS[gl_VertexIndex & 3];
+    vec3 offset = (right * corner.x + up * corner.y) * sphere.w;
+    vec4 worldPosition = model * vec4(sphere.xyz + offset, 1.0);
+    gl_Position = uboView.proj * uboView.view * worldPosition;
+
+    // Bilinear weights between the four view centers around the camera's direction
+    float n = float(impostor.framesPerSide);
+    vec2 grid = octahedralUv(viewDirection) * n - 0.5;
+    vec2 first = clamp(floor(grid), vec2(0.0), vec2(n - 2.0));
+    vec2 t = clamp(grid - first, 0.0, 1.0);
+    fragWeights = vec4((1.0 - t.x) * (1.0 - t.y), t.x * (1.0 - t.y), (1.0 - t.x) * t.y, t.x * t.y);
+
+    vec2 localUvs[4];
+    for (int i = 0; i < 4; i++) {
+        vec2 cell = first + vec2(i & 1, i >> 1);
+        fragFrames[i] = int(cell.y * n + cell.x);
+
+        vec3 frameRight, frameUp;
+        frameBasis(octahedralDirection((cell + 0.5) / n), frameRight, frameUp);
+        localUvs[i] = vec2(dot(offset, frameRight), dot(offset, frameUp)) / (2.0 * sphere.w) + 0.5;
+    }
+    fragLocalUv01 = vec4(localUvs[0], localUvs[1]);
+    fragLocalUv23 = vec4(localUvs[2], localUvs[3]);
+
+    // One radius toward the camera, the baked depth says how much of it to move
+    float scale = max(max(length(model[0].xyz), length(model[1].xyz)), length(model[2].xyz));
+    vec3 center = (model * vec4(sphere.xyz, 1.0)).xyz;
+    vec3 toCamera = normalize(cameraPosition - center) * sphere.w * scale;
+    fragClipPosition = gl_Position;
+    fragClipToCamera = uboView.proj * uboView.view * vec4(toCamera, 0.0);
+    fragNormalMatrix = mat3(model);
+}
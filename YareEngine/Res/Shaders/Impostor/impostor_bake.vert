@@ -0,0 +1,29 @@
+// SHADER: VERTEX
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Draws the mesh into one view of an impostor atlas, the viewport picks the view's cell
+layout(push_constant) uniform View {
+    mat4 viewProjection;  // also undoes the position quantization
+} view;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inNormal;
+layout(location = 3) in vec2 inTexCoord;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec3 fragNormal;
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(encoded.yx)) * vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main() {
+    gl_Position = view.viewProjection * vec4(inPosition, 1.0);
+    fragTexCoord = inTexCoord;
+    fragNormal = decodeOctahedral(inNormal);
+}
@@ -0,0 +1,15 @@
+// SHADER: FRAGMENT
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D albedo;
+
+// Unlit, the impostor shader lights it with the baked normals. Alpha marks the texels the mesh covers.
+void main() {
+    outColor = vec4(texture(albedo, fragTexCoord).rgb, 1.0);
+}
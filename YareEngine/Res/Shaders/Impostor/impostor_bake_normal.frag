@@ -0,0 +1,13 @@
+// SHADER: FRAGMENT
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outNormalDepth;
+
+// Object space normal packed into 0 to 1, with the depth through the bounding sphere next to it
+void main() {
+    outNormalDepth = vec4(normalize(fragNormal) * 0.5 + 0.5, gl_FragCoord.z);
+}
@@ -0,0 +1,6 @@
+//SHADER:VERTEX
+impostor_bakeVert.spv
+//end
+//SHADER:FRAGMENT
+impostor_bake_normalFrag.spv
+//end
\ No newline at end of file
@@ -0,0 +1,3 @@
+//SHADER:COMPUTE
+instance_transformComp.spv
+//end
\ No newline at end of file
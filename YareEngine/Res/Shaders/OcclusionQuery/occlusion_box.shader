@@ -0,0 +1,3 @@
+//SHADER:VERTEX
+occlusion_boxVert.spv
+//end
\ No newline at end of file
@@ -0,0 +1,18 @@
+// SHADER: VERTEX
+#version 450
+
+// Draws the box an occlusion query tests, a unit cube from -1 to 1 moved into clip space by the push constant. There
+// are no vertex buffers, the 36 corners of the cube's triangles come from the vertex index.
+layout(push_constant) uniform Proxy {
+    mat4 boxToClip;
+} proxy;
+
+// Corners are numbered by their bits, x is bit 0, y bit 1 and z bit 2
+const int BOX_INDICES[36] = int[36](0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 4, 6, 0, 6, 2,
+                                    1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3);
+
+void main() {
+    int corner = BOX_INDICES[gl_VertexIndex];
+    vec3 position = vec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1) * 2.0 - 1.0;
+    gl_Position = proxy.boxToClip * vec4(position, 1.0);
+}
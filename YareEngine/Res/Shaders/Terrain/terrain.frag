@@ -0,0 +1,21 @@
+// SHADER: FRAGMENT
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) in float fragHeight;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 DIRECTION_TO_LIGHT = normalize(vec3(1.0, 5.0, -1.0));
+const vec3 GRASS = vec3(0.28, 0.42, 0.18);
+const vec3 ROCK = vec3(0.42, 0.38, 0.34);
+const vec3 SNOW = vec3(0.92, 0.93, 0.95);
+
+void main() {
+    vec3  normal = normalize(fragNormal);
+    vec3  color = mix(GRASS, ROCK, 1.0 - smoothstep(0.6, 0.75, normal.y));
+    color = mix(color, SNOW, smoothstep(45.0, 60.0, fragHeight) * smoothstep(0.6, 0.8, normal.y));
+    float intensity = max(dot(normal, DIRECTION_TO_LIGHT), 0.0) * 0.8 + 0.2;
+    outColor = vec4(color * intensity, 1.0);
+}
@@ -0,0 +1,70 @@
+// SHADER: VERTEX
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(set = 0, binding = 0) uniform UboView {
+    mat4 view;
+    mat4 proj;
+} uboView;
+
+// Heights in world units relative to the base height, one float per texel
+layout(set = 0, binding = 1) uniform sampler2D heightmap;
+
+struct Node {
+    vec2 offset;
+    float size;
+    float level;
+    vec2 morphRange;
+    vec2 padding;
+};
+
+// Written every frame by the quadtree selection, indexed by the draw's firstInstance plus the instance
+layout(set = 0, binding = 2) readonly buffer Nodes {
+    Node nodes[];
+} terrainNodes;
+
+layout(push_constant) uniform Constants {
+    vec4 cameraPosition;
+    // World size, base height, grid resolution and one unused
+    vec4 terrain;
+} constants;
+
+// Position in the grid, 0 to 1 along both edges
+layout(location = 0) in vec2 inGridPosition;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out float fragHeight;
+
+float sampleHeight(vec2 world) {
+    ivec2 size = textureSize(heightmap, 0);
+    vec2  texel = clamp(world / constants.terrain.x + 0.5, 0.0, 1.0) * vec2(size - 1);
+    ivec2 base = min(ivec2(texel), size - 2);
+    vec2  weight = texel - vec2(base);
+
+    float h00 = texelFetch(heightmap, base, 0).r;
+    float h10 = texelFetch(heightmap, base + ivec2(1, 0), 0).r;
+    float h01 = texelFetch(heightmap, base + ivec2(0, 1), 0).r;
+    float h11 = texelFetch(heightmap, base + ivec2(1, 1), 0).r;
+    return constants.terrain.y + mix(mix(h00, h10, weight.x), mix(h01, h11, weight.x), weight.y);
+}
+
+void main() {
+    Node node = terrainNodes.nodes[gl_InstanceIndex];
+    float resolution = constants.terrain.z;
+
+    vec2  world = node.offset + inGridPosition * node.size;
+    float distanceToCamera = distance(constants.cameraPosition.xyz, vec3(world.x, sampleHeight(world), world.y));
+    float morph = clamp((distanceToCamera - node.morphRange.x) / (node.morphRange.y - node.morphRange.x), 0.0, 1.0);
+
+    // The odd vertices slide onto their even neighbours, which turns the grid into the next coarser level's
+    vec2 odd = fract(inGridPosition * resolution * 0.5) * 2.0 / resolution;
+    world = node.offset + (inGridPosition - odd * morph) * node.size;
+
+    float height = sampleHeight(world);
+    vec2 dx = vec2(node.size / resolution, 0.0);
+    vec2 dz = dx.yx;
+    fragNormal = normalize(vec3(sampleHeight(world - dx) - sampleHeight(world + dx), 2.0 * dx.x,
+                                sampleHeight(world - dz) - sampleHeight(world + dz)));
+    fragHeight = height - constants.terrain.y;
+    gl_Position = uboView.proj * uboView.view * vec4(world.x, height, world.y, 1.0);
+}
@@ -4,15 +4,30 @@
 
 layout(location = 0) in float fragIntensity;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in int fragImageIdx;
 
 layout(location = 0) out vec4 outColor;
 
-layout(set = 0, binding = 2) uniform sampler2D texSampler[16];
+// Slots of the renderer's texture array, TextureStreamer::MAX_TEXTURES at most
+layout(constant_id = 0) const uint TEXTURE_COUNT = 256;
+layout(set = 1, binding = 0) uniform sampler2D texSampler[TEXTURE_COUNT];
 
-layout(push_constant) uniform PER_OBJECT {
-    int imgIdx;
-}pc;
+// Matches TextureStreamer::Feedback, levels are of the whole mip chain while the images start at their resident level
+layout(set = 1, binding = 1) buffer TextureFeedback {
+    uint residentLevels[256];
+    uint requestedLevels[256];
+} feedback;
 
 void main() {
-    outColor = vec4(texture(texSampler[pc.imgIdx], fragTexCoord).rgb * fragIntensity, 1.0);
+    // Derivatives are only defined in uniform control flow, so the level is queried before the branch. The
+    // unclamped level says how much finer than the resident levels the fragment wants to sample.
+    float lod = textureQueryLod(texSampler[fragImageIdx], fragTexCoord).y;
+
+    // One fragment of every 4x4 block reports the level it needs, which is plenty and keeps the atomics down
+    if ((uint(gl_FragCoord.x) & 3u) == 0u && (uint(gl_FragCoord.y) & 3u) == 0u) {
+        int level = max(int(floor(lod)) + int(feedback.residentLevels[fragImageIdx]), 0);
+        atomicMin(feedback.requestedLevels[fragImageIdx], uint(level));
+    }
+
+    outColor = vec4(texture(texSampler[fragImageIdx], fragTexCoord).rgb * fragIntensity, 1.0);
 }
@@ -2,32 +2,82 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 0) uniform UboView {
+layout(set = 0, binding = 0) uniform UboView {
     mat4 view;
     mat4 proj;
 } uboView;
 
-layout(binding = 1) uniform UboInstance {
-    mat4 model;
-} uboInstance;
+struct Object {
+    vec4 boundingSphere;
+    uint batchIndex;
+    uint materialIndex;
+    uint lodCount;
+    uint impostorBatch;
+    vec4 lodErrors;
+    float impostorTexelSize;
+    uint meshletCount;
+    uint padding1;
+    uint padding2;
+    vec4 positionTransform;
+};
 
+// Written every frame by the instance transform compute shader, indexed by object id
+layout(set = 2, binding = 0) readonly buffer InstanceModels {
+    mat4 models[];
+} instanceModels;
+
+// Written every frame by the culling shader, each draws first instance points at its batch's visible object ids
+layout(set = 2, binding = 1) readonly buffer VisibleInstances {
+    uint ids[];
+} visibleInstances;
+
+// Left in the slots the culling wrote no object to
+const uint NO_INSTANCE = 0xFFFFFFFFu;
+
+layout(set = 2, binding = 2) readonly buffer Objects {
+    Object objects[];
+} sceneObjects;
+
+// Quantized to the box around the mesh's bounding sphere, the normal is octahedral encoded
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec3 normal;
+layout(location = 2) in vec2 inNormal;
 layout(location = 3) in vec2 inTexCoord;
 
 layout(location = 0) out float fragIntensity;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out int fragImageIdx;
+
+// Must match the depth prepass bit for bit
+invariant gl_Position;
 
 const vec3 DIRECTION_TO_LIGHT = normalize(vec3(1.0, 5.0, -1.0));
 
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(encoded.yx)) * vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
 void main() {
-    gl_Position = uboView.proj * uboView.view * uboInstance.model * vec4(inPosition, 1.0);
+    uint objectId = visibleInstances.ids[gl_InstanceIndex];
+    // Empty slots are only drawn without drawIndirectFirstInstance, they end up outside the clip volume
+    if (objectId == NO_INSTANCE) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    mat4 model = instanceModels.models[objectId];
+    vec4 positionTransform = sceneObjects.objects[objectId].positionTransform;
+    vec3 position = positionTransform.xyz + positionTransform.w * inPosition;
+    gl_Position = uboView.proj * uboView.view * model * vec4(position, 1.0);
 
-    vec3 normalWorldSpace = normalize(mat3(uboInstance.model) * normal);
+    vec3 normalWorldSpace = normalize(mat3(model) * decodeOctahedral(inNormal));
 
     float lightIntensity = max(dot(normalWorldSpace, DIRECTION_TO_LIGHT), 0);
 
     fragIntensity = lightIntensity;
     fragTexCoord = inTexCoord;
+    // Batches never mix materials, so this is uniform across a draw
+    fragImageIdx = int(sceneObjects.objects[objectId].materialIndex);
 }
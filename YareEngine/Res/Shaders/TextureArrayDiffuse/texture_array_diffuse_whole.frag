@@ -0,0 +1,18 @@
+// SHADER: FRAGMENT
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in float fragIntensity;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in int fragImageIdx;
+
+layout(location = 0) out vec4 outColor;
+
+// For gpus that can't store from fragment shaders, the textures are loaded whole and nothing reports their levels
+// Slots of the renderer's texture array, TextureStreamer::MAX_TEXTURES at most
+layout(constant_id = 0) const uint TEXTURE_COUNT = 256;
+layout(set = 1, binding = 0) uniform sampler2D texSampler[TEXTURE_COUNT];
+
+void main() {
+    outColor = vec4(texture(texSampler[fragImageIdx], fragTexCoord).rgb * fragIntensity, 1.0);
+}
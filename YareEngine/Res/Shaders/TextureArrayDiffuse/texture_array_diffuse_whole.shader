@@ -0,0 +1,6 @@
+//SHADER:VERTEX
+texture_array_diffuseVert.spv
+//end
+//SHADER:FRAGMENT
+texture_array_diffuse_wholeFrag.spv
+//end
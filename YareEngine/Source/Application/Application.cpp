@@ -1,7 +1,9 @@
 #include "Application/Application.h"
 
 #include "Application/GlobalSettings.h"
+#include "Core/FileSystem.h"
 #include "Core/Glfw.h"
+#include "Core/JobSystem.h"
 #include "Graphics/RenderManager.h"
 #include "Utilities/Logger.h"
 
@@ -29,6 +31,8 @@ namespace Yare {
 
     Application::~Application() {
         GlobalSettings::release();
+        JobSystem::release();
+        FileSystem::release();
         ImGui::DestroyContext();
     }
 
@@ -36,6 +40,9 @@ namespace Yare {
         Yare::Logger::init();
         YZ_INFO("Logger Initialized");
 
+        // Built by the AssetPacker tool, without it or when it is stale every asset is mapped from its own file
+        FileSystem::instance()->mount("../Res.pack", "../Res");
+
         // Create a window
         Graphics::WindowProperties props = {1200, 800};
         m_Window = Graphics::Window::createNewWindow(props);
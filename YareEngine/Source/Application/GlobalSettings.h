@@ -1,6 +1,9 @@
 #ifndef YARE_GLOBAL_SETTINGS_H
 #define YARE_GLOBAL_SETTINGS_H
 
+#include <string>
+#include <vector>
+
 #include "Utilities/T_Singleton.h"
 
 namespace Yare {
@@ -9,6 +12,45 @@ namespace Yare {
         GlobalSettings() {}
         bool   displayModels = true;
         bool   displayBackground = true;
+        bool   displayTerrain = true;
+        int    terrainNodeCount = 0;
+        int    terrainTriangleCount = 0;
+        // Cells of the world partition streamed in around the camera, and the meshes and textures they hold
+        int    residentCellCount = 0;
+        int    loadingCellCount = 0;
+        float  cellMegabytes = 0.0f;
+        // Streamed texture mip levels, resident against what the whole chains would take
+        int    loadingTextureCount = 0;
+        float  textureMegabytes = 0.0f;
+        float  fullTextureMegabytes = 0.0f;
+        // Meshes and textures of the asset loader, and a line per resident one while they are listed
+        int                      assetCount = 0;
+        int                      loadingAssetCount = 0;
+        float                    assetCpuMegabytes = 0.0f;
+        float                    assetGpuMegabytes = 0.0f;
+        bool                     listAssets = false;
+        std::vector<std::string> assetListing;
+        // Turned off at startup when the gpu can't build the depth pyramid
+        bool   occlusionCulling = true;
+        // Rasterizes the marked occluders on the cpu and skips what they hide, on top of the gpu culling
+        bool   cpuOcclusionCulling = false;
+        int    cpuOccludedCount = 0;
+        int    cpuTestedCount = 0;
+        double cpuRasterizeTime = 0;
+        // Hardware occlusion queries per entity, replaces the two phase occlusion culling while it's on
+        bool   occlusionQueries = false;
+        int    queryCount = 0;
+        int    queryOccludedCount = 0;
+        int    queryTrianglesSaved = 0;
+        // Every step up halves the detail meshes are drawn with, negative values keep more detail
+        float  lodBias = 0.0f;
+        // Far away trees are drawn as baked impostors instead of meshes
+        bool   impostors = true;
+        // Large meshes drawn at full detail skip their meshlets that face away or are off screen
+        bool   meshletCulling = true;
+        // Lays down the depth of each culled phase with a position only pass first, so the lit pass shades every
+        // pixel once. Occlusion queries draw the objects one by one and don't use it.
+        bool   depthPrepass = false;
         bool   logFps = false;
         double fps = 0;
     };
@@ -25,6 +25,14 @@ namespace Yare {
         glm::mat4* model = nullptr;
     };
 
+    // Per instance input of the instance transform compute shader, laid out to match its std430 struct
+    struct GpuInstance {
+        glm::vec4 translation;
+        glm::vec4 rotation;  // Quaternion as xyzw
+        glm::vec4 scale;
+        glm::vec4 spin;  // Axis in xyz, speed in radians per second in w
+    };
+
     struct UniformVS {
         glm::mat4 view;
         glm::mat4 projection;
@@ -0,0 +1,196 @@
+#include "Core/FileSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+#include "Utilities/Logger.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Yare {
+
+    namespace {
+        std::string normalize(const std::string& path) {
+            return std::filesystem::path(path).lexically_normal().generic_string();
+        }
+
+        std::string_view getName(const char* names, const AssetPackEntry& entry) {
+            return std::string_view(names + entry.nameOffset, entry.nameLength);
+        }
+
+        // A file under the root written after the pack, empty when there is none. Only the timestamps are read.
+        std::string findNewerFile(const std::string& root, const std::string& packPath) {
+            std::error_code                 error;
+            std::filesystem::file_time_type packTime = std::filesystem::last_write_time(packPath, error);
+            if (error) {
+                return {};
+            }
+            for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end;
+                 it.increment(error)) {
+                std::error_code fileError;
+                if (it->is_regular_file(fileError) && !isAssetCache(it->path().string()) &&
+                    it->last_write_time(fileError) > packTime && !fileError) {
+                    return it->path().generic_string();
+                }
+            }
+            return {};
+        }
+    }  // namespace
+
+    bool isAssetCache(const std::string& filePath) {
+        std::string extension = std::filesystem::path(filePath).extension().string();
+        return extension == ".mips" || extension == ".occluder" || extension == ".heightfield";
+    }
+
+    MappedFile::~MappedFile() {
+#ifdef _WIN32
+        if (m_Data) {
+            UnmapViewOfFile(m_Data);
+        }
+        if (m_Mapping) {
+            CloseHandle(m_Mapping);
+        }
+        if (m_File) {
+            CloseHandle(m_File);
+        }
+#else
+        if (m_Data) {
+            munmap(const_cast<unsigned char*>(m_Data), m_Size);
+        }
+#endif
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string& filePath) {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+#ifdef _WIN32
+        HANDLE handle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        file->m_File = handle;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size)) {
+            return nullptr;
+        }
+        file->m_Size = static_cast<size_t>(size.QuadPart);
+        // Empty files can't be mapped, they are open with no bytes
+        if (file->m_Size == 0) {
+            return file;
+        }
+        file->m_Mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file->m_Mapping) {
+            return nullptr;
+        }
+        file->m_Data = static_cast<const unsigned char*>(MapViewOfFile(file->m_Mapping, FILE_MAP_READ, 0, 0, 0));
+        return file->m_Data ? file : nullptr;
+#else
+        int descriptor = ::open(filePath.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return nullptr;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+            close(descriptor);
+            return nullptr;
+        }
+        file->m_Size = static_cast<size_t>(status.st_size);
+        // Empty files can't be mapped, they are open with no bytes. The mapping outlives the descriptor.
+        void* data = file->m_Size > 0 ? mmap(nullptr, file->m_Size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+        close(descriptor);
+        if (data == MAP_FAILED) {
+            file->m_Size = 0;
+            return nullptr;
+        }
+        file->m_Data = static_cast<const unsigned char*>(data);
+        return file;
+#endif
+    }
+
+    bool FileSystem::mount(const std::string& packPath, const std::string& root) {
+        std::shared_ptr<MappedFile> pack = MappedFile::open(packPath);
+        if (!pack) {
+            return false;
+        }
+        // The pack would hide files edited since it was built behind their old copies
+        std::string newerFile = findNewerFile(root, packPath);
+        if (!newerFile.empty()) {
+            YZ_WARN("'" + packPath + "' is older than '" + newerFile + "', reading from disk until it is built again.");
+            return false;
+        }
+
+        // Everything the table of contents points at has to be inside the file
+        AssetPackHeader header;
+        if (pack->getSize() < sizeof(header)) {
+            YZ_ERROR("'" + packPath + "' is not an asset pack.");
+            return false;
+        }
+        std::memcpy(&header, pack->getData(), sizeof(header));
+        uint64_t namesOffset = sizeof(header) + uint64_t(header.entryCount) * sizeof(AssetPackEntry);
+        if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION ||
+            namesOffset + header.namesSize > pack->getSize()) {
+            YZ_ERROR("'" + packPath + "' is not an asset pack of version " + std::to_string(ASSET_PACK_VERSION) + ".");
+            return false;
+        }
+        auto entries = reinterpret_cast<const AssetPackEntry*>(pack->getData() + sizeof(header));
+        for (uint32_t i = 0; i < header.entryCount; i++) {
+            if (entries[i].offset > pack->getSize() || entries[i].size > pack->getSize() - entries[i].offset ||
+                uint64_t(entries[i].nameOffset) + entries[i].nameLength > header.namesSize) {
+                YZ_ERROR("'" + packPath + "' is truncated.");
+                return false;
+            }
+        }
+
+        m_Entries = entries;
+        m_Names = reinterpret_cast<const char*>(pack->getData() + namesOffset);
+        m_EntryCount = header.entryCount;
+        m_Root = normalize(root);
+        if (m_Root.size() > 1 && m_Root.back() == '/') {
+            m_Root.pop_back();
+        }
+        m_Pack = std::move(pack);
+        YZ_INFO("Mounted '" + packPath + "' at '" + m_Root + "', " + std::to_string(m_EntryCount) + " files");
+        return true;
+    }
+
+    FileView FileSystem::open(const std::string& filePath) const {
+        if (const AssetPackEntry* entry = find(filePath)) {
+            return FileView(m_Pack, m_Pack->getData() + entry->offset, static_cast<size_t>(entry->size));
+        }
+        std::shared_ptr<const MappedFile> file = MappedFile::open(filePath);
+        if (!file) {
+            return {};
+        }
+        return FileView(file, file->getData(), file->getSize());
+    }
+
+    bool FileSystem::isPacked(const std::string& filePath) const { return find(filePath) != nullptr; }
+
+    const AssetPackEntry* FileSystem::find(const std::string& filePath) const {
+        if (!m_Pack) {
+            return nullptr;
+        }
+        std::string path = normalize(filePath);
+        if (path.size() <= m_Root.size() || path.compare(0, m_Root.size(), m_Root) != 0 ||
+            path[m_Root.size()] != '/') {
+            return nullptr;
+        }
+
+        std::string_view      name = std::string_view(path).substr(m_Root.size() + 1);
+        const AssetPackEntry* end = m_Entries + m_EntryCount;
+        const AssetPackEntry* entry =
+            std::lower_bound(m_Entries, end, name, [this](const AssetPackEntry& candidate, std::string_view value) {
+                return getName(m_Names, candidate) < value;
+            });
+        return entry != end && getName(m_Names, *entry) == name ? entry : nullptr;
+    }
+}  // namespace Yare
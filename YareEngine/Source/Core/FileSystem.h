@@ -0,0 +1,109 @@
+#ifndef YARE_FILE_SYSTEM_H
+#define YARE_FILE_SYSTEM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Core/Core.h"
+#include "Utilities/T_Singleton.h"
+
+namespace Yare {
+
+    // An asset pack starts with the header and the table of contents, sorted by name, followed by the names. The
+    // bytes of every file start on their own ASSET_PACK_ALIGNMENT boundary after that.
+    constexpr uint32_t ASSET_PACK_MAGIC = 0x4B415059;  // "YPAK"
+    constexpr uint32_t ASSET_PACK_VERSION = 1;
+    constexpr uint64_t ASSET_PACK_ALIGNMENT = 4096;
+
+    struct AssetPackHeader {
+        uint32_t magic = ASSET_PACK_MAGIC;
+        uint32_t version = ASSET_PACK_VERSION;
+        uint32_t entryCount = 0;
+        uint32_t namesSize = 0;
+    };
+
+    struct AssetPackEntry {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        // Into the names, relative to the packed folder with forward slashes and not terminated
+        uint32_t nameOffset = 0;
+        uint32_t nameLength = 0;
+    };
+
+    // Written next to the assets by the engine and rebuilt whenever they are stale, so never packed
+    bool isAssetCache(const std::string& filePath);
+
+    // A whole file mapped read only, unmapped again with the last view of it
+    class MappedFile {
+       public:
+        ~MappedFile();
+
+        // Null when the file can't be opened or mapped
+        static std::shared_ptr<MappedFile> open(const std::string& filePath);
+
+        const unsigned char* getData() const { return m_Data; }
+        size_t               getSize() const { return m_Size; }
+
+       private:
+        MappedFile() = default;
+        NONCOPYABLE(MappedFile);
+
+        const unsigned char* m_Data = nullptr;
+        size_t               m_Size = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+
+    // The bytes of one file, straight from the page cache. They stay valid as long as the view is alive.
+    class FileView {
+       public:
+        FileView() = default;
+
+        bool                 isOpen() const { return m_File != nullptr; }
+        const unsigned char* data() const { return m_Data; }
+        size_t               size() const { return m_Size; }
+        bool                 empty() const { return m_Size == 0; }
+        const unsigned char* begin() const { return m_Data; }
+        const unsigned char* end() const { return m_Data + m_Size; }
+
+       private:
+        friend class FileSystem;
+        FileView(std::shared_ptr<const MappedFile> file, const unsigned char* data, size_t size)
+            : m_File(std::move(file)), m_Data(data), m_Size(size) {}
+
+        std::shared_ptr<const MappedFile> m_File;
+        const unsigned char*              m_Data = nullptr;
+        size_t                            m_Size = 0;
+    };
+
+    // Opens files by mapping them instead of reading them. Once a pack is mounted, the files under its root are
+    // found in the pack's table of contents, the pack was mapped once and nothing more is opened for them. Anything
+    // the pack doesn't have is mapped from disk. Mount before loading anything, opening is safe on any thread.
+    class FileSystem : public Utilities::T_Singleton<FileSystem> {
+       public:
+        FileSystem() {}
+
+        // Returns false and keeps reading from disk when the pack is missing, invalid or older than a file under the
+        // root
+        bool mount(const std::string& packPath, const std::string& root);
+
+        // Not open when the file is neither in the pack nor on disk
+        FileView open(const std::string& filePath) const;
+        bool     isPacked(const std::string& filePath) const;
+
+       private:
+        const AssetPackEntry* find(const std::string& filePath) const;
+
+        std::shared_ptr<const MappedFile> m_Pack;
+        // Lexically normal with forward slashes, like the paths looked up
+        std::string           m_Root;
+        const AssetPackEntry* m_Entries = nullptr;
+        const char*           m_Names = nullptr;
+        uint32_t              m_EntryCount = 0;
+    };
+}  // namespace Yare
+
+#endif  // YARE_FILE_SYSTEM_H
@@ -0,0 +1,92 @@
+#include "Core/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Yare {
+
+    JobSystem::JobSystem() {
+        uint32_t workerCount = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&JobSystem::workerLoop, this);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_JobAvailable.notify_all();
+        for (auto& worker : m_Workers) {
+            worker.join();
+        }
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t)>& job) {
+        if (count == 0) {
+            return;
+        }
+        batchSize = (std::max)(batchSize, 1u);
+
+        // Lives on this stack frame, which is safe because we don't return before every batch has finished
+        std::atomic<uint32_t> remainingBatches((count + batchSize - 1) / batchSize);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (uint32_t begin = 0; begin < count; begin += batchSize) {
+                uint32_t end = (std::min)(begin + batchSize, count);
+                m_Jobs.emplace_back([&job, &remainingBatches, begin, end]() {
+                    for (uint32_t index = begin; index < end; index++) {
+                        job(index);
+                    }
+                    remainingBatches.fetch_sub(1, std::memory_order_release);
+                });
+            }
+        }
+        m_JobAvailable.notify_all();
+
+        while (remainingBatches.load(std::memory_order_acquire) > 0) {
+            if (!runPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::schedule(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push_back(std::move(job));
+        }
+        m_JobAvailable.notify_one();
+    }
+
+    void JobSystem::workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_JobAvailable.wait(lock, [this]() { return !m_Running || !m_Jobs.empty(); });
+                if (m_Jobs.empty()) {
+                    return;
+                }
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    bool JobSystem::runPendingJob() {
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Jobs.empty()) {
+                return false;
+            }
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+        job();
+        return true;
+    }
+}  // namespace Yare
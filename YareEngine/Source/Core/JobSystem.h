@@ -0,0 +1,42 @@
+#ifndef YARE_JOB_SYSTEM_H
+#define YARE_JOB_SYSTEM_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utilities/T_Singleton.h"
+
+namespace Yare {
+    // A fixed pool of worker threads, one less than the cpu has cores so the main thread keeps one for itself
+    class JobSystem : public Utilities::T_Singleton<JobSystem> {
+       public:
+        JobSystem();
+        ~JobSystem();
+
+        // Calls job(index) for every index below count, spread over the workers in batches of batchSize. The calling
+        // thread works on batches too and only returns once all of them are done.
+        void parallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t)>& job);
+        // Queues job and returns at once, the caller keeps whatever the job uses alive until it has run
+        void schedule(std::function<void()> job);
+
+        // Runs one queued job on the calling thread, returns false when the queue was empty
+        bool runPendingJob();
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+       private:
+        void workerLoop();
+
+        std::vector<std::thread>          m_Workers;
+        std::deque<std::function<void()>> m_Jobs;
+        std::mutex                        m_Mutex;
+        std::condition_variable           m_JobAvailable;
+        bool                              m_Running = true;
+    };
+}  // namespace Yare
+
+#endif  // YARE_JOB_SYSTEM_H
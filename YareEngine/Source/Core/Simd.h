@@ -0,0 +1,116 @@
+#ifndef YARE_SIMD_H
+#define YARE_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define YARE_SIMD
+#elif defined(__SSE4_1__) || defined(_M_X64)
+#include <smmintrin.h>
+#define YARE_SIMD
+#define YARE_SIMD_SSE
+#endif
+
+namespace Yare::Simd {
+    // Loops written once against these handle LANE_COUNT floats per step, 8 with AVX2 and 4 with SSE4.1. Builds
+    // without either fall back to one float per step. Integer lanes wrap around like uint32_t in every variant.
+#if defined(__AVX2__)
+    using Lanes = __m256;
+    using IntLanes = __m256i;
+    using Mask = __m256;
+    constexpr uint32_t LANE_COUNT = 8;
+
+    inline Lanes    splat(float value) { return _mm256_set1_ps(value); }
+    inline Lanes    laneOffsets() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+    inline Lanes    add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+    inline Lanes    sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+    inline Lanes    mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+    inline Lanes    minimum(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+    inline Lanes    maximum(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+    inline Lanes    absolute(Lanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline Lanes    floorLanes(Lanes a) { return _mm256_floor_ps(a); }
+    inline Mask     greater(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    inline Mask     greaterEqual(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline Mask     both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    inline bool     any(Mask mask) { return _mm256_movemask_ps(mask) != 0; }
+    inline Lanes    select(Mask mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+    inline Lanes    load(const float* source) { return _mm256_loadu_ps(source); }
+    inline void     store(float* destination, Lanes value) { _mm256_storeu_ps(destination, value); }
+    inline IntLanes splatInt(uint32_t value) { return _mm256_set1_epi32(static_cast<int32_t>(value)); }
+    inline IntLanes toInt(Lanes a) { return _mm256_cvttps_epi32(a); }
+    inline IntLanes addInt(IntLanes a, IntLanes b) { return _mm256_add_epi32(a, b); }
+    inline IntLanes mulInt(IntLanes a, IntLanes b) { return _mm256_mullo_epi32(a, b); }
+    inline IntLanes xorInt(IntLanes a, IntLanes b) { return _mm256_xor_si256(a, b); }
+    inline IntLanes shiftRight(IntLanes a, int count) { return _mm256_srl_epi32(a, _mm_cvtsi32_si128(count)); }
+    inline Mask     bitSet(IntLanes a, uint32_t bit) {
+        IntLanes clear = _mm256_cmpeq_epi32(_mm256_and_si256(a, splatInt(bit)), _mm256_setzero_si256());
+        return _mm256_castsi256_ps(_mm256_xor_si256(clear, _mm256_set1_epi32(-1)));
+    }
+#elif defined(YARE_SIMD_SSE)
+    using Lanes = __m128;
+    using IntLanes = __m128i;
+    using Mask = __m128;
+    constexpr uint32_t LANE_COUNT = 4;
+
+    inline Lanes    splat(float value) { return _mm_set1_ps(value); }
+    inline Lanes    laneOffsets() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+    inline Lanes    add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+    inline Lanes    sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+    inline Lanes    mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+    inline Lanes    minimum(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+    inline Lanes    maximum(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+    inline Lanes    absolute(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline Lanes    floorLanes(Lanes a) { return _mm_floor_ps(a); }
+    inline Mask     greater(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+    inline Mask     greaterEqual(Lanes a, Lanes b) { return _mm_cmpge_ps(a, b); }
+    inline Mask     both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    inline bool     any(Mask mask) { return _mm_movemask_ps(mask) != 0; }
+    inline Lanes    select(Mask mask, Lanes a, Lanes b) { return _mm_blendv_ps(b, a, mask); }
+    inline Lanes    load(const float* source) { return _mm_loadu_ps(source); }
+    inline void     store(float* destination, Lanes value) { _mm_storeu_ps(destination, value); }
+    inline IntLanes splatInt(uint32_t value) { return _mm_set1_epi32(static_cast<int32_t>(value)); }
+    inline IntLanes toInt(Lanes a) { return _mm_cvttps_epi32(a); }
+    inline IntLanes addInt(IntLanes a, IntLanes b) { return _mm_add_epi32(a, b); }
+    inline IntLanes mulInt(IntLanes a, IntLanes b) { return _mm_mullo_epi32(a, b); }
+    inline IntLanes xorInt(IntLanes a, IntLanes b) { return _mm_xor_si128(a, b); }
+    inline IntLanes shiftRight(IntLanes a, int count) { return _mm_srl_epi32(a, _mm_cvtsi32_si128(count)); }
+    inline Mask     bitSet(IntLanes a, uint32_t bit) {
+        IntLanes clear = _mm_cmpeq_epi32(_mm_and_si128(a, splatInt(bit)), _mm_setzero_si128());
+        return _mm_castsi128_ps(_mm_xor_si128(clear, _mm_set1_epi32(-1)));
+    }
+#else
+    using Lanes = float;
+    using IntLanes = uint32_t;
+    using Mask = bool;
+    constexpr uint32_t LANE_COUNT = 1;
+
+    inline Lanes    splat(float value) { return value; }
+    inline Lanes    laneOffsets() { return 0.0f; }
+    inline Lanes    add(Lanes a, Lanes b) { return a + b; }
+    inline Lanes    sub(Lanes a, Lanes b) { return a - b; }
+    inline Lanes    mul(Lanes a, Lanes b) { return a * b; }
+    inline Lanes    minimum(Lanes a, Lanes b) { return (std::min)(a, b); }
+    inline Lanes    maximum(Lanes a, Lanes b) { return (std::max)(a, b); }
+    inline Lanes    absolute(Lanes a) { return std::fabs(a); }
+    inline Lanes    floorLanes(Lanes a) { return std::floor(a); }
+    inline Mask     greater(Lanes a, Lanes b) { return a > b; }
+    inline Mask     greaterEqual(Lanes a, Lanes b) { return a >= b; }
+    inline Mask     both(Mask a, Mask b) { return a && b; }
+    inline bool     any(Mask mask) { return mask; }
+    inline Lanes    select(Mask mask, Lanes a, Lanes b) { return mask ? a : b; }
+    inline Lanes    load(const float* source) { return *source; }
+    inline void     store(float* destination, Lanes value) { *destination = value; }
+    inline IntLanes splatInt(uint32_t value) { return value; }
+    inline IntLanes toInt(Lanes a) { return static_cast<uint32_t>(static_cast<int32_t>(a)); }
+    inline IntLanes addInt(IntLanes a, IntLanes b) { return a + b; }
+    inline IntLanes mulInt(IntLanes a, IntLanes b) { return a * b; }
+    inline IntLanes xorInt(IntLanes a, IntLanes b) { return a ^ b; }
+    inline IntLanes shiftRight(IntLanes a, int count) { return a >> count; }
+    inline Mask     bitSet(IntLanes a, uint32_t bit) { return (a & bit) != 0; }
+#endif
+}  // namespace Yare::Simd
+
+#endif  // YARE_SIMD_H
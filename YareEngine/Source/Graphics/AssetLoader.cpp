@@ -1 +1,389 @@
-#include "AssetLoader.h"
+#include "Graphics/AssetLoader.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+
+#include "Core/FileSystem.h"
+#include "Core/JobSystem.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        // FNV-1a over the files one after the other, 0 when one can't be read
+        uint64_t hashFiles(const std::vector<std::string>& paths) {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (const auto& path : paths) {
+                FileView file = FileSystem::instance()->open(path);
+                if (!file.isOpen()) {
+                    return 0;
+                }
+                for (unsigned char byte : file) {
+                    hash = (hash ^ byte) * 0x100000001B3ull;
+                }
+            }
+            return hash;
+        }
+
+        // What a decoded asset holds until it is uploaded, the decode owns the data before that
+        size_t getDecodedSize(const AssetEntry& entry) {
+            if (entry.state != AssetState::DECODED) {
+                return 0;
+            }
+            return entry.meshData.vertices.size() * sizeof(Vertex) + entry.meshData.indices.size() * sizeof(uint32_t) +
+                   entry.textureData.pixels.size() + (entry.stagedTexture ? entry.stagedTexture->buffer.getSize() : 0);
+        }
+
+        size_t getMeshCpuSize(const Mesh& mesh) {
+            return mesh.getLods().size() * sizeof(MeshLod) + mesh.getMeshlets().size() * sizeof(Meshlet);
+        }
+    }  // namespace
+
+    AssetLoader::AssetLoader(const AssetLoaderSettings& settings) : m_Settings(settings) {}
+
+    AssetLoader::~AssetLoader() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_AssetDecoded.wait(lock, [this]() { return m_DecodingCount == 0; });
+    }
+
+    AssetHandle<Mesh> AssetLoader::loadMesh(const std::string& path) {
+        return AssetHandle<Mesh>(request(AssetType::Model, {path}));
+    }
+
+    AssetHandle<Material> AssetLoader::loadTexture(const std::string& path) {
+        return AssetHandle<Material>(request(AssetType::Texture, {path}));
+    }
+
+    AssetHandle<Material> AssetLoader::loadTextureCube(const std::vector<std::string>& paths) {
+        return AssetHandle<Material>(request(AssetType::TextureCube, paths));
+    }
+
+    AssetHandle<Mesh> AssetLoader::addMesh(const std::string& path, std::shared_ptr<Mesh> mesh) {
+        return AssetHandle<Mesh>(add(AssetType::Model, path, std::move(mesh)));
+    }
+
+    AssetHandle<Material> AssetLoader::addMaterial(const std::string& path, std::shared_ptr<Material> material) {
+        return AssetHandle<Material>(add(AssetType::Texture, path, std::move(material)));
+    }
+
+    std::shared_ptr<Mesh> AssetLoader::findMesh(const std::string& path) {
+        return std::static_pointer_cast<Mesh>(find(AssetType::Model, path));
+    }
+
+    std::shared_ptr<Material> AssetLoader::findMaterial(const std::string& path) {
+        return std::static_pointer_cast<Material>(find(AssetType::Texture, path));
+    }
+
+    bool AssetLoader::update() {
+        m_UpdateCount++;
+        size_t pendingCount = m_Pending.size();
+        uploadDecoded(m_Settings.uploadsPerUpdate);
+        bool uploaded = m_Pending.size() != pendingCount;
+
+        // Assets in use count as used now, the ones nothing holds age from the last update something did
+        for (auto& entry : m_Entries) {
+            if (isReferenced(entry.second)) {
+                entry.second->lastUsed = m_UpdateCount;
+            }
+            measure(*entry.second);
+        }
+        releaseOverBudget();
+        updateStats();
+        return uploaded;
+    }
+
+    std::vector<AssetInfo> AssetLoader::getResidentAssets() const {
+        std::vector<AssetInfo> assets;
+        for (const auto& entry : m_Entries) {
+            if (entry.second->state != AssetState::RESIDENT) {
+                continue;
+            }
+            AssetInfo info;
+            info.path = entry.second->path;
+            info.type = entry.second->type;
+            info.cpuBytes = entry.second->cpuBytes;
+            info.gpuBytes = entry.second->gpuBytes;
+            info.references = (std::max)(entry.second.use_count() - 1,
+                                         entry.second->asset.use_count() - getEntryCount(entry.second->asset));
+            info.lastUsed = entry.second->lastUsed;
+            assets.push_back(info);
+        }
+        std::sort(assets.begin(), assets.end(), [](const AssetInfo& a, const AssetInfo& b) {
+            return a.cpuBytes + a.gpuBytes > b.cpuBytes + b.gpuBytes;
+        });
+        return assets;
+    }
+
+    std::shared_ptr<AssetEntry> AssetLoader::request(AssetType type, const std::vector<std::string>& paths) {
+        std::string key = getKey(type, paths);
+        auto        found = m_Entries.find(key);
+        if (found != m_Entries.end()) {
+            found->second->lastUsed = m_UpdateCount;
+            m_Stats.sharedCount++;
+            return found->second;
+        }
+
+        auto entry = std::make_shared<AssetEntry>();
+        entry->type = type;
+        entry->path = paths.empty() ? std::string() : paths[0];
+        entry->filePaths = paths;
+        entry->lastUsed = m_UpdateCount;
+        m_Entries[key] = entry;
+        m_Pending.push_back(entry);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_DecodingCount++;
+        }
+        JobSystem::instance()->schedule([this, entry]() { decode(entry); });
+        return entry;
+    }
+
+    std::shared_ptr<AssetEntry> AssetLoader::add(AssetType type, const std::string& path,
+                                                 std::shared_ptr<Component> asset) {
+        std::string key = getKey(type, {path});
+        auto        found = m_Entries.find(key);
+        if (found != m_Entries.end()) {
+            return found->second;
+        }
+
+        auto entry = std::make_shared<AssetEntry>();
+        entry->type = type;
+        entry->path = path;
+        entry->filePaths = {path};
+        entry->asset = std::move(asset);
+        entry->lastUsed = m_UpdateCount;
+        entry->state = AssetState::RESIDENT;
+        // Counted like a loaded asset, the budgets see everything that is shared
+        measure(*entry);
+        m_Entries[key] = entry;
+        updateStats();
+        return entry;
+    }
+
+    std::shared_ptr<Component> AssetLoader::find(AssetType type, const std::string& path) {
+        auto found = m_Entries.find(getKey(type, {path}));
+        if (found == m_Entries.end() || found->second->state != AssetState::RESIDENT) {
+            return nullptr;
+        }
+        found->second->lastUsed = m_UpdateCount;
+        return found->second->asset;
+    }
+
+    void AssetLoader::decode(const std::shared_ptr<AssetEntry>& entry) {
+        // The file is read once more to be hashed, the decode then finds it in the page cache
+        uint64_t contentHash = hashFiles(entry->filePaths);
+        bool     shared = false;
+        if (contentHash != 0) {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto                        found = m_ContentHashes.find(contentHash);
+            std::shared_ptr<AssetEntry> original = found != m_ContentHashes.end() ? found->second.lock() : nullptr;
+            if (original && original->type == entry->type) {
+                entry->original = original;
+                shared = true;
+            } else {
+                m_ContentHashes[contentHash] = entry;
+            }
+            entry->contentHash = contentHash;
+        }
+
+        if (!shared) {
+            try {
+                if (entry->type == AssetType::Model) {
+                    entry->meshData = Mesh::loadMeshData(entry->path);
+                } else if (entry->type == AssetType::TextureCube) {
+                    // The faces are decoded straight into the staging buffer
+                    auto staged = std::make_unique<StagedTexture>();
+                    Image::stageTextureLayers(entry->filePaths, true, *staged);
+                    entry->stagedTexture = std::move(staged);
+                } else if (!Image::loadTextureData(entry->path, entry->textureData)) {
+                    entry->textureData = {};
+                }
+            } catch (const std::exception& exception) {
+                YZ_ERROR("'" + entry->path + "' could not be loaded: " + exception.what());
+                entry->meshData = {};
+                entry->stagedTexture.reset();
+            }
+        }
+
+        // Notified under the lock, the destructor may run as soon as the count reaches zero
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        entry->state = AssetState::DECODED;
+        m_DecodingCount--;
+        m_DecodedCount++;
+        m_AssetDecoded.notify_all();
+    }
+
+    bool AssetLoader::upload(AssetEntry& entry) {
+        if (entry.original) {
+            AssetState originalState = entry.original->state;
+            if (originalState != AssetState::RESIDENT && originalState != AssetState::FAILED) {
+                return false;
+            }
+            // The original keeps the bytes, and stays referenced while this entry is resident
+            entry.asset = entry.original->asset;
+            entry.original.reset();
+            entry.shared = true;
+            entry.state = entry.asset ? AssetState::RESIDENT : AssetState::FAILED;
+            m_Stats.sharedCount++;
+            return true;
+        }
+
+        if (entry.type == AssetType::Model && !entry.meshData.vertices.empty()) {
+            entry.asset = std::make_shared<Mesh>(entry.path, std::move(entry.meshData));
+        } else if (entry.type == AssetType::Texture && !entry.textureData.pixels.empty()) {
+            auto material = std::make_shared<Material>(entry.path);
+            material->setTexture(Image::createTexture2D(entry.textureData));
+            entry.asset = material;
+        } else if (entry.type == AssetType::TextureCube && entry.stagedTexture) {
+            auto material = std::make_shared<Material>(entry.filePaths, MaterialTexType::TextureCube);
+            material->setTexture(Image::createTexture(*entry.stagedTexture));
+            entry.asset = material;
+        }
+        entry.meshData = {};
+        entry.textureData = {};
+        entry.stagedTexture.reset();
+        entry.state = entry.asset ? AssetState::RESIDENT : AssetState::FAILED;
+        measure(entry);
+        return true;
+    }
+
+    void AssetLoader::uploadDecoded(uint32_t maxCount) {
+        uint32_t uploadCount = 0;
+        for (auto it = m_Pending.begin(); it != m_Pending.end() && uploadCount < maxCount;) {
+            if ((*it)->state == AssetState::DECODED && upload(**it)) {
+                it = m_Pending.erase(it);
+                uploadCount++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void AssetLoader::waitFor(const std::shared_ptr<AssetEntry>& entry) {
+        auto isDone = [&entry]() {
+            return entry->state == AssetState::RESIDENT || entry->state == AssetState::FAILED;
+        };
+        while (!isDone()) {
+            uint64_t decodedCount;
+            size_t   decodingCount;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                decodedCount = m_DecodedCount;
+                decodingCount = m_DecodingCount;
+            }
+            // An entry sharing the asset of another needs that one uploaded first, which may be pending after it, so
+            // everything decoded goes and it is tried again as long as anything was uploaded
+            size_t pendingCount = m_Pending.size();
+            uploadDecoded(UINT32_MAX);
+            if (isDone() || m_Pending.size() != pendingCount || JobSystem::instance()->runPendingJob()) {
+                continue;
+            }
+            // Nothing was uploaded and nothing is left to decode, waiting would never end
+            if (decodingCount == 0) {
+                YZ_ERROR("'" + entry->path + "' can't be loaded, nothing it waits for is decoding.");
+                break;
+            }
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_AssetDecoded.wait(lock, [this, decodedCount]() { return m_DecodedCount != decodedCount; });
+        }
+        updateStats();
+    }
+
+    void AssetLoader::releaseOverBudget() {
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        for (const auto& entry : m_Entries) {
+            cpuBytes += entry.second->cpuBytes + getDecodedSize(*entry.second);
+            gpuBytes += entry.second->gpuBytes;
+        }
+
+        while (cpuBytes > m_Settings.cpuBudget || gpuBytes > m_Settings.gpuBudget) {
+            auto leastRecent = m_Entries.end();
+            for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+                AssetState state = it->second->state;
+                if ((state == AssetState::RESIDENT || state == AssetState::FAILED) && !isReferenced(it->second) &&
+                    (leastRecent == m_Entries.end() || it->second->lastUsed < leastRecent->second->lastUsed)) {
+                    leastRecent = it;
+                }
+            }
+            if (leastRecent == m_Entries.end()) {
+                break;
+            }
+
+            // The asset goes with the entry, the next request loads it again. When another entry shares it, that
+            // one keeps it and counts its bytes from now on.
+            std::shared_ptr<Component> asset = leastRecent->second->asset;
+            cpuBytes -= leastRecent->second->cpuBytes;
+            gpuBytes -= leastRecent->second->gpuBytes;
+            bool counted = leastRecent->second->cpuBytes + leastRecent->second->gpuBytes > 0;
+            m_Entries.erase(leastRecent);
+            m_Stats.releasedCount++;
+            for (auto& entry : m_Entries) {
+                if (asset && counted && entry.second->asset == asset) {
+                    entry.second->shared = false;
+                    measure(*entry.second);
+                    cpuBytes += entry.second->cpuBytes;
+                    gpuBytes += entry.second->gpuBytes;
+                    break;
+                }
+            }
+        }
+    }
+
+    void AssetLoader::updateStats() {
+        m_Stats.residentCount = 0;
+        m_Stats.loadingCount = static_cast<uint32_t>(m_Pending.size());
+        m_Stats.cpuBytes = 0;
+        m_Stats.gpuBytes = 0;
+        for (const auto& entry : m_Entries) {
+            m_Stats.residentCount += entry.second->state == AssetState::RESIDENT ? 1 : 0;
+            m_Stats.cpuBytes += entry.second->cpuBytes + getDecodedSize(*entry.second);
+            m_Stats.gpuBytes += entry.second->gpuBytes;
+        }
+    }
+
+    void AssetLoader::measure(AssetEntry& entry) {
+        entry.cpuBytes = 0;
+        entry.gpuBytes = 0;
+        if (entry.state != AssetState::RESIDENT || entry.shared) {
+            return;
+        }
+        if (entry.type == AssetType::Model) {
+            const Mesh& mesh = static_cast<const Mesh&>(*entry.asset);
+            entry.cpuBytes = getMeshCpuSize(mesh);
+            entry.gpuBytes = mesh.getMemorySize();
+        } else {
+            const Image* texture = static_cast<const Material&>(*entry.asset).getTextureImage();
+            entry.gpuBytes = texture ? texture->getMemorySize() : 0;
+        }
+    }
+
+    bool AssetLoader::isReferenced(const std::shared_ptr<AssetEntry>& entry) const {
+        return entry.use_count() > 1 || entry->asset.use_count() > getEntryCount(entry->asset);
+    }
+
+    long AssetLoader::getEntryCount(const std::shared_ptr<Component>& asset) const {
+        if (!asset) {
+            return 0;
+        }
+        long count = 0;
+        for (const auto& entry : m_Entries) {
+            count += entry.second->asset == asset ? 1 : 0;
+        }
+        return count;
+    }
+
+    std::string AssetLoader::getKey(AssetType type, const std::vector<std::string>& paths) {
+        // Different spellings of the same file end up as one key, paths that can't be resolved are kept as they are
+        std::string key = type == AssetType::Model ? "model:" : type == AssetType::Texture ? "texture:" : "cube:";
+        for (size_t i = 0; i < paths.size(); i++) {
+            std::error_code error;
+            std::string     canonicalPath =
+                paths[i].empty() ? paths[i] : std::filesystem::weakly_canonical(paths[i], error).string();
+            key += (i > 0 ? "|" : "") + (error ? paths[i] : canonicalPath);
+        }
+        return key;
+    }
+}  // namespace Yare::Graphics
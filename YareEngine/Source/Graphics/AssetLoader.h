@@ -1,23 +1,170 @@
-#ifndef YARE_ASSET_LOADER
-#define YARE_ASSET_LOADER
+#ifndef YARE_ASSET_LOADER_H
+#define YARE_ASSET_LOADER_H
 
-#include "Components/Component.h"
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
-
 #include <unordered_map>
+#include <vector>
+
+#include "Graphics/Components/Material.h"
+#include "Graphics/Components/Mesh.h"
+
+namespace Yare::Graphics {
+
+    enum class AssetType { Model, Texture, TextureCube };
+
+    enum class AssetState { DECODING, DECODED, RESIDENT, FAILED };
+
+    struct AssetLoaderSettings {
+        // Assets nothing references any more stay resident for the next request, the least recently used are
+        // released once either kind of memory goes over its budget. Referenced assets are never released.
+        size_t cpuBudget = size_t(64) << 20;
+        size_t gpuBudget = size_t(512) << 20;
+        // Decoded assets uploaded per update at most, which spreads the uploads over several frames
+        uint32_t uploadsPerUpdate = 4;
+    };
+
+    struct AssetLoaderStats {
+        uint32_t residentCount = 0;
+        uint32_t loadingCount = 0;
+        size_t   cpuBytes = 0;
+        size_t   gpuBytes = 0;
+        // Requests answered with an asset already loaded or loading, under the same path or with the same contents
+        uint32_t sharedCount = 0;
+        uint32_t releasedCount = 0;
+    };
+
+    // One resident asset of the listing
+    struct AssetInfo {
+        std::string path;
+        AssetType   type = AssetType::Model;
+        size_t      cpuBytes = 0;
+        size_t      gpuBytes = 0;
+        // Handles and owners of the asset other than the loader
+        long     references = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    // What the loader keeps of an asset, shared with its handles
+    struct AssetEntry {
+        AssetType               type = AssetType::Model;
+        std::string             path;
+        std::atomic<AssetState> state{AssetState::DECODING};
+        // Every file the asset is read from, the faces of a cube map. The path is the first one.
+        std::vector<std::string> filePaths;
+        // Written by the decode, read once it is done
+        uint64_t                       contentHash = 0;
+        MeshData                       meshData;
+        TextureData                    textureData;
+        std::unique_ptr<StagedTexture> stagedTexture;
+        // Set by the decode when a file with the same contents was requested first, this entry shares its asset
+        std::shared_ptr<AssetEntry> original;
+        // Once it does the original counts the bytes
+        bool shared = false;
+
+        // Only touched on the thread calling update
+        std::shared_ptr<Component> asset;
+        size_t                     cpuBytes = 0;
+        size_t                     gpuBytes = 0;
+        uint64_t                   lastUsed = 0;
+    };
+
+    // Returned by the load requests, the asset is there once an update uploaded it. As long as a handle or a pointer
+    // it returned is alive, the asset is referenced and stays resident.
+    template <typename T>
+    class AssetHandle {
+       public:
+        AssetHandle() = default;
+
+        bool isValid() const { return m_Entry != nullptr; }
+        // Also true when the asset failed to load, get returns null then
+        bool isReady() const {
+            return m_Entry && (m_Entry->state == AssetState::RESIDENT || m_Entry->state == AssetState::FAILED);
+        }
+        std::shared_ptr<T> get() const { return m_Entry ? std::static_pointer_cast<T>(m_Entry->asset) : nullptr; }
+        const std::string& getPath() const { return m_Entry->path; }
+
+       private:
+        friend class AssetLoader;
+        explicit AssetHandle(std::shared_ptr<AssetEntry> entry) : m_Entry(std::move(entry)) {}
+
+        std::shared_ptr<AssetEntry> m_Entry;
+    };
+
+    // Shares the meshes, textures and cube maps loaded from files between everything using them. Requests are looked
+    // up by canonical path, and files are decoded on the job system, where a file with the same contents as one
+    // already requested is caught by its hash and shares that asset. The uploads run in update between frames, which
+    // also releases unreferenced assets over the budgets. Everything but the decodes runs on the main thread.
+    class AssetLoader {
+       public:
+        AssetLoader(const AssetLoaderSettings& settings = {});
+        // Waits for the decodes that are still running
+        ~AssetLoader();
+
+        AssetHandle<Mesh> loadMesh(const std::string& path);
+        // The material gets the file as its texture
+        AssetHandle<Material> loadTexture(const std::string& path);
+        // The six faces in the order Image::createTextureCube takes them, or one cooked cube map
+        AssetHandle<Material> loadTextureCube(const std::vector<std::string>& paths);
+        // Adds an asset that was created elsewhere under the path, so requests for it share it. When the path is
+        // already there, that asset is kept and returned.
+        AssetHandle<Mesh>     addMesh(const std::string& path, std::shared_ptr<Mesh> mesh);
+        AssetHandle<Material> addMaterial(const std::string& path, std::shared_ptr<Material> material);
+        // Null unless the path is resident, nothing is queued
+        std::shared_ptr<Mesh>     findMesh(const std::string& path);
+        std::shared_ptr<Material> findMaterial(const std::string& path);
+
+        // Uploads the asset as soon as it is decoded, helping with the decodes until then, and returns it
+        template <typename T>
+        std::shared_ptr<T> wait(const AssetHandle<T>& handle) {
+            waitFor(handle.m_Entry);
+            return handle.get();
+        }
+
+        // Uploads decoded assets and releases the least recently used unreferenced ones while over a budget. Runs
+        // between frames and returns true when any asset became resident.
+        bool update();
+
+        // Largest first
+        std::vector<AssetInfo>  getResidentAssets() const;
+        const AssetLoaderStats& getStats() const { return m_Stats; }
 
-enum class AssetType {
-    Model,
-    Texture
-};
+       private:
+        std::shared_ptr<AssetEntry> request(AssetType type, const std::vector<std::string>& paths);
+        std::shared_ptr<AssetEntry> add(AssetType type, const std::string& path, std::shared_ptr<Component> asset);
+        std::shared_ptr<Component>  find(AssetType type, const std::string& path);
+        void                        decode(const std::shared_ptr<AssetEntry>& entry);
+        // Returns false when the entry shares the asset of one that isn't uploaded yet
+        bool upload(AssetEntry& entry);
+        void uploadDecoded(uint32_t maxCount);
+        void waitFor(const std::shared_ptr<AssetEntry>& entry);
+        void releaseOverBudget();
+        void updateStats();
+        // Streamed textures change size, so the resident assets are measured again every update
+        static void measure(AssetEntry& entry);
+        // Anything but the loader holds on to the entry or its asset. The entries sharing an asset each hold it, so
+        // those don't count.
+        bool isReferenced(const std::shared_ptr<AssetEntry>& entry) const;
+        long getEntryCount(const std::shared_ptr<Component>& asset) const;
+        static std::string getKey(AssetType type, const std::vector<std::string>& paths);
 
-class AssetLoader {
-public:
-    AssetLoader();
-    std::shared_ptr<Component> loadAsset(AssetType type, const std::string& name);
-    std::unordered_map<std::string, std::shared_ptr<Component>> assets;
-};
+        AssetLoaderSettings m_Settings;
+        AssetLoaderStats    m_Stats;
+        uint64_t            m_UpdateCount = 0;
+        // By type and canonical path, and the entries not yet resident in the order they were requested
+        std::unordered_map<std::string, std::shared_ptr<AssetEntry>> m_Entries;
+        std::vector<std::shared_ptr<AssetEntry>>                     m_Pending;
 
+        // Guards the content hashes and the decode counts, shared with the decodes
+        std::mutex                                              m_Mutex;
+        std::condition_variable                                 m_AssetDecoded;
+        std::unordered_map<uint64_t, std::weak_ptr<AssetEntry>> m_ContentHashes;
+        size_t                                                  m_DecodingCount = 0;
+        uint64_t                                                m_DecodedCount = 0;
+    };
+}  // namespace Yare::Graphics
 
-#endif // YARE_ASSET_LOADER
+#endif  // YARE_ASSET_LOADER_H
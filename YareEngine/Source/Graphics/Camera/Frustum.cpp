@@ -0,0 +1,44 @@
+#include "Graphics/Camera/Frustum.h"
+
+namespace Yare::Graphics {
+
+    Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+        // Gribb/Hartmann, glm is column major so the rows have to be gathered by hand
+        glm::mat4 m = glm::transpose(viewProjection);
+
+        Frustum frustum;
+        frustum.planes[PLANE_LEFT] = m[3] + m[0];
+        frustum.planes[PLANE_RIGHT] = m[3] - m[0];
+        frustum.planes[PLANE_BOTTOM] = m[3] + m[1];
+        frustum.planes[PLANE_TOP] = m[3] - m[1];
+        // The -1 to 1 depth near plane, which is behind the 0 to 1 one, so it stays conservative with either range
+        frustum.planes[PLANE_NEAR] = m[3] + m[2];
+        frustum.planes[PLANE_FAR] = m[3] - m[2];
+
+        for (auto& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+        for (const auto& plane : planes) {
+            // The corner furthest along the plane's normal
+            glm::vec3 corner = glm::vec3(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y,
+                                         plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace Yare::Graphics
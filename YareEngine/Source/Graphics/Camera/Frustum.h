@@ -0,0 +1,24 @@
+#ifndef YARE_FRUSTUM_H
+#define YARE_FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+namespace Yare::Graphics {
+
+    // Six planes pointing into the view volume, xyz is the normal and w the distance, so a point p is inside a plane
+    // when dot(plane.xyz, p) + plane.w >= 0. Laid out so it can be copied straight into a push constant block.
+    struct Frustum {
+        enum Plane { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+        glm::vec4 planes[PLANE_COUNT];
+
+        // Extracts the planes from a projection * view matrix
+        static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+        bool intersectsSphere(const glm::vec3& center, float radius) const;
+        // Only rejects boxes entirely behind one plane, so boxes near a corner of the frustum may pass
+        bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_FRUSTUM_H
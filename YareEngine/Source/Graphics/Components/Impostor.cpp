@@ -0,0 +1,187 @@
+#include "Graphics/Components/Impostor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "Graphics/Vulkan/DescriptorSet.h"
+#include "Graphics/Vulkan/Devices.h"
+#include "Graphics/Vulkan/Framebuffer.h"
+#include "Graphics/Vulkan/Pipeline.h"
+#include "Graphics/Vulkan/Utilities.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        // Same basis the impostor shader builds around the view direction, x right and y up on the atlas
+        void frameBasis(const glm::vec3& direction, glm::vec3& right, glm::vec3& up) {
+            glm::vec3 hint = std::abs(direction.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            right = glm::normalize(glm::cross(hint, direction));
+            up = glm::cross(direction, right);
+        }
+
+        // Orthographic view of the sphere from direction, depth goes from 0 on the near side to 1 on the far side.
+        // There is no y flip, so atlas rows go the same way as the up vector.
+        glm::mat4 frameViewProjection(const glm::vec4& sphere, const glm::vec3& direction) {
+            glm::vec3 right, up;
+            frameBasis(direction, right, up);
+            glm::vec3 center = glm::vec3(sphere);
+            float     radius = sphere.w;
+
+            float     depthScale = 0.5f / radius;
+            glm::mat4 rows = {glm::vec4(right / radius, -glm::dot(center, right) / radius),
+                              glm::vec4(up / radius, -glm::dot(center, up) / radius),
+                              glm::vec4(-direction * depthScale, 0.5f + glm::dot(center, direction) * depthScale),
+                              glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)};
+            return glm::transpose(rows);
+        }
+    }  // namespace
+
+    Impostor::Impostor(const Mesh& mesh, const Material& material, const ImpostorSettings& settings)
+        : m_Settings(settings), m_BoundingSphere(mesh.getBoundingSphere()) {
+        m_Settings.framesPerSide = (std::max)(m_Settings.framesPerSide, 2u);
+        if (m_BoundingSphere.w <= 0.0f) {
+            YZ_WARN("Impostors need a mesh with a bounding sphere, the atlas stays empty.");
+            m_BoundingSphere.w = 1.0f;
+        }
+        m_TexelSize = 2.0f * m_BoundingSphere.w / static_cast<float>(m_Settings.frameSize);
+
+        uint32_t atlasSize = m_Settings.framesPerSide * m_Settings.frameSize;
+        m_AlbedoAtlas = Image::createRenderTarget(atlasSize, atlasSize, VK_FORMAT_R8G8B8A8_SRGB);
+        m_NormalDepthAtlas = Image::createRenderTarget(atlasSize, atlasSize, VK_FORMAT_R8G8B8A8_UNORM);
+        std::unique_ptr<Image> depthBuffer(
+            Image::createDepthStencilBuffer(atlasSize, atlasSize, VkUtil::findDepthFormat()));
+
+        bake(mesh, &material, m_AlbedoAtlas, VK_FORMAT_R8G8B8A8_SRGB, "impostor_bake_albedo.shader",
+             depthBuffer.get());
+        bake(mesh, nullptr, m_NormalDepthAtlas, VK_FORMAT_R8G8B8A8_UNORM, "impostor_bake_normal.shader",
+             depthBuffer.get());
+    }
+
+    Impostor::~Impostor() {
+        delete m_AlbedoAtlas;
+        delete m_NormalDepthAtlas;
+    }
+
+    glm::vec3 Impostor::octahedralDirection(const glm::vec2& uv) {
+        glm::vec2 p = uv * 2.0f - 1.0f;
+        glm::vec3 direction = glm::vec3(p.x, 1.0f - std::abs(p.x) - std::abs(p.y), p.y);
+        // The lower half of the sphere is folded over the corners of the square
+        if (direction.y < 0.0f) {
+            float x = direction.x;
+            direction.x = (1.0f - std::abs(direction.z)) * (x >= 0.0f ? 1.0f : -1.0f);
+            direction.z = (1.0f - std::abs(x)) * (direction.z >= 0.0f ? 1.0f : -1.0f);
+        }
+        return glm::normalize(direction);
+    }
+
+    void Impostor::bake(const Mesh& mesh, const Material* material, Image* target, VkFormat format,
+                        const std::string& shaderFile, const Image* depthBuffer) {
+        uint32_t atlasSize = m_Settings.framesPerSide * m_Settings.frameSize;
+
+        RenderPassInfo passInfo = {};
+        passInfo.imageFormat = format;
+        passInfo.extent = {atlasSize, atlasSize};
+        passInfo.presentColor = false;
+        passInfo.clearColor = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        RenderPass renderPass(passInfo);
+
+        FramebufferInfo framebufferInfo = {};
+        framebufferInfo.type = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.width = atlasSize;
+        framebufferInfo.height = atlasSize;
+        framebufferInfo.attachments = {target->getImageView(), depthBuffer->getImageView()};
+        framebufferInfo.renderPass = &renderPass;
+        Framebuffer framebuffer(framebufferInfo);
+
+        Shader shader("../Res/Shaders/Impostor", shaderFile);
+
+        // Without the y flip the winding is mirrored, so culling front faces keeps what the forward pass keeps
+        PipelineInfo pInfo = {};
+        pInfo.shader = &shader;
+        pInfo.renderpass = &renderPass;
+        pInfo.cullMode = VK_CULL_MODE_FRONT_BIT;
+        pInfo.depthTestEnable = VK_TRUE;
+        pInfo.depthWriteEnable = VK_TRUE;
+        pInfo.width = m_Settings.frameSize;
+        pInfo.height = m_Settings.frameSize;
+        pInfo.dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        pInfo.bindingDescriptions = mesh.getVertexLayout().getBindingDescriptions();
+        pInfo.vertexInputAttributes = mesh.getVertexLayout().getAttributeDescriptions();
+        pInfo.pushConstants = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4)};
+        if (material) {
+            pInfo.setLayoutBindings = {{{0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                                         VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}}};
+        }
+        Pipeline pipeline;
+        pipeline.init(pInfo);
+
+        DescriptorSet materialSet;
+        if (material) {
+            // The bake is waited on below, so a transient set lives long enough
+            materialSet.init({&pipeline, 1, 0, true});
+            BufferInfo textureInfo = {};
+            textureInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            textureInfo.binding = 0;
+            textureInfo.descriptorCount = 1;
+            textureInfo.imageViews = {material->getTextureImage()->getImageView()};
+            textureInfo.imageSamplers = {material->getTextureImage()->getSampler()};
+            std::vector<BufferInfo> materialInfos = {textureInfo};
+            materialSet.update(materialInfos);
+        }
+
+        CommandBuffer commandBuffer;
+        commandBuffer.beginRecording();
+        renderPass.beginRenderPass(&commandBuffer, &framebuffer);
+        pipeline.setActive(commandBuffer);
+        if (material) {
+            vkCmdBindDescriptorSets(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                    pipeline.getPipelineLayout(), 0, 1u, &materialSet.getDescriptorSet(0), 0,
+                                    nullptr);
+        }
+        mesh.bindVertexStreams(&commandBuffer);
+        mesh.getIndexBuffer()->bindIndex(&commandBuffer, mesh.getIndexType());
+
+        // Every view gets its own cell of the atlas, the full detail mesh is drawn into each of them
+        float           frameSize = static_cast<float>(m_Settings.frameSize);
+        const glm::vec4 positionTransform = mesh.getPositionTransform();
+        glm::mat4       dequantize = glm::mat4(positionTransform.w);
+        dequantize[3] = glm::vec4(glm::vec3(positionTransform), 1.0f);
+        for (uint32_t y = 0; y < m_Settings.framesPerSide; y++) {
+            for (uint32_t x = 0; x < m_Settings.framesPerSide; x++) {
+                VkViewport viewport = {x * frameSize, y * frameSize, frameSize, frameSize, 0.0f, 1.0f};
+                VkRect2D   scissor = {{static_cast<int32_t>(x * m_Settings.frameSize),
+                                     static_cast<int32_t>(y * m_Settings.frameSize)},
+                                    {m_Settings.frameSize, m_Settings.frameSize}};
+                vkCmdSetViewport(commandBuffer.getCommandBuffer(), 0, 1, &viewport);
+                vkCmdSetScissor(commandBuffer.getCommandBuffer(), 0, 1, &scissor);
+
+                glm::vec2 uv = (glm::vec2(x, y) + 0.5f) / static_cast<float>(m_Settings.framesPerSide);
+                glm::mat4 viewProjection =
+                    frameViewProjection(m_BoundingSphere, octahedralDirection(uv)) * dequantize;
+                vkCmdPushConstants(commandBuffer.getCommandBuffer(), pipeline.getPipelineLayout(),
+                                   VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &viewProjection);
+                vkCmdDrawIndexed(commandBuffer.getCommandBuffer(), mesh.getIndexCount(), 1, 0, 0, 0);
+            }
+        }
+        renderPass.endRenderPass(&commandBuffer);
+
+        commandBuffer.imageBarrier(target->getImage(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        commandBuffer.endRecording();
+
+        // Baking happens while loading, so waiting for it is fine
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer.getCommandBuffer();
+        if (vkQueueSubmit(Devices::instance()->getGraphicsQueue(), 1, &submitInfo, commandBuffer.getFence()) !=
+            VK_SUCCESS) {
+            YZ_CRITICAL("Failed to submit the impostor bake.");
+        }
+        vkWaitForFences(Devices::instance()->getDevice(), 1, &commandBuffer.getFence(), VK_TRUE, UINT64_MAX);
+    }
+}  // namespace Yare::Graphics
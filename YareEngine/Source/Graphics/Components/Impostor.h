@@ -0,0 +1,53 @@
+#ifndef YARE_IMPOSTOR_H
+#define YARE_IMPOSTOR_H
+
+#include <glm/glm.hpp>
+
+#include "Graphics/Components/Material.h"
+#include "Graphics/Components/Mesh.h"
+#include "Graphics/Vulkan/Image.h"
+
+namespace Yare::Graphics {
+
+    struct ImpostorSettings {
+        // Views along each side of the atlas, at least 2
+        uint32_t framesPerSide = 8;
+        // Pixels along each side of a view
+        uint32_t frameSize = 128;
+    };
+
+    // A mesh rendered from framesPerSide^2 directions spread over the whole sphere with an octahedral mapping, every
+    // view looking at the mesh's bounding sphere. Far away instances are drawn as a camera facing quad that blends
+    // the four views nearest to the camera's direction, so they cost pixels instead of triangles. The views are baked
+    // on the gpu when the impostor is created, the material's textures have to be loaded by then.
+    class Impostor {
+       public:
+        Impostor(const Mesh& mesh, const Material& material, const ImpostorSettings& settings = {});
+        ~Impostor();
+
+        // Color in rgb and coverage in a
+        const Image* getAlbedoAtlas() const { return m_AlbedoAtlas; }
+        // Object space normal in rgb, depth through the bounding sphere in a, 0 on the side facing the view
+        const Image* getNormalDepthAtlas() const { return m_NormalDepthAtlas; }
+        uint32_t     getFramesPerSide() const { return m_Settings.framesPerSide; }
+        // Object space size of an atlas texel, the same measure as a level of detail's error
+        float getTexelSize() const { return m_TexelSize; }
+
+        // Direction from the center of the view at uv on the octahedral atlas, y is up
+        static glm::vec3 octahedralDirection(const glm::vec2& uv);
+
+       private:
+        // Renders every view into target, the material is only needed for the albedo atlas
+        void bake(const Mesh& mesh, const Material* material, Image* target, VkFormat format,
+                  const std::string& shaderFile, const Image* depthBuffer);
+
+        ImpostorSettings m_Settings;
+        glm::vec4        m_BoundingSphere;
+        float            m_TexelSize = 0.0f;
+
+        Image* m_AlbedoAtlas = nullptr;
+        Image* m_NormalDepthAtlas = nullptr;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_IMPOSTOR_H
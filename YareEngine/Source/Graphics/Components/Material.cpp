@@ -14,21 +14,18 @@ namespace Yare::Graphics {
         }
     }
 
+    void Material::setTexture(Image* texture) {
+        if (m_Texture != texture) {
+            delete m_Texture;
+        }
+        m_Texture = texture;
+    }
+
     void Material::loadTextures() {
         switch (m_Type) {
             case MaterialTexType::TextureCube: {
-                std::vector<std::string> texturePaths{6};
-                int                      index = 0;
-                for (int i = 0; i < 6; i++) {
-                    if (index < m_FilePaths.size()) {
-                        texturePaths[i] = m_FilePaths[index];
-                        index++;
-                    } else {
-                        texturePaths[i] = "../Res/Textures/default.jpg";
-                    }
-                }
-
-                m_Texture = Image::createTextureCube(texturePaths);
+                // Six faces of the same size or one cooked cube, padding with other images can't work
+                m_Texture = Image::createTextureCube(m_FilePaths);
                 break;
             }
             case MaterialTexType::Texture2D: {
@@ -19,13 +19,18 @@ namespace Yare::Graphics {
         virtual ~Material();
 
         void loadTextures();
+        // Takes ownership of a texture that was already created, in place of loadTextures. The previous texture is
+        // deleted, so nothing in flight may still use it.
+        void setTexture(Image* texture);
+        const std::vector<std::string>& getFilePaths() const { return m_FilePaths; }
+        MaterialTexType                 getType() const { return m_Type; }
         void setImageIdx(int idx) { m_ImageIdx = idx; }
 
         const Image* getTextureImage() const { return m_Texture; }
         int          getImageIdx() const { return m_ImageIdx; }
 
        private:
-        Image*                   m_Texture;
+        Image*                   m_Texture = nullptr;
         MaterialTexType          m_Type;
         int                      m_ImageIdx = 0;
         std::vector<std::string> m_FilePaths;
@@ -1,13 +1,23 @@
 #include "Mesh.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "Graphics/MeshOptimizer.h"
 #include "Utilities/IOHelper.h"
+#include "Utilities/Logger.h"
 
 namespace Yare::Graphics {
 
-    Mesh::Mesh(const std::string& meshFilePath) { loadMeshFromFile(meshFilePath); }
+    Mesh::Mesh(const std::string& meshFilePath, const VertexLayout& layout) : m_VertexLayout(layout) {
+        loadMeshFromFile(meshFilePath);
+    }
 
-    Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
-        createBuffers(vertices, indices);
+    Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const VertexLayout& layout)
+        : m_VertexLayout(layout) {
+        std::vector<uint32_t> clusteredIndices = indices;
+        m_Meshlets = buildMeshlets(vertices, clusteredIndices, clusteredIndices.size());
+        createBuffers(vertices, clusteredIndices);
     }
 
     Mesh::~Mesh() {
@@ -15,6 +25,12 @@ namespace Yare::Graphics {
         delete m_IndexBuffer;
     }
 
+    Mesh::Mesh(const std::string& meshFilePath, MeshData&& data, const VertexLayout& layout)
+        : m_VertexLayout(layout) {
+        m_FilePath = meshFilePath;
+        setMeshData(std::move(data));
+    }
+
     void Mesh::loadMeshFromFile(const std::string& meshFilePath) {
         if (m_VertexBuffer || m_IndexBuffer) {
             throw std::runtime_error("Mesh already has buffers allocated.");
@@ -23,23 +39,130 @@ namespace Yare::Graphics {
         m_FilePath = meshFilePath;
 
         if (!meshFilePath.empty()) {
-            std::vector<Vertex>   vertices;
-            std::vector<uint32_t> indices;
+            setMeshData(loadMeshData(meshFilePath));
+        }
+    }
+
+    MeshData Mesh::loadMeshData(const std::string& meshFilePath) {
+        MeshData data;
+        Utilities::loadMesh(meshFilePath, data.vertices, data.indices);
+        VertexCacheStatistics loaded = analyzeVertexCache(data.indices, 0, data.indices.size(), data.vertices.size());
 
-            Utilities::loadMesh(meshFilePath, vertices, indices);
-            createBuffers(vertices, indices);
+        data.lods = generateLods(data.vertices, data.indices);
+        data.meshlets = buildMeshlets(data.vertices, data.indices, data.lods[0].indexCount);
+        optimizeMesh(data.vertices, data.indices, data.lods, &data.meshlets);
+
+        VertexCacheStatistics optimized =
+            analyzeVertexCache(data.indices, 0, data.lods[0].indexCount, data.vertices.size());
+        YZ_INFO("'" + meshFilePath + "' ACMR " + std::to_string(loaded.acmr) + " -> " +
+                std::to_string(optimized.acmr) + ", ATVR " + std::to_string(loaded.atvr) + " -> " +
+                std::to_string(optimized.atvr));
+        return data;
+    }
+
+    void Mesh::setMeshData(MeshData&& data) {
+        m_Lods = std::move(data.lods);
+        m_Meshlets = std::move(data.meshlets);
+        createBuffers(data.vertices, data.indices);
+    }
+
+    size_t Mesh::getMemorySize() const {
+        return (m_VertexBuffer ? m_VertexBuffer->getSize() : 0) + (m_IndexBuffer ? m_IndexBuffer->getSize() : 0);
+    }
+
+    VkDeviceSize Mesh::getAttributeStreamOffset() const {
+        return m_VertexLayout.separatePositions ? VkDeviceSize(m_VertexCount) * m_VertexLayout.getPositionStride() : 0;
+    }
+
+    void Mesh::bindVertexStreams(CommandBuffer* commandBuffer, bool positionsOnly) const {
+        m_VertexBuffer->bindVertex(commandBuffer, 0, 0);
+        if (m_VertexLayout.separatePositions && !positionsOnly) {
+            m_VertexBuffer->bindVertex(commandBuffer, getAttributeStreamOffset(), 1);
+        }
+    }
+
+    void Mesh::createOccluderFromMesh() {
+        if (m_VertexCount == 0 || m_IndexCount == 0) {
+            return;
+        }
+
+        OccluderGeometry occluder;
+        readBackGeometry(occluder.positions, occluder.indices);
+        setOccluder(occluder);
+    }
+
+    void Mesh::createOccluderProxy(const OccluderProxySettings& settings) {
+        if (m_VertexCount == 0 || m_IndexCount == 0) {
+            return;
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t>  indices;
+        readBackGeometry(positions, indices);
+        if (m_FilePath.empty()) {
+            setOccluder(Graphics::createOccluderProxy(positions, indices, settings));
+        } else {
+            setOccluder(loadOccluderProxy(m_FilePath, positions, indices, settings));
+        }
+    }
+
+    void Mesh::readBackGeometry(std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) const {
+        if (m_VertexBuffer->mapMemory()) {
+            positions = m_VertexLayout.unpackPositions(m_VertexBuffer->getMappedData(), m_VertexCount,
+                                                       m_BoundingSphere);
+            m_VertexBuffer->unmapMemory();
+        }
+        indices.resize(m_IndexCount);
+        if (m_IndexBuffer->mapMemory()) {
+            if (m_IndexType == VK_INDEX_TYPE_UINT16) {
+                const auto* source = static_cast<const uint16_t*>(m_IndexBuffer->getMappedData());
+                std::copy(source, source + m_IndexCount, indices.begin());
+            } else {
+                memcpy(indices.data(), m_IndexBuffer->getMappedData(), m_IndexCount * sizeof(uint32_t));
+            }
+            m_IndexBuffer->unmapMemory();
         }
     }
 
     void Mesh::createBuffers(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
-        // Vertex Buffers
-        VkDeviceSize bufferSize = sizeof(Vertex) * vertices.size();
+        m_VertexCount = static_cast<uint32_t>(vertices.size());
+        m_TotalIndexCount = static_cast<uint32_t>(indices.size());
+        if (m_Lods.empty()) {
+            m_Lods = {{0, m_TotalIndexCount, 0.0f}};
+        }
+        m_IndexCount = m_Lods[0].indexCount;
 
-        m_VertexBuffer = new Buffer(BufferUsage::VERTEX, (size_t)bufferSize, vertices.data());
+        // Sphere around the center of the bounding box, loose but cheap to test against on the gpu
+        if (!vertices.empty()) {
+            glm::vec3 min = vertices[0].pos;
+            glm::vec3 max = vertices[0].pos;
+            for (const auto& vertex : vertices) {
+                min = glm::min(min, vertex.pos);
+                max = glm::max(max, vertex.pos);
+            }
 
-        // Index Buffers
-        bufferSize = sizeof(indices[0]) * indices.size();
+            glm::vec3 center = (min + max) * 0.5f;
+            float     radius = 0.0f;
+            for (const auto& vertex : vertices) {
+                radius = glm::max(radius, glm::length(vertex.pos - center));
+            }
+            m_BoundingSphere = glm::vec4(center, radius);
+        }
 
-        m_IndexBuffer = new Buffer(BufferUsage::INDEX, (size_t)bufferSize, indices.data());
+        // Vertex Buffers
+        m_PositionTransform = m_VertexLayout.getPositionTransform(m_BoundingSphere);
+        std::vector<uint8_t> packedVertices = m_VertexLayout.pack(vertices, m_BoundingSphere);
+
+        m_VertexBuffer = new Buffer(BufferUsage::VERTEX, packedVertices.size(), packedVertices.data());
+
+        // Index Buffers, half the size for meshes small enough
+        if (m_VertexCount < 0x10000) {
+            m_IndexType = VK_INDEX_TYPE_UINT16;
+            std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            m_IndexBuffer = new Buffer(BufferUsage::INDEX, sizeof(uint16_t) * shortIndices.size(), shortIndices.data());
+        } else {
+            m_IndexType = VK_INDEX_TYPE_UINT32;
+            m_IndexBuffer = new Buffer(BufferUsage::INDEX, sizeof(uint32_t) * indices.size(), indices.data());
+        }
     }
 }  // namespace Yare::Graphics
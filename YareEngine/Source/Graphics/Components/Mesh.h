@@ -1,31 +1,98 @@
 #ifndef YARE_MESH_H
 #define YARE_MESH_H
 
+#include <memory>
 #include <vector>
 
 #include "Component.h"
+#include "Graphics/Culling/OccluderProxy.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/MeshletBuilder.h"
+#include "Graphics/VertexLayout.h"
 #include "Core/DataStructures.h"
 #include "Graphics/Vulkan/Buffer.h"
 
 namespace Yare::Graphics {
+    // What loading a mesh file works out on the cpu, nothing in it touches the gpu so it can be loaded on any thread
+    struct MeshData {
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        std::vector<MeshLod>  lods;
+        std::vector<Meshlet>  meshlets;
+    };
+
     class Mesh : public Component {
        public:
         Mesh() {}
-        Mesh(const std::string& meshFilePath);
-        Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+        Mesh(const std::string& meshFilePath, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+        Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+             const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+        // Creates the buffers for data that was loaded with loadMeshData, on the main thread
+        Mesh(const std::string& meshFilePath, MeshData&& data, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
         virtual ~Mesh();
 
         void loadMeshFromFile(const std::string& meshFilePath);
+        static MeshData loadMeshData(const std::string& meshFilePath);
 
         Buffer* getIndexBuffer() const { return m_IndexBuffer; }
         Buffer* getVertexBuffer() const { return m_VertexBuffer; }
 
+        // Indices of the full detail mesh, the index buffer holds every level of detail after it
+        uint32_t getIndexCount() const { return m_IndexCount; }
+        uint32_t getTotalIndexCount() const { return m_TotalIndexCount; }
+        uint32_t getVertexCount() const { return m_VertexCount; }
+        // Bytes of the vertex and index buffers together
+        size_t getMemorySize() const;
+        // Meshes with fewer than 65536 vertices get 16 bit indices
+        VkIndexType getIndexType() const { return m_IndexType; }
+        uint32_t    getIndexSize() const { return m_IndexType == VK_INDEX_TYPE_UINT16 ? 2 : 4; }
+        const VertexLayout& getVertexLayout() const { return m_VertexLayout; }
+        // Where the stream of everything but the position starts in the vertex buffer
+        VkDeviceSize getAttributeStreamOffset() const;
+        // Binds the vertex buffer for every stream of the layout, or only the position stream
+        void bindVertexStreams(CommandBuffer* commandBuffer, bool positionsOnly = false) const;
+        // Turns the stored positions back into object space ones, see VertexLayout::getPositionTransform
+        const glm::vec4& getPositionTransform() const { return m_PositionTransform; }
+        // Ranges of the index buffer from full detail to coarsest, meshes loaded from a file get their levels
+        // generated, the others only have the full mesh
+        const std::vector<MeshLod>& getLods() const { return m_Lods; }
+        // Object space bounding sphere, center in xyz and radius in w
+        const glm::vec4& getBoundingSphere() const { return m_BoundingSphere; }
+        // Clusters of the full detail level, each a range of its indices
+        const std::vector<Meshlet>& getMeshlets() const { return m_Meshlets; }
+
+        // Uses the mesh itself as its occluder, cheap enough for boxes and walls but not for detailed meshes
+        void createOccluderFromMesh();
+        // Uses a few boxes inside the voxelized mesh, cached next to the file the mesh was loaded from
+        void createOccluderProxy(const OccluderProxySettings& settings = {});
+        void setOccluder(const OccluderGeometry& occluder) {
+            m_Occluder = std::make_shared<OccluderGeometry>(occluder);
+        }
+        // Null until one of the above is called
+        const OccluderGeometry* getOccluder() const { return m_Occluder.get(); }
+
        protected:
+        void setMeshData(MeshData&& data);
         void createBuffers(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+        // Both buffers are host visible, so the geometry is read straight back instead of being kept around
+        void readBackGeometry(std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) const;
 
         Buffer*     m_VertexBuffer = nullptr;
         Buffer*     m_IndexBuffer = nullptr;
         std::string m_FilePath;
+
+        uint32_t  m_IndexCount = 0;
+        uint32_t  m_TotalIndexCount = 0;
+        uint32_t  m_VertexCount = 0;
+        glm::vec4 m_BoundingSphere = glm::vec4(0.0f);
+        glm::vec4 m_PositionTransform = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        VertexLayout m_VertexLayout = COMPACT_VERTEX_LAYOUT;
+        VkIndexType  m_IndexType = VK_INDEX_TYPE_UINT32;
+
+        std::vector<MeshLod>              m_Lods;
+        std::vector<Meshlet>              m_Meshlets;
+        std::shared_ptr<OccluderGeometry> m_Occluder;
     };
 }  // namespace Yare::Graphics
 
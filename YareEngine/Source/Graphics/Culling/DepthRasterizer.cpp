@@ -0,0 +1,258 @@
+#include "Graphics/Culling/DepthRasterizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "Core/JobSystem.h"
+#include "Core/Simd.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        using namespace Simd;
+
+        // A row of LANES pixels per step, signed like the pixel coordinates
+        constexpr int32_t LANES = static_cast<int32_t>(LANE_COUNT);
+        constexpr int32_t TILE = static_cast<int32_t>(DepthRasterizer::TILE_SIZE);
+        static_assert(TILE % LANES == 0, "Rows of lanes must not cross a tile edge");
+
+        // Same rules as the gpu, 0 <= z <= w is inside, so anything that passes the near plane also has a positive w
+        bool outsideOnePlane(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+            return (a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+                   (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+                   (a.z < 0.0f && b.z < 0.0f && c.z < 0.0f) || (a.z > a.w && b.z > b.w && c.z > c.w);
+        }
+    }  // namespace
+
+    DepthRasterizer::DepthRasterizer(uint32_t width, uint32_t height) {
+        m_TilesX = (std::max)((width + TILE_SIZE - 1) / TILE_SIZE, 1u);
+        m_TilesY = (std::max)((height + TILE_SIZE - 1) / TILE_SIZE, 1u);
+        m_Width = m_TilesX * TILE_SIZE;
+        m_Height = m_TilesY * TILE_SIZE;
+
+        m_Depth.resize(m_Width * m_Height);
+        m_TileMaxDepth.resize(m_TilesX * m_TilesY);
+        m_TileBins.resize(m_TilesX * m_TilesY);
+        clear();
+    }
+
+    void DepthRasterizer::clear() {
+        std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+        std::fill(m_TileMaxDepth.begin(), m_TileMaxDepth.end(), 1.0f);
+        for (auto& bin : m_TileBins) {
+            bin.clear();
+        }
+        m_Triangles.clear();
+    }
+
+    void DepthRasterizer::addOccluder(const OccluderGeometry& occluder, const glm::mat4& modelViewProjection) {
+        std::vector<glm::vec4> clipPositions;
+        clipPositions.reserve(occluder.positions.size());
+        for (const auto& position : occluder.positions) {
+            clipPositions.push_back(modelViewProjection * glm::vec4(position, 1.0f));
+        }
+
+        for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3) {
+            const glm::vec4 triangle[3] = {clipPositions[occluder.indices[i]], clipPositions[occluder.indices[i + 1]],
+                                           clipPositions[occluder.indices[i + 2]]};
+            if (outsideOnePlane(triangle[0], triangle[1], triangle[2])) {
+                continue;
+            }
+
+            // Clip against the near plane, a triangle gains at most one vertex doing so
+            glm::vec4 polygon[4];
+            int       vertexCount = 0;
+            for (int k = 0; k < 3; k++) {
+                const glm::vec4& a = triangle[k];
+                const glm::vec4& b = triangle[(k + 1) % 3];
+                if (a.z >= 0.0f) {
+                    polygon[vertexCount++] = a;
+                }
+                if ((a.z >= 0.0f) != (b.z >= 0.0f)) {
+                    polygon[vertexCount++] = a + (b - a) * (a.z / (a.z - b.z));
+                }
+            }
+
+            for (int k = 2; k < vertexCount; k++) {
+                addTriangle(polygon[0], polygon[k - 1], polygon[k]);
+            }
+        }
+    }
+
+    void DepthRasterizer::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+        glm::vec3 screen[3];
+        const glm::vec4* clip[3] = {&a, &b, &c};
+        for (int k = 0; k < 3; k++) {
+            float w = (std::max)(clip[k]->w, FLT_EPSILON);
+            screen[k] = glm::vec3((clip[k]->x / w * 0.5f + 0.5f) * m_Width, (clip[k]->y / w * 0.5f + 0.5f) * m_Height,
+                                  clip[k]->z / w);
+        }
+
+        float minX = (std::min)({screen[0].x, screen[1].x, screen[2].x});
+        float maxX = (std::max)({screen[0].x, screen[1].x, screen[2].x});
+        float minY = (std::min)({screen[0].y, screen[1].y, screen[2].y});
+        float maxY = (std::max)({screen[0].y, screen[1].y, screen[2].y});
+        if (maxX < 0.0f || maxY < 0.0f || minX > m_Width || minY > m_Height) {
+            return;
+        }
+
+        // Occluders are closed meshes seen from any side, so both windings are drawn and flipped to the same one
+        float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                     (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+        if (std::abs(area) < 1e-6f) {
+            return;
+        }
+        if (area < 0.0f) {
+            std::swap(screen[1], screen[2]);
+            area = -area;
+        }
+
+        ScreenTriangle triangle;
+        for (int k = 0; k < 3; k++) {
+            const glm::vec3& from = screen[k];
+            const glm::vec3& to = screen[(k + 1) % 3];
+            triangle.edgeA[k] = from.y - to.y;
+            triangle.edgeB[k] = to.x - from.x;
+            triangle.edgeC[k] = from.x * to.y - from.y * to.x;
+        }
+
+        // Edge k is opposite of vertex (k + 2) % 3, its value over the area is that vertex's barycentric weight
+        triangle.depthA = (triangle.edgeA[1] * screen[0].z + triangle.edgeA[2] * screen[1].z +
+                           triangle.edgeA[0] * screen[2].z) / area;
+        triangle.depthB = (triangle.edgeB[1] * screen[0].z + triangle.edgeB[2] * screen[1].z +
+                           triangle.edgeB[0] * screen[2].z) / area;
+        triangle.depthC = (triangle.edgeC[1] * screen[0].z + triangle.edgeC[2] * screen[1].z +
+                           triangle.edgeC[0] * screen[2].z) / area;
+
+        // Clamped as floats first, vertices close to the eye project far outside of what fits in an int
+        triangle.minX = static_cast<int32_t>(std::clamp(minX, 0.0f, m_Width - 1.0f));
+        triangle.maxX = static_cast<int32_t>(std::clamp(maxX, 0.0f, m_Width - 1.0f));
+        triangle.minY = static_cast<int32_t>(std::clamp(minY, 0.0f, m_Height - 1.0f));
+        triangle.maxY = static_cast<int32_t>(std::clamp(maxY, 0.0f, m_Height - 1.0f));
+
+        uint32_t index = static_cast<uint32_t>(m_Triangles.size());
+        m_Triangles.push_back(triangle);
+        for (int32_t tileY = triangle.minY / TILE; tileY <= triangle.maxY / TILE; tileY++) {
+            for (int32_t tileX = triangle.minX / TILE; tileX <= triangle.maxX / TILE; tileX++) {
+                m_TileBins[tileY * m_TilesX + tileX].push_back(index);
+            }
+        }
+    }
+
+    void DepthRasterizer::rasterize() {
+        // Tiles don't share pixels, so the jobs never touch the same memory
+        JobSystem::instance()->parallelFor(m_TilesX * m_TilesY, 1, [this](uint32_t tile) { rasterizeTile(tile); });
+    }
+
+    void DepthRasterizer::rasterizeTile(uint32_t tile) {
+        const int32_t tileMinX = (tile % m_TilesX) * TILE;
+        const int32_t tileMinY = (tile / m_TilesX) * TILE;
+        const int32_t tileMaxX = tileMinX + TILE - 1;
+        const int32_t tileMaxY = tileMinY + TILE - 1;
+        const Lanes   zero = splat(0.0f);
+
+        for (uint32_t index : m_TileBins[tile]) {
+            const ScreenTriangle& triangle = m_Triangles[index];
+
+            // Starting on a lane boundary keeps every row of lanes inside the tile, the extra pixels fail the edge test
+            const int32_t minX = (std::max)(triangle.minX, tileMinX) & ~(LANES - 1);
+            const int32_t maxX = (std::min)(triangle.maxX, tileMaxX);
+            const int32_t minY = (std::max)(triangle.minY, tileMinY);
+            const int32_t maxY = (std::min)(triangle.maxY, tileMaxY);
+
+            const Lanes edgeA0 = splat(triangle.edgeA[0]);
+            const Lanes edgeA1 = splat(triangle.edgeA[1]);
+            const Lanes edgeA2 = splat(triangle.edgeA[2]);
+            const Lanes depthA = splat(triangle.depthA);
+
+            for (int32_t y = minY; y <= maxY; y++) {
+                const float centerY = y + 0.5f;
+                const Lanes edgeRow0 = splat(triangle.edgeB[0] * centerY + triangle.edgeC[0]);
+                const Lanes edgeRow1 = splat(triangle.edgeB[1] * centerY + triangle.edgeC[1]);
+                const Lanes edgeRow2 = splat(triangle.edgeB[2] * centerY + triangle.edgeC[2]);
+                const Lanes depthRow = splat(triangle.depthB * centerY + triangle.depthC);
+                float*      row = &m_Depth[y * m_Width];
+
+                for (int32_t x = minX; x <= maxX; x += LANES) {
+                    const Lanes centerX = add(splat(static_cast<float>(x) + 0.5f), laneOffsets());
+                    const Mask  inside = both(both(greaterEqual(add(mul(edgeA0, centerX), edgeRow0), zero),
+                                                   greaterEqual(add(mul(edgeA1, centerX), edgeRow1), zero)),
+                                              greaterEqual(add(mul(edgeA2, centerX), edgeRow2), zero));
+                    if (!any(inside)) {
+                        continue;
+                    }
+
+                    const Lanes depth = add(mul(depthA, centerX), depthRow);
+                    const Lanes current = load(row + x);
+                    store(row + x, select(inside, minimum(current, depth), current));
+                }
+            }
+        }
+
+        float maxDepth = 0.0f;
+        for (int32_t y = tileMinY; y <= tileMaxY; y++) {
+            const float* row = &m_Depth[y * m_Width];
+            maxDepth = (std::max)(maxDepth, *std::max_element(row + tileMinX, row + tileMaxX + 1));
+        }
+        m_TileMaxDepth[tile] = maxDepth;
+    }
+
+    bool DepthRasterizer::isSphereVisible(const glm::vec3& center, float radius,
+                                          const glm::mat4& viewProjection) const {
+        // The corners of the box around the sphere give a screen rectangle and depth that are never too small
+        glm::vec2 minNdc(FLT_MAX);
+        glm::vec2 maxNdc(-FLT_MAX);
+        float     nearestDepth = FLT_MAX;
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = center + radius * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f,
+                                                           i & 4 ? 1.0f : -1.0f);
+            glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+            // Reaches past the near plane, nothing that was rasterized can be in front of it
+            if (clip.z < 0.0f || clip.w <= 0.0f) {
+                return true;
+            }
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            minNdc = glm::min(minNdc, glm::vec2(ndc));
+            maxNdc = glm::max(maxNdc, glm::vec2(ndc));
+            nearestDepth = (std::min)(nearestDepth, ndc.z);
+        }
+
+        // Whatever is off screen or past the far plane is left to the frustum culling
+        if (maxNdc.x < -1.0f || maxNdc.y < -1.0f || minNdc.x > 1.0f || minNdc.y > 1.0f || nearestDepth > 1.0f) {
+            return true;
+        }
+
+        const int32_t minX = static_cast<int32_t>(std::clamp((minNdc.x * 0.5f + 0.5f) * m_Width, 0.0f, m_Width - 1.0f));
+        const int32_t maxX = static_cast<int32_t>(std::clamp((maxNdc.x * 0.5f + 0.5f) * m_Width, 0.0f, m_Width - 1.0f));
+        const int32_t minY =
+            static_cast<int32_t>(std::clamp((minNdc.y * 0.5f + 0.5f) * m_Height, 0.0f, m_Height - 1.0f));
+        const int32_t maxY =
+            static_cast<int32_t>(std::clamp((maxNdc.y * 0.5f + 0.5f) * m_Height, 0.0f, m_Height - 1.0f));
+        const Lanes nearest = splat(nearestDepth);
+
+        for (int32_t tileY = minY / TILE; tileY <= maxY / TILE; tileY++) {
+            for (int32_t tileX = minX / TILE; tileX <= maxX / TILE; tileX++) {
+                // The whole tile is in front of the sphere, no need to look at its pixels
+                if (m_TileMaxDepth[tileY * m_TilesX + tileX] < nearestDepth) {
+                    continue;
+                }
+
+                // Lanes outside of the rectangle only make the test more conservative
+                const int32_t rowMinX = (std::max)(minX, tileX * TILE) & ~(LANES - 1);
+                const int32_t rowMaxX = (std::min)(maxX, (tileX + 1) * TILE - 1);
+                const int32_t tileMinY = (std::max)(minY, tileY * TILE);
+                const int32_t tileMaxY = (std::min)(maxY, (tileY + 1) * TILE - 1);
+                for (int32_t y = tileMinY; y <= tileMaxY; y++) {
+                    const float* row = &m_Depth[y * m_Width];
+                    for (int32_t x = rowMinX; x <= rowMaxX; x += LANES) {
+                        if (any(greaterEqual(load(row + x), nearest))) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,59 @@
+#ifndef YARE_DEPTH_RASTERIZER_H
+#define YARE_DEPTH_RASTERIZER_H
+
+#include <vector>
+
+#include "Graphics/Culling/OccluderProxy.h"
+
+namespace Yare::Graphics {
+
+    // Low resolution depth buffer the cpu rasterizes occluders into. The buffer is split into tiles and every tile is
+    // filled by its own job, with 4 or 8 pixels of a row per SIMD instruction. Depth is clip z / w of the same
+    // projection the gpu draws with, so 1.0 is the far plane the buffer is cleared to.
+    class DepthRasterizer {
+       public:
+        // The size is rounded up to whole tiles
+        DepthRasterizer(uint32_t width, uint32_t height);
+
+        // Drops the binned triangles of the last frame and resets the depth to the far plane
+        void clear();
+        // Clips the occluder's triangles against the near plane, projects them and bins them into the tiles they touch
+        void addOccluder(const OccluderGeometry& occluder, const glm::mat4& modelViewProjection);
+        // Rasterizes the binned triangles on the job system, one job per tile
+        void rasterize();
+
+        // False only when every pixel under the sphere's screen rectangle is closer than the sphere's nearest point
+        bool isSphereVisible(const glm::vec3& center, float radius, const glm::mat4& viewProjection) const;
+
+        uint32_t                  getWidth() const { return m_Width; }
+        uint32_t                  getHeight() const { return m_Height; }
+        uint32_t                  getTriangleCount() const { return static_cast<uint32_t>(m_Triangles.size()); }
+        const std::vector<float>& getDepth() const { return m_Depth; }
+
+        static constexpr uint32_t TILE_SIZE = 32;
+
+       private:
+        // Edge functions and depth plane of a projected triangle, evaluated at pixel centers as a*x + b*y + c
+        struct ScreenTriangle {
+            float   edgeA[3], edgeB[3], edgeC[3];
+            float   depthA, depthB, depthC;
+            int32_t minX, minY, maxX, maxY;
+        };
+
+        void addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+        void rasterizeTile(uint32_t tile);
+
+        uint32_t m_Width;
+        uint32_t m_Height;
+        uint32_t m_TilesX;
+        uint32_t m_TilesY;
+
+        std::vector<float> m_Depth;
+        // Farthest depth of every tile, lets most tests finish without touching the pixels
+        std::vector<float>                 m_TileMaxDepth;
+        std::vector<ScreenTriangle>        m_Triangles;
+        std::vector<std::vector<uint32_t>> m_TileBins;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_DEPTH_RASTERIZER_H
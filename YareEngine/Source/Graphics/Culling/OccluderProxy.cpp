@@ -0,0 +1,252 @@
+#include "Graphics/Culling/OccluderProxy.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include "Utilities/Logger.h"
+
+#define VOXELIZER_IMPLEMENTATION
+#include <tinyobjloader/examples/voxelize/voxelizer.h>
+
+namespace Yare::Graphics {
+
+    namespace {
+        struct Box {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        struct CacheHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t resolution;
+            uint32_t maxBoxes;
+            uint64_t sourceSize;
+            int64_t  sourceTime;
+            uint32_t boxCount;
+            uint32_t padding;
+        };
+
+        constexpr uint32_t CACHE_MAGIC = 0x50434F59;  // "YOCP"
+        constexpr uint32_t CACHE_VERSION = 1;
+
+        enum Cell : uint8_t { CELL_EMPTY = 0, CELL_SURFACE, CELL_OUTSIDE, CELL_INSIDE, CELL_MERGED };
+
+        // Corners are numbered by their bits, x is bit 0, y bit 1 and z bit 2
+        constexpr uint32_t BOX_INDICES[36] = {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 4, 6, 0, 6, 2,
+                                              1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3};
+
+        std::vector<Box> findInsideBoxes(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                                         const OccluderProxySettings& settings) {
+            glm::vec3 boundsMin(FLT_MAX);
+            glm::vec3 boundsMax(-FLT_MAX);
+            for (const auto& position : positions) {
+                boundsMin = glm::min(boundsMin, position);
+                boundsMax = glm::max(boundsMax, position);
+            }
+            glm::vec3 extent = boundsMax - boundsMin;
+            float     longestSide = (std::max)({extent.x, extent.y, extent.z});
+            if (positions.empty() || indices.size() < 3 || longestSide <= 0.0f) {
+                return {};
+            }
+            float voxelSize = longestSide / (std::max)(settings.resolution, 1u);
+
+            // The voxelizer snaps negative coordinates to the wrong voxel and drops faces on that side, so the mesh is
+            // moved by whole voxels until it is two voxels clear of zero on every axis
+            glm::vec3  shift = (2.0f - glm::floor(boundsMin / voxelSize)) * voxelSize;
+            vx_mesh_t* mesh = vx_mesh_alloc(static_cast<int>(positions.size()), static_cast<int>(indices.size()));
+            for (size_t i = 0; i < positions.size(); i++) {
+                mesh->vertices[i].x = positions[i].x + shift.x;
+                mesh->vertices[i].y = positions[i].y + shift.y;
+                mesh->vertices[i].z = positions[i].z + shift.z;
+            }
+            std::copy(indices.begin(), indices.end(), mesh->indices);
+
+            // A tenth of a voxel of slack closes the gaps the voxelizer would leave between neighbouring triangles
+            vx_mesh_t* surface = vx_voxelize(mesh, voxelSize, voxelSize, voxelSize, voxelSize * 0.1f);
+            vx_mesh_free(mesh);
+
+            // Voxel centers sit on multiples of the voxel size, which makes them their cell. The grid keeps two empty
+            // cells around the mesh so the outside surrounds it completely.
+            glm::ivec3 size = glm::ivec3(glm::ceil((boundsMax + shift) / voxelSize)) + 3;
+            auto       cellIndex = [&size](int x, int y, int z) { return (z * size.y + y) * size.x + x; };
+
+            std::vector<uint8_t> cells(size.x * size.y * size.z, CELL_EMPTY);
+            for (size_t voxel = 0; voxel < surface->nvertices / 8; voxel++) {
+                glm::vec3 center(0.0f);
+                for (size_t corner = 0; corner < 8; corner++) {
+                    const vx_vertex_t& vertex = surface->vertices[voxel * 8 + corner];
+                    center += glm::vec3(vertex.x, vertex.y, vertex.z) / 8.0f;
+                }
+                glm::ivec3 cell = glm::ivec3(glm::round(center / voxelSize));
+                if (glm::all(glm::greaterThanEqual(cell, glm::ivec3(0))) && glm::all(glm::lessThan(cell, size))) {
+                    cells[cellIndex(cell.x, cell.y, cell.z)] = CELL_SURFACE;
+                }
+            }
+            // The voxelizer doesn't free the normal indices of the meshes it creates
+            free(surface->normalindices);
+            vx_mesh_free(surface);
+
+            // Flood the outside from a corner, whatever it can't reach is enclosed by the surface
+            std::vector<glm::ivec3> open = {glm::ivec3(0)};
+            cells[0] = CELL_OUTSIDE;
+            while (!open.empty()) {
+                glm::ivec3 cell = open.back();
+                open.pop_back();
+                for (int axis = 0; axis < 3; axis++) {
+                    for (int step : {-1, 1}) {
+                        glm::ivec3 next = cell;
+                        next[axis] += step;
+                        if (next[axis] < 0 || next[axis] >= size[axis]) {
+                            continue;
+                        }
+                        uint8_t& state = cells[cellIndex(next.x, next.y, next.z)];
+                        if (state == CELL_EMPTY) {
+                            state = CELL_OUTSIDE;
+                            open.push_back(next);
+                        }
+                    }
+                }
+            }
+            for (auto& state : cells) {
+                if (state == CELL_EMPTY) {
+                    state = CELL_INSIDE;
+                }
+            }
+
+            // Greedily grow boxes through the inside, along x first, then y, then z
+            auto isInside = [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+                for (int z = z0; z <= z1; z++) {
+                    for (int y = y0; y <= y1; y++) {
+                        for (int x = x0; x <= x1; x++) {
+                            if (cells[cellIndex(x, y, z)] != CELL_INSIDE) {
+                                return false;
+                            }
+                        }
+                    }
+                }
+                return true;
+            };
+
+            std::vector<Box> boxes;
+            for (int z = 0; z < size.z; z++) {
+                for (int y = 0; y < size.y; y++) {
+                    for (int x = 0; x < size.x; x++) {
+                        if (cells[cellIndex(x, y, z)] != CELL_INSIDE) {
+                            continue;
+                        }
+                        int x1 = x, y1 = y, z1 = z;
+                        while (x1 + 1 < size.x && isInside(x1 + 1, x1 + 1, y, y, z, z)) {
+                            x1++;
+                        }
+                        while (y1 + 1 < size.y && isInside(x, x1, y1 + 1, y1 + 1, z, z)) {
+                            y1++;
+                        }
+                        while (z1 + 1 < size.z && isInside(x, x1, y, y1, z1 + 1, z1 + 1)) {
+                            z1++;
+                        }
+                        for (int mz = z; mz <= z1; mz++) {
+                            for (int my = y; my <= y1; my++) {
+                                for (int mx = x; mx <= x1; mx++) {
+                                    cells[cellIndex(mx, my, mz)] = CELL_MERGED;
+                                }
+                            }
+                        }
+
+                        glm::vec3 cellMin = glm::vec3(glm::ivec3(x, y, z));
+                        glm::vec3 cellMax = glm::vec3(glm::ivec3(x1, y1, z1));
+                        boxes.push_back({(cellMin - 0.5f) * voxelSize - shift, (cellMax + 0.5f) * voxelSize - shift});
+                    }
+                }
+            }
+
+            // Every box is inside the voxelized surface on its own, so dropping the small ones only hides less
+            auto volume = [](const Box& box) {
+                glm::vec3 extent = box.max - box.min;
+                return extent.x * extent.y * extent.z;
+            };
+            std::sort(boxes.begin(), boxes.end(), [&](const Box& a, const Box& b) { return volume(a) > volume(b); });
+            if (boxes.size() > settings.maxBoxes) {
+                boxes.resize(settings.maxBoxes);
+            }
+            return boxes;
+        }
+
+        OccluderGeometry createBoxGeometry(const std::vector<Box>& boxes) {
+            OccluderGeometry occluder;
+            occluder.positions.reserve(boxes.size() * 8);
+            occluder.indices.reserve(boxes.size() * 36);
+            for (const auto& box : boxes) {
+                uint32_t firstVertex = static_cast<uint32_t>(occluder.positions.size());
+                for (int corner = 0; corner < 8; corner++) {
+                    occluder.positions.emplace_back(corner & 1 ? box.max.x : box.min.x,
+                                                    corner & 2 ? box.max.y : box.min.y,
+                                                    corner & 4 ? box.max.z : box.min.z);
+                }
+                for (uint32_t index : BOX_INDICES) {
+                    occluder.indices.push_back(firstVertex + index);
+                }
+            }
+            return occluder;
+        }
+    }  // namespace
+
+    OccluderGeometry createOccluderProxy(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                                         const OccluderProxySettings& settings) {
+        return createBoxGeometry(findInsideBoxes(positions, indices, settings));
+    }
+
+    OccluderGeometry loadOccluderProxy(const std::string& sourcePath, const std::vector<glm::vec3>& positions,
+                                       const std::vector<uint32_t>& indices, const OccluderProxySettings& settings) {
+        std::error_code sizeError, timeError;
+        uint64_t        sourceSize = std::filesystem::file_size(sourcePath, sizeError);
+        auto            sourceTime = std::filesystem::last_write_time(sourcePath, timeError);
+        if (sizeError || timeError) {
+            return createOccluderProxy(positions, indices, settings);
+        }
+
+        CacheHeader header = {};
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.resolution = settings.resolution;
+        header.maxBoxes = settings.maxBoxes;
+        header.sourceSize = sourceSize;
+        header.sourceTime = static_cast<int64_t>(sourceTime.time_since_epoch().count());
+
+        std::string cachePath = sourcePath + ".occluder";
+        {
+            std::ifstream cacheFile(cachePath, std::ios::binary);
+            CacheHeader   cachedHeader = {};
+            if (cacheFile.read(reinterpret_cast<char*>(&cachedHeader), sizeof(cachedHeader)) &&
+                cachedHeader.magic == header.magic && cachedHeader.version == header.version &&
+                cachedHeader.resolution == header.resolution && cachedHeader.maxBoxes == header.maxBoxes &&
+                cachedHeader.sourceSize == header.sourceSize && cachedHeader.sourceTime == header.sourceTime &&
+                cachedHeader.boxCount <= header.maxBoxes &&
+                std::filesystem::file_size(cachePath, sizeError) ==
+                    sizeof(CacheHeader) + uint64_t(cachedHeader.boxCount) * sizeof(Box) &&
+                !sizeError) {
+                std::vector<Box> boxes(cachedHeader.boxCount);
+                if (cacheFile.read(reinterpret_cast<char*>(boxes.data()), boxes.size() * sizeof(Box))) {
+                    return createBoxGeometry(boxes);
+                }
+            }
+        }
+
+        std::vector<Box> boxes = findInsideBoxes(positions, indices, settings);
+        if (boxes.empty()) {
+            YZ_WARN("'" + sourcePath + "' isn't a closed mesh, its occluder proxy is empty.");
+        }
+
+        header.boxCount = static_cast<uint32_t>(boxes.size());
+        std::ofstream cacheFile(cachePath, std::ios::binary | std::ios::trunc);
+        if (!cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !cacheFile.write(reinterpret_cast<const char*>(boxes.data()), boxes.size() * sizeof(Box))) {
+            YZ_WARN("Occluder proxy cache '" + cachePath + "' could not be written.");
+        }
+        return createBoxGeometry(boxes);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,39 @@
+#ifndef YARE_OCCLUDER_PROXY_H
+#define YARE_OCCLUDER_PROXY_H
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Yare::Graphics {
+
+    // Triangles the cpu occlusion culler rasterizes in place of the mesh, in the meshes object space
+    struct OccluderGeometry {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t>  indices;
+    };
+
+    struct OccluderProxySettings {
+        // Voxels along the longest side of the mesh
+        uint32_t resolution = 32;
+        // Only the largest boxes are kept, each one is 12 triangles
+        uint32_t maxBoxes = 8;
+    };
+
+    // Builds an occluder out of a few boxes inside a mesh. The mesh is voxelized with the bundled voxelizer, the
+    // voxels enclosed by its surface are merged into boxes and the largest of those become the occluder. For a closed
+    // mesh it never hides anything the mesh wouldn't when seen from outside. The voxels also close holes smaller than
+    // about a voxel, so a mesh with such holes, like the viking room, is approximated and its occluder can hide what
+    // shows through them. Meshes with larger holes have no inside and give an empty occluder.
+    OccluderGeometry createOccluderProxy(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                                         const OccluderProxySettings& settings = {});
+
+    // Same as above, cached in a .occluder file next to the source. The cache is rebuilt when the source file or the
+    // settings change.
+    OccluderGeometry loadOccluderProxy(const std::string& sourcePath, const std::vector<glm::vec3>& positions,
+                                       const std::vector<uint32_t>& indices,
+                                       const OccluderProxySettings& settings = {});
+}  // namespace Yare::Graphics
+
+#endif  // YARE_OCCLUDER_PROXY_H
@@ -0,0 +1,63 @@
+#include "Graphics/Culling/OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Core/JobSystem.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        double millisecondsSince(Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        constexpr uint32_t TEST_BATCH_SIZE = 64;
+    }  // namespace
+
+    OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height) : m_Rasterizer(width, height) {}
+
+    void OcclusionCuller::cull(const std::vector<std::shared_ptr<Entity>>& entities, const glm::mat4& viewProjection) {
+        m_Stats = {};
+
+        Clock::time_point start = Clock::now();
+        m_Rasterizer.clear();
+        for (const auto& entity : entities) {
+            const OccluderGeometry* occluder = entity->isOccluder() ? entity->getMesh()->getOccluder() : nullptr;
+            if (occluder) {
+                m_Rasterizer.addOccluder(*occluder, viewProjection * entity->getTransform().getMatrix());
+                m_Stats.occluderCount++;
+            }
+        }
+        m_Rasterizer.rasterize();
+        m_Stats.occluderTriangleCount = m_Rasterizer.getTriangleCount();
+        m_Stats.rasterizeTime = millisecondsSince(start);
+
+        // Every entity writes only its own flag, the list is gathered afterwards so it keeps the entity order
+        start = Clock::now();
+        m_Visibility.resize(entities.size());
+        JobSystem::instance()->parallelFor(
+            static_cast<uint32_t>(entities.size()), TEST_BATCH_SIZE, [&](uint32_t index) {
+                const Entity*    entity = entities[index].get();
+                const glm::mat4  model = entity->getTransform().getMatrix();
+                const glm::vec4& sphere = entity->getMesh()->getBoundingSphere();
+
+                glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+                float     scale = (std::max)({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                              glm::length(glm::vec3(model[2]))});
+                m_Visibility[index] = m_Rasterizer.isSphereVisible(center, sphere.w * scale, viewProjection) ? 1 : 0;
+            });
+
+        m_VisibleEntities.clear();
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (m_Visibility[i]) {
+                m_VisibleEntities.push_back(entities[i].get());
+            }
+        }
+        m_Stats.testedCount = static_cast<uint32_t>(entities.size());
+        m_Stats.occludedCount = m_Stats.testedCount - static_cast<uint32_t>(m_VisibleEntities.size());
+        m_Stats.testTime = millisecondsSince(start);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,45 @@
+#ifndef YARE_OCCLUSION_CULLER_H
+#define YARE_OCCLUSION_CULLER_H
+
+#include <memory>
+#include <vector>
+
+#include "Graphics/Culling/DepthRasterizer.h"
+#include "Graphics/Scene/Entity.h"
+
+namespace Yare::Graphics {
+
+    struct OcclusionCullingStats {
+        uint32_t occluderCount = 0;
+        uint32_t occluderTriangleCount = 0;
+        uint32_t testedCount = 0;
+        uint32_t occludedCount = 0;
+        // Milliseconds spent binning and rasterizing the occluders, and testing the entities against them
+        double rasterizeTime = 0.0;
+        double testTime = 0.0;
+    };
+
+    // Answers visibility on the cpu before any work is submitted. The entities marked as occluders are rasterized
+    // into a small depth buffer and the bounds of every entity are tested against it.
+    class OcclusionCuller {
+       public:
+        OcclusionCuller(uint32_t width = 320, uint32_t height = 192);
+
+        void cull(const std::vector<std::shared_ptr<Entity>>& entities, const glm::mat4& viewProjection);
+
+        // The entities that may be visible this frame, in the order they were passed in
+        const std::vector<const Entity*>& getVisibleEntities() const { return m_VisibleEntities; }
+        // One flag per entity passed in, 1 when it may be visible
+        const std::vector<uint32_t>& getVisibility() const { return m_Visibility; }
+        const OcclusionCullingStats& getStats() const { return m_Stats; }
+        const DepthRasterizer&       getRasterizer() const { return m_Rasterizer; }
+
+       private:
+        DepthRasterizer            m_Rasterizer;
+        std::vector<const Entity*> m_VisibleEntities;
+        std::vector<uint32_t>      m_Visibility;
+        OcclusionCullingStats      m_Stats;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_OCCLUSION_CULLER_H
@@ -0,0 +1,141 @@
+#include "Graphics/Culling/OcclusionQueries.h"
+
+#include "Graphics/Vulkan/Devices.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr uint32_t BOX_VERTEX_COUNT = 36;
+    }  // namespace
+
+    OcclusionQueries::OcclusionQueries(RenderPass* renderPass, uint32_t width, uint32_t height) {
+        createPipeline(renderPass, width, height);
+    }
+
+    OcclusionQueries::~OcclusionQueries() {
+        deleteQueries();
+        delete m_Pipeline;
+    }
+
+    void OcclusionQueries::onResize(RenderPass* renderPass, uint32_t width, uint32_t height) {
+        Pipeline* oldPipeline = m_Pipeline;
+        createPipeline(renderPass, width, height);
+        delete oldPipeline;
+    }
+
+    void OcclusionQueries::setObjectCount(uint32_t objectCount) {
+        // Frames are waited on before the next one is recorded, so nothing in flight still uses the old pool
+        deleteQueries();
+        m_ObjectCount = objectCount;
+        m_Visible.assign(objectCount, 1);
+        m_QueryCount = 0;
+        m_OccludedCount = 0;
+        if (objectCount == 0) {
+            return;
+        }
+
+        VkQueryPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        poolInfo.queryCount = objectCount;
+        if (vkCreateQueryPool(Devices::instance()->getDevice(), &poolInfo, nullptr, &m_QueryPool) != VK_SUCCESS) {
+            YZ_CRITICAL("Failed to create the occlusion query pool.");
+        }
+
+        if (Devices::instance()->hasConditionalRendering()) {
+            m_PredicateBuffer = new Buffer(BufferUsage::PREDICATE, objectCount * sizeof(uint32_t), nullptr);
+        }
+    }
+
+    void OcclusionQueries::readResults() {
+        if (m_ObjectCount == 0 || !m_PoolReset) {
+            return;
+        }
+
+        // Every query has its sample count followed by its availability, unavailable ones were never issued
+        std::vector<uint64_t> results(m_ObjectCount * 2);
+        VkResult              result = vkGetQueryPoolResults(
+            Devices::instance()->getDevice(), m_QueryPool, 0, m_ObjectCount, results.size() * sizeof(uint64_t),
+            results.data(), 2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            YZ_WARN("Occlusion query results could not be read.");
+            return;
+        }
+
+        m_QueryCount = 0;
+        m_OccludedCount = 0;
+        for (uint32_t i = 0; i < m_ObjectCount; i++) {
+            bool available = results[i * 2 + 1] != 0;
+            bool occluded = available && results[i * 2] == 0;
+            m_Visible[i] = occluded ? 0 : 1;
+            m_QueryCount += available ? 1 : 0;
+            m_OccludedCount += occluded ? 1 : 0;
+        }
+    }
+
+    void OcclusionQueries::beginFrame(CommandBuffer* commandBuffer) {
+        if (m_ObjectCount == 0) {
+            return;
+        }
+
+        if (m_PredicateBuffer) {
+            // Queries that weren't issued aren't copied, so the objects they belong to keep the visible predicate
+            vkCmdFillBuffer(commandBuffer->getCommandBuffer(), m_PredicateBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 1);
+            if (m_PoolReset) {
+                commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+                vkCmdCopyQueryPoolResults(commandBuffer->getCommandBuffer(), m_QueryPool, 0, m_ObjectCount,
+                                          m_PredicateBuffer->getBuffer(), 0, sizeof(uint32_t), 0);
+            }
+            // The reset below also has to wait for the copy
+            commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                         VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT |
+                                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                         VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT);
+        }
+
+        vkCmdResetQueryPool(commandBuffer->getCommandBuffer(), m_QueryPool, 0, m_ObjectCount);
+        m_PoolReset = true;
+    }
+
+    void OcclusionQueries::beginProxies(CommandBuffer* commandBuffer) { m_Pipeline->setActive(*commandBuffer); }
+
+    void OcclusionQueries::drawProxy(CommandBuffer* commandBuffer, uint32_t object, const glm::mat4& boxToClip) {
+        // Any sample passing is enough, so the queries don't need to be precise
+        vkCmdBeginQuery(commandBuffer->getCommandBuffer(), m_QueryPool, object, 0);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_Pipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &boxToClip);
+        vkCmdDraw(commandBuffer->getCommandBuffer(), BOX_VERTEX_COUNT, 1, 0, 0);
+        vkCmdEndQuery(commandBuffer->getCommandBuffer(), m_QueryPool, object);
+    }
+
+    void OcclusionQueries::createPipeline(RenderPass* renderPass, uint32_t width, uint32_t height) {
+        Shader shader("../Res/Shaders/OcclusionQuery", "occlusion_box.shader");
+
+        // The box is generated from the vertex index, so there are no vertex streams
+        PipelineInfo pInfo = {};
+        pInfo.shader = &shader;
+        pInfo.renderpass = renderPass;
+        pInfo.cullMode = VK_CULL_MODE_NONE;
+        pInfo.depthTestEnable = VK_TRUE;
+        pInfo.depthWriteEnable = VK_FALSE;
+        pInfo.colorWriteEnabled = false;
+        pInfo.width = width;
+        pInfo.height = height;
+        pInfo.pushConstants = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4)};
+
+        m_Pipeline = new Pipeline();
+        m_Pipeline->init(pInfo);
+    }
+
+    void OcclusionQueries::deleteQueries() {
+        if (m_QueryPool) {
+            vkDestroyQueryPool(Devices::instance()->getDevice(), m_QueryPool, nullptr);
+            m_QueryPool = VK_NULL_HANDLE;
+        }
+        delete m_PredicateBuffer;
+        m_PredicateBuffer = nullptr;
+        m_PoolReset = false;
+    }
+}  // namespace Yare::Graphics
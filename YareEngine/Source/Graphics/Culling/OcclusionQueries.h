@@ -0,0 +1,60 @@
+#ifndef YARE_OCCLUSION_QUERIES_H
+#define YARE_OCCLUSION_QUERIES_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Graphics/Vulkan/Buffer.h"
+#include "Graphics/Vulkan/Pipeline.h"
+
+namespace Yare::Graphics {
+
+    // Hardware occlusion queries, one per object. After the scene is drawn the bounding box of every object is drawn
+    // inside a query without writing anything, and the next frame draws only the objects whose box had samples pass
+    // the depth test. Results are a frame late, so nothing ever waits on the gpu. With VK_EXT_conditional_rendering
+    // the results are copied into a predicate buffer and the gpu skips the draws itself, otherwise the cpu reads them
+    // back and skips the draws while recording.
+    class OcclusionQueries {
+       public:
+        OcclusionQueries(RenderPass* renderPass, uint32_t width, uint32_t height);
+        ~OcclusionQueries();
+
+        void onResize(RenderPass* renderPass, uint32_t width, uint32_t height);
+
+        // Makes room for a new scene, every object counts as visible until it has been queried
+        void setObjectCount(uint32_t objectCount);
+        // Reads last frame's results without waiting, objects that weren't queried count as visible
+        void readResults();
+        // Has to be recorded outside of a render pass, before any draw that uses the predicates. Copies last frame's
+        // results into the predicate buffer and resets the pool for this frame's queries.
+        void beginFrame(CommandBuffer* commandBuffer);
+        // The scene's depth has to be in the attachment already, the proxies only test against it
+        void beginProxies(CommandBuffer* commandBuffer);
+        // Draws the cube from -1 to 1 moved into clip space by boxToClip, inside the object's query
+        void drawProxy(CommandBuffer* commandBuffer, uint32_t object, const glm::mat4& boxToClip);
+
+        bool isVisible(uint32_t object) const { return m_Visible[object] != 0; }
+        // One 32 bit predicate per object, only exists with Devices::hasConditionalRendering
+        Buffer*  getPredicateBuffer() const { return m_PredicateBuffer; }
+        uint32_t getQueryCount() const { return m_QueryCount; }
+        uint32_t getOccludedCount() const { return m_OccludedCount; }
+
+       private:
+        void createPipeline(RenderPass* renderPass, uint32_t width, uint32_t height);
+        void deleteQueries();
+
+        Pipeline*   m_Pipeline = nullptr;
+        VkQueryPool m_QueryPool = VK_NULL_HANDLE;
+        Buffer*     m_PredicateBuffer = nullptr;
+
+        std::vector<uint8_t> m_Visible;
+        uint32_t             m_ObjectCount = 0;
+        uint32_t             m_QueryCount = 0;
+        uint32_t             m_OccludedCount = 0;
+        // Queries can only be read or copied once they have been reset
+        bool m_PoolReset = false;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_OCCLUSION_QUERIES_H
@@ -1,83 +1,81 @@
 #include "Graphics/MeshFactory.h"
 
-#include "Core/DataStructures.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "Core/JobSystem.h"
 #include "Graphics/Components/Mesh.h"
 
 namespace Yare::Graphics {
 
-    Mesh* createMesh(PrimativeShape shape) {
+    namespace {
+        // Enough vertices per batch that a job is worth handing to another thread
+        constexpr uint32_t VERTICES_PER_BATCH = 16384;
+
+        Vertex makeVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv) {
+            Vertex vertex;
+            vertex.pos = position;
+            vertex.color = normal;
+            vertex.normal = normal;
+            vertex.uv = uv;
+            return vertex;
+        }
+
+        // Appends columns by rows vertices from surface(column, row) and two triangles per cell, a row of cells at a
+        // time. With p(u, v) the surface, the front faces point along dp/dv x dp/du, which is +y for u along x and
+        // v along z.
+        template <typename Surface>
+        void appendSurface(uint32_t columns, uint32_t rows, std::vector<Vertex>& vertices,
+                           std::vector<uint32_t>& indices, const Surface& surface) {
+            uint32_t firstVertex = static_cast<uint32_t>(vertices.size());
+            size_t   firstIndex = indices.size();
+            vertices.resize(vertices.size() + size_t(columns) * rows);
+            indices.resize(indices.size() + size_t(columns - 1) * (rows - 1) * 6);
+
+            // Rows write disjoint ranges of both arrays, so they don't need to know about each other
+            uint32_t batchSize = (std::max)(VERTICES_PER_BATCH / columns, 1u);
+            JobSystem::instance()->parallelFor(rows, batchSize, [&](uint32_t row) {
+                Vertex* rowVertices = vertices.data() + firstVertex + size_t(row) * columns;
+                for (uint32_t column = 0; column < columns; column++) {
+                    rowVertices[column] = surface(column, row);
+                }
+                if (row + 1 == rows) {
+                    return;
+                }
+
+                uint32_t* rowIndices = indices.data() + firstIndex + size_t(row) * (columns - 1) * 6;
+                uint32_t  current = firstVertex + row * columns;
+                uint32_t  next = current + columns;
+                for (uint32_t column = 0; column < columns - 1; column++) {
+                    uint32_t quad[6] = {next + column,        next + column + 1, current + column + 1,
+                                        current + column + 1, current + column,  next + column};
+                    std::copy(std::begin(quad), std::end(quad), rowIndices + column * 6);
+                }
+            });
+        }
+    }  // namespace
+
+    Mesh* createMesh(PrimativeShape shape, const VertexLayout& layout) {
         switch (shape) {
             case PrimativeShape::CUBE:
-                return createCube(1.0f);
+                return createCube(1.0f, layout);
             case PrimativeShape::QUAD:
-                return createQuad(1.0f, 1.0f);
+                return createQuad(1.0f, 1.0f, layout);
+            case PrimativeShape::SPHERE:
+                return createSphere(1.0f, 32, layout);
+            case PrimativeShape::TORUS:
+                return createTorus(0.5f, 0.2f, 32, layout);
+            case PrimativeShape::RECT:
+                return createRect(1.0f, 1.0f, 1.0f, layout);
             default:
                 return nullptr;
         }
     }
 
-    Mesh* createCube(float size) {
-        /* You can't have a primative creation class without ascii art, like seriously
-            e--------f
-           / |     / |
-          a--|----b  |
-          |  g----|--h
-          | /     | /
-          c-------d
-        */
-
-        std::vector<Vertex> verticies;
-
-        glm::f32 x = size / 2.0f;
-        glm::f32 y = size / 2.0f;
-        glm::f32 z = size / 2.0f;
-
-        glm::vec3 a0 = glm::vec3(+x, +y, +z);
-        glm::vec3 a1 = glm::vec3(-x, +y, +z);
-        glm::vec3 a2 = glm::vec3(-x, -y, +z);
-        glm::vec3 a3 = glm::vec3(+x, -y, +z);
-        glm::vec3 a4 = glm::vec3(+x, +y, -z);
-        glm::vec3 a5 = glm::vec3(-x, +y, -z);
-        glm::vec3 a6 = glm::vec3(-x, -y, -z);
-        glm::vec3 a7 = glm::vec3(+x, -y, -z);
-
-        glm::vec3 verts[] = {a1, a2, a3, a3, a0, a1, a2, a6, a7, a7, a3, a2, a6, a5, a4, a4, a7, a6,
-                             a5, a1, a0, a0, a4, a5, a0, a3, a7, a7, a4, a0, a5, a6, a2, a2, a1, a5};
-
-        glm::vec2 texc[] = {
-            glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1),
-            glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1),
-            glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1), glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(1, 0),
-            glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1),
-            glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(1, 1), glm::vec2(0, 1), glm::vec2(0, 0),
-            glm::vec2(1, 1), glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1),
-        };
-
-        glm::vec3 norm[36];
-
-        for (int i = 0; i < 36; i += 3) {
-            glm::vec3 normal = glm::normalize(glm::cross(glm::vec3(verts[i + 1]) - glm::vec3(verts[i]),
-                                                         glm::vec3(verts[i + 2]) - glm::vec3(verts[i])));
+    Mesh* createCube(float size, const VertexLayout& layout) { return createRect(size, size, size, layout); }
 
-            norm[i] = normal;
-            norm[i + 1] = normal;
-            norm[i + 2] = normal;
-        }
-        std::vector<uint32_t> inds;
-
-        for (int i = 0; i < 36; i++) {
-            Vertex new_vert;
-            new_vert.pos = verts[i];
-            new_vert.uv = texc[i];
-            new_vert.normal = norm[i];
-            verticies.push_back(new_vert);
-            inds.push_back(i);
-        }
-
-        return new Mesh(verticies, inds);
-    }
-
-    Mesh* createQuad(float width, float height) {
+    Mesh* createQuad(float width, float height, const VertexLayout& layout) {
         /*
         (-1, -1)   (1,-1)
             ----------
@@ -94,101 +92,144 @@ namespace Yare::Graphics {
                                         {{-1.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}}};
         std::vector<uint32_t> indices = {0, 1, 2, 2, 3, 0};
 
-        return new Mesh(vertices, indices);
+        return new Mesh(vertices, indices, layout);
     }
 
-    Mesh* createQuadPlane(size_t width, size_t height) {
-        float positionX = 0;
-        float positionZ = 0;
-        int   index = 0;
+    Mesh* createQuadPlane(size_t width, size_t height, const VertexLayout& layout) {
+        GridSettings settings;
+        settings.columns = static_cast<uint32_t>(width);
+        settings.rows = static_cast<uint32_t>(height);
+        settings.uvScale = glm::vec2(settings.columns - 1.0f, settings.rows - 1.0f);
+        return createGrid(settings, layout);
+    }
 
-        size_t              vertex_count = (width - 1) * (height - 1) * 6;
-        size_t              index_count = vertex_count;  // duplicating
-        std::vector<Vertex> vertices;
-        vertices.resize(vertex_count);
+    Mesh* createGrid(const GridSettings& settings, const VertexLayout& layout) {
+        std::vector<Vertex>   vertices;
         std::vector<uint32_t> indices;
-        indices.resize(index_count);
-
-        size_t vertex_height = 0;  // Todo later with a heightmap
-        size_t step_density = 1;
-
-        for (size_t i = 0; i < height - 1; i++) {
-            for (size_t j = 0; j < width - 1; j++) {
-                // Triangle one
-                // Upper left.
-                positionX = (float)i;
-                positionZ = (float)(j + 1);
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(1.0f, 1.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-
-                // Upper right.
-                positionX = (float)(i + 1);
-                positionZ = (float)(j + 1);
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(1.0f, 0.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-
-                // Bottom right.
-                positionX = (float)(i + 1);
-                positionZ = (float)j;
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(0.0f, 0.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-
-                // Triangle two
-                // Bottom right.
-                positionX = (float)(i + 1);
-                positionZ = (float)j;
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(0.0f, 0.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-
-                // Bottom left.
-                positionX = (float)i;
-                positionZ = (float)j;
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(0.0f, 1.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-
-                // Upper left.
-                positionX = (float)i;
-                positionZ = (float)(j + 1);
-
-                vertices[index].pos = glm::vec3(positionX, 0.0f, positionZ);
-                vertices[index].uv = glm::vec2(1.0f, 1.0f);
-                vertices[index].normal = glm::vec3(1.0f, 1.0f, 1.0f);
-                indices[index] = index;
-                index++;
-            }
-        }
-        return new Mesh(vertices, indices);
+        generateGrid(settings, vertices, indices);
+        return new Mesh(vertices, indices, layout);
+    }
+
+    Mesh* createSphere(float diameter, uint32_t segments, const VertexLayout& layout) {
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        uint32_t              columns = (std::max)(segments, 3u) + 1;
+        uint32_t              rows = (std::max)(segments / 2, 2u) + 1;
+
+        // The seam and the poles get a vertex per column so every one has its own uv
+        appendSurface(columns, rows, vertices, indices, [&](uint32_t column, uint32_t row) {
+            glm::vec2 uv = glm::vec2(float(column) / (columns - 1), float(row) / (rows - 1));
+            float     longitude = glm::two_pi<float>() * uv.x;
+            float     latitude = glm::pi<float>() * uv.y;
+            glm::vec3 normal = glm::vec3(std::sin(latitude) * std::cos(longitude), std::cos(latitude),
+                                         -std::sin(latitude) * std::sin(longitude));
+            return makeVertex(normal * diameter * 0.5f, normal, uv);
+        });
+        return new Mesh(vertices, indices, layout);
     }
 
-    // Mesh* createSphere(float diameter) {
+    Mesh* createTorus(float radius, float thickness, uint32_t segments, const VertexLayout& layout) {
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        uint32_t              columns = (std::max)(segments, 3u) + 1;
+        uint32_t              rows = (std::max)(segments / 2, 3u) + 1;
+
+        appendSurface(columns, rows, vertices, indices, [&](uint32_t column, uint32_t row) {
+            glm::vec2 uv = glm::vec2(float(column) / (columns - 1), float(row) / (rows - 1));
+            float     around = glm::two_pi<float>() * uv.x;
+            float     tube = glm::two_pi<float>() * uv.y;
+            glm::vec3 ring = glm::vec3(std::cos(around), 0.0f, -std::sin(around));
+            glm::vec3 normal = ring * std::cos(tube) - glm::vec3(0.0f, std::sin(tube), 0.0f);
+            return makeVertex(ring * radius + normal * thickness * 0.5f, normal, uv);
+        });
+        return new Mesh(vertices, indices, layout);
+    }
 
-    // }
+    Mesh* createRect(float width, float height, float depth, const VertexLayout& layout) {
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        glm::vec3             halfExtent = glm::vec3(width, height, depth) * 0.5f;
+
+        // One 2 by 2 grid per face, u runs along the first axis and v along normal x u so the faces point out
+        const glm::vec3 faces[6][2] = {{{0, 0, 1}, {1, 0, 0}},  {{0, 0, -1}, {-1, 0, 0}}, {{0, 1, 0}, {1, 0, 0}},
+                                       {{0, -1, 0}, {1, 0, 0}}, {{1, 0, 0}, {0, 0, -1}},  {{-1, 0, 0}, {0, 0, 1}}};
+        for (const auto& face : faces) {
+            glm::vec3 normal = face[0];
+            glm::vec3 u = face[1];
+            glm::vec3 v = glm::cross(u, normal);
+            appendSurface(2, 2, vertices, indices, [&](uint32_t column, uint32_t row) {
+                glm::vec2 uv = glm::vec2(float(column), float(row));
+                glm::vec3 position = (normal + u * (uv.x * 2.0f - 1.0f) + v * (uv.y * 2.0f - 1.0f)) * halfExtent;
+                return makeVertex(position, normal, uv);
+            });
+        }
+        return new Mesh(vertices, indices, layout);
+    }
 
-    // Mesh* createTorus() {
+    void generateGrid(const GridSettings& settings, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        uint32_t columns = (std::max)(settings.columns, 2u);
+        uint32_t rows = (std::max)(settings.rows, 2u);
+        vertices.clear();
+        indices.clear();
 
-    // }
+        auto height = [&](int64_t column, int64_t row) {
+            if (!settings.heights) {
+                return 0.0f;
+            }
+            column = std::clamp<int64_t>(column, 0, columns - 1);
+            row = std::clamp<int64_t>(row, 0, rows - 1);
+            return settings.heights[row * columns + column];
+        };
 
-    // Mesh* createRect(float width, float height, float depth) {
+        appendSurface(columns, rows, vertices, indices, [&](uint32_t column, uint32_t row) {
+            // Central differences, one sided at the borders
+            int64_t   x = column;
+            int64_t   z = row;
+            glm::vec3 normal = glm::normalize(glm::vec3(height(x - 1, z) - height(x + 1, z), 2.0f * settings.spacing,
+                                                        height(x, z - 1) - height(x, z + 1)));
+            glm::vec3 position = glm::vec3(column * settings.spacing, height(column, row), row * settings.spacing);
+            glm::vec2 uv = glm::vec2(float(column) / (columns - 1), float(row) / (rows - 1)) * settings.uvScale;
+            return makeVertex(position, normal, uv);
+        });
+
+        if (settings.skirtDepth <= 0.0f) {
+            return;
+        }
 
-    // }
+        // The border vertices in a loop around the grid
+        std::vector<uint32_t> border;
+        for (uint32_t column = 0; column < columns - 1; column++) {
+            border.push_back(column);
+        }
+        for (uint32_t row = 0; row < rows - 1; row++) {
+            border.push_back(row * columns + columns - 1);
+        }
+        for (uint32_t column = columns - 1; column > 0; column--) {
+            border.push_back((rows - 1) * columns + column);
+        }
+        for (uint32_t row = rows - 1; row > 0; row--) {
+            border.push_back(row * columns);
+        }
+
+        glm::vec3 center = glm::vec3(columns - 1.0f, 0.0f, rows - 1.0f) * settings.spacing * 0.5f;
+        uint32_t  firstSkirtVertex = static_cast<uint32_t>(vertices.size());
+        for (uint32_t vertex : border) {
+            Vertex skirt = vertices[vertex];
+            skirt.pos.y -= settings.skirtDepth;
+            vertices.push_back(skirt);
+        }
+        for (uint32_t i = 0; i < border.size(); i++) {
+            uint32_t  next = (i + 1) % static_cast<uint32_t>(border.size());
+            uint32_t  top[2] = {border[i], border[next]};
+            uint32_t  bottom[2] = {firstSkirtVertex + i, firstSkirtVertex + next};
+            glm::vec3 outward = (vertices[top[0]].pos + vertices[top[1]].pos) * 0.5f - center;
+            glm::vec3 facing = glm::cross(vertices[bottom[0]].pos - vertices[top[0]].pos,
+                                          vertices[top[1]].pos - vertices[top[0]].pos);
+            if (glm::dot(facing, outward) >= 0.0f) {
+                indices.insert(indices.end(), {top[0], bottom[0], top[1], top[1], bottom[0], bottom[1]});
+            } else {
+                indices.insert(indices.end(), {top[0], top[1], bottom[0], top[1], bottom[1], bottom[0]});
+            }
+        }
+    }
 }  // namespace Yare::Graphics
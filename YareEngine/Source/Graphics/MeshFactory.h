@@ -1,21 +1,51 @@
 #ifndef YARE_MESH_FACTORY_H
 #define YARE_MESH_FACTORY_H
 
+#include <cstddef>
+#include <vector>
+
+#include "Core/DataStructures.h"
+#include "Graphics/VertexLayout.h"
+
 namespace Yare::Graphics {
     class Mesh;
 
     enum class PrimativeShape { CUBE, QUAD, SPHERE, TORUS, RECT };
 
+    // A regular grid of shared vertices in the xz plane, starting at the origin
+    struct GridSettings {
+        // Vertices along x and z, at least 2 each
+        uint32_t columns = 2;
+        uint32_t rows = 2;
+        float    spacing = 1.0f;
+        // The uvs run from 0 to this across the grid
+        glm::vec2 uvScale = glm::vec2(1.0f);
+        // columns * rows heights, one row after the other. Flat when null.
+        const float* heights = nullptr;
+        // Hangs a strip this far down from every border, which hides the cracks between neighbouring grids of
+        // different detail. 0 leaves them out.
+        float skirtDepth = 0.0f;
+    };
+
     // Create a mesh with its default parameters
-    Mesh* createMesh(PrimativeShape shape);
+    Mesh* createMesh(PrimativeShape shape, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
 
     // Create a more custom mesh
-    Mesh* createCube(float size);
-    Mesh* createQuad(float width, float height);
-    Mesh* createQuadPlane(size_t width, size_t height);
-    // Mesh* createSphere(float diameter);
-    // Mesh* createTorus();
-    // Mesh* createRect(float width, float height, float depth);
+    Mesh* createCube(float size, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    Mesh* createQuad(float width, float height, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    // width by height vertices one unit apart, the texture repeats once per cell
+    Mesh* createQuadPlane(size_t width, size_t height, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    Mesh* createGrid(const GridSettings& settings, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    Mesh* createSphere(float diameter, uint32_t segments = 32, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    // Around the y axis, radius to the center of the tube
+    Mesh* createTorus(float radius, float thickness, uint32_t segments = 32,
+                      const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+    Mesh* createRect(float width, float height, float depth, const VertexLayout& layout = COMPACT_VERTEX_LAYOUT);
+
+    // The geometry of createGrid without the mesh, for callers that build their own buffers. Every row of cells is
+    // one run of quads sharing their edges, so the triangles read like a strip and neighbouring rows share their
+    // vertices. Rows are generated on the job system.
+    void generateGrid(const GridSettings& settings, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
 }  // namespace Yare::Graphics
 
 #endif  // YARE_MESH_FACTORY_H
@@ -0,0 +1,259 @@
+#include "Graphics/MeshOptimizer.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr uint32_t NONE = 0xFFFFFFFFu;
+    }  // namespace
+
+    VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, size_t firstIndex,
+                                             size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+        VertexCacheStatistics statistics;
+        size_t                triangleCount = indexCount / 3;
+        if (triangleCount == 0) {
+            return statistics;
+        }
+
+        // A vertex stays in a fifo cache until cacheSize misses came after its own, 0 means it was never loaded
+        std::vector<size_t> loadedAt(vertexCount, 0);
+        size_t              misses = 0;
+        size_t              uniqueVertices = 0;
+        for (size_t i = firstIndex; i < firstIndex + triangleCount * 3; i++) {
+            uint32_t vertex = indices[i];
+            if (loadedAt[vertex] == 0) {
+                uniqueVertices++;
+            }
+            if (loadedAt[vertex] == 0 || misses - loadedAt[vertex] >= cacheSize) {
+                misses++;
+                loadedAt[vertex] = misses;
+            }
+        }
+
+        statistics.acmr = static_cast<float>(misses) / triangleCount;
+        statistics.atvr = static_cast<float>(misses) / uniqueVertices;
+        return statistics;
+    }
+
+    std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t firstIndex, size_t indexCount,
+                                              size_t vertexCount, uint32_t cacheSize) {
+        std::vector<uint32_t> clusters;
+        size_t                triangleCount = indexCount / 3;
+        if (triangleCount == 0) {
+            return clusters;
+        }
+        const uint32_t* source = indices.data() + firstIndex;
+
+        // The triangles around every vertex, packed one vertex after the other
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacencyOffsets[source[i] + 1]++;
+        }
+        for (size_t i = 1; i < adjacencyOffsets.size(); i++) {
+            adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+        }
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[adjacencyFill[source[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Triangles not emitted yet around every vertex
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+            liveTriangles[vertex] = adjacencyOffsets[vertex + 1] - adjacencyOffsets[vertex];
+        }
+
+        // Time stamps count cache misses, a vertex is cached while fewer than cacheSize came after it
+        std::vector<uint32_t> cachedAt(vertexCount, 0);
+        uint32_t              time = cacheSize + 1;
+        std::vector<bool>     emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> ordered;
+        uint32_t              cursor = 0;
+        ordered.reserve(triangleCount * 3);
+
+        // The most recently used vertex with triangles left, or without one the next in index order
+        auto skipDeadEnd = [&]() {
+            while (!deadEnds.empty()) {
+                uint32_t vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[vertex] > 0) {
+                    return vertex;
+                }
+            }
+            while (cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) {
+                    return cursor;
+                }
+                cursor++;
+            }
+            return NONE;
+        };
+
+        uint32_t fan = skipDeadEnd();
+        clusters.push_back(0);
+        while (fan != NONE) {
+            candidates.clear();
+            for (uint32_t i = adjacencyOffsets[fan]; i < adjacencyOffsets[fan + 1]; i++) {
+                uint32_t triangle = adjacency[i];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                emitted[triangle] = true;
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    uint32_t vertex = source[triangle * 3 + corner];
+                    ordered.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+                    if (time - cachedAt[vertex] > cacheSize) {
+                        cachedAt[vertex] = time++;
+                    }
+                }
+            }
+
+            // Fan next around the oldest vertex that is still cached after emitting all of its triangles, those
+            // that won't be get the lowest priority
+            uint32_t next = NONE;
+            int64_t  bestPriority = -1;
+            for (uint32_t vertex : candidates) {
+                if (liveTriangles[vertex] == 0) {
+                    continue;
+                }
+                int64_t priority = 0;
+                if (time - cachedAt[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                    priority = time - cachedAt[vertex];
+                }
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = vertex;
+                }
+            }
+            if (next == NONE) {
+                next = skipDeadEnd();
+                if (next != NONE) {
+                    clusters.push_back(static_cast<uint32_t>(ordered.size()));
+                }
+            }
+            fan = next;
+        }
+
+        std::copy(ordered.begin(), ordered.end(), indices.begin() + firstIndex);
+        return clusters;
+    }
+
+    std::vector<uint32_t> optimizeOverdraw(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                           size_t firstIndex, size_t indexCount,
+                                           const std::vector<uint32_t>& clusters) {
+        std::vector<uint32_t> order(clusters.size());
+        std::iota(order.begin(), order.end(), 0u);
+        size_t end = firstIndex + indexCount / 3 * 3;
+        if (clusters.size() < 2) {
+            return order;
+        }
+
+        // Area weighted centers and normals, the normals facing the same way as the vertex normals
+        std::vector<glm::vec3> centers(clusters.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> normals(clusters.size(), glm::vec3(0.0f));
+        std::vector<float>     areas(clusters.size(), 0.0f);
+        glm::vec3              meshCenter = glm::vec3(0.0f);
+        float                  meshArea = 0.0f;
+        for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+            size_t clusterEnd = cluster + 1 < clusters.size() ? firstIndex + clusters[cluster + 1] : end;
+            for (size_t i = firstIndex + clusters[cluster]; i + 2 < clusterEnd; i += 3) {
+                const Vertex& a = vertices[indices[i]];
+                const Vertex& b = vertices[indices[i + 1]];
+                const Vertex& c = vertices[indices[i + 2]];
+                glm::vec3     normal = glm::cross(b.pos - a.pos, c.pos - a.pos);
+                if (glm::dot(normal, a.normal + b.normal + c.normal) < 0.0f) {
+                    normal = -normal;
+                }
+                float area = glm::length(normal);
+                centers[cluster] += (a.pos + b.pos + c.pos) / 3.0f * area;
+                normals[cluster] += normal;
+                areas[cluster] += area;
+            }
+            meshCenter += centers[cluster];
+            meshArea += areas[cluster];
+        }
+        if (meshArea <= 0.0f) {
+            return order;
+        }
+        meshCenter /= meshArea;
+
+        std::vector<float> facing(clusters.size(), 0.0f);
+        for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+            float length = glm::length(normals[cluster]);
+            if (areas[cluster] > 0.0f && length > 0.0f) {
+                facing[cluster] = glm::dot(centers[cluster] / areas[cluster] - meshCenter, normals[cluster] / length);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return facing[a] > facing[b]; });
+
+        std::vector<uint32_t> sorted;
+        sorted.reserve(end - firstIndex);
+        for (uint32_t cluster : order) {
+            size_t clusterEnd = cluster + 1 < clusters.size() ? firstIndex + clusters[cluster + 1] : end;
+            sorted.insert(sorted.end(), indices.begin() + firstIndex + clusters[cluster], indices.begin() + clusterEnd);
+        }
+        std::copy(sorted.begin(), sorted.end(), indices.begin() + firstIndex);
+        return order;
+    }
+
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> remap(vertices.size(), NONE);
+        std::vector<Vertex>   ordered;
+        ordered.reserve(vertices.size());
+        for (auto& index : indices) {
+            if (remap[index] == NONE) {
+                remap[index] = static_cast<uint32_t>(ordered.size());
+                ordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(ordered);
+    }
+
+    void optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods,
+                      std::vector<Meshlet>* meshlets) {
+        for (size_t lod = 0; lod < lods.size(); lod++) {
+            if (lod == 0 && meshlets && !meshlets->empty()) {
+                continue;
+            }
+            std::vector<uint32_t> clusters =
+                optimizeVertexCache(indices, lods[lod].firstIndex, lods[lod].indexCount, vertices.size());
+            // Coarser levels are drawn far away and small, where overdraw doesn't cost much
+            if (lod == 0) {
+                optimizeOverdraw(vertices, indices, lods[lod].firstIndex, lods[lod].indexCount, clusters);
+            }
+        }
+
+        // The meshlet builder leaves every meshlet a contiguous range from the start of the full detail level
+        if (meshlets && !meshlets->empty()) {
+            std::vector<uint32_t> clusters;
+            for (const auto& meshlet : *meshlets) {
+                optimizeVertexCache(indices, meshlet.firstIndex, meshlet.indexCount, vertices.size());
+                clusters.push_back(meshlet.firstIndex);
+            }
+            std::vector<uint32_t> order =
+                optimizeOverdraw(vertices, indices, 0, meshlets->back().firstIndex + meshlets->back().indexCount,
+                                 clusters);
+
+            std::vector<Meshlet> sorted;
+            uint32_t             firstIndex = 0;
+            for (uint32_t meshlet : order) {
+                sorted.push_back((*meshlets)[meshlet]);
+                sorted.back().firstIndex = firstIndex;
+                firstIndex += sorted.back().indexCount;
+            }
+            meshlets->swap(sorted);
+        }
+
+        optimizeVertexFetch(vertices, indices);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,53 @@
+#ifndef YARE_MESH_OPTIMIZER_H
+#define YARE_MESH_OPTIMIZER_H
+
+#include <vector>
+
+#include "Core/DataStructures.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/MeshletBuilder.h"
+
+namespace Yare::Graphics {
+
+    // Roughly the post transform cache of current gpus, the exact size matters little to the orderings below
+    constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+    struct VertexCacheStatistics {
+        // Average cache miss ratio, vertices transformed per triangle. 0.5 is the best a regular grid can get and
+        // 3 means nothing is ever reused.
+        float acmr = 0.0f;
+        // Average transform to vertex ratio, vertices transformed per vertex referenced. 1 is the best possible.
+        float atvr = 0.0f;
+    };
+
+    // Runs indexCount indices from firstIndex through a fifo cache of cacheSize vertices
+    VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, size_t firstIndex,
+                                             size_t indexCount, size_t vertexCount,
+                                             uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+    // Reorders the triangles of the range for the vertex cache with Tipsify, which fans around the vertex that
+    // stays longest in the cache. Returns the first index of every cluster, the points where the cache had to
+    // start over, relative to firstIndex.
+    std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t firstIndex, size_t indexCount,
+                                              size_t vertexCount, uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+    // Sorts the clusters of a cache optimized range so the ones facing away from the mesh's center come first.
+    // They are the most likely to cover the rest of the mesh, so less of it gets shaded twice, while the order of
+    // the triangles inside every cluster and with it the cache efficiency stays the same. Returns which cluster
+    // ended up at every position.
+    std::vector<uint32_t> optimizeOverdraw(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                           size_t firstIndex, size_t indexCount,
+                                           const std::vector<uint32_t>& clusters);
+
+    // Moves the vertices into the order the indices first use them and rewrites the indices, so the vertex fetch
+    // walks through memory instead of jumping around. Vertices no index uses are dropped.
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    // Every level is cache optimized and the full detail one sorted for overdraw as well, then the vertices follow
+    // the new index order. The ranges of the levels stay where they are. When the full detail level is split into
+    // meshlets every meshlet is optimized on its own and the meshlets are the clusters sorted for overdraw.
+    void optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const std::vector<MeshLod>& lods,
+                      std::vector<Meshlet>* meshlets = nullptr);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_MESH_OPTIMIZER_H
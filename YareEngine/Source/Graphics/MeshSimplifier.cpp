@@ -0,0 +1,351 @@
+#include "Graphics/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Yare::Graphics {
+
+    namespace {
+        // Sum of squared distances to a set of weighted planes, as the upper half of a symmetric 4x4 matrix
+        struct Quadric {
+            double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+            double a11 = 0, a12 = 0, a13 = 0;
+            double a22 = 0, a23 = 0;
+            double a33 = 0;
+            double weight = 0;
+
+            void addPlane(const glm::vec3& normal, float distance, double planeWeight) {
+                double x = normal.x, y = normal.y, z = normal.z, d = distance;
+                a00 += planeWeight * x * x;
+                a01 += planeWeight * x * y;
+                a02 += planeWeight * x * z;
+                a03 += planeWeight * x * d;
+                a11 += planeWeight * y * y;
+                a12 += planeWeight * y * z;
+                a13 += planeWeight * y * d;
+                a22 += planeWeight * z * z;
+                a23 += planeWeight * z * d;
+                a33 += planeWeight * d * d;
+                weight += planeWeight;
+            }
+
+            void add(const Quadric& other) {
+                a00 += other.a00, a01 += other.a01, a02 += other.a02, a03 += other.a03;
+                a11 += other.a11, a12 += other.a12, a13 += other.a13;
+                a22 += other.a22, a23 += other.a23;
+                a33 += other.a33;
+                weight += other.weight;
+            }
+
+            // Weighted mean of the squared distances from the point to the planes
+            double evaluate(const glm::vec3& point) const {
+                double x = point.x, y = point.y, z = point.z;
+                double sum = a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                             2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+                return weight > 0.0 ? (std::max)(sum, 0.0) / weight : 0.0;
+            }
+        };
+
+        struct Collapse {
+            uint32_t from;
+            uint32_t to;
+            double   cost;
+        };
+
+        struct PositionHash {
+            size_t operator()(const glm::vec3& position) const {
+                // Adding zero turns -0 into 0, which compares equal and has to hash the same
+                glm::vec3 key = position + 0.0f;
+                uint32_t  bits[3];
+                memcpy(bits, &key, sizeof(bits));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+
+        uint64_t edgeKey(uint32_t from, uint32_t to) { return (uint64_t(from) << 32) | to; }
+
+        // Border planes stand up from the border edges, weighted well above the triangles so borders don't shrink
+        constexpr double BORDER_WEIGHT = 10.0;
+        // Triangles around a collapse may turn but not fold over
+        constexpr float MIN_NORMAL_DOT = 0.0f;
+    }  // namespace
+
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                       size_t targetIndexCount, float maxError, float* error) {
+        std::vector<uint32_t> result = indices;
+        if (error) {
+            *error = 0.0f;
+        }
+        if (vertices.empty() || indices.size() <= targetIndexCount) {
+            return result;
+        }
+
+        // Vertices split by normals or texture coordinates are wedges of one position, collapses move positions
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> positionIds;
+        std::vector<uint32_t>                                 positionOf(vertices.size());
+        std::vector<std::vector<uint32_t>>                    wedges;
+        for (uint32_t vertex = 0; vertex < vertices.size(); vertex++) {
+            auto position = positionIds.emplace(vertices[vertex].pos, static_cast<uint32_t>(wedges.size())).first;
+            if (position->second == wedges.size()) {
+                wedges.emplace_back();
+            }
+            positionOf[vertex] = position->second;
+            wedges[position->second].push_back(vertex);
+        }
+        size_t positionCount = wedges.size();
+
+        // Texture seams only move along themselves, hard normals are allowed to soften
+        std::vector<bool> seam(positionCount, false);
+        for (size_t position = 0; position < positionCount; position++) {
+            for (uint32_t wedge : wedges[position]) {
+                seam[position] = seam[position] || vertices[wedge].uv != vertices[wedges[position][0]].uv;
+            }
+        }
+
+        auto pos = [&](uint32_t vertex) -> const glm::vec3& { return vertices[vertex].pos; };
+
+        std::vector<Quadric> quadrics(positionCount);
+        {
+            std::unordered_set<uint64_t> directedEdges;
+            for (size_t i = 0; i + 2 < result.size(); i += 3) {
+                for (int edge = 0; edge < 3; edge++) {
+                    directedEdges.insert(edgeKey(positionOf[result[i + edge]], positionOf[result[i + (edge + 1) % 3]]));
+                }
+            }
+
+            for (size_t i = 0; i + 2 < result.size(); i += 3) {
+                const glm::vec3& a = pos(result[i]);
+                glm::vec3        normal = glm::cross(pos(result[i + 1]) - a, pos(result[i + 2]) - a);
+                float            doubleArea = glm::length(normal);
+                if (doubleArea <= 0.0f) {
+                    continue;
+                }
+                normal /= doubleArea;
+                for (int corner = 0; corner < 3; corner++) {
+                    quadrics[positionOf[result[i + corner]]].addPlane(normal, -glm::dot(normal, a), doubleArea * 0.5);
+                }
+
+                // An edge without its twin is on the border
+                for (int edge = 0; edge < 3; edge++) {
+                    uint32_t from = positionOf[result[i + edge]];
+                    uint32_t to = positionOf[result[i + (edge + 1) % 3]];
+                    if (directedEdges.count(edgeKey(to, from))) {
+                        continue;
+                    }
+                    glm::vec3 direction = pos(result[i + (edge + 1) % 3]) - pos(result[i + edge]);
+                    glm::vec3 borderNormal = glm::cross(direction, normal);
+                    float     length = glm::length(borderNormal);
+                    if (length <= 0.0f) {
+                        continue;
+                    }
+                    borderNormal /= length;
+                    double borderWeight = BORDER_WEIGHT * glm::dot(direction, direction);
+                    float  distance = -glm::dot(borderNormal, pos(result[i + edge]));
+                    quadrics[from].addPlane(borderNormal, distance, borderWeight);
+                    quadrics[to].addPlane(borderNormal, distance, borderWeight);
+                }
+            }
+        }
+
+        double maxCost = double(maxError) * double(maxError);
+        double largestCost = 0.0;
+
+        // Every pass collapses the cheapest edges whose neighbourhoods don't overlap, then rebuilds the triangles
+        std::vector<bool>     locked(positionCount);
+        std::vector<uint32_t> remap(vertices.size());
+        while (result.size() > targetIndexCount) {
+            std::unordered_set<uint64_t> directedEdges;
+            std::vector<uint32_t>        triangleOffsets(positionCount + 1, 0);
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int edge = 0; edge < 3; edge++) {
+                    directedEdges.insert(edgeKey(positionOf[result[i + edge]], positionOf[result[i + (edge + 1) % 3]]));
+                    triangleOffsets[positionOf[result[i + edge]] + 1]++;
+                }
+            }
+            for (size_t position = 0; position < positionCount; position++) {
+                triangleOffsets[position + 1] += triangleOffsets[position];
+            }
+            std::vector<uint32_t> triangles(triangleOffsets.back());
+            std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int corner = 0; corner < 3; corner++) {
+                    triangles[fill[positionOf[result[i + corner]]]++] = static_cast<uint32_t>(i);
+                }
+            }
+
+            std::vector<bool> border(positionCount, false);
+            for (uint64_t edge : directedEdges) {
+                auto from = static_cast<uint32_t>(edge >> 32);
+                auto to = static_cast<uint32_t>(edge);
+                if (!directedEdges.count(edgeKey(to, from))) {
+                    border[from] = border[to] = true;
+                }
+            }
+
+            // Border positions may only slide along a border edge, seams only onto other seams
+            std::vector<Collapse> collapses;
+            for (uint64_t edge : directedEdges) {
+                auto from = static_cast<uint32_t>(edge >> 32);
+                auto to = static_cast<uint32_t>(edge);
+                bool borderEdge = !directedEdges.count(edgeKey(to, from));
+                for (int direction = 0; direction < 2; direction++) {
+                    // Interior edges show up once per direction, so each one only adds its own
+                    if (direction == 1 && !borderEdge) {
+                        break;
+                    }
+                    uint32_t source = direction == 0 ? from : to;
+                    uint32_t target = direction == 0 ? to : from;
+                    if ((border[source] && !borderEdge) || (seam[source] && !seam[target])) {
+                        continue;
+                    }
+                    double cost = quadrics[source].evaluate(pos(wedges[target][0]));
+                    if (cost <= maxCost) {
+                        collapses.push_back({source, target, cost});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(),
+                      [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+            std::fill(locked.begin(), locked.end(), false);
+            for (uint32_t vertex = 0; vertex < remap.size(); vertex++) {
+                remap[vertex] = vertex;
+            }
+
+            size_t indexCount = result.size();
+            size_t collapseCount = 0;
+            for (const auto& collapse : collapses) {
+                if (indexCount <= targetIndexCount) {
+                    break;
+                }
+                if (locked[collapse.from] || locked[collapse.to]) {
+                    continue;
+                }
+
+                const glm::vec3& target = pos(wedges[collapse.to][0]);
+                bool             flips = false;
+                size_t           removed = 0;
+                for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; t++) {
+                    uint32_t  triangle = triangles[t];
+                    uint32_t  corners[3] = {positionOf[result[triangle]], positionOf[result[triangle + 1]],
+                                            positionOf[result[triangle + 2]]};
+                    glm::vec3 before[3] = {pos(result[triangle]), pos(result[triangle + 1]),
+                                           pos(result[triangle + 2])};
+                    if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+                        removed++;
+                        continue;
+                    }
+                    glm::vec3 after[3] = {before[0], before[1], before[2]};
+                    for (int corner = 0; corner < 3; corner++) {
+                        if (corners[corner] == collapse.from) {
+                            after[corner] = target;
+                        }
+                    }
+                    glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    if (glm::dot(normalBefore, normalAfter) <= MIN_NORMAL_DOT) {
+                        flips = true;
+                        break;
+                    }
+                }
+                if (flips) {
+                    continue;
+                }
+
+                // Every wedge moves onto the target's wedge with the closest attributes
+                for (uint32_t wedge : wedges[collapse.from]) {
+                    float closest = FLT_MAX;
+                    for (uint32_t candidate : wedges[collapse.to]) {
+                        glm::vec2 uvOffset = vertices[candidate].uv - vertices[wedge].uv;
+                        glm::vec3 normalOffset = vertices[candidate].normal - vertices[wedge].normal;
+                        float     distance = glm::dot(uvOffset, uvOffset) + glm::dot(normalOffset, normalOffset);
+                        if (distance < closest) {
+                            closest = distance;
+                            remap[wedge] = candidate;
+                        }
+                    }
+                }
+                quadrics[collapse.to].add(quadrics[collapse.from]);
+
+                // The one ring is locked so the flip tests of later collapses in this pass still hold
+                for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; t++) {
+                    for (int corner = 0; corner < 3; corner++) {
+                        locked[positionOf[result[triangles[t] + corner]]] = true;
+                    }
+                }
+                locked[collapse.to] = true;
+
+                largestCost = (std::max)(largestCost, collapse.cost);
+                indexCount -= removed * 3;
+                collapseCount++;
+            }
+            if (collapseCount == 0) {
+                break;
+            }
+
+            size_t kept = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] ||
+                    positionOf[c] == positionOf[a]) {
+                    continue;
+                }
+                result[kept++] = a;
+                result[kept++] = b;
+                result[kept++] = c;
+            }
+            result.resize(kept);
+        }
+
+        if (error) {
+            *error = static_cast<float>(std::sqrt(largestCost));
+        }
+        return result;
+    }
+
+    std::vector<MeshLod> generateLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                      const MeshLodSettings& settings) {
+        std::vector<MeshLod> lods = {{0, static_cast<uint32_t>(indices.size()), 0.0f}};
+        if (vertices.empty() || indices.empty()) {
+            return lods;
+        }
+
+        glm::vec3 min = vertices[0].pos;
+        glm::vec3 max = vertices[0].pos;
+        for (const auto& vertex : vertices) {
+            min = glm::min(min, vertex.pos);
+            max = glm::max(max, vertex.pos);
+        }
+        float maxError = glm::length(max - min) * 0.5f * settings.maxError;
+
+        // Every level starts from the full mesh, so its error is measured against the original surface
+        const std::vector<uint32_t> original(indices.begin(), indices.end());
+        size_t                      targetIndexCount = original.size();
+        while (lods.size() < settings.maxLodCount) {
+            targetIndexCount = static_cast<size_t>(targetIndexCount * settings.reduction) / 3 * 3;
+            float                 error = 0.0f;
+            std::vector<uint32_t> lodIndices = simplifyMesh(vertices, original, targetIndexCount, maxError, &error);
+
+            // Not worth a level if it barely saves anything over the last one
+            if (lodIndices.empty() || lodIndices.size() > lods.back().indexCount * 9 / 10) {
+                break;
+            }
+            lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices.size()),
+                            (std::max)(error, lods.back().error)});
+            indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+        }
+        return lods;
+    }
+
+    uint32_t selectLod(const std::vector<MeshLod>& lods, float errorToPixels) {
+        uint32_t lod = 0;
+        while (lod + 1 < lods.size() && lods[lod + 1].error * errorToPixels <= 1.0f) {
+            lod++;
+        }
+        return lod;
+    }
+}  // namespace Yare::Graphics
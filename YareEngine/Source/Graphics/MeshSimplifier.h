@@ -0,0 +1,44 @@
+#ifndef YARE_MESH_SIMPLIFIER_H
+#define YARE_MESH_SIMPLIFIER_H
+
+#include <vector>
+
+#include "Core/DataStructures.h"
+
+namespace Yare::Graphics {
+
+    // A range of a mesh's index buffer, every level of detail draws the same vertices
+    struct MeshLod {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        // How far the simplified surface may be from the original one, in object space
+        float error = 0.0f;
+    };
+
+    struct MeshLodSettings {
+        // Including the full mesh
+        uint32_t maxLodCount = 5;
+        // Every level keeps this much of the previous level's triangles
+        float reduction = 0.5f;
+        // Largest error a level may have, relative to the mesh's bounding sphere radius
+        float maxError = 0.25f;
+    };
+
+    // Collapses edges with the smallest quadric error until the mesh is down to targetIndexCount indices or the next
+    // collapse would move the surface further than maxError. Vertices only ever move onto their neighbours, so the
+    // result indexes the same vertex buffer. Borders and texture seams are kept where they are. The largest error
+    // of any collapse is written to error.
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                       size_t targetIndexCount, float maxError, float* error = nullptr);
+
+    // Appends the simplified levels to indices and returns the ranges of all levels, the full mesh first. Levels
+    // stop once simplifying doesn't get rid of enough triangles anymore.
+    std::vector<MeshLod> generateLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                      const MeshLodSettings& settings = {});
+
+    // The coarsest level whose error covers at most one pixel. errorToPixels converts object space errors to pixels
+    // at the instance's distance, any bias has to be applied to it already.
+    uint32_t selectLod(const std::vector<MeshLod>& lods, float errorToPixels);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_MESH_SIMPLIFIER_H
@@ -0,0 +1,172 @@
+#include "Graphics/MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr uint32_t NONE = 0xFFFFFFFFu;
+        // Cones wider than this are never back facing from anywhere worth testing, the same cutoff meshoptimizer uses
+        constexpr float MIN_CONE_DOT = 0.1f;
+
+        // Unit normal facing the same way as the vertex normals whatever the winding, zero for degenerate triangles
+        glm::vec3 triangleNormal(const Vertex& a, const Vertex& b, const Vertex& c) {
+            glm::vec3 normal = glm::cross(b.pos - a.pos, c.pos - a.pos);
+            float     length = glm::length(normal);
+            if (length <= 0.0f) {
+                return glm::vec3(0.0f);
+            }
+            normal /= length;
+            return glm::dot(normal, a.normal + b.normal + c.normal) < 0.0f ? -normal : normal;
+        }
+
+        Meshlet boundMeshlet(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& meshletVertices,
+                             const std::vector<glm::vec3>& normals) {
+            Meshlet meshlet = {};
+
+            glm::vec3 min = vertices[meshletVertices[0]].pos;
+            glm::vec3 max = min;
+            for (uint32_t vertex : meshletVertices) {
+                min = glm::min(min, vertices[vertex].pos);
+                max = glm::max(max, vertices[vertex].pos);
+            }
+            glm::vec3 center = (min + max) * 0.5f;
+            float     radius = 0.0f;
+            for (uint32_t vertex : meshletVertices) {
+                radius = (std::max)(radius, glm::length(vertices[vertex].pos - center));
+            }
+            meshlet.boundingSphere = glm::vec4(center, radius);
+
+            glm::vec3 axis = glm::vec3(0.0f);
+            for (const auto& normal : normals) {
+                axis += normal;
+            }
+            meshlet.cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            if (glm::length(axis) <= 1e-6f) {
+                return meshlet;
+            }
+            axis = glm::normalize(axis);
+
+            float minDot = 1.0f;
+            for (const auto& normal : normals) {
+                if (normal != glm::vec3(0.0f)) {
+                    minDot = (std::min)(minDot, glm::dot(axis, normal));
+                }
+            }
+            if (minDot > MIN_CONE_DOT) {
+                meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+            }
+            return meshlet;
+        }
+    }  // namespace
+
+    std::vector<Meshlet> buildMeshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                       size_t indexCount, const MeshletSettings& settings) {
+        std::vector<Meshlet> meshlets;
+        size_t               triangleCount = (std::min)(indexCount, indices.size()) / 3;
+        uint32_t             maxVertices = (std::max)(settings.maxVertices, 3u);
+        uint32_t             maxTriangles = (std::max)(settings.maxTriangles, 1u);
+        if (triangleCount == 0) {
+            return meshlets;
+        }
+
+        // The triangles around every vertex, packed one vertex after the other
+        std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacencyOffsets[indices[i] + 1]++;
+        }
+        for (size_t i = 1; i < adjacencyOffsets.size(); i++) {
+            adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+        }
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[adjacencyFill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<glm::vec3> normals(triangleCount);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+            normals[triangle] = triangleNormal(vertices[indices[triangle * 3]], vertices[indices[triangle * 3 + 1]],
+                                               vertices[indices[triangle * 3 + 2]]);
+        }
+
+        std::vector<uint32_t>  ordered;
+        std::vector<bool>      emitted(triangleCount, false);
+        std::vector<uint32_t>  vertexMeshlet(vertices.size(), NONE);
+        std::vector<uint32_t>  meshletVertices;
+        std::vector<glm::vec3> meshletNormals;
+        ordered.reserve(triangleCount * 3);
+
+        size_t nextSeed = 0;
+        while (ordered.size() < triangleCount * 3) {
+            uint32_t meshletIndex = static_cast<uint32_t>(meshlets.size());
+            uint32_t firstIndex = static_cast<uint32_t>(ordered.size());
+            meshletVertices.clear();
+            meshletNormals.clear();
+
+            auto newVertexCount = [&](uint32_t triangle) {
+                uint32_t count = 0;
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    count += vertexMeshlet[indices[triangle * 3 + corner]] != meshletIndex ? 1 : 0;
+                }
+                return count;
+            };
+
+            while (emitted[nextSeed]) {
+                nextSeed++;
+            }
+            uint32_t triangle = static_cast<uint32_t>(nextSeed);
+            while (triangle != NONE) {
+                emitted[triangle] = true;
+                meshletNormals.push_back(normals[triangle]);
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    uint32_t vertex = indices[triangle * 3 + corner];
+                    ordered.push_back(vertex);
+                    if (vertexMeshlet[vertex] != meshletIndex) {
+                        vertexMeshlet[vertex] = meshletIndex;
+                        meshletVertices.push_back(vertex);
+                    }
+                }
+                if (meshletNormals.size() >= maxTriangles) {
+                    break;
+                }
+
+                // The neighbour adding the fewest vertices, or without one left the next triangle in index order.
+                // Files tend to keep nearby triangles close together, so that is usually still close by.
+                triangle = NONE;
+                uint32_t bestNewVertices = 4;
+                for (uint32_t vertex : meshletVertices) {
+                    for (uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; i++) {
+                        uint32_t candidate = adjacency[i];
+                        if (emitted[candidate]) {
+                            continue;
+                        }
+                        uint32_t newVertices = newVertexCount(candidate);
+                        if (newVertices < bestNewVertices && meshletVertices.size() + newVertices <= maxVertices) {
+                            triangle = candidate;
+                            bestNewVertices = newVertices;
+                        }
+                    }
+                }
+                if (triangle == NONE) {
+                    while (nextSeed < triangleCount && emitted[nextSeed]) {
+                        nextSeed++;
+                    }
+                    if (nextSeed < triangleCount &&
+                        meshletVertices.size() + newVertexCount(static_cast<uint32_t>(nextSeed)) <= maxVertices) {
+                        triangle = static_cast<uint32_t>(nextSeed);
+                    }
+                }
+            }
+
+            Meshlet meshlet = boundMeshlet(vertices, meshletVertices, meshletNormals);
+            meshlet.firstIndex = firstIndex;
+            meshlet.indexCount = static_cast<uint32_t>(ordered.size()) - firstIndex;
+            meshlets.push_back(meshlet);
+        }
+
+        std::copy(ordered.begin(), ordered.end(), indices.begin());
+        return meshlets;
+    }
+}  // namespace Yare::Graphics
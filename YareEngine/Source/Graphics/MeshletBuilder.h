@@ -0,0 +1,33 @@
+#ifndef YARE_MESHLET_BUILDER_H
+#define YARE_MESHLET_BUILDER_H
+
+#include <vector>
+
+#include "Core/DataStructures.h"
+
+namespace Yare::Graphics {
+
+    // A small cluster of neighbouring triangles, drawn as a range of its mesh's index buffer
+    struct Meshlet {
+        // Object space, center in xyz and radius in w
+        glm::vec4 boundingSphere;
+        // Average facing of the triangles in xyz and the sine of the largest angle between it and any of them in w.
+        // A w of 1 means the triangles face too many ways to ever be back facing all at once.
+        glm::vec4 cone;
+        uint32_t  firstIndex;
+        uint32_t  indexCount;
+    };
+
+    struct MeshletSettings {
+        uint32_t maxVertices = 64;
+        uint32_t maxTriangles = 124;
+    };
+
+    // Groups the first indexCount indices into meshlets and reorders them in place so every meshlet is a contiguous
+    // range. A meshlet grows by the neighbouring triangle that adds the fewest new vertices, which keeps meshlets
+    // compact and their normal cones narrow.
+    std::vector<Meshlet> buildMeshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                       size_t indexCount, const MeshletSettings& settings = {});
+}  // namespace Yare::Graphics
+
+#endif  // YARE_MESHLET_BUILDER_H
@@ -0,0 +1,255 @@
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Simd.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        // The vertical pass runs over whole rows, LANE_COUNT floats per step
+        using namespace Simd;
+
+        // The horizontal pass works on one rgba texel at a time, all four channels in one register when there is SSE
+#if defined(YARE_SIMD)
+        using Texel = __m128;
+
+        inline Texel splatTexel(float value) { return _mm_set1_ps(value); }
+        inline Texel addTexel(Texel a, Texel b) { return _mm_add_ps(a, b); }
+        inline Texel mulTexel(Texel a, Texel b) { return _mm_mul_ps(a, b); }
+        inline Texel loadTexel(const float* source) { return _mm_loadu_ps(source); }
+        inline void  storeTexel(float* destination, Texel value) { _mm_storeu_ps(destination, value); }
+#else
+        struct Texel {
+            float channels[4];
+        };
+
+        inline Texel splatTexel(float value) { return {value, value, value, value}; }
+        inline Texel addTexel(Texel a, Texel b) {
+            return {a.channels[0] + b.channels[0], a.channels[1] + b.channels[1], a.channels[2] + b.channels[2],
+                    a.channels[3] + b.channels[3]};
+        }
+        inline Texel mulTexel(Texel a, Texel b) {
+            return {a.channels[0] * b.channels[0], a.channels[1] * b.channels[1], a.channels[2] * b.channels[2],
+                    a.channels[3] * b.channels[3]};
+        }
+        inline Texel loadTexel(const float* source) { return {source[0], source[1], source[2], source[3]}; }
+        inline void  storeTexel(float* destination, Texel value) {
+            std::memcpy(destination, value.channels, sizeof(value.channels));
+        }
+#endif
+
+        constexpr float  PI = 3.14159265358979f;
+        constexpr float  KAISER_ALPHA = 4.0f;
+        constexpr size_t ENCODE_TABLE_SIZE = 1 << 14;
+
+        // Weights of the taps from source texel 2 * x + first on, for destination texel x
+        struct Kernel {
+            int32_t            first = 0;
+            std::vector<float> weights;
+        };
+
+        float besselI0(float x) {
+            float sum = 1.0f;
+            float term = 1.0f;
+            for (int k = 1; k < 16; k++) {
+                term *= (x * 0.5f / k) * (x * 0.5f / k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        Kernel makeKernel(MipFilter filter, size_t sourceSize) {
+            // An edge of one texel has nothing to filter
+            if (sourceSize == 1) {
+                return {0, {1.0f}};
+            }
+            if (filter == MipFilter::BOX) {
+                return {0, {0.5f, 0.5f}};
+            }
+
+            // Six taps centered between texels 2x and 2x + 1. The sinc is stretched to the destination's texel size
+            // and the window reaches three source texels out.
+            Kernel kernel;
+            kernel.first = -2;
+            float sum = 0.0f;
+            for (int32_t tap = 0; tap < 6; tap++) {
+                float distance = static_cast<float>(tap + kernel.first) - 0.5f;
+                float x = distance * 0.5f;
+                float sinc = std::sin(PI * x) / (PI * x);
+                float window = distance / 3.0f;
+                float kaiser = besselI0(KAISER_ALPHA * std::sqrt(1.0f - window * window)) / besselI0(KAISER_ALPHA);
+                kernel.weights.push_back(sinc * kaiser);
+                sum += sinc * kaiser;
+            }
+            for (float& weight : kernel.weights) {
+                weight /= sum;
+            }
+            return kernel;
+        }
+
+        // Source texel of every tap of every destination texel along one axis, edges already resolved
+        std::vector<int32_t> makeTapIndices(const Kernel& kernel, size_t sourceSize, size_t destinationSize,
+                                            bool wrap) {
+            int32_t              size = static_cast<int32_t>(sourceSize);
+            std::vector<int32_t> indices;
+            indices.reserve(destinationSize * kernel.weights.size());
+            for (size_t x = 0; x < destinationSize; x++) {
+                for (size_t tap = 0; tap < kernel.weights.size(); tap++) {
+                    int32_t index = 2 * static_cast<int32_t>(x) + kernel.first + static_cast<int32_t>(tap);
+                    index = wrap ? ((index % size) + size) % size : (std::min)((std::max)(index, 0), size - 1);
+                    indices.push_back(index);
+                }
+            }
+            return indices;
+        }
+
+        const float* getDecodeTable(bool srgb) {
+            static float srgbTable[256];
+            static float linearTable[256];
+            static bool  initialized = [] {
+                for (int value = 0; value < 256; value++) {
+                    float color = value / 255.0f;
+                    srgbTable[value] =
+                        color <= 0.04045f ? color / 12.92f : std::pow((color + 0.055f) / 1.055f, 2.4f);
+                    linearTable[value] = color;
+                }
+                return true;
+            }();
+            (void)initialized;
+            return srgb ? srgbTable : linearTable;
+        }
+
+        // Linear values from 0 to 1 in ENCODE_TABLE_SIZE steps, fine enough that the darkest srgb steps still round
+        // to the right byte
+        const unsigned char* getEncodeTable() {
+            static unsigned char table[ENCODE_TABLE_SIZE];
+            static bool          initialized = [] {
+                for (size_t i = 0; i < ENCODE_TABLE_SIZE; i++) {
+                    float linear = static_cast<float>(i) / (ENCODE_TABLE_SIZE - 1);
+                    float color =
+                        linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+                    table[i] = static_cast<unsigned char>(std::lround(color * 255.0f));
+                }
+                return true;
+            }();
+            (void)initialized;
+            return table;
+        }
+
+        void downsampleHorizontal(const float* source, size_t sourceWidth, size_t rowCount, float* destination,
+                                  size_t destinationWidth, const Kernel& kernel, const std::vector<int32_t>& taps) {
+            size_t tapCount = kernel.weights.size();
+            for (size_t y = 0; y < rowCount; y++) {
+                const float* sourceRow = source + y * sourceWidth * 4;
+                float*       destinationRow = destination + y * destinationWidth * 4;
+                for (size_t x = 0; x < destinationWidth; x++) {
+                    const int32_t* texelTaps = taps.data() + x * tapCount;
+                    Texel          sum = splatTexel(0.0f);
+                    for (size_t tap = 0; tap < tapCount; tap++) {
+                        sum = addTexel(sum, mulTexel(loadTexel(sourceRow + texelTaps[tap] * 4),
+                                                     splatTexel(kernel.weights[tap])));
+                    }
+                    storeTexel(destinationRow + x * 4, sum);
+                }
+            }
+        }
+
+        void downsampleVertical(const float* source, size_t destinationHeight, size_t rowFloats, float* destination,
+                                const Kernel& kernel, const std::vector<int32_t>& taps) {
+            size_t tapCount = kernel.weights.size();
+            for (size_t y = 0; y < destinationHeight; y++) {
+                const int32_t* rowTaps = taps.data() + y * tapCount;
+                float*         destinationRow = destination + y * rowFloats;
+                size_t         i = 0;
+                for (; i + LANE_COUNT <= rowFloats; i += LANE_COUNT) {
+                    Lanes sum = splat(0.0f);
+                    for (size_t tap = 0; tap < tapCount; tap++) {
+                        sum = add(sum, mul(load(source + rowTaps[tap] * rowFloats + i), splat(kernel.weights[tap])));
+                    }
+                    store(destinationRow + i, sum);
+                }
+                for (; i < rowFloats; i++) {
+                    float sum = 0.0f;
+                    for (size_t tap = 0; tap < tapCount; tap++) {
+                        sum += source[rowTaps[tap] * rowFloats + i] * kernel.weights[tap];
+                    }
+                    destinationRow[i] = sum;
+                }
+            }
+        }
+
+        void encodeLevel(const float* texels, size_t texelCount, bool srgb, unsigned char* destination) {
+            const unsigned char* encodeTable = getEncodeTable();
+            for (size_t i = 0; i < texelCount * 4; i++) {
+                // Kaiser taps are partly negative, so the sums can overshoot a little
+                float value = (std::min)((std::max)(texels[i], 0.0f), 1.0f);
+                if (srgb && i % 4 != 3) {
+                    destination[i] = encodeTable[static_cast<size_t>(value * (ENCODE_TABLE_SIZE - 1) + 0.5f)];
+                } else {
+                    destination[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+                }
+            }
+        }
+    }  // namespace
+
+    uint32_t getMipLevelCount(size_t width, size_t height) {
+        uint32_t levelCount = 1;
+        while (((std::max)(width, height) >> levelCount) > 0) {
+            levelCount++;
+        }
+        return levelCount;
+    }
+
+    size_t getMipLevelsSize(size_t width, size_t height, uint32_t firstLevel, uint32_t endLevel) {
+        size_t size = 0;
+        for (uint32_t level = firstLevel; level < endLevel; level++) {
+            size += (std::max)(width >> level, size_t(1)) * (std::max)(height >> level, size_t(1)) * 4;
+        }
+        return size;
+    }
+
+    std::vector<unsigned char> generateMipChain(const unsigned char* pixels, size_t width, size_t height,
+                                                uint32_t levelCount, const MipChainSettings& settings) {
+        std::vector<unsigned char> chain(getMipLevelsSize(width, height, 0, levelCount));
+        std::memcpy(chain.data(), pixels, width * height * 4);
+
+        // Alpha always decodes linearly, the color channels by the setting
+        const float*       colorTable = getDecodeTable(settings.srgb);
+        const float*       alphaTable = getDecodeTable(false);
+        std::vector<float> current(width * height * 4);
+        for (size_t i = 0; i < current.size(); i++) {
+            current[i] = (i % 4 == 3 ? alphaTable : colorTable)[pixels[i]];
+        }
+
+        std::vector<float> horizontal;
+        std::vector<float> next;
+        size_t             sourceWidth = width;
+        size_t             sourceHeight = height;
+        size_t             offset = width * height * 4;
+        for (uint32_t level = 1; level < levelCount; level++) {
+            size_t levelWidth = (std::max)(sourceWidth >> 1, size_t(1));
+            size_t levelHeight = (std::max)(sourceHeight >> 1, size_t(1));
+
+            Kernel horizontalKernel = makeKernel(settings.filter, sourceWidth);
+            Kernel verticalKernel = makeKernel(settings.filter, sourceHeight);
+            std::vector<int32_t> columnTaps = makeTapIndices(horizontalKernel, sourceWidth, levelWidth, settings.wrap);
+            std::vector<int32_t> rowTaps = makeTapIndices(verticalKernel, sourceHeight, levelHeight, settings.wrap);
+
+            horizontal.resize(levelWidth * sourceHeight * 4);
+            next.resize(levelWidth * levelHeight * 4);
+            downsampleHorizontal(current.data(), sourceWidth, sourceHeight, horizontal.data(), levelWidth,
+                                 horizontalKernel, columnTaps);
+            downsampleVertical(horizontal.data(), levelHeight, levelWidth * 4, next.data(), verticalKernel, rowTaps);
+            encodeLevel(next.data(), levelWidth * levelHeight, settings.srgb, chain.data() + offset);
+
+            offset += levelWidth * levelHeight * 4;
+            sourceWidth = levelWidth;
+            sourceHeight = levelHeight;
+            std::swap(current, next);
+        }
+        return chain;
+    }
+}  // namespace Yare::Graphics
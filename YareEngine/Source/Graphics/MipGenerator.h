@@ -0,0 +1,37 @@
+#ifndef YARE_MIP_GENERATOR_H
+#define YARE_MIP_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Yare::Graphics {
+
+    enum class MipFilter {
+        // Average of every 2x2 block, what a linear blit gives
+        BOX,
+        // Kaiser windowed sinc over 6x6 texels, keeps the levels sharper without the aliasing of a box
+        KAISER
+    };
+
+    struct MipChainSettings {
+        MipFilter filter = MipFilter::KAISER;
+        // Color channels are averaged in linear space and stored as srgb again, alpha is always linear
+        bool srgb = true;
+        // Taps past the edges wrap around for repeating textures and clamp otherwise
+        bool wrap = true;
+    };
+
+    // Levels of a full chain, down to 1x1
+    uint32_t getMipLevelCount(size_t width, size_t height);
+    // Bytes of the rgba8 levels [firstLevel, endLevel) of a width by height texture
+    size_t getMipLevelsSize(size_t width, size_t height, uint32_t firstLevel, uint32_t endLevel);
+
+    // Downsamples width by height rgba8 pixels into levelCount levels packed finest first, the first of which is a
+    // copy of the pixels. Every level is filtered from the previous one in floats, 4 or 8 at a time with SSE4.1 or
+    // AVX2, and only rounded to 8 bits for the output. Runs on the calling thread, loaders call it too.
+    std::vector<unsigned char> generateMipChain(const unsigned char* pixels, size_t width, size_t height,
+                                                uint32_t levelCount, const MipChainSettings& settings = {});
+}  // namespace Yare::Graphics
+
+#endif  // YARE_MIP_GENERATOR_H
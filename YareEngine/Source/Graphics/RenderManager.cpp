@@ -1,13 +1,32 @@
 #include "Graphics/RenderManager.h"
 
+#include <chrono>
+#include <cstdio>
+
+#include "Application/GlobalSettings.h"
 #include "Graphics/Renderers/ForwardRenderer.h"
 #include "Graphics/Renderers/ImGuiRenderer.h"
 #include "Graphics/Renderers/SkyboxRenderer.h"
+#include "Graphics/Renderers/TerrainRenderer.h"
+#include "Graphics/StartupLoader.h"
+#include "Graphics/Vulkan/Pipeline.h"
 #include "Graphics/Vulkan/Utilities.h"
 #include "Graphics/Window/GlfwWindow.h"
+#include "Utilities/Logger.h"
 
 namespace Yare::Graphics {
 
+    namespace {
+        // Makes compute results visible to the indirect draws and vertex shaders recorded after it
+        void computeToDrawBarrier(CommandBuffer* commandBuffer) {
+            commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                         VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                             VK_ACCESS_SHADER_READ_BIT);
+        }
+    }  // namespace
+
     RenderManager::RenderManager(const std::shared_ptr<Window> window) : m_WindowRef(window) { init(); }
 
     RenderManager::~RenderManager() {
@@ -16,7 +35,9 @@ namespace Yare::Graphics {
         for (auto renderer : m_Renderers) {
             delete renderer;
         }
+        delete m_AssetLoader;
 
+        delete m_DepthPyramid;
         delete m_DepthBuffer;
 
         for (auto commandBuffer : m_CommandBuffers) {
@@ -24,20 +45,46 @@ namespace Yare::Graphics {
         }
         m_CommandBuffers.clear();
 
+        for (auto commandBuffer : m_ComputeCommandBuffers) {
+            delete commandBuffer;
+        }
+        m_ComputeCommandBuffers.clear();
+
         for (auto frameBuffer : m_FrameBuffers) {
             delete frameBuffer;
         }
         m_FrameBuffers.clear();
 
         delete m_RenderPass;
+        delete m_EarlyRenderPass;
 
         delete m_VulkanContext;
     }
 
     void RenderManager::renderScene() {
+        // Turning occlusion culling on or off changes the passes, so it is only picked up between frames
+        if (wantsOcclusionCulling() != m_OcclusionCulling) {
+            onResize();
+        }
+
         begin();
+        updateAssets();
         for (const auto renderer : m_Renderers) {
             renderer->prepareScene();
+        }
+
+        // Compute has to be recorded outside of the render pass, the draws then consume its results
+        dispatchCompute();
+        for (const auto renderer : m_Renderers) {
+            renderer->recordPrePass(m_CommandBuffers[m_CurrentBufferID]);
+        }
+
+        if (m_OcclusionCulling) {
+            renderEarlyPass();
+        }
+
+        m_RenderPass->beginRenderPass(m_CommandBuffers[m_CurrentBufferID], m_FrameBuffers[m_CurrentBufferID]);
+        for (const auto renderer : m_Renderers) {
             renderer->present(m_CommandBuffers[m_CurrentBufferID]);
         }
         end();
@@ -54,8 +101,43 @@ namespace Yare::Graphics {
         m_CurrentBufferID = m_VulkanContext->getSwapchain()->getCurrentImage();
 
         m_CommandBuffers[m_CurrentBufferID]->beginRecording();
+    }
 
-        m_RenderPass->beginRenderPass(m_CommandBuffers[m_CurrentBufferID], m_FrameBuffers[m_CurrentBufferID]);
+    void RenderManager::dispatchCompute() {
+        if (Devices::instance()->hasAsyncCompute()) {
+            // Recorded and submitted separately, the graphics submission for this frame waits on it
+            auto computeCommandBuffer = m_ComputeCommandBuffers[m_CurrentBufferID];
+            computeCommandBuffer->beginRecording();
+            for (const auto renderer : m_Renderers) {
+                renderer->dispatch(computeCommandBuffer);
+            }
+            computeCommandBuffer->endRecording();
+            m_VulkanContext->submitCompute(computeCommandBuffer);
+        } else {
+            auto commandBuffer = m_CommandBuffers[m_CurrentBufferID];
+            for (const auto renderer : m_Renderers) {
+                renderer->dispatch(commandBuffer);
+            }
+            // Same queue, so a barrier is enough to order the compute writes before the draws that read them
+            computeToDrawBarrier(commandBuffer);
+        }
+    }
+
+    void RenderManager::renderEarlyPass() {
+        auto commandBuffer = m_CommandBuffers[m_CurrentBufferID];
+
+        m_EarlyRenderPass->beginRenderPass(commandBuffer, m_FrameBuffers[m_CurrentBufferID]);
+        for (const auto renderer : m_Renderers) {
+            renderer->presentEarly(commandBuffer);
+        }
+        m_EarlyRenderPass->endRenderPass(commandBuffer);
+
+        // The late phase depends on the depth written just now, so it always runs on the graphics queue
+        m_DepthPyramid->build(commandBuffer);
+        for (const auto renderer : m_Renderers) {
+            renderer->dispatchLate(commandBuffer, *m_DepthPyramid);
+        }
+        computeToDrawBarrier(commandBuffer);
     }
 
     void RenderManager::end() {
@@ -76,21 +158,94 @@ namespace Yare::Graphics {
         createRenderPass();
         createFrameBuffers();
         createCommandBuffers();
-        m_Renderers.emplace_back(new SkyboxRenderer(m_RenderPass, m_WindowWidth, m_WindowHeight));
-        m_Renderers.emplace_back(new ForwardRenderer(m_RenderPass, m_WindowWidth, m_WindowHeight));
+        m_AssetLoader = new AssetLoader();
+
+        // The skybox and forward renderers request their files first, so they are decoded on the workers while the
+        // terrain is generated. The streamed textures are uploaded as they complete once every renderer is
+        // constructed, the asset loader's files when the renderers wait for them.
+        using Clock = std::chrono::steady_clock;
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        StartupLoader startupLoader;
+        Renderer*     skyboxRenderer = new SkyboxRenderer(*m_AssetLoader);
+        Renderer*     forwardRenderer = new ForwardRenderer(startupLoader, *m_AssetLoader);
+
+        auto      start = Clock::now();
+        Renderer* terrainRenderer = new TerrainRenderer(m_RenderPass, m_WindowWidth, m_WindowHeight);
+        startupLoader.addTiming("Terrain", Milliseconds(Clock::now() - start).count());
+        m_Renderers.emplace_back(skyboxRenderer);
+        m_Renderers.emplace_back(terrainRenderer);
+        m_Renderers.emplace_back(forwardRenderer);
         m_Renderers.emplace_back(new ImGuiRenderer(m_RenderPass, m_WindowWidth, m_WindowHeight));
+        startupLoader.finish();
+
+        start = Clock::now();
+        for (auto renderer : m_Renderers) {
+            renderer->onAssetsLoaded(m_RenderPass, m_WindowWidth, m_WindowHeight);
+            renderer->setOcclusionCulling(m_OcclusionCulling);
+        }
+        startupLoader.addTiming("Renderer setup", Milliseconds(Clock::now() - start).count());
+        // Every pipeline so far, some were built before the renderers
+        startupLoader.addTiming("Pipeline builds", Pipeline::getTotalBuildTime());
+        startupLoader.report();
+    }
+
+    void RenderManager::updateAssets() {
+        m_AssetLoader->update();
+
+        auto                    settings = GlobalSettings::instance();
+        const AssetLoaderStats& stats = m_AssetLoader->getStats();
+        settings->assetCount = static_cast<int>(stats.residentCount);
+        settings->loadingAssetCount = static_cast<int>(stats.loadingCount);
+        settings->assetCpuMegabytes = static_cast<float>(stats.cpuBytes) / (1 << 20);
+        settings->assetGpuMegabytes = static_cast<float>(stats.gpuBytes) / (1 << 20);
+        settings->assetListing.clear();
+        if (!settings->listAssets) {
+            return;
+        }
+        for (const AssetInfo& asset : m_AssetLoader->getResidentAssets()) {
+            char line[64];
+            std::snprintf(line, sizeof(line), ": %.2f MB gpu, %.2f MB cpu, %ld refs",
+                          static_cast<float>(asset.gpuBytes) / (1 << 20),
+                          static_cast<float>(asset.cpuBytes) / (1 << 20), asset.references);
+            settings->assetListing.push_back(asset.path + line);
+        }
     }
 
     void RenderManager::createRenderPass() {
+        auto settings = GlobalSettings::instance();
+        if (settings->occlusionCulling && !DepthPyramid::isSupported(VkUtil::findDepthFormat())) {
+            YZ_WARN("Occlusion culling needs rg32f storage images and a sampled depth format, turning it off");
+            settings->occlusionCulling = false;
+        }
+        m_OcclusionCulling = wantsOcclusionCulling();
+
         RenderPassInfo renderPassInfo{};
         renderPassInfo.imageFormat = m_VulkanContext->getSwapchain()->getImageFormat();
         renderPassInfo.extent = VkExtent2D{m_WindowWidth, m_WindowHeight};
+        if (m_OcclusionCulling) {
+            // Both passes use the same attachments, so they share the framebuffers and pipelines
+            RenderPassInfo earlyRenderPassInfo = renderPassInfo;
+            earlyRenderPassInfo.storeDepth = true;
+            earlyRenderPassInfo.presentColor = false;
+            m_EarlyRenderPass = new RenderPass(earlyRenderPassInfo);
+
+            renderPassInfo.loadAttachments = true;
+        }
         m_RenderPass = new RenderPass(renderPassInfo);
     }
 
+    bool RenderManager::wantsOcclusionCulling() const {
+        // Occlusion queries replace the two phase culling, running both would test everything twice
+        auto settings = GlobalSettings::instance();
+        return settings->occlusionCulling && !settings->occlusionQueries;
+    }
+
     void RenderManager::createFrameBuffers() {
         VkFormat depthFormat = VkUtil::findDepthFormat();
-        m_DepthBuffer = Image::createDepthStencilBuffer(m_WindowWidth, m_WindowHeight, depthFormat);
+        m_DepthBuffer = Image::createDepthStencilBuffer(m_WindowWidth, m_WindowHeight, depthFormat, m_OcclusionCulling);
+        if (m_OcclusionCulling) {
+            m_DepthPyramid = new DepthPyramid(m_DepthBuffer, m_WindowWidth, m_WindowHeight);
+        }
 
         FramebufferInfo framebufferInfo;
         framebufferInfo.type = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -114,6 +269,12 @@ namespace Yare::Graphics {
 
             m_CommandBuffers[i] = new CommandBuffer();
         }
+
+        if (Devices::instance()->hasAsyncCompute()) {
+            for (size_t i = 0; i < m_CommandBuffers.size(); i++) {
+                m_ComputeCommandBuffers.push_back(new CommandBuffer(m_VulkanContext->getComputeCommandPool()));
+            }
+        }
     }
 
     void RenderManager::onResize() {
@@ -124,23 +285,38 @@ namespace Yare::Graphics {
             }
             m_CommandBuffers.clear();
 
+            for (auto commandBuffer : m_ComputeCommandBuffers) {
+                delete commandBuffer;
+            }
+            m_ComputeCommandBuffers.clear();
+
             for (auto frameBuffer : m_FrameBuffers) {
                 delete frameBuffer;
             }
             m_FrameBuffers.clear();
 
+            delete m_DepthPyramid;
+            m_DepthPyramid = nullptr;
             delete m_DepthBuffer;
-            delete m_RenderPass;
         }
         m_WindowWidth = m_WindowRef->getWindowProperties().width;
         m_WindowHeight = m_WindowRef->getWindowProperties().height;
         m_VulkanContext->onResize(m_WindowWidth, m_WindowHeight);
+
+        // The old render pass is only released once the new one exists, so unless the swapchain format changed the
+        // resource cache hands back the same vulkan render pass
+        RenderPass* oldRenderPass = m_RenderPass;
+        RenderPass* oldEarlyRenderPass = m_EarlyRenderPass;
+        m_EarlyRenderPass = nullptr;
         createRenderPass();
+        delete oldRenderPass;
+        delete oldEarlyRenderPass;
         createFrameBuffers();
         createCommandBuffers();
 
         for (auto renderer : m_Renderers) {
             renderer->onResize(m_RenderPass, m_WindowWidth, m_WindowHeight);
+            renderer->setOcclusionCulling(m_OcclusionCulling);
         }
     }
 }  // namespace Yare::Graphics
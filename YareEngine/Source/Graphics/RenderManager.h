@@ -1,6 +1,8 @@
 #ifndef YARE_RENDER_MANAGER_H
 #define YARE_RENDER_MANAGER_H
 
+#include "Graphics/AssetLoader.h"
+#include "Graphics/Renderers/DepthPyramid.h"
 #include "Graphics/Renderers/Renderer.h"
 #include "Graphics/Vulkan/CommandBuffer.h"
 #include "Graphics/Vulkan/Context.h"
@@ -25,22 +27,36 @@ namespace Yare::Graphics {
         void createRenderPass();
         void createFrameBuffers();
         void createCommandBuffers();
+        void dispatchCompute();
+        void renderEarlyPass();
         void onResize();
+        bool wantsOcclusionCulling() const;
+        void updateAssets();
 
        private:
         // Constructs the instance, devices and swapchain required for rendering
         VulkanContext*                m_VulkanContext;
         std::vector<Framebuffer*>     m_FrameBuffers;
         std::vector<CommandBuffer*>   m_CommandBuffers;
+        // Only used when the device has an async compute queue, otherwise compute is recorded into m_CommandBuffers
+        std::vector<CommandBuffer*>   m_ComputeCommandBuffers;
         RenderPass*                   m_RenderPass;
+        // Only created with occlusion culling, draws last frame's visible objects so their depth can be reduced
+        // into the depth pyramid before the main pass draws the rest
+        RenderPass*                   m_EarlyRenderPass = nullptr;
+        DepthPyramid*                 m_DepthPyramid = nullptr;
         Image*                        m_DepthBuffer;
         const std::shared_ptr<Window> m_WindowRef;
         // TODO: Find a better naming scheme
         std::vector<Renderer*> m_Renderers;
+        // Shared by the renderers, outlives them
+        AssetLoader* m_AssetLoader = nullptr;
 
         uint32_t m_CurrentBufferID = 0;
         uint32_t m_WindowWidth = 0;
         uint32_t m_WindowHeight = 0;
+        // What the current passes were built for, the setting itself can change at any point of a frame
+        bool m_OcclusionCulling = false;
     };
 }  // namespace Yare::Graphics
 
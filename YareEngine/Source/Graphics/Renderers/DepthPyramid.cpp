@@ -0,0 +1,117 @@
+#include "Graphics/Renderers/DepthPyramid.h"
+
+#include <algorithm>
+
+#include "Graphics/Vulkan/DescriptorSet.h"
+#include "Graphics/Vulkan/Devices.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr uint32_t GROUP_SIZE = 8;
+        constexpr VkFormat PYRAMID_FORMAT = VK_FORMAT_R32G32_SFLOAT;
+    }  // namespace
+
+    DepthPyramid::DepthPyramid(const Image* depthBuffer, uint32_t width, uint32_t height)
+        : m_DepthBuffer(depthBuffer), m_DepthWidth(width), m_DepthHeight(height) {
+        uint32_t pyramidWidth = (std::max)(width / 2, 1u);
+        uint32_t pyramidHeight = (std::max)(height / 2, 1u);
+        while ((std::max)(pyramidWidth, pyramidHeight) >> m_LevelCount) {
+            m_LevelCount++;
+        }
+        m_Pyramid = Image::createStorageImage(pyramidWidth, pyramidHeight, PYRAMID_FORMAT, m_LevelCount);
+
+        Shader shader("../Res/Shaders/GpuCulling", "depth_pyramid.shader");
+
+        // Binding 0 is the level being read, binding 1 the level being written
+        ComputePipelineInfo pInfo = {};
+        pInfo.shader = &shader;
+        pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants)};
+        VkDescriptorSetLayoutBinding source = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                                               VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+        VkDescriptorSetLayoutBinding destination = {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1,
+                                                    VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+        pInfo.setLayoutBindings = {{source, destination}};
+
+        m_Pipeline = new ComputePipeline();
+        m_Pipeline->init(pInfo);
+    }
+
+    DepthPyramid::~DepthPyramid() {
+        delete m_Pipeline;
+        delete m_Pyramid;
+    }
+
+    void DepthPyramid::build(CommandBuffer* commandBuffer) const {
+        // Last frame's pyramid is never read again, discarding it also waits for the culling that sampled it
+        commandBuffer->imageBarrier(m_Pyramid->getImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                    VK_ACCESS_SHADER_WRITE_BIT);
+
+        m_Pipeline->setActive(*commandBuffer);
+
+        uint32_t sourceWidth = m_DepthWidth;
+        uint32_t sourceHeight = m_DepthHeight;
+        for (uint32_t level = 0; level < m_LevelCount; level++) {
+            uint32_t destinationWidth = (std::max)(sourceWidth / 2, 1u);
+            uint32_t destinationHeight = (std::max)(sourceHeight / 2, 1u);
+
+            // The sets come from the per frame allocator, the views they point at change with every resize
+            DescriptorSet descriptorSet;
+            descriptorSet.init({nullptr, 1, 0, true, m_Pipeline->getDescriptorSetLayout(0)});
+
+            BufferInfo sourceInfo = {};
+            sourceInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            sourceInfo.binding = 0;
+            sourceInfo.descriptorCount = 1;
+            sourceInfo.imageViews = {level == 0 ? m_DepthBuffer->getImageView()
+                                                : m_Pyramid->getMipImageView(level - 1)};
+            sourceInfo.imageSamplers = {m_Pyramid->getSampler()};
+            sourceInfo.imageLayout =
+                level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+            BufferInfo destinationInfo = {};
+            destinationInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            destinationInfo.binding = 1;
+            destinationInfo.descriptorCount = 1;
+            destinationInfo.imageViews = {m_Pyramid->getMipImageView(level)};
+
+            std::vector<BufferInfo> bufferInfos = {sourceInfo, destinationInfo};
+            descriptorSet.update(bufferInfos);
+
+            PushConstants constants = {static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+                                       static_cast<int32_t>(destinationWidth),
+                                       static_cast<int32_t>(destinationHeight), level == 0 ? 1u : 0u};
+            vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                    m_Pipeline->getPipelineLayout(), 0, 1u, &descriptorSet.getDescriptorSet(0), 0,
+                                    nullptr);
+            vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_Pipeline->getPipelineLayout(),
+                               VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+            commandBuffer->dispatch(CommandBuffer::getGroupCount(destinationWidth, GROUP_SIZE),
+                                    CommandBuffer::getGroupCount(destinationHeight, GROUP_SIZE));
+
+            // The next level, and after the last one the culling, read what was just written
+            commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+            sourceWidth = destinationWidth;
+            sourceHeight = destinationHeight;
+        }
+    }
+
+    bool DepthPyramid::isSupported(VkFormat depthFormat) {
+        if (!Devices::instance()->hasStorageImageExtendedFormats()) {
+            return false;
+        }
+
+        VkFormatProperties pyramidProperties;
+        VkFormatProperties depthProperties;
+        vkGetPhysicalDeviceFormatProperties(Devices::instance()->getGPU(), PYRAMID_FORMAT, &pyramidProperties);
+        vkGetPhysicalDeviceFormatProperties(Devices::instance()->getGPU(), depthFormat, &depthProperties);
+
+        VkFormatFeatureFlags pyramidFeatures =
+            VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+        return (pyramidProperties.optimalTilingFeatures & pyramidFeatures) == pyramidFeatures &&
+               (depthProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,50 @@
+#ifndef YARE_DEPTH_PYRAMID_H
+#define YARE_DEPTH_PYRAMID_H
+
+#include "Graphics/Vulkan/CommandBuffer.h"
+#include "Graphics/Vulkan/ComputePipeline.h"
+#include "Graphics/Vulkan/Image.h"
+
+namespace Yare::Graphics {
+
+    // Mip chain of the depth buffer where every texel holds the nearest and farthest depth below it. Level 0 is half
+    // the size of the depth buffer and the last level is a single texel, so any screen rect can be tested against a
+    // handful of texels.
+    class DepthPyramid {
+       public:
+        // The depth buffer has to be sampled and stay alive as long as the pyramid does
+        DepthPyramid(const Image* depthBuffer, uint32_t width, uint32_t height);
+        ~DepthPyramid();
+
+        // Reduces the depth buffer into every level, recorded after the pass that wrote the depth has ended
+        void build(CommandBuffer* commandBuffer) const;
+
+        const VkImageView& getImageView() const { return m_Pyramid->getImageView(); }
+        const VkSampler&   getSampler() const { return m_Pyramid->getSampler(); }
+        uint32_t           getDepthWidth() const { return m_DepthWidth; }
+        uint32_t           getDepthHeight() const { return m_DepthHeight; }
+        uint32_t           getLevelCount() const { return m_LevelCount; }
+
+        // Needs rg32f storage images and a depth format that can be sampled
+        static bool isSupported(VkFormat depthFormat);
+
+       private:
+        struct PushConstants {
+            int32_t  sourceWidth;
+            int32_t  sourceHeight;
+            int32_t  destinationWidth;
+            int32_t  destinationHeight;
+            uint32_t depthSource;
+        };
+
+        const Image*     m_DepthBuffer;
+        Image*           m_Pyramid = nullptr;
+        ComputePipeline* m_Pipeline = nullptr;
+
+        uint32_t m_DepthWidth;
+        uint32_t m_DepthHeight;
+        uint32_t m_LevelCount = 1;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_DEPTH_PYRAMID_H
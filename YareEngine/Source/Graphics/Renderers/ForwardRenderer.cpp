@@ -1,8 +1,13 @@
 #include "Graphics/Renderers/ForwardRenderer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
+
 #include "Application/Application.h"
 #include "Application/GlobalSettings.h"
-#include "Core/Memory.h"
+#include "Core/Glfw.h"
 #include "Graphics/MeshFactory.h"
 #include "Graphics/Vulkan/Devices.h"
 #include "Graphics/Vulkan/Utilities.h"
@@ -10,19 +15,66 @@
 
 namespace Yare::Graphics {
 
-    ForwardRenderer::ForwardRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
-        m_Meshes.push_back(std::make_shared<Mesh>("../Res/Models/viking_room.obj"));
-        m_Meshes.emplace_back(createMesh(PrimativeShape::CUBE));
-        m_Meshes.emplace_back(createQuadPlane(15, 15));
-        m_Meshes.push_back(std::make_shared<Mesh>("../Res/Models/Lowpoly_tree_sample.obj"));
-
-        m_Materials.push_back(std::make_shared<Material>());  // Default texture 0
+    namespace {
+        // The box around a bounding sphere reaches out to its corners, sqrt(3) radii from the center
+        constexpr float BOX_CORNER_DISTANCE = 1.7320508f;
+        // Keeps the near plane from cutting into the boxes that are queried
+        constexpr float NEAR_PLANE_MARGIN = 0.25f;
+        constexpr float WORLD_CELL_SIZE = 16.0f;
+
+        // Slots of the texture array, the materials then two atlases per impostor. The lit and impostor shaders size
+        // their sampler array with specialization constant 0, which is set to this.
+        uint32_t getTextureSlotCount() {
+            return (std::min)(TextureStreamer::MAX_TEXTURES,
+                              Devices::instance()->getGPUProperties().limits.maxPerStageDescriptorSamplers);
+        }
+    }  // namespace
+
+    ForwardRenderer::ForwardRenderer(StartupLoader& startupLoader, AssetLoader& assetLoader)
+        : m_AssetLoader(&assetLoader) {
+        // The models and textures are read and decoded on the workers, the scene is set up once they are uploaded
+        m_Meshes.resize(4);
+        m_LoadingMeshes.emplace_back(0, m_AssetLoader->loadMesh("../Res/Models/viking_room.obj"));
+        m_Meshes[1].reset(createMesh(PrimativeShape::CUBE));
+        m_Meshes[2].reset(createQuadPlane(15, 15));
+        m_LoadingMeshes.emplace_back(3, m_AssetLoader->loadMesh("../Res/Models/Lowpoly_tree_sample.obj"));
+
+        // The default texture is also what the impostors are baked from, so it is always whole
+        m_Materials.push_back(nullptr);  // Default texture 0
+        m_LoadingDefaultTexture = m_AssetLoader->loadTexture("../Res/Textures/default.jpg");
         m_Materials.push_back(std::make_shared<Material>("../Res/Textures/viking_room.png")); //1
         m_Materials.push_back(std::make_shared<Material>("../Res/Textures/mossytiles.jpg")); // 2
         m_Materials.push_back(std::make_shared<Material>("../Res/Textures/skysphere.png")); // 3
         m_Materials.push_back(std::make_shared<Material>("../Res/Textures/sprite.jpg")); // 4
         m_Materials.push_back(std::make_shared<Material>("../Res/Textures/tile.png")); // 5
 
+        m_TextureStreamer = std::make_unique<TextureStreamer>();
+        for (size_t i = 1; i < m_Materials.size(); i++) {
+            std::shared_ptr<Material> material = m_Materials[i];
+            auto prepared = std::make_shared<std::unique_ptr<TextureStreamer::StreamedTexture>>();
+            startupLoader.add(
+                material->getFilePaths()[0],
+                [this, material, prepared]() { *prepared = m_TextureStreamer->prepareMaterial(material); },
+                [this, material, prepared]() { m_TextureStreamer->addMaterial(material, std::move(*prepared)); });
+        }
+    }
+
+    void ForwardRenderer::createScene() {
+        for (const auto& mesh : m_LoadingMeshes) {
+            m_Meshes[mesh.first] = m_AssetLoader->wait(mesh.second);
+            if (!m_Meshes[mesh.first]) {
+                YZ_CRITICAL("'" + mesh.second.getPath() + "' could not be loaded.");
+            }
+        }
+        m_LoadingMeshes.clear();
+        // A file the loader couldn't decode is loaded once more on its own, which reports what is wrong with it
+        m_Materials[0] = m_AssetLoader->wait(m_LoadingDefaultTexture);
+        if (!m_Materials[0]) {
+            m_Materials[0] = std::make_shared<Material>();
+            m_Materials[0]->loadTextures();
+        }
+        m_LoadingDefaultTexture = {};
+
         Transform transform{glm::vec3(3.0f, -0.42f, 0.0f), glm::radians(glm::vec3(90.0f, 90.0f, -180.0f)), glm::vec3(1.0f, 1.0f, 1.0f)};
         m_Entities.push_back(std::make_shared<Entity>(m_Meshes[0], m_Materials[1], transform));
         Transform transform2;
@@ -37,85 +89,386 @@ namespace Yare::Graphics {
         transform2.setTranslation(-1.5f, 0.0f, 0.0f);
         m_Entities.push_back(std::make_shared<Entity>(m_Meshes[1], m_Materials[3], transform2)); // cube
 
-        init(renderPass, windowWidth, windowHeight);
+        // A row of trees further back, to see the levels of detail change with distance
+        for (float z : {-4.0f, -6.5f}) {
+            for (float x : {-6.0f, -3.0f, 0.0f, 3.0f, 6.0f}) {
+                transform3.setTranslation(x, -0.5f, z);
+                m_Entities.push_back(std::make_shared<Entity>(m_Meshes[3], m_Materials[0], transform3));
+            }
+        }
+        m_StaticEntityCount = m_Entities.size();
+        m_StaticMaterialCount = m_Materials.size();
+
+        // And a forest in the distance, mostly drawn as impostors, and a few rooms further out. Both are streamed in
+        // cells around the camera, the tree mesh and default material stay resident for the trees near the origin.
+        WorldPartitionSettings partitionSettings;
+        partitionSettings.cellSize = WORLD_CELL_SIZE;
+        m_WorldPartition = std::make_unique<WorldPartition>(*m_AssetLoader, partitionSettings);
+        m_WorldPartition->addResidentMaterial("", m_Materials[0]);
+        // The files loaded here are shared with the cells through the asset loader, so the rooms far out use the
+        // same mesh and texture. The streamed textures are added to it, the meshes were loaded by it. They are all
+        // resident for the partition too, which keeps them out of its materials.
+        std::pair<size_t, std::string> meshPaths[] = {{0, "../Res/Models/viking_room.obj"},
+                                                      {3, "../Res/Models/Lowpoly_tree_sample.obj"}};
+        for (const auto& mesh : meshPaths) {
+            m_WorldPartition->addResidentMesh(mesh.second, m_Meshes[mesh.first]);
+        }
+        for (size_t i = 1; i < m_StaticMaterialCount; i++) {
+            const std::string& path = m_Materials[i]->getFilePaths()[0];
+            m_AssetLoader->addMaterial(path, m_Materials[i]);
+            m_WorldPartition->addResidentMaterial(path, m_Materials[i]);
+        }
+
+        std::map<std::pair<int32_t, int32_t>, CellManifest> cells;
+        auto addToCell = [&](const CellEntity& entity) {
+            glm::vec3     position = entity.transform.getTranslation();
+            auto          key = std::make_pair(static_cast<int32_t>(std::floor(position.x / WORLD_CELL_SIZE)),
+                                               static_cast<int32_t>(std::floor(position.z / WORLD_CELL_SIZE)));
+            CellManifest& cell = cells[key];
+            cell.x = key.first;
+            cell.z = key.second;
+            cell.entities.push_back(entity);
+        };
+        for (int row = 0; row < 8; row++) {
+            for (int column = 0; column < 16; column++) {
+                float offset = (row % 2) * 1.5f;
+                transform3.setTranslation(-22.5f + column * 3.0f + offset, -0.5f, -15.0f - row * 3.0f);
+                addToCell({"../Res/Models/Lowpoly_tree_sample.obj", "", transform3});
+            }
+        }
+        for (float x : {-45.0f, 45.0f}) {
+            for (float z : {-45.0f, 45.0f}) {
+                transform.setTranslation(x, -0.42f, z);
+                addToCell({"../Res/Models/viking_room.obj", "../Res/Textures/viking_room.png", transform});
+            }
+        }
+        for (const auto& cell : cells) {
+            m_WorldPartition->addCell(cell.second);
+        }
+
+        // The cubes are cheap enough to be their own occluders, the room is far too detailed and gets a proxy. The
+        // plane can be seen through from below, so it doesn't occlude anything.
+        m_Meshes[0]->createOccluderProxy();
+        m_Meshes[1]->createOccluderFromMesh();
+        m_Entities[0]->setOccluder(true);
+        m_Entities[3]->setOccluder(true);
+        m_Entities[4]->setOccluder(true);
     }
 
     ForwardRenderer::~ForwardRenderer() {
-        if (m_UboDynamicData.model) {
-            alignedFree(m_UboDynamicData.model);
-        }
+        delete m_GpuScene;
+        delete m_OcclusionQueries;
 
         delete m_Pipeline;
+        delete m_DepthPipeline;
+        delete m_ImpostorPipeline;
+        delete m_FrameSetTemplate;
+        delete m_MaterialDescriptorSet;
+        for (auto drawDescriptorSet : m_DrawDescriptorSets) {
+            delete drawDescriptorSet;
+        }
+        delete m_ObjectDrawDescriptorSet;
 
         delete m_UniformBuffers.view;
-        delete m_UniformBuffers.dynamic;
     }
 
     void ForwardRenderer::init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
-        for (auto material : m_Materials) {
-            material->loadTextures();
+        m_Height = windowHeight;
+        createScene();
+
+        // The trees are baked once their texture is loaded, every tree shares the impostor
+        m_Impostors.push_back(std::make_shared<Impostor>(*m_Meshes[3], *m_Materials[0]));
+        for (auto entity : m_Entities) {
+            if (entity->getMesh() == m_Meshes[3]) {
+                entity->setImpostor(m_Impostors[0]);
+            }
         }
 
         createGraphicsPipeline(renderPass, windowWidth, windowHeight);
+        createImpostorPipeline(renderPass, windowWidth, windowHeight);
+        m_GpuScene = new GpuScene();
+        m_OcclusionQueries = new OcclusionQueries(renderPass, windowWidth, windowHeight);
 
         prepareUniformBuffers();
 
         createDescriptorSets();
     }
 
+    void ForwardRenderer::onAssetsLoaded(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
+        init(renderPass, windowWidth, windowHeight);
+    }
+
     void ForwardRenderer::prepareScene() {
-        resetCommandQueue();
+        // Runs between frames, so cells can come and go with nothing in flight still using them
+        if (m_WorldPartition->update(getLodParams().cameraPosition)) {
+            updateStreamedCells();
+        }
+        const WorldPartitionStats& partitionStats = m_WorldPartition->getStats();
+        GlobalSettings::instance()->residentCellCount = static_cast<int>(partitionStats.residentCellCount);
+        GlobalSettings::instance()->loadingCellCount = static_cast<int>(partitionStats.loadingCellCount);
+        GlobalSettings::instance()->cellMegabytes = static_cast<float>(partitionStats.residentBytes) / (1 << 20);
+
+        // Also between frames, a texture that got other levels is a new image the descriptors have to point at
+        if (m_TextureStreamer->update()) {
+            updateMaterialDescriptorSet();
+        }
+        const TextureStreamerStats& streamerStats = m_TextureStreamer->getStats();
+        GlobalSettings::instance()->loadingTextureCount = static_cast<int>(streamerStats.loadingCount);
+        GlobalSettings::instance()->textureMegabytes = static_cast<float>(streamerStats.residentBytes) / (1 << 20);
+        GlobalSettings::instance()->fullTextureMegabytes = static_cast<float>(streamerStats.fullBytes) / (1 << 20);
+
+        // The gpu works out what to draw every frame, the cpu only rebuilds the scene when it changes
+        auto settings = GlobalSettings::instance();
+        if (settings->impostors != m_SceneSettings.impostors ||
+            settings->meshletCulling != m_SceneSettings.meshletCulling) {
+            m_SceneSettings.impostors = settings->impostors;
+            m_SceneSettings.meshletCulling = settings->meshletCulling;
+            m_SceneDirty = true;
+        }
+        if (m_SceneDirty) {
+            resetCommandQueue();
+            for (const auto entity : m_Entities) {
+                submit(entity.get());
+            }
+
+            m_GpuScene->build(m_CommandQueue, m_SceneSettings);
+            m_OcclusionQueries->setObjectCount(m_GpuScene->getObjectCount());
+            updateDrawDescriptorSets();
+            m_SceneDirty = false;
+        }
+
+        cullOccluded();
+        readOcclusionQueries();
 
-        for (const auto entity : m_Entities) {
-            submit(entity.get());
+        // The view and the set pointing at it are the same for every pass of the frame, the frame's descriptor
+        // allocator was reset before this runs
+        updateViewBuffer();
+        m_FrameDescriptorSet = createFrameDescriptorSet();
+    }
+
+    void ForwardRenderer::readOcclusionQueries() {
+        auto settings = GlobalSettings::instance();
+        // Results left over from the last time the queries were on are too old to trust
+        if (settings->occlusionQueries && !m_OcclusionQueriesActive) {
+            m_OcclusionQueries->setObjectCount(m_GpuScene->getObjectCount());
+        }
+        m_OcclusionQueriesActive = settings->occlusionQueries;
+        if (!m_OcclusionQueriesActive) {
+            return;
         }
+
+        m_OcclusionQueries->readResults();
+        settings->queryCount = static_cast<int>(m_OcclusionQueries->getQueryCount());
+        settings->queryOccludedCount = static_cast<int>(m_OcclusionQueries->getOccludedCount());
     }
 
-    void ForwardRenderer::present(CommandBuffer* commandBuffer) {
+    void ForwardRenderer::cullOccluded() {
+        auto settings = GlobalSettings::instance();
+        if (!settings->cpuOcclusionCulling) {
+            m_GpuScene->setCpuVisibility({});
+            return;
+        }
+
+        // Object ids follow the order the entities were submitted in, so the flags map straight onto the objects
+        m_OcclusionCuller.cull(m_Entities, getViewProjection());
+        m_GpuScene->setCpuVisibility(m_OcclusionCuller.getVisibility());
+
+        const OcclusionCullingStats& stats = m_OcclusionCuller.getStats();
+        settings->cpuOccludedCount = stats.occludedCount;
+        settings->cpuTestedCount = stats.testedCount;
+        settings->cpuRasterizeTime = stats.rasterizeTime;
+    }
+
+    void ForwardRenderer::dispatch(CommandBuffer* commandBuffer) {
+        if (GlobalSettings::instance()->displayModels) {
+            float time = static_cast<float>(glfwGetTime() - m_StartTime);
+            m_GpuScene->dispatch(commandBuffer, Frustum::fromMatrix(getViewProjection()), getLodParams(), time,
+                                 m_OcclusionCulling);
+        }
+    }
+
+    void ForwardRenderer::recordPrePass(CommandBuffer* commandBuffer) {
+        if (m_OcclusionQueriesActive) {
+            m_OcclusionQueries->beginFrame(commandBuffer);
+        }
+    }
+
+    void ForwardRenderer::presentEarly(CommandBuffer* commandBuffer) {
+        if (!GlobalSettings::instance()->displayModels) {
+            return;
+        }
+        drawScene(commandBuffer, CULL_PHASE_EARLY);
+    }
+
+    void ForwardRenderer::dispatchLate(CommandBuffer* commandBuffer, const DepthPyramid& depthPyramid) {
         if (GlobalSettings::instance()->displayModels) {
-            int index = 0;
-            for (auto& command : m_CommandQueue) {
-                uint32_t dynamicOffset = index * static_cast<uint32_t>(m_DynamicAlignment);
-                updateUniformBuffers(index, command.entity->getTransform());
-                m_Pipeline->setActive(*commandBuffer);
-
-                int imageIdx = command.entity->getMaterial()->getImageIdx();
-                vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_Pipeline->getPipelineLayout(),
-                                   VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(int), (void*)&imageIdx);
-
-                vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                        m_Pipeline->getPipelineLayout(), 0u, 1u, &m_DescriptorSet->getDescriptorSet(0),
-                                        1, &dynamicOffset);
-
-                command.entity->getMesh()->getVertexBuffer()->bindVertex(commandBuffer, 0);
-                command.entity->getMesh()->getIndexBuffer()->bindIndex(commandBuffer, VK_INDEX_TYPE_UINT32);
-
-                auto indicesCount = command.entity->getMesh()->getIndexBuffer()->getSize() / sizeof(uint32_t);
-                vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), static_cast<uint32_t>(indicesCount), 1, 0, 0, 0);
-                index++;
+            m_GpuScene->dispatchLate(commandBuffer, getViewProjection(), getLodParams(), depthPyramid);
+        }
+    }
+
+    void ForwardRenderer::present(CommandBuffer* commandBuffer) {
+        if (!GlobalSettings::instance()->displayModels) {
+            return;
+        }
+        if (m_OcclusionQueriesActive) {
+            drawSceneWithQueries(commandBuffer);
+        } else {
+            drawScene(commandBuffer, m_OcclusionCulling ? CULL_PHASE_LATE : CULL_PHASE_EARLY);
+        }
+    }
+
+    void ForwardRenderer::bindScene(CommandBuffer* commandBuffer, DescriptorSet* drawDescriptorSet,
+                                    Pipeline* pipeline) {
+        pipeline->setActive(*commandBuffer);
+
+        // All three sets stay bound for the whole pass, the draws find their objects through firstInstance
+        VkDescriptorSet passSets[] = {m_FrameDescriptorSet, m_MaterialDescriptorSet->getDescriptorSet(0),
+                                      drawDescriptorSet->getDescriptorSet(0)};
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                pipeline->getPipelineLayout(), PER_FRAME, 3u, passSets, 0, nullptr);
+    }
+
+    void ForwardRenderer::drawScene(CommandBuffer* commandBuffer, CullPhase phase) {
+        if (GlobalSettings::instance()->depthPrepass) {
+            bindScene(commandBuffer, m_DrawDescriptorSets[phase], m_DepthPipeline);
+            m_GpuScene->draw(commandBuffer, phase, true);
+        }
+        bindScene(commandBuffer, m_DrawDescriptorSets[phase], m_Pipeline);
+        m_GpuScene->draw(commandBuffer, phase);
+        drawImpostors(commandBuffer, phase);
+    }
+
+    void ForwardRenderer::drawImpostors(CommandBuffer* commandBuffer, CullPhase phase) {
+        const auto& sceneImpostors = m_GpuScene->getImpostors();
+        if (sceneImpostors.empty()) {
+            return;
+        }
+
+        // The push constants make the layout incompatible with the mesh pipeline's, so the sets are bound again
+        bindScene(commandBuffer, m_DrawDescriptorSets[phase], m_ImpostorPipeline);
+        for (uint32_t i = 0; i < sceneImpostors.size(); i++) {
+            auto impostor = std::find_if(m_Impostors.begin(), m_Impostors.end(),
+                                         [&](const auto& owned) { return owned.get() == sceneImpostors[i]; });
+            if (impostor == m_Impostors.end()) {
+                continue;
             }
+
+            uint32_t              firstImage = static_cast<uint32_t>(m_Materials.size() +
+                                                        2 * std::distance(m_Impostors.begin(), impostor));
+            ImpostorPushConstants constants = {firstImage, firstImage + 1, (*impostor)->getFramesPerSide()};
+            vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_ImpostorPipeline->getPipelineLayout(),
+                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants),
+                               &constants);
+            m_GpuScene->drawImpostor(commandBuffer, phase, i);
         }
     }
 
-    void ForwardRenderer::onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) {
-        // Cleanup
-        {
-            if (m_UboDynamicData.model) {
-                alignedFree(m_UboDynamicData.model);
+    void ForwardRenderer::drawSceneWithQueries(CommandBuffer* commandBuffer) {
+        if (m_GpuScene->getObjectCount() == 0) {
+            return;
+        }
+
+        // Objects are drawn one by one as whole meshes here, impostors and meshlets only go through the gpu culled path
+        bindScene(commandBuffer, m_ObjectDrawDescriptorSet, m_Pipeline);
+        m_GpuScene->bindGeometry(commandBuffer);
+
+        glm::mat4 viewProjection = getViewProjection();
+        Frustum   frustum = Frustum::fromMatrix(viewProjection);
+        LodParams lodParams = getLodParams();
+        glm::vec3 cameraPosition = lodParams.cameraPosition;
+        Buffer*   predicateBuffer = m_OcclusionQueries->getPredicateBuffer();
+
+        // Object ids follow the order the entities were submitted in. The proxies are drawn after every object so
+        // they test against the depth of the whole scene.
+        std::vector<std::pair<uint32_t, glm::mat4>> proxies;
+        int                                         trianglesSaved = 0;
+        for (uint32_t object = 0; object < m_GpuScene->getObjectCount(); object++) {
+            const Entity*    entity = m_CommandQueue[object].entity;
+            const glm::mat4  model = entity->getTransform().getMatrix();
+            const glm::vec4& sphere = entity->getMesh()->getBoundingSphere();
+
+            glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+            float     scale = (std::max)({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                          glm::length(glm::vec3(model[2]))});
+            float     radius = sphere.w * scale;
+            if (!frustum.intersectsSphere(center, radius)) {
+                continue;
             }
 
-            delete m_Pipeline;
+            // Same choice as the culling shaders make, from the point of the sphere nearest the camera
+            float    distance = (std::max)(glm::distance(cameraPosition, center) - radius, 0.0f);
+            uint32_t lod = distance > 0.0f
+                               ? selectLod(entity->getMesh()->getLods(), scale * lodParams.errorScale / distance)
+                               : 0;
+
+            // With conditional rendering the gpu reads the same results the cpu has, the cpu only keeps count
+            if (predicateBuffer) {
+                commandBuffer->beginConditionalRendering(predicateBuffer->getBuffer(), object * sizeof(uint32_t));
+                m_GpuScene->drawObject(commandBuffer, object, lod);
+                commandBuffer->endConditionalRendering();
+            } else if (m_OcclusionQueries->isVisible(object)) {
+                m_GpuScene->drawObject(commandBuffer, object, lod);
+            }
+            if (!m_OcclusionQueries->isVisible(object)) {
+                trianglesSaved += static_cast<int>(m_GpuScene->getObjectIndexCount(object, lod) / 3);
+            }
+
+            // From inside its box an object can't be hidden, so it isn't queried and stays visible
+            if (glm::distance(cameraPosition, center) > radius * BOX_CORNER_DISTANCE + NEAR_PLANE_MARGIN) {
+                glm::mat4 box = glm::translate(glm::mat4(1.0f), glm::vec3(sphere)) *
+                                glm::scale(glm::mat4(1.0f), glm::vec3(sphere.w));
+                proxies.emplace_back(object, viewProjection * model * box);
+            }
+        }
+        GlobalSettings::instance()->queryTrianglesSaved = trianglesSaved;
 
-            delete m_UniformBuffers.view;
-            delete m_UniformBuffers.dynamic;
+        m_OcclusionQueries->beginProxies(commandBuffer);
+        for (const auto& proxy : proxies) {
+            m_OcclusionQueries->drawProxy(commandBuffer, proxy.first, proxy.second);
         }
+    }
+
+    glm::mat4 ForwardRenderer::getViewProjection() const {
+        auto      camera = Application::getAppInstance()->getWindow()->getCamera();
+        glm::mat4 projection = camera->getProjectionMatrix();
+        projection[1][1] *= -1;
+        return projection * camera->getViewMatrix();
+    }
+
+    LodParams ForwardRenderer::getLodParams() const {
+        auto camera = Application::getAppInstance()->getWindow()->getCamera();
+
+        // An error of one unit at distance one covers this many pixels, the bias halves it per step
+        LodParams lodParams = {};
+        lodParams.cameraPosition = glm::vec3(glm::inverse(camera->getViewMatrix())[3]);
+        lodParams.errorScale = camera->getProjectionMatrix()[1][1] * static_cast<float>(m_Height) * 0.5f /
+                               std::exp2(GlobalSettings::instance()->lodBias);
+        return lodParams;
+    }
+
+    void ForwardRenderer::onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) {
+        m_Height = newHeight;
+        // The set layouts come from the resource cache, so the rebuilt pipeline stays compatible with the
+        // descriptor sets and buffers we already have. The old pipeline is deleted last so it still holds a
+        // reference to those layouts while the new one is created.
+        Pipeline* oldPipeline = m_Pipeline;
+        Pipeline* oldDepthPipeline = m_DepthPipeline;
+        Pipeline* oldImpostorPipeline = m_ImpostorPipeline;
         createGraphicsPipeline(renderPass, newWidth, newHeight);
-        prepareUniformBuffers();
-        createDescriptorSets();
+        createImpostorPipeline(renderPass, newWidth, newHeight);
+        delete oldPipeline;
+        delete oldDepthPipeline;
+        delete oldImpostorPipeline;
+
+        m_OcclusionQueries->onResize(renderPass, newWidth, newHeight);
     }
 
     void ForwardRenderer::createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height) {
-        Shader shader("../Res/Shaders/TextureArrayDiffuse", "texture_array_diffuse.shader");
+        // Without stores from fragment shaders nothing reports the sampled levels, the textures are loaded whole
+        std::string shaderName = Devices::instance()->hasFragmentStoresAndAtomics()
+                                     ? "texture_array_diffuse.shader"
+                                     : "texture_array_diffuse_whole.shader";
+        Shader      shader("../Res/Shaders/TextureArrayDiffuse", shaderName);
 
         PipelineInfo pInfo = {};
         pInfo.shader = &shader;
@@ -123,65 +476,118 @@ namespace Yare::Graphics {
         pInfo.cullMode = VK_CULL_MODE_BACK_BIT;
         pInfo.depthTestEnable = VK_TRUE;
         pInfo.depthWriteEnable = VK_TRUE;
-        pInfo.maxObjects = 2;
+        // Equal depths pass so the fragments the depth prepass left are still shaded
+        pInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
         pInfo.width = width;
         pInfo.height = height;
-        pInfo.pushConstants = {VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(int)};
-        pInfo.bindingDescription = VkVertexInputBindingDescription{0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX};
-
-        // location, binding, format, offset
-        VkVertexInputAttributeDescription pos = {0u, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, pos)};
-        VkVertexInputAttributeDescription color = {1u, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)};
-        VkVertexInputAttributeDescription normal = {2u, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal)};
-        VkVertexInputAttributeDescription uv = {3u, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv)};
-        pInfo.vertexInputAttributes = {pos, color, normal, uv};
+        pInfo.bindingDescriptions = GpuScene::VERTEX_LAYOUT.getBindingDescriptions();
+        pInfo.vertexInputAttributes = GpuScene::VERTEX_LAYOUT.getAttributeDescriptions();
 
         // binding, descriptorType, descriptorCount, stageFlags, pImmuatbleSamplers
         VkDescriptorSetLayoutBinding projView = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
                                                  nullptr};
-        VkDescriptorSetLayoutBinding model = {1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
-                                              VK_SHADER_STAGE_VERTEX_BIT, nullptr};
-        VkDescriptorSetLayoutBinding sampler = {2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (std::min)(256u, Devices::instance()->getGPUProperties().limits.maxPerStageDescriptorSamplers),
+        VkDescriptorSetLayoutBinding sampler = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, getTextureSlotCount(),
                                                 VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
-        pInfo.layoutBindings = {projView, model, sampler};
+        VkDescriptorSetLayoutBinding textureFeedback = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                                                        VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        VkDescriptorSetLayoutBinding models = {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                               nullptr};
+        VkDescriptorSetLayoutBinding visibleInstances = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                                                         VK_SHADER_STAGE_VERTEX_BIT, nullptr};
+        VkDescriptorSetLayoutBinding objects = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                                nullptr};
+        // Set 0 per frame, set 1 per material, set 2 per draw
+        pInfo.setLayoutBindings = {{projView}, {sampler, textureFeedback}, {models, visibleInstances, objects}};
+        pInfo.specializationConstants = {getTextureSlotCount()};
 
         m_Pipeline = new Pipeline();
         m_Pipeline->init(pInfo);
+
+        // The prepass shares the set layouts, so the sets bound for it are the ones the lit pass uses
+        Shader depthShader("../Res/Shaders/DepthOnly", "depth_only.shader");
+        pInfo.shader = &depthShader;
+        pInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+        pInfo.bindingDescriptions = GpuScene::VERTEX_LAYOUT.getPositionBindingDescriptions();
+        pInfo.vertexInputAttributes = GpuScene::VERTEX_LAYOUT.getPositionAttributeDescriptions();
+        pInfo.colorWriteEnabled = false;
+
+        m_DepthPipeline = new Pipeline();
+        m_DepthPipeline->init(pInfo);
+    }
+
+    void ForwardRenderer::createImpostorPipeline(RenderPass* renderPass, uint32_t width, uint32_t height) {
+        Shader shader("../Res/Shaders/Impostor", "impostor.shader");
+
+        // The quad's corners come from the vertex index, so there are no attributes. The set bindings match the
+        // mesh pipeline's, which lets both share the same sets.
+        PipelineInfo pInfo = {};
+        pInfo.shader = &shader;
+        pInfo.renderpass = renderPass;
+        pInfo.cullMode = VK_CULL_MODE_NONE;
+        pInfo.depthTestEnable = VK_TRUE;
+        pInfo.depthWriteEnable = VK_TRUE;
+        pInfo.width = width;
+        pInfo.height = height;
+        pInfo.pushConstants = {VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                               sizeof(ImpostorPushConstants)};
+
+        uint32_t samplerCount = getTextureSlotCount();
+        VkDescriptorSetLayoutBinding projView = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                                 nullptr};
+        VkDescriptorSetLayoutBinding sampler = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, samplerCount,
+                                                VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        VkDescriptorSetLayoutBinding textureFeedback = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                                                        VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        VkDescriptorSetLayoutBinding models = {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                               nullptr};
+        VkDescriptorSetLayoutBinding visibleInstances = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                                                         VK_SHADER_STAGE_VERTEX_BIT, nullptr};
+        VkDescriptorSetLayoutBinding objects = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                                nullptr};
+        pInfo.setLayoutBindings = {{projView}, {sampler, textureFeedback}, {models, visibleInstances, objects}};
+        pInfo.specializationConstants = {samplerCount};
+
+        m_ImpostorPipeline = new Pipeline();
+        m_ImpostorPipeline->init(pInfo);
     }
 
     void ForwardRenderer::createDescriptorSets() {
-        DescriptorSetInfo descriptorSetInfo;
-        descriptorSetInfo.descriptorSetCount = 1;
-        descriptorSetInfo.pipeline = m_Pipeline;
-
-        // First create the descriptor set, but the buffers are empty
-        m_DescriptorSet = new DescriptorSet();
-        m_DescriptorSet->init(descriptorSetInfo);
-
-        std::vector<BufferInfo> bufferInfos = {};
-        BufferInfo              viewBufferInfo = {};
-        viewBufferInfo.buffer = m_UniformBuffers.view->getBuffer();
-        viewBufferInfo.offset = 0;
-        viewBufferInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        viewBufferInfo.size = sizeof(UniformVS);
-        viewBufferInfo.binding = 0;
-        viewBufferInfo.descriptorCount = 1;
-
-        BufferInfo dynamicBufferInfo = {};
-        dynamicBufferInfo.buffer = m_UniformBuffers.dynamic->getBuffer();
-        dynamicBufferInfo.offset = 0;
-        dynamicBufferInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-        dynamicBufferInfo.size = sizeof(glm::mat4);
-        dynamicBufferInfo.binding = 1;
-        dynamicBufferInfo.descriptorCount = 1;
-
-        bufferInfos.push_back(viewBufferInfo);
-        bufferInfos.push_back(dynamicBufferInfo);
+        // Per material set, the texture array is written once and bound for the whole pass
+        m_MaterialDescriptorSet = new DescriptorSet();
+        m_MaterialDescriptorSet->init({m_Pipeline, 1, PER_MATERIAL});
 
+        updateMaterialDescriptorSet();
+
+        // Per draw sets, written whenever the gpu scene is rebuilt
+        for (auto& drawDescriptorSet : m_DrawDescriptorSets) {
+            drawDescriptorSet = new DescriptorSet();
+            drawDescriptorSet->init({m_Pipeline, 1, PER_DRAW});
+        }
+        m_ObjectDrawDescriptorSet = new DescriptorSet();
+        m_ObjectDrawDescriptorSet->init({m_Pipeline, 1, PER_DRAW});
+
+        // The per frame set is allocated every frame from the transient allocator, so it's written with a template
+        VkDescriptorUpdateTemplateEntry viewEntry = {};
+        viewEntry.dstBinding = 0;
+        viewEntry.dstArrayElement = 0;
+        viewEntry.descriptorCount = 1;
+        viewEntry.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        viewEntry.offset = offsetof(FrameSetData, view);
+        viewEntry.stride = sizeof(VkDescriptorBufferInfo);
+        m_FrameSetTemplate = new DescriptorUpdateTemplate(m_Pipeline->getDescriptorSetLayout(PER_FRAME), {viewEntry});
+    }
+
+    void ForwardRenderer::updateMaterialDescriptorSet() {
+        std::vector<BufferInfo> materialInfos = {};
         BufferInfo imageBufferInfo = {};
         imageBufferInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        imageBufferInfo.binding = 2;
-        imageBufferInfo.descriptorCount = (std::min)(256u, Devices::instance()->getGPUProperties().limits.maxPerStageDescriptorSamplers);
+        imageBufferInfo.binding = 0;
+        imageBufferInfo.descriptorCount = getTextureSlotCount();
+        // updateStreamedCells leaves out the materials that don't fit, the renderer's own always have to
+        if (m_Materials.size() + 2 * m_Impostors.size() > imageBufferInfo.descriptorCount) {
+            YZ_CRITICAL(STR(m_Materials.size()) + " materials and " + STR(m_Impostors.size()) +
+                        " impostors don't fit the " + STR(imageBufferInfo.descriptorCount) + " texture slots.");
+        }
 
         int imageIdx = 0;
         for (auto material : m_Materials) {
@@ -189,41 +595,105 @@ namespace Yare::Graphics {
             imageBufferInfo.imageViews.push_back(material->getTextureImage()->getImageView());
             material->setImageIdx(imageIdx++);
         }
+        for (const auto& impostor : m_Impostors) {
+            for (const Image* atlas : {impostor->getAlbedoAtlas(), impostor->getNormalDepthAtlas()}) {
+                imageBufferInfo.imageSamplers.push_back(atlas->getSampler());
+                imageBufferInfo.imageViews.push_back(atlas->getImageView());
+            }
+        }
 
-        for (size_t i = m_Materials.size(); i < std::min(256u, Devices::instance()->getGPUProperties().limits.maxPerStageDescriptorSamplers); i++) {
+        for (size_t i = imageBufferInfo.imageViews.size(); i < imageBufferInfo.descriptorCount; i++) {
             imageBufferInfo.imageSamplers.push_back(m_Materials[0]->getTextureImage()->getSampler());
             imageBufferInfo.imageViews.push_back(m_Materials[0]->getTextureImage()->getImageView());
         }
 
-        bufferInfos.push_back(imageBufferInfo);
+        materialInfos.push_back(imageBufferInfo);
+
+        BufferInfo feedbackBufferInfo = {};
+        feedbackBufferInfo.buffer = m_TextureStreamer->getFeedbackBuffer()->getBuffer();
+        feedbackBufferInfo.offset = 0;
+        feedbackBufferInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        feedbackBufferInfo.size = static_cast<uint32_t>(m_TextureStreamer->getFeedbackBuffer()->getSize());
+        feedbackBufferInfo.binding = 1;
+        feedbackBufferInfo.descriptorCount = 1;
+        materialInfos.push_back(feedbackBufferInfo);
+        m_MaterialDescriptorSet->update(materialInfos);
+    }
 
-        m_DescriptorSet->update(bufferInfos);
+    void ForwardRenderer::updateStreamedCells() {
+        // The streamed entities and materials follow the ones the renderer owns, the indices of which never change
+        m_Entities.resize(m_StaticEntityCount);
+        for (const auto& entity : m_WorldPartition->getEntities()) {
+            if (entity->getMesh() == m_Meshes[3]) {
+                entity->setImpostor(m_Impostors[0]);
+            }
+            m_Entities.push_back(entity);
+        }
+
+        // The impostor atlases follow the materials in the texture array, materials past its end are drawn with the
+        // default texture
+        std::vector<std::shared_ptr<Material>> materials = m_WorldPartition->getMaterials();
+        size_t slotCount = getTextureSlotCount() - 2 * m_Impostors.size() - m_StaticMaterialCount;
+        if (materials.size() > slotCount) {
+            YZ_WARN(STR(materials.size() - slotCount) + " streamed materials don't fit the texture array.");
+            for (size_t i = slotCount; i < materials.size(); i++) {
+                materials[i]->setImageIdx(0);
+            }
+            materials.resize(slotCount);
+        }
+        m_Materials.resize(m_StaticMaterialCount);
+        m_Materials.insert(m_Materials.end(), materials.begin(), materials.end());
+
+        updateMaterialDescriptorSet();
+        m_SceneDirty = true;
     }
 
-    void ForwardRenderer::prepareUniformBuffers() {
-        VkDeviceSize viewBufferSize = sizeof(UniformVS);
+    void ForwardRenderer::updateDrawDescriptorSets() {
+        // The sets only differ in the instance list at binding 1
+        std::vector<std::pair<DescriptorSet*, Buffer*>> drawSets = {
+            {m_ObjectDrawDescriptorSet, m_GpuScene->getObjectInstanceBuffer()}};
+        for (int phase = 0; phase < CULL_PHASE_COUNT; phase++) {
+            drawSets.emplace_back(m_DrawDescriptorSets[phase],
+                                  m_GpuScene->getVisibleInstanceBuffer(static_cast<CullPhase>(phase)));
+        }
 
-        m_DynamicAlignment = sizeof(glm::mat4);
-        auto minUboAlignment = Devices::instance()->getGPUProperties().limits.minUniformBufferOffsetAlignment;
-        if (minUboAlignment > 0) {
-            m_DynamicAlignment = (m_DynamicAlignment + minUboAlignment - 1) & ~(minUboAlignment - 1);
+        for (const auto& drawSet : drawSets) {
+            std::vector<BufferInfo> drawInfos = {};
+            int                     binding = 0;
+            for (auto buffer : {m_GpuScene->getModelBuffer(), drawSet.second, m_GpuScene->getObjectBuffer()}) {
+                BufferInfo bufferInfo = {};
+                bufferInfo.buffer = buffer->getBuffer();
+                bufferInfo.offset = 0;
+                bufferInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                bufferInfo.size = static_cast<uint32_t>(buffer->getSize());
+                bufferInfo.binding = binding++;
+                bufferInfo.descriptorCount = 1;
+                drawInfos.push_back(bufferInfo);
+            }
+            drawSet.first->update(drawInfos);
         }
+    }
 
-        VkDeviceSize dynamicBufferSize = MAX_OBJECTS * m_DynamicAlignment;
-        m_UboDynamicData.model = (glm::mat4*)alignedAlloc(dynamicBufferSize, m_DynamicAlignment);
+    VkDescriptorSet ForwardRenderer::createFrameDescriptorSet() {
+        DescriptorSet frameSet;
+        frameSet.init({m_Pipeline, 1, PER_FRAME, true});
 
-        m_UniformBuffers.view = new Buffer(BufferUsage::UNIFORM, viewBufferSize, nullptr);
-        m_UniformBuffers.dynamic = new Buffer(BufferUsage::DYNAMIC, dynamicBufferSize, nullptr);
+        FrameSetData frameSetData = {};
+        frameSetData.view = {m_UniformBuffers.view->getBuffer(), 0, sizeof(UniformVS)};
+        frameSet.update(*m_FrameSetTemplate, &frameSetData);
+
+        return frameSet.getDescriptorSet(0);
     }
 
-    void ForwardRenderer::updateUniformBuffers(uint32_t index, const Transform& transform) {
-        // TODO, store UBOs for each model we want to display in one UBO, separated by an offset
-        // then bind based on that offset in the present call
-        glm::mat4* uboDynamicModelPtr = (glm::mat4*)((uint64_t)m_UboDynamicData.model + (index * m_DynamicAlignment));
-        *uboDynamicModelPtr = transform.getMatrix();
+    void ForwardRenderer::prepareUniformBuffers() {
+        VkDeviceSize viewBufferSize = sizeof(UniformVS);
+
+        m_UniformBuffers.view = new Buffer(BufferUsage::UNIFORM, viewBufferSize, nullptr);
 
-        m_UniformBuffers.dynamic->setDynamicData(sizeof(glm::mat4), uboDynamicModelPtr, index * m_DynamicAlignment);
+        m_StartTime = glfwGetTime();
+    }
 
+    void ForwardRenderer::updateViewBuffer() {
         UniformVS uboVS = {};
         uboVS.view = Application::getAppInstance()->getWindow()->getCamera()->getViewMatrix();
         uboVS.projection = Application::getAppInstance()->getWindow()->getCamera()->getProjectionMatrix();
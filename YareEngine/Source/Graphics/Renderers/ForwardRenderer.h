@@ -3,47 +3,115 @@
 
 #include <memory>
 
+#include "Graphics/Culling/OcclusionCuller.h"
+#include "Graphics/Culling/OcclusionQueries.h"
+#include "Graphics/AssetLoader.h"
+#include "Graphics/Renderers/GpuScene.h"
 #include "Graphics/Renderers/Renderer.h"
+#include "Graphics/Scene/WorldPartition.h"
+#include "Graphics/StartupLoader.h"
+#include "Graphics/TextureStreamer.h"
 #include "Graphics/Vulkan/Buffer.h"
 #include "Graphics/Vulkan/DescriptorSet.h"
 #include "Graphics/Vulkan/Pipeline.h"
 
-#define MAX_OBJECTS 2048
-
 namespace Yare::Graphics {
 
     class ForwardRenderer : public Renderer {
        public:
-        ForwardRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight);
+        // Requests the models and default texture from the asset loader, which shares them with the world cells, and
+        // queues the streamed textures on the startup loader. The rest is set up once they are loaded.
+        ForwardRenderer(StartupLoader& startupLoader, AssetLoader& assetLoader);
         ~ForwardRenderer() override;
 
+        void onAssetsLoaded(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) override;
+
         void prepareScene() override;
+        void dispatch(CommandBuffer* commandBuffer) override;
+        void recordPrePass(CommandBuffer* commandBuffer) override;
+        void presentEarly(CommandBuffer* commandBuffer) override;
+        void dispatchLate(CommandBuffer* commandBuffer, const DepthPyramid& depthPyramid) override;
         void present(CommandBuffer* commandBuffer) override;
         void onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) override;
 
        private:
         void init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) override;
+        // Places the entities and world cells, the meshes and materials have to be loaded
+        void createScene();
         void createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height);
+        void createImpostorPipeline(RenderPass* renderPass, uint32_t width, uint32_t height);
         void createDescriptorSets();
+        void updateMaterialDescriptorSet();
+        void updateDrawDescriptorSets();
+        // Swaps the entities and materials of the cells that were streamed in or out
+        void updateStreamedCells();
         void prepareUniformBuffers();
-        void updateUniformBuffers(uint32_t index, const Transform& transform);
+        void updateViewBuffer();
+        void bindScene(CommandBuffer* commandBuffer, DescriptorSet* drawDescriptorSet, Pipeline* pipeline);
+        void drawScene(CommandBuffer* commandBuffer, CullPhase phase);
+        void drawImpostors(CommandBuffer* commandBuffer, CullPhase phase);
+        void drawSceneWithQueries(CommandBuffer* commandBuffer);
+        void cullOccluded();
+        void readOcclusionQueries();
+        glm::mat4 getViewProjection() const;
+        LodParams getLodParams() const;
+
+        VkDescriptorSet createFrameDescriptorSet();
 
         // TODO Move this into some content management class
         std::vector<std::shared_ptr<Mesh>>     m_Meshes;
         std::vector<std::shared_ptr<Material>> m_Materials;
         std::vector<std::shared_ptr<Entity>>   m_Entities;
+        // Their atlases follow the materials in the texture array, albedo then normal and depth
+        std::vector<std::shared_ptr<Impostor>> m_Impostors;
+        AssetLoader*                           m_AssetLoader;
+        // Requested in the constructor and waited for by createScene, by index into the meshes
+        std::vector<std::pair<size_t, AssetHandle<Mesh>>> m_LoadingMeshes;
+        AssetHandle<Material>                             m_LoadingDefaultTexture;
+        // The entities and materials of the resident cells come after the first counts, which are always resident
+        std::unique_ptr<WorldPartition> m_WorldPartition;
+        size_t                          m_StaticEntityCount = 0;
+        size_t                          m_StaticMaterialCount = 0;
+        // Mip levels of the static materials' textures, by what the lit pass samples
+        std::unique_ptr<TextureStreamer> m_TextureStreamer;
 
-        uint64_t m_DynamicAlignment = 0;
+        Pipeline*                 m_Pipeline;
+        // Same vertex transform as m_Pipeline, fed by the position stream alone and writing only depth
+        Pipeline*                 m_DepthPipeline;
+        Pipeline*                 m_ImpostorPipeline;
+        DescriptorSet*            m_MaterialDescriptorSet;
+        // The phases only differ in their visible instance list
+        DescriptorSet*            m_DrawDescriptorSets[CULL_PHASE_COUNT];
+        // Same with the object instance buffer, for drawing objects one by one
+        DescriptorSet*            m_ObjectDrawDescriptorSet;
+        DescriptorUpdateTemplate* m_FrameSetTemplate;
+        // Built once per frame by prepareScene from the per frame allocator
+        VkDescriptorSet           m_FrameDescriptorSet = VK_NULL_HANDLE;
 
-        Pipeline*      m_Pipeline;
-        DescriptorSet* m_DescriptorSet;
+        GpuScene*       m_GpuScene;
+        OcclusionCuller m_OcclusionCuller;
+        OcclusionQueries* m_OcclusionQueries;
+        bool      m_SceneDirty = true;
+        bool      m_OcclusionQueriesActive = false;
+        double    m_StartTime = 0.0;
+        uint32_t  m_Height = 0;
+        // What the gpu scene was last built with
+        GpuSceneSettings m_SceneSettings;
+
+        struct ImpostorPushConstants {
+            uint32_t albedoIndex;
+            uint32_t normalDepthIndex;
+            uint32_t framesPerSide;
+        };
+
+        // Layout of the data consumed by the per frame update template
+        struct FrameSetData {
+            VkDescriptorBufferInfo view;
+        };
 
         struct UniformBuffers {
             Buffer* view;
-            Buffer* dynamic;
         } m_UniformBuffers;
-
-        UboDataDynamic m_UboDynamicData;
     };
 
 }  // namespace Yare::Graphics
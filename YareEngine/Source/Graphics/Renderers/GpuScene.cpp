@@ -0,0 +1,702 @@
+#include "Graphics/Renderers/GpuScene.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+
+#include "Graphics/Vulkan/Devices.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        // Everything the scene passes around lives in whole storage buffers
+        BufferInfo storageBufferInfo(const Buffer* buffer, int binding) {
+            BufferInfo bufferInfo = {};
+            bufferInfo.buffer = buffer->getBuffer();
+            bufferInfo.offset = 0;
+            bufferInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bufferInfo.size = static_cast<uint32_t>(buffer->getSize());
+            bufferInfo.binding = binding;
+            bufferInfo.descriptorCount = 1;
+            return bufferInfo;
+        }
+
+        VkDescriptorSetLayoutBinding storageBinding(uint32_t binding) {
+            return {binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+        }
+
+        // Both buffers are host visible, so meshes are merged with plain copies through mapped memory
+        void appendBuffer(Buffer* source, Buffer* destination, size_t size, uint64_t offset,
+                          uint64_t sourceOffset = 0) {
+            if (size == 0) {
+                return;
+            }
+            if (source->mapMemory(size, sourceOffset)) {
+                destination->setData(size, source->getMappedData(), offset);
+                source->unmapMemory();
+            }
+        }
+
+        // Widens 16 bit indices when the merged buffer needs 32 bit ones
+        void appendIndices(const Mesh* mesh, Buffer* destination, VkIndexType indexType, uint64_t firstIndex) {
+            size_t indexCount = mesh->getTotalIndexCount();
+            if (indexCount == 0) {
+                return;
+            }
+            if (mesh->getIndexType() == indexType) {
+                appendBuffer(mesh->getIndexBuffer(), destination, indexCount * mesh->getIndexSize(),
+                             firstIndex * mesh->getIndexSize());
+                return;
+            }
+            if (mesh->getIndexBuffer()->mapMemory(indexCount * sizeof(uint16_t), 0)) {
+                const auto*           source = static_cast<const uint16_t*>(mesh->getIndexBuffer()->getMappedData());
+                std::vector<uint32_t> indices(source, source + indexCount);
+                destination->setData(indices.size() * sizeof(uint32_t), indices.data(), firstIndex * sizeof(uint32_t));
+                mesh->getIndexBuffer()->unmapMemory();
+            }
+        }
+
+        constexpr uint32_t GROUP_SIZE = 64;
+        constexpr uint32_t DRAW_STRIDE = sizeof(VkDrawIndexedIndirectCommand);
+        // Impostors are drawn as a quad whose corners come from the vertex index
+        constexpr uint32_t IMPOSTOR_QUAD_INDICES[6] = {0, 1, 2, 2, 3, 0};
+    }  // namespace
+
+    GpuScene::GpuScene() {
+        createPipelines();
+
+        m_TransformDescriptorSet = new DescriptorSet();
+        m_TransformDescriptorSet->init({nullptr, 1, 0, false, m_TransformPipeline->getDescriptorSetLayout(0)});
+        m_CullDescriptorSet = new DescriptorSet();
+        m_CullDescriptorSet->init({nullptr, 1, 0, false, m_CullPipeline->getDescriptorSetLayout(0)});
+        for (auto& drawList : m_DrawLists) {
+            drawList.meshletDescriptorSet = new DescriptorSet();
+            drawList.meshletDescriptorSet->init(
+                {nullptr, 1, 0, false, m_MeshletCullPipeline->getDescriptorSetLayout(0)});
+            drawList.compactDescriptorSet = new DescriptorSet();
+            drawList.compactDescriptorSet->init({nullptr, 1, 0, false, m_CompactPipeline->getDescriptorSetLayout(0)});
+        }
+    }
+
+    GpuScene::~GpuScene() {
+        deleteBuffers();
+
+        delete m_TransformDescriptorSet;
+        delete m_CullDescriptorSet;
+        for (auto& drawList : m_DrawLists) {
+            delete drawList.meshletDescriptorSet;
+            delete drawList.compactDescriptorSet;
+        }
+
+        delete m_TransformPipeline;
+        delete m_CullPipeline;
+        delete m_OcclusionPipeline;
+        delete m_MeshletCullPipeline;
+        delete m_CompactPipeline;
+    }
+
+    void GpuScene::build(const CommandQueue& commandQueue, const GpuSceneSettings& settings) {
+        // Every unique mesh gets a range of the merged buffers, every unique mesh and material pair gets a batch per
+        // level of detail and every unique impostor gets a batch of its own
+        std::unordered_map<const Mesh*, VkDrawIndexedIndirectCommand> meshRanges;
+        std::map<std::pair<const Mesh*, const Material*>, uint32_t>  batchIndices;
+        std::unordered_map<const Impostor*, uint32_t>                 impostorIndices;
+        std::vector<const Mesh*>                                      meshes;
+        std::vector<VkDrawIndexedIndirectCommand>                     batches;
+        std::vector<uint32_t>                                         objectBatches;
+        std::vector<uint32_t>                                         objectImpostors;
+        std::vector<uint32_t>                                         impostorInstanceCounts;
+        m_Impostors.clear();
+        m_IndexType = VK_INDEX_TYPE_UINT16;
+
+        for (const auto& command : commandQueue) {
+            if (command.entity->getMesh()->getVertexLayout() != VERTEX_LAYOUT) {
+                YZ_ERROR("Every mesh of a gpu scene needs its vertex layout, the scene stays empty.");
+                build(CommandQueue(), settings);
+                return;
+            }
+            if (command.entity->getMesh()->getIndexType() != VK_INDEX_TYPE_UINT16) {
+                m_IndexType = VK_INDEX_TYPE_UINT32;
+            }
+        }
+
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        for (const auto& command : commandQueue) {
+            const Mesh* mesh = command.entity->getMesh().get();
+            if (meshRanges.find(mesh) == meshRanges.end()) {
+                VkDrawIndexedIndirectCommand range = {};
+                range.firstIndex = static_cast<uint32_t>(indexCount);
+                range.vertexOffset = static_cast<int32_t>(vertexCount);
+                meshRanges[mesh] = range;
+                meshes.push_back(mesh);
+
+                vertexCount += mesh->getVertexCount();
+                indexCount += mesh->getTotalIndexCount();
+            }
+
+            auto     key = std::make_pair(mesh, command.entity->getMaterial().get());
+            auto     batch = batchIndices.find(key);
+            uint32_t lodCount = (std::min)(static_cast<uint32_t>(mesh->getLods().size()), MAX_GPU_LODS);
+            if (batch == batchIndices.end()) {
+                batch = batchIndices.emplace(key, static_cast<uint32_t>(batches.size())).first;
+                for (uint32_t lod = 0; lod < lodCount; lod++) {
+                    VkDrawIndexedIndirectCommand range = meshRanges[mesh];
+                    range.firstIndex += mesh->getLods()[lod].firstIndex;
+                    range.indexCount = mesh->getLods()[lod].indexCount;
+                    batches.push_back(range);
+                }
+            }
+            for (uint32_t lod = 0; lod < lodCount; lod++) {
+                batches[batch->second + lod].instanceCount++;
+            }
+            objectBatches.push_back(batch->second);
+
+            const Impostor* impostor = settings.impostors ? command.entity->getImpostor().get() : nullptr;
+            if (!impostor) {
+                objectImpostors.push_back(NO_IMPOSTOR);
+                continue;
+            }
+            auto impostorIndex = impostorIndices.find(impostor);
+            if (impostorIndex == impostorIndices.end()) {
+                impostorIndex = impostorIndices.emplace(impostor, static_cast<uint32_t>(m_Impostors.size())).first;
+                m_Impostors.push_back(impostor);
+                impostorInstanceCounts.push_back(0);
+            }
+            impostorInstanceCounts[impostorIndex->second]++;
+            objectImpostors.push_back(impostorIndex->second);
+        }
+
+        // Objects culled meshlet by meshlet get a batch of one instance per meshlet, each mesh's meshlets are only
+        // uploaded once
+        std::unordered_map<const Mesh*, uint32_t> meshletOffsets;
+        std::vector<GpuMeshlet>                   meshlets;
+        std::vector<GpuMeshletDraw>               meshletDraws;
+        std::vector<uint32_t>                     objectMeshletCounts(commandQueue.size(), 0);
+        m_FirstMeshletBatch = static_cast<uint32_t>(batches.size());
+        for (size_t i = 0; i < commandQueue.size() && settings.meshletCulling; i++) {
+            const Mesh* mesh = commandQueue[i].entity->getMesh().get();
+            const auto& meshMeshlets = mesh->getMeshlets();
+            if (meshMeshlets.size() < (std::max)(settings.minMeshlets, 1u)) {
+                continue;
+            }
+
+            auto offset = meshletOffsets.find(mesh);
+            if (offset == meshletOffsets.end()) {
+                offset = meshletOffsets.emplace(mesh, static_cast<uint32_t>(meshlets.size())).first;
+                for (const auto& meshlet : meshMeshlets) {
+                    meshlets.push_back({meshlet.boundingSphere, meshlet.cone});
+                }
+            }
+            const VkDrawIndexedIndirectCommand& range = meshRanges[mesh];
+            for (uint32_t m = 0; m < meshMeshlets.size(); m++) {
+                batches.push_back({meshMeshlets[m].indexCount, 1, range.firstIndex + meshMeshlets[m].firstIndex,
+                                   range.vertexOffset, 0});
+                meshletDraws.push_back({static_cast<uint32_t>(i), offset->second + m});
+            }
+            objectMeshletCounts[i] = static_cast<uint32_t>(meshMeshlets.size());
+        }
+        m_MeshletBatchCount = static_cast<uint32_t>(batches.size()) - m_FirstMeshletBatch;
+
+        // All impostors share one quad at the end of the index buffer
+        m_MeshBatchCount = static_cast<uint32_t>(batches.size());
+        uint32_t quadFirstIndex = static_cast<uint32_t>(indexCount);
+        if (!m_Impostors.empty()) {
+            indexCount += std::size(IMPOSTOR_QUAD_INDICES);
+        }
+        for (uint32_t instanceCount : impostorInstanceCounts) {
+            batches.push_back({static_cast<uint32_t>(std::size(IMPOSTOR_QUAD_INDICES)), instanceCount, quadFirstIndex,
+                               0, 0});
+        }
+
+        // Each batch owns a range of the visible instance list big enough for all of its objects, the culling
+        // shader counts the instances back up from zero every frame
+        uint32_t firstInstance = 0;
+        for (auto& batch : batches) {
+            batch.firstInstance = firstInstance;
+            firstInstance += batch.instanceCount;
+        }
+        m_InstanceSlotCount = firstInstance;
+        m_BatchRanges = batches;
+        for (auto& batch : batches) {
+            batch.instanceCount = 0;
+        }
+        m_ObjectBatches = objectBatches;
+
+        m_ObjectCount = static_cast<uint32_t>(commandQueue.size());
+        m_BatchCount = static_cast<uint32_t>(batches.size());
+
+        deleteBuffers();
+        createBuffers(vertexCount, indexCount, meshlets.size());
+
+        // All positions first and all other attributes after them, so the position stream can be bound alone
+        uint32_t positionStride = VERTEX_LAYOUT.getPositionStride();
+        uint32_t attributeStride = VERTEX_LAYOUT.getAttributeStride();
+        m_AttributeStreamOffset = VERTEX_LAYOUT.separatePositions ? vertexCount * positionStride : 0;
+        for (auto mesh : meshes) {
+            const auto& range = meshRanges[mesh];
+            appendBuffer(mesh->getVertexBuffer(), m_VertexBuffer, mesh->getVertexCount() * positionStride,
+                         range.vertexOffset * positionStride);
+            if (VERTEX_LAYOUT.separatePositions) {
+                appendBuffer(mesh->getVertexBuffer(), m_VertexBuffer, mesh->getVertexCount() * attributeStride,
+                             m_AttributeStreamOffset + range.vertexOffset * attributeStride,
+                             mesh->getAttributeStreamOffset());
+            }
+            appendIndices(mesh, m_IndexBuffer, m_IndexType, range.firstIndex);
+        }
+        if (!m_Impostors.empty() && m_IndexType == VK_INDEX_TYPE_UINT16) {
+            std::vector<uint16_t> quadIndices(std::begin(IMPOSTOR_QUAD_INDICES), std::end(IMPOSTOR_QUAD_INDICES));
+            m_IndexBuffer->setData(quadIndices.size() * sizeof(uint16_t), quadIndices.data(),
+                                   quadFirstIndex * sizeof(uint16_t));
+        } else if (!m_Impostors.empty()) {
+            m_IndexBuffer->setData(sizeof(IMPOSTOR_QUAD_INDICES), IMPOSTOR_QUAD_INDICES,
+                                   quadFirstIndex * sizeof(uint32_t));
+        }
+
+        std::vector<GpuInstance> instances;
+        std::vector<GpuObject>   objects;
+        std::vector<uint32_t>    objectInstances;
+        instances.reserve(m_ObjectCount);
+        objects.reserve(m_ObjectCount);
+        objectInstances.reserve(m_ObjectCount);
+        for (size_t i = 0; i < commandQueue.size(); i++) {
+            const Entity*    entity = commandQueue[i].entity;
+            const Transform& transform = entity->getTransform();
+            glm::quat        rotation = transform.getQuatRotation();
+
+            GpuInstance instance = {};
+            instance.translation = glm::vec4(transform.getTranslation(), 1.0f);
+            instance.rotation = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+            instance.scale = glm::vec4(transform.getScale(), 1.0f);
+            instance.spin = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+            instances.push_back(instance);
+
+            const auto& lods = entity->getMesh()->getLods();
+            GpuObject   object = {};
+            object.boundingSphere = entity->getMesh()->getBoundingSphere();
+            object.positionTransform = entity->getMesh()->getPositionTransform();
+            object.batchIndex = objectBatches[i];
+            object.materialIndex = static_cast<uint32_t>(entity->getMaterial()->getImageIdx());
+            object.lodCount = (std::min)(static_cast<uint32_t>(lods.size()), MAX_GPU_LODS);
+            for (uint32_t lod = 1; lod < object.lodCount; lod++) {
+                object.lodErrors[lod - 1] = lods[lod].error;
+            }
+            object.meshletCount = objectMeshletCounts[i];
+            object.impostorBatch = NO_IMPOSTOR;
+            if (objectImpostors[i] != NO_IMPOSTOR) {
+                object.impostorBatch = m_MeshBatchCount + objectImpostors[i];
+                object.impostorTexelSize = m_Impostors[objectImpostors[i]]->getTexelSize();
+            }
+            objects.push_back(object);
+            objectInstances.push_back(static_cast<uint32_t>(i));
+        }
+
+        if (m_ObjectCount > 0) {
+            m_InstanceBuffer->setData(instances.size() * sizeof(GpuInstance), instances.data());
+            m_ObjectBuffer->setData(objects.size() * sizeof(GpuObject), objects.data());
+            m_BatchTemplateBuffer->setData(batches.size() * DRAW_STRIDE, batches.data());
+            m_ObjectInstanceBuffer->setData(objectInstances.size() * sizeof(uint32_t), objectInstances.data());
+        }
+        if (!meshlets.empty()) {
+            m_MeshletBuffer->setData(meshlets.size() * sizeof(GpuMeshlet), meshlets.data());
+            m_MeshletDrawBuffer->setData(meshletDraws.size() * sizeof(GpuMeshletDraw), meshletDraws.data());
+        }
+
+        m_ResetVisibility = true;
+        m_CpuVisibilityCleared = false;
+        setCpuVisibility({});
+        updateDescriptorSets();
+    }
+
+    void GpuScene::setCpuVisibility(const std::vector<uint32_t>& visibility) {
+        if (m_ObjectCount == 0) {
+            return;
+        }
+
+        // Frames are waited on before the next one is recorded, so the buffer can be written in place
+        if (visibility.empty()) {
+            if (!m_CpuVisibilityCleared) {
+                std::vector<uint32_t> allVisible(m_ObjectCount, 1);
+                m_CpuVisibilityBuffer->setData(allVisible.size() * sizeof(uint32_t), allVisible.data());
+                m_CpuVisibilityCleared = true;
+            }
+            return;
+        }
+        if (visibility.size() != m_ObjectCount) {
+            YZ_WARN("Cpu visibility has " + std::to_string(visibility.size()) + " flags for " +
+                    std::to_string(m_ObjectCount) + " objects, ignoring it.");
+            return;
+        }
+
+        m_CpuVisibilityBuffer->setData(visibility.size() * sizeof(uint32_t), visibility.data());
+        m_CpuVisibilityCleared = false;
+    }
+
+    void GpuScene::dispatch(CommandBuffer* commandBuffer, const Frustum& frustum, const LodParams& lodParams,
+                            float time, bool occlusionCulling) {
+        if (m_ObjectCount == 0) {
+            return;
+        }
+
+        if (m_ResetVisibility) {
+            vkCmdFillBuffer(commandBuffer->getCommandBuffer(), m_VisibilityBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+            m_ResetVisibility = false;
+        }
+        resetDrawList(commandBuffer, CULL_PHASE_EARLY);
+
+        TransformPushConstants transformConstants = {time, m_ObjectCount};
+        m_TransformPipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_TransformPipeline->getPipelineLayout(), 0, 1u,
+                                &m_TransformDescriptorSet->getDescriptorSet(0), 0, nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_TransformPipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(transformConstants), &transformConstants);
+        commandBuffer->dispatch(CommandBuffer::getGroupCount(m_ObjectCount, GROUP_SIZE));
+
+        // Culling reads the model matrices and counts into the freshly reset batches
+        commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        CullPushConstants cullConstants = {frustum, lodParams, m_ObjectCount, occlusionCulling ? 1u : 0u};
+        m_CullPipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_CullPipeline->getPipelineLayout(), 0, 1u, &m_CullDescriptorSet->getDescriptorSet(0),
+                                0, nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_CullPipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(cullConstants), &cullConstants);
+        commandBuffer->dispatch(CommandBuffer::getGroupCount(m_ObjectCount, GROUP_SIZE));
+
+        cullMeshlets(commandBuffer, CULL_PHASE_EARLY, frustum, lodParams.cameraPosition);
+        compactDrawList(commandBuffer, CULL_PHASE_EARLY);
+    }
+
+    void GpuScene::dispatchLate(CommandBuffer* commandBuffer, const glm::mat4& viewProjection,
+                                const LodParams& lodParams, const DepthPyramid& depthPyramid) {
+        if (m_ObjectCount == 0) {
+            return;
+        }
+
+        resetDrawList(commandBuffer, CULL_PHASE_LATE);
+        commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        // The pyramid is rebuilt with every resize, so its set is written fresh every frame
+        DescriptorSet occlusionSet;
+        occlusionSet.init({nullptr, 1, 0, true, m_OcclusionPipeline->getDescriptorSetLayout(0)});
+
+        BufferInfo pyramidInfo = {};
+        pyramidInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pyramidInfo.binding = 5;
+        pyramidInfo.descriptorCount = 1;
+        pyramidInfo.imageViews = {depthPyramid.getImageView()};
+        pyramidInfo.imageSamplers = {depthPyramid.getSampler()};
+        pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        const DrawList&         drawList = m_DrawLists[CULL_PHASE_LATE];
+        std::vector<BufferInfo> occlusionInfos = {storageBufferInfo(m_ObjectBuffer, 0),
+                                                  storageBufferInfo(m_ModelBuffer, 1),
+                                                  storageBufferInfo(drawList.batchBuffer, 2),
+                                                  storageBufferInfo(drawList.visibleInstanceBuffer, 3),
+                                                  storageBufferInfo(m_VisibilityBuffer, 4),
+                                                  pyramidInfo,
+                                                  storageBufferInfo(m_CpuVisibilityBuffer, 6),
+                                                  storageBufferInfo(m_ClusterVisibilityBuffer, 7)};
+        occlusionSet.update(occlusionInfos);
+
+        OcclusionPushConstants occlusionConstants = {viewProjection, lodParams,
+                                                     static_cast<int32_t>(depthPyramid.getDepthWidth()),
+                                                     static_cast<int32_t>(depthPyramid.getDepthHeight()),
+                                                     m_ObjectCount, depthPyramid.getLevelCount()};
+        m_OcclusionPipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_OcclusionPipeline->getPipelineLayout(), 0, 1u, &occlusionSet.getDescriptorSet(0),
+                                0, nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_OcclusionPipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(occlusionConstants), &occlusionConstants);
+        commandBuffer->dispatch(CommandBuffer::getGroupCount(m_ObjectCount, GROUP_SIZE));
+
+        // Meshlets aren't tested against the pyramid, the object already was
+        cullMeshlets(commandBuffer, CULL_PHASE_LATE, Frustum::fromMatrix(viewProjection), lodParams.cameraPosition);
+        compactDrawList(commandBuffer, CULL_PHASE_LATE);
+    }
+
+    void GpuScene::cullMeshlets(CommandBuffer* commandBuffer, CullPhase phase, const Frustum& frustum,
+                                const glm::vec3& cameraPosition) {
+        if (m_MeshletBatchCount == 0) {
+            return;
+        }
+
+        commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        MeshletCullPushConstants meshletConstants = {frustum, glm::vec4(cameraPosition, 1.0f), m_FirstMeshletBatch,
+                                                     m_MeshletBatchCount};
+        m_MeshletCullPipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_MeshletCullPipeline->getPipelineLayout(), 0, 1u,
+                                &m_DrawLists[phase].meshletDescriptorSet->getDescriptorSet(0), 0, nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_MeshletCullPipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(meshletConstants), &meshletConstants);
+        commandBuffer->dispatch(CommandBuffer::getGroupCount(m_MeshletBatchCount, GROUP_SIZE));
+    }
+
+    void GpuScene::resetDrawList(CommandBuffer* commandBuffer, CullPhase phase) {
+        const DrawList& drawList = m_DrawLists[phase];
+        VkBufferCopy    batchCopy = {0, 0, m_BatchCount * DRAW_STRIDE};
+        vkCmdCopyBuffer(commandBuffer->getCommandBuffer(), m_BatchTemplateBuffer->getBuffer(),
+                        drawList.batchBuffer->getBuffer(), 1, &batchCopy);
+        vkCmdFillBuffer(commandBuffer->getCommandBuffer(), drawList.drawCountBuffer->getBuffer(), 0,
+                        sizeof(uint32_t), 0);
+        // Batches drawn over all of their slots skip the ones no visible instance was written to
+        if (!Devices::instance()->hasDrawIndirectFirstInstance()) {
+            vkCmdFillBuffer(commandBuffer->getCommandBuffer(), drawList.visibleInstanceBuffer->getBuffer(), 0,
+                            VK_WHOLE_SIZE, NO_INSTANCE);
+        }
+    }
+
+    void GpuScene::compactDrawList(CommandBuffer* commandBuffer, CullPhase phase) {
+        if (!Devices::instance()->hasDrawIndirectCount() || !Devices::instance()->hasDrawIndirectFirstInstance()) {
+            return;
+        }
+
+        commandBuffer->memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+        CompactPushConstants compactConstants = {m_MeshBatchCount};
+        m_CompactPipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_CompactPipeline->getPipelineLayout(), 0, 1u,
+                                &m_DrawLists[phase].compactDescriptorSet->getDescriptorSet(0), 0, nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_CompactPipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(compactConstants), &compactConstants);
+        commandBuffer->dispatch(CommandBuffer::getGroupCount(m_MeshBatchCount, GROUP_SIZE));
+    }
+
+    void GpuScene::draw(CommandBuffer* commandBuffer, CullPhase phase, bool positionsOnly) {
+        if (m_ObjectCount == 0) {
+            return;
+        }
+
+        const DrawList& drawList = m_DrawLists[phase];
+        bindGeometry(commandBuffer, positionsOnly);
+
+        // The instance counts only exist on the gpu, so every slot is drawn and the empty ones are skipped by the
+        // vertex shader
+        if (!Devices::instance()->hasDrawIndirectFirstInstance()) {
+            for (uint32_t batch = 0; batch < m_MeshBatchCount; batch++) {
+                drawBatchSlots(commandBuffer, batch);
+            }
+            return;
+        }
+
+        uint32_t maxDrawCount = Devices::instance()->getGPUProperties().limits.maxDrawIndirectCount;
+        if (Devices::instance()->hasDrawIndirectCount() && m_MeshBatchCount <= maxDrawCount) {
+            commandBuffer->drawIndexedIndirectCount(drawList.drawBuffer->getBuffer(), 0,
+                                                    drawList.drawCountBuffer->getBuffer(), 0, m_MeshBatchCount,
+                                                    DRAW_STRIDE);
+            return;
+        }
+
+        // Without a gpu side draw count every batch is issued, the culled ones just have no instances. Without
+        // multiDrawIndirect the limit is 1, which makes this one indirect draw per batch.
+        for (uint32_t firstBatch = 0; firstBatch < m_MeshBatchCount; firstBatch += maxDrawCount) {
+            commandBuffer->drawIndexedIndirect(drawList.batchBuffer->getBuffer(), firstBatch * DRAW_STRIDE,
+                                               (std::min)(maxDrawCount, m_MeshBatchCount - firstBatch), DRAW_STRIDE);
+        }
+    }
+
+    void GpuScene::drawImpostor(CommandBuffer* commandBuffer, CullPhase phase, uint32_t impostor) {
+        if (m_ObjectCount == 0 || impostor >= m_Impostors.size()) {
+            return;
+        }
+        if (!Devices::instance()->hasDrawIndirectFirstInstance()) {
+            drawBatchSlots(commandBuffer, m_MeshBatchCount + impostor);
+            return;
+        }
+        commandBuffer->drawIndexedIndirect(m_DrawLists[phase].batchBuffer->getBuffer(),
+                                           (m_MeshBatchCount + impostor) * DRAW_STRIDE, 1, DRAW_STRIDE);
+    }
+
+    void GpuScene::drawBatchSlots(CommandBuffer* commandBuffer, uint32_t batch) const {
+        const VkDrawIndexedIndirectCommand& range = m_BatchRanges[batch];
+        if (range.instanceCount > 0) {
+            vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), range.indexCount, range.instanceCount,
+                             range.firstIndex, range.vertexOffset, range.firstInstance);
+        }
+    }
+
+    void GpuScene::bindGeometry(CommandBuffer* commandBuffer, bool positionsOnly) {
+        m_VertexBuffer->bindVertex(commandBuffer, 0, 0);
+        if (VERTEX_LAYOUT.separatePositions && !positionsOnly) {
+            m_VertexBuffer->bindVertex(commandBuffer, m_AttributeStreamOffset, 1);
+        }
+        m_IndexBuffer->bindIndex(commandBuffer, m_IndexType);
+    }
+
+    void GpuScene::drawObject(CommandBuffer* commandBuffer, uint32_t object, uint32_t lod) {
+        // The object instance buffer maps the first instance back to the object
+        const VkDrawIndexedIndirectCommand& range = m_BatchRanges[m_ObjectBatches[object] + lod];
+        vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), range.indexCount, 1, range.firstIndex, range.vertexOffset,
+                         object);
+    }
+
+    void GpuScene::createPipelines() {
+        {
+            Shader shader("../Res/Shaders/InstanceTransform", "instance_transform.shader");
+
+            // Binding 0 reads the instances, binding 1 writes the model matrices
+            ComputePipelineInfo pInfo = {};
+            pInfo.shader = &shader;
+            pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(TransformPushConstants)};
+            pInfo.setLayoutBindings = {{storageBinding(0), storageBinding(1)}};
+
+            m_TransformPipeline = new ComputePipeline();
+            m_TransformPipeline->init(pInfo);
+        }
+        {
+            Shader shader("../Res/Shaders/GpuCulling", "cull.shader");
+
+            // Objects, model matrices, batches, the visible instance list, last frame's visibility, the cpu's and the
+            // objects left to meshlet culling
+            ComputePipelineInfo pInfo = {};
+            pInfo.shader = &shader;
+            pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants)};
+            pInfo.setLayoutBindings = {{storageBinding(0), storageBinding(1), storageBinding(2), storageBinding(3),
+                                        storageBinding(4), storageBinding(5), storageBinding(6)}};
+
+            m_CullPipeline = new ComputePipeline();
+            m_CullPipeline->init(pInfo);
+        }
+        {
+            Shader shader("../Res/Shaders/GpuCulling", "cull_occlusion.shader");
+
+            // Same as the cull pass with the depth pyramid in between
+            ComputePipelineInfo pInfo = {};
+            pInfo.shader = &shader;
+            pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(OcclusionPushConstants)};
+            VkDescriptorSetLayoutBinding depthPyramid = {5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                                                         VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+            pInfo.setLayoutBindings = {{storageBinding(0), storageBinding(1), storageBinding(2), storageBinding(3),
+                                        storageBinding(4), depthPyramid, storageBinding(6), storageBinding(7)}};
+
+            m_OcclusionPipeline = new ComputePipeline();
+            m_OcclusionPipeline->init(pInfo);
+        }
+        {
+            Shader shader("../Res/Shaders/GpuCulling", "meshlet_cull.shader");
+
+            // Meshlet bounds, meshlet draws, model matrices, the objects left to meshlet culling, batches and the
+            // visible instance list
+            ComputePipelineInfo pInfo = {};
+            pInfo.shader = &shader;
+            pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(MeshletCullPushConstants)};
+            pInfo.setLayoutBindings = {{storageBinding(0), storageBinding(1), storageBinding(2), storageBinding(3),
+                                        storageBinding(4), storageBinding(5)}};
+
+            m_MeshletCullPipeline = new ComputePipeline();
+            m_MeshletCullPipeline->init(pInfo);
+        }
+        {
+            Shader shader("../Res/Shaders/GpuCulling", "compact.shader");
+
+            // Batches, the compacted draws and the draw count
+            ComputePipelineInfo pInfo = {};
+            pInfo.shader = &shader;
+            pInfo.pushConstants = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CompactPushConstants)};
+            pInfo.setLayoutBindings = {{storageBinding(0), storageBinding(1), storageBinding(2)}};
+
+            m_CompactPipeline = new ComputePipeline();
+            m_CompactPipeline->init(pInfo);
+        }
+    }
+
+    void GpuScene::createBuffers(size_t vertexCount, size_t indexCount, size_t meshletCount) {
+        // Vulkan doesn't allow empty buffers, so an empty scene still gets one element of everything
+        size_t objectCount = (std::max)(m_ObjectCount, 1u);
+        size_t batchCount = (std::max)(m_BatchCount, 1u);
+
+        size_t indexSize = m_IndexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        m_VertexBuffer = new Buffer(BufferUsage::VERTEX, (std::max)(vertexCount, size_t(1)) * VERTEX_LAYOUT.getStride(),
+                                    nullptr);
+        m_IndexBuffer = new Buffer(BufferUsage::INDEX, (std::max)(indexCount, size_t(1)) * indexSize, nullptr);
+
+        m_InstanceBuffer = new Buffer(BufferUsage::STORAGE, objectCount * sizeof(GpuInstance), nullptr);
+        m_ObjectBuffer = new Buffer(BufferUsage::STORAGE, objectCount * sizeof(GpuObject), nullptr);
+        m_ModelBuffer = new Buffer(BufferUsage::GPU_STORAGE, objectCount * sizeof(glm::mat4), nullptr);
+        m_VisibilityBuffer = new Buffer(BufferUsage::GPU_STORAGE, objectCount * sizeof(uint32_t), nullptr);
+        m_CpuVisibilityBuffer = new Buffer(BufferUsage::STORAGE, objectCount * sizeof(uint32_t), nullptr);
+
+        m_BatchTemplateBuffer = new Buffer(BufferUsage::STORAGE, batchCount * DRAW_STRIDE, nullptr);
+        m_ObjectInstanceBuffer = new Buffer(BufferUsage::STORAGE, objectCount * sizeof(uint32_t), nullptr);
+        m_MeshletBuffer = new Buffer(BufferUsage::STORAGE, (std::max)(meshletCount, size_t(1)) * sizeof(GpuMeshlet),
+                                     nullptr);
+        m_MeshletDrawBuffer = new Buffer(BufferUsage::STORAGE,
+                                         (std::max)(m_MeshletBatchCount, 1u) * sizeof(GpuMeshletDraw), nullptr);
+        m_ClusterVisibilityBuffer = new Buffer(BufferUsage::GPU_STORAGE, objectCount * sizeof(uint32_t), nullptr);
+        for (auto& drawList : m_DrawLists) {
+            drawList.visibleInstanceBuffer = new Buffer(
+                BufferUsage::GPU_STORAGE, (std::max)(m_InstanceSlotCount, 1u) * sizeof(uint32_t), nullptr);
+            drawList.batchBuffer = new Buffer(BufferUsage::INDIRECT, batchCount * DRAW_STRIDE, nullptr);
+            drawList.drawBuffer = new Buffer(BufferUsage::INDIRECT, batchCount * DRAW_STRIDE, nullptr);
+            drawList.drawCountBuffer = new Buffer(BufferUsage::INDIRECT, sizeof(uint32_t), nullptr);
+        }
+    }
+
+    void GpuScene::deleteBuffers() {
+        // Frames are waited on before the next one is recorded, so nothing in flight still uses these
+        delete m_VertexBuffer;
+        delete m_IndexBuffer;
+        delete m_InstanceBuffer;
+        delete m_ObjectBuffer;
+        delete m_ModelBuffer;
+        delete m_VisibilityBuffer;
+        delete m_CpuVisibilityBuffer;
+        delete m_BatchTemplateBuffer;
+        delete m_ObjectInstanceBuffer;
+        delete m_MeshletBuffer;
+        delete m_MeshletDrawBuffer;
+        delete m_ClusterVisibilityBuffer;
+        for (auto& drawList : m_DrawLists) {
+            delete drawList.visibleInstanceBuffer;
+            delete drawList.batchBuffer;
+            delete drawList.drawBuffer;
+            delete drawList.drawCountBuffer;
+        }
+    }
+
+    void GpuScene::updateDescriptorSets() {
+        std::vector<BufferInfo> transformInfos = {storageBufferInfo(m_InstanceBuffer, 0),
+                                                  storageBufferInfo(m_ModelBuffer, 1)};
+        m_TransformDescriptorSet->update(transformInfos);
+
+        const DrawList&         earlyList = m_DrawLists[CULL_PHASE_EARLY];
+        std::vector<BufferInfo> cullInfos = {storageBufferInfo(m_ObjectBuffer, 0), storageBufferInfo(m_ModelBuffer, 1),
+                                             storageBufferInfo(earlyList.batchBuffer, 2),
+                                             storageBufferInfo(earlyList.visibleInstanceBuffer, 3),
+                                             storageBufferInfo(m_VisibilityBuffer, 4),
+                                             storageBufferInfo(m_CpuVisibilityBuffer, 5),
+                                             storageBufferInfo(m_ClusterVisibilityBuffer, 6)};
+        m_CullDescriptorSet->update(cullInfos);
+
+        for (auto& drawList : m_DrawLists) {
+            std::vector<BufferInfo> meshletInfos = {storageBufferInfo(m_MeshletBuffer, 0),
+                                                    storageBufferInfo(m_MeshletDrawBuffer, 1),
+                                                    storageBufferInfo(m_ModelBuffer, 2),
+                                                    storageBufferInfo(m_ClusterVisibilityBuffer, 3),
+                                                    storageBufferInfo(drawList.batchBuffer, 4),
+                                                    storageBufferInfo(drawList.visibleInstanceBuffer, 5)};
+            drawList.meshletDescriptorSet->update(meshletInfos);
+
+            std::vector<BufferInfo> compactInfos = {storageBufferInfo(drawList.batchBuffer, 0),
+                                                    storageBufferInfo(drawList.drawBuffer, 1),
+                                                    storageBufferInfo(drawList.drawCountBuffer, 2)};
+            drawList.compactDescriptorSet->update(compactInfos);
+        }
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,234 @@
+#ifndef YARE_GPU_SCENE_H
+#define YARE_GPU_SCENE_H
+
+#include "Graphics/Camera/Frustum.h"
+#include "Graphics/Renderers/DepthPyramid.h"
+#include "Graphics/Renderers/Renderer.h"
+#include "Graphics/VertexLayout.h"
+#include "Graphics/Vulkan/Buffer.h"
+#include "Graphics/Vulkan/ComputePipeline.h"
+#include "Graphics/Vulkan/DescriptorSet.h"
+
+namespace Yare::Graphics {
+
+    // Levels of detail the gpu picks from, more levels of a mesh are ignored
+    constexpr uint32_t MAX_GPU_LODS = 5;
+    constexpr uint32_t NO_IMPOSTOR = 0xFFFFFFFFu;
+    // Fills the visible instance slots the culling left empty, only drawn without drawIndirectFirstInstance
+    constexpr uint32_t NO_INSTANCE = 0xFFFFFFFFu;
+
+    // Per object input of the culling shader, laid out to match its std430 struct
+    struct GpuObject {
+        glm::vec4 boundingSphere;  // Object space, center in xyz and radius in w
+        // Batch of the full detail mesh, the batches of the other levels follow it
+        uint32_t  batchIndex;
+        uint32_t  materialIndex;
+        uint32_t  lodCount;
+        // Batch of the object's impostor or NO_IMPOSTOR, the impostor batches come after all mesh batches
+        uint32_t  impostorBatch;
+        glm::vec4 lodErrors;  // Object space error of levels 1 to 4
+        float     impostorTexelSize;
+        // Meshlets the object is culled by when drawn at full detail, 0 when it is always drawn whole
+        uint32_t  meshletCount;
+        uint32_t  padding[2];
+        // Undoes the quantization of the mesh's positions, xyz offset and w scale
+        glm::vec4 positionTransform;
+    };
+
+    // Bounds of a meshlet for the meshlet culling shader, laid out to match its std430 struct
+    struct GpuMeshlet {
+        glm::vec4 boundingSphere;
+        glm::vec4 cone;
+    };
+
+    // One per meshlet batch, which object draws which meshlet
+    struct GpuMeshletDraw {
+        uint32_t object;
+        uint32_t meshlet;
+    };
+
+    struct GpuSceneSettings {
+        // Without impostors every object is drawn as a mesh at any distance
+        bool impostors = true;
+        // Objects whose full detail mesh has at least minMeshlets meshlets cull their meshlets one by one when they
+        // are drawn at full detail, smaller meshes aren't worth the extra draws
+        bool     meshletCulling = true;
+        uint32_t minMeshlets = 8;
+    };
+
+    // Picks the coarsest level whose error stays within a pixel at the nearest point of an object's bounds
+    struct LodParams {
+        glm::vec3 cameraPosition;
+        // Pixels covered by one unit at a distance of one, divided by the error allowed in pixels
+        float errorScale;
+    };
+
+    // With occlusion culling the early phase draws what was visible last frame and the late phase draws what the
+    // depth pyramid of the early phase revealed. Without it everything is drawn in the early phase.
+    enum CullPhase { CULL_PHASE_EARLY = 0, CULL_PHASE_LATE, CULL_PHASE_COUNT };
+
+    // Holds everything the gpu needs to decide what to draw by itself. All meshes are merged into one vertex and
+    // index buffer and objects sharing a mesh and material form a batch. Every frame compute passes build the model
+    // matrices, cull the objects against the frustum and optionally the depth pyramid, and fill one indirect draw
+    // per batch, so the cpu cost of a frame is the same for a thousand objects as for a million. Large meshes are
+    // split further, every meshlet of a visible object is tested against the frustum and its normal cone and gets a
+    // batch of its own, so the parts of a building facing away or off screen aren't drawn.
+    class GpuScene {
+       public:
+        // Every mesh is merged into one vertex buffer, so they all have to share this layout
+        static constexpr VertexLayout VERTEX_LAYOUT = COMPACT_VERTEX_LAYOUT;
+
+        GpuScene();
+        ~GpuScene();
+
+        // Rebuilds the gpu side scene, only needed when entities are added, removed or their transform changes.
+        // The merged indices are 16 bit as long as every mesh's are.
+        void build(const CommandQueue& commandQueue, const GpuSceneSettings& settings = {});
+        // Records the transform pass and the early phase, has to happen outside of a render pass. With occlusion
+        // culling only the objects that were visible last frame make it into the early phase.
+        void dispatch(CommandBuffer* commandBuffer, const Frustum& frustum, const LodParams& lodParams, float time,
+                      bool occlusionCulling);
+        // Records the late phase, tests every object against the pyramid built from the early phase's depth
+        void dispatchLate(CommandBuffer* commandBuffer, const glm::mat4& viewProjection, const LodParams& lodParams,
+                          const DepthPyramid& depthPyramid);
+        // Binds the merged geometry and issues the indirect draws, the callers pipeline and sets must already be bound.
+        // Depth only pipelines bind the position stream alone.
+        void draw(CommandBuffer* commandBuffer, CullPhase phase, bool positionsOnly = false);
+        // One instanced draw of the quad with every visible instance of the impostor, after draw bound the geometry.
+        // The caller's impostor pipeline reads the object id the same way the mesh pipeline does.
+        void drawImpostor(CommandBuffer* commandBuffer, CullPhase phase, uint32_t impostor);
+        // Draws the objects one at a time instead, for renderers that decide visibility per object themselves. The
+        // draws go through the object instance buffer, so it has to be bound in place of a visible instance list.
+        void bindGeometry(CommandBuffer* commandBuffer, bool positionsOnly = false);
+        void drawObject(CommandBuffer* commandBuffer, uint32_t object, uint32_t lod = 0);
+        // One flag per object from the cpu occlusion culler, both phases skip the objects it rejected. An empty list
+        // lets every object through.
+        void setCpuVisibility(const std::vector<uint32_t>& visibility);
+
+        // Read by the vertex shader, model matrices and objects are indexed by object id
+        Buffer*  getModelBuffer() const { return m_ModelBuffer; }
+        Buffer*  getVisibleInstanceBuffer(CullPhase phase) const { return m_DrawLists[phase].visibleInstanceBuffer; }
+        Buffer*  getObjectBuffer() const { return m_ObjectBuffer; }
+        // Maps every instance index to the object with the same id, for drawObject
+        Buffer*  getObjectInstanceBuffer() const { return m_ObjectInstanceBuffer; }
+        uint32_t getObjectCount() const { return m_ObjectCount; }
+        // The impostors of the last build, in the order of their batches
+        const std::vector<const Impostor*>& getImpostors() const { return m_Impostors; }
+        uint32_t getObjectIndexCount(uint32_t object, uint32_t lod = 0) const {
+            return m_BatchRanges[m_ObjectBatches[object] + lod].indexCount;
+        }
+
+       private:
+        struct TransformPushConstants {
+            float    time;
+            uint32_t instanceCount;
+        };
+
+        struct CullPushConstants {
+            Frustum   frustum;
+            LodParams lodParams;
+            uint32_t  objectCount;
+            uint32_t  visibleOnly;
+        };
+
+        struct OcclusionPushConstants {
+            glm::mat4 viewProjection;
+            LodParams lodParams;
+            int32_t   depthWidth;
+            int32_t   depthHeight;
+            uint32_t  objectCount;
+            uint32_t  levelCount;
+        };
+
+        struct MeshletCullPushConstants {
+            Frustum   frustum;
+            glm::vec4 cameraPosition;
+            uint32_t  firstBatch;
+            uint32_t  batchCount;
+        };
+
+        struct CompactPushConstants {
+            uint32_t batchCount;
+        };
+
+        void createPipelines();
+        void createBuffers(size_t vertexCount, size_t indexCount, size_t meshletCount);
+        void deleteBuffers();
+        void updateDescriptorSets();
+        // Copies the empty batches over the phase's batches and zeroes its draw count
+        void resetDrawList(CommandBuffer* commandBuffer, CullPhase phase);
+        // Culls the meshlets of the objects the phase's object pass left to them
+        void cullMeshlets(CommandBuffer* commandBuffer, CullPhase phase, const Frustum& frustum,
+                          const glm::vec3& cameraPosition);
+        void compactDrawList(CommandBuffer* commandBuffer, CullPhase phase);
+        // Draws every slot of the batch without an indirect command, for gpus without drawIndirectFirstInstance
+        void drawBatchSlots(CommandBuffer* commandBuffer, uint32_t batch) const;
+
+        // Everything one phase culls into and draws from
+        struct DrawList {
+            Buffer* visibleInstanceBuffer = nullptr;
+            Buffer* batchBuffer = nullptr;
+            // Only the batches with visible instances, used with vkCmdDrawIndexedIndirectCount
+            Buffer* drawBuffer = nullptr;
+            Buffer* drawCountBuffer = nullptr;
+
+            DescriptorSet* meshletDescriptorSet = nullptr;
+            DescriptorSet* compactDescriptorSet = nullptr;
+        };
+
+        ComputePipeline* m_TransformPipeline = nullptr;
+        ComputePipeline* m_CullPipeline = nullptr;
+        ComputePipeline* m_OcclusionPipeline = nullptr;
+        ComputePipeline* m_MeshletCullPipeline = nullptr;
+        ComputePipeline* m_CompactPipeline = nullptr;
+        DescriptorSet*   m_TransformDescriptorSet = nullptr;
+        // Only the early phase has a persistent cull set, the late one points at the pyramid and is made per frame
+        DescriptorSet*   m_CullDescriptorSet = nullptr;
+
+        // Merged geometry of every mesh in the scene
+        Buffer* m_VertexBuffer = nullptr;
+        // Where the stream of everything but the position starts in the merged vertex buffer
+        VkDeviceSize m_AttributeStreamOffset = 0;
+        Buffer* m_IndexBuffer = nullptr;
+
+        Buffer* m_InstanceBuffer = nullptr;
+        Buffer* m_ObjectBuffer = nullptr;
+        Buffer* m_ModelBuffer = nullptr;
+        // One flag per object, set when it passed the occlusion test of the last frame
+        Buffer* m_VisibilityBuffer = nullptr;
+        // Written by the cpu every frame the cpu occlusion culler runs
+        Buffer* m_CpuVisibilityBuffer = nullptr;
+        // The batches with no instances, copied over the batch buffers before culling starts counting again
+        Buffer* m_BatchTemplateBuffer = nullptr;
+        Buffer* m_ObjectInstanceBuffer = nullptr;
+        Buffer* m_MeshletBuffer = nullptr;
+        Buffer* m_MeshletDrawBuffer = nullptr;
+        // One flag per object, set by the object pass of the current phase when its meshlets are to be culled
+        Buffer* m_ClusterVisibilityBuffer = nullptr;
+
+        // The index and slot ranges of the batches and the first batch of every object, for drawObject and
+        // drawBatchSlots
+        std::vector<VkDrawIndexedIndirectCommand> m_BatchRanges;
+        std::vector<uint32_t>                     m_ObjectBatches;
+        std::vector<const Impostor*>              m_Impostors;
+
+        DrawList m_DrawLists[CULL_PHASE_COUNT];
+
+        VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
+
+        uint32_t m_ObjectCount = 0;
+        uint32_t m_BatchCount = 0;
+        // Only the mesh and meshlet batches go through compaction and draw, the impostor batches are drawn one by one
+        uint32_t m_MeshBatchCount = 0;
+        // The meshlet batches come right after the batches of whole meshes
+        uint32_t m_FirstMeshletBatch = 0;
+        uint32_t m_MeshletBatchCount = 0;
+        // Every level of a batch has room for all of the batch's objects in the visible instance lists
+        uint32_t m_InstanceSlotCount = 0;
+        // Object ids change with every build, so the visibility of the old scene means nothing
+        bool m_ResetVisibility = true;
+        bool m_CpuVisibilityCleared = false;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_GPU_SCENE_H
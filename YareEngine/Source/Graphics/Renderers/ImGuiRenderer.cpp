@@ -17,6 +17,7 @@ namespace Yare::Graphics {
     }
 
     ImGuiRenderer::~ImGuiRenderer() {
+        delete m_DescriptorSet;
         delete m_Font;
         delete m_Pipeline;
         delete m_IndexBuffer;
@@ -36,7 +37,15 @@ namespace Yare::Graphics {
         ImGuiIO& io = ImGui::GetIO();
         io.DisplaySize = ImVec2((float)windowWidth, (float)windowHeight);
         io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
-        io.Fonts->AddFontFromFileTTF("../Res/Fonts/Cousine-Regular.ttf", 24.0f);
+        m_FontFile = FileSystem::instance()->open("../Res/Fonts/Cousine-Regular.ttf");
+        if (!m_FontFile.empty()) {
+            ImFontConfig fontConfig;
+            fontConfig.FontDataOwnedByAtlas = false;
+            io.Fonts->AddFontFromMemoryTTF(const_cast<unsigned char*>(m_FontFile.data()),
+                                           static_cast<int>(m_FontFile.size()), 24.0f, &fontConfig);
+        } else {
+            YZ_WARN("The font could not be opened, ImGui's default font is used.");
+        }
 
         createGraphicsPipeline(renderPass);
         createDescriptorSet();
@@ -51,14 +60,13 @@ namespace Yare::Graphics {
         pInfo.cullMode = VK_CULL_MODE_NONE;
         pInfo.depthTestEnable = VK_FALSE;
         pInfo.depthWriteEnable = VK_FALSE;
-        pInfo.maxObjects = 2;
         pInfo.width = (size_t)ImGui::GetIO().DisplaySize.x;
         pInfo.height = (size_t)ImGui::GetIO().DisplaySize.y;
         pInfo.colorBlendingEnabled = true;
         pInfo.dynamicStates.emplace_back(VK_DYNAMIC_STATE_VIEWPORT);
         pInfo.dynamicStates.emplace_back(VK_DYNAMIC_STATE_SCISSOR);
         pInfo.pushConstants = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstBlock)};
-        pInfo.bindingDescription = VkVertexInputBindingDescription{0, sizeof(ImDrawVert), VK_VERTEX_INPUT_RATE_VERTEX};
+        pInfo.bindingDescriptions = {{0, sizeof(ImDrawVert), VK_VERTEX_INPUT_RATE_VERTEX}};
 
         VkVertexInputAttributeDescription pos = {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, pos)};
         VkVertexInputAttributeDescription uv = {1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, uv)};
@@ -67,7 +75,7 @@ namespace Yare::Graphics {
 
         VkDescriptorSetLayoutBinding sampler = {2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
                                                 VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
-        pInfo.layoutBindings = {sampler};
+        pInfo.setLayoutBindings = {{sampler}};
 
         m_Pipeline = new Pipeline();
         m_Pipeline->init(pInfo);
@@ -108,7 +116,44 @@ namespace Yare::Graphics {
         std::string fpsStr = "FPS: " + std::to_string((int)GlobalSettings::instance()->fps);
         ImGui::Text(fpsStr.c_str());
         ImGui::Checkbox("Render models", &GlobalSettings::instance()->displayModels);
+        if (GlobalSettings::instance()->displayModels) {
+            ImGui::Text("Cells: %d resident, %d loading, %.1f MB", GlobalSettings::instance()->residentCellCount,
+                        GlobalSettings::instance()->loadingCellCount, GlobalSettings::instance()->cellMegabytes);
+            ImGui::Text("Textures: %.1f of %.1f MB, %d loading", GlobalSettings::instance()->textureMegabytes,
+                        GlobalSettings::instance()->fullTextureMegabytes,
+                        GlobalSettings::instance()->loadingTextureCount);
+            ImGui::Text("Assets: %d resident, %d loading, %.1f MB cpu, %.1f MB gpu",
+                        GlobalSettings::instance()->assetCount, GlobalSettings::instance()->loadingAssetCount,
+                        GlobalSettings::instance()->assetCpuMegabytes, GlobalSettings::instance()->assetGpuMegabytes);
+            ImGui::Checkbox("List assets", &GlobalSettings::instance()->listAssets);
+            if (GlobalSettings::instance()->listAssets) {
+                for (const std::string& line : GlobalSettings::instance()->assetListing) {
+                    ImGui::TextUnformatted(line.c_str());
+                }
+            }
+        }
         ImGui::Checkbox("Display background", &GlobalSettings::instance()->displayBackground);
+        ImGui::Checkbox("Display terrain", &GlobalSettings::instance()->displayTerrain);
+        if (GlobalSettings::instance()->displayTerrain) {
+            ImGui::Text("Terrain nodes: %d, triangles: %d", GlobalSettings::instance()->terrainNodeCount,
+                        GlobalSettings::instance()->terrainTriangleCount);
+        }
+        ImGui::Checkbox("Occlusion culling", &GlobalSettings::instance()->occlusionCulling);
+        ImGui::Checkbox("Cpu occlusion culling", &GlobalSettings::instance()->cpuOcclusionCulling);
+        if (GlobalSettings::instance()->cpuOcclusionCulling) {
+            ImGui::Text("Occluded: %d / %d, raster: %.2f ms", GlobalSettings::instance()->cpuOccludedCount,
+                        GlobalSettings::instance()->cpuTestedCount, GlobalSettings::instance()->cpuRasterizeTime);
+        }
+        ImGui::Checkbox("Occlusion queries", &GlobalSettings::instance()->occlusionQueries);
+        if (GlobalSettings::instance()->occlusionQueries) {
+            ImGui::Text("Queries: %d, occluded: %d, triangles saved: %d", GlobalSettings::instance()->queryCount,
+                        GlobalSettings::instance()->queryOccludedCount,
+                        GlobalSettings::instance()->queryTrianglesSaved);
+        }
+        ImGui::SliderFloat("LOD bias", &GlobalSettings::instance()->lodBias, -2.0f, 4.0f);
+        ImGui::Checkbox("Impostors", &GlobalSettings::instance()->impostors);
+        ImGui::Checkbox("Meshlet culling", &GlobalSettings::instance()->meshletCulling);
+        ImGui::Checkbox("Depth prepass", &GlobalSettings::instance()->depthPrepass);
         ImGui::End();
         postFrame();
         updateBuffers();
@@ -166,12 +211,11 @@ namespace Yare::Graphics {
     }
 
     void ImGuiRenderer::onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) {
-        // Cleanup
-        {
-            delete m_Font;
-            delete m_Pipeline;
-        }
-        init(renderPass, newWidth, newHeight);
+        // The font and its descriptor set survive a resize, only the display size and pipeline change
+        Pipeline* oldPipeline = m_Pipeline;
+        ImGui::GetIO().DisplaySize = ImVec2((float)newWidth, (float)newHeight);
+        createGraphicsPipeline(renderPass);
+        delete oldPipeline;
     }
 
     void ImGuiRenderer::newFrame() { ImGui::NewFrame(); }
@@ -3,6 +3,7 @@
 
 #include <imgui/imgui.h>
 
+#include "Core/FileSystem.h"
 #include "Graphics/Renderers/Renderer.h"
 #include "Graphics/Vulkan/Buffer.h"
 #include "Graphics/Vulkan/DescriptorSet.h"
@@ -31,6 +32,8 @@ namespace Yare::Graphics {
             glm::vec2 translate = {};
         } m_PushConstBlock;
 
+        // The atlas reads the font where it is mapped
+        FileView       m_FontFile;
         Image*         m_Font;
         Pipeline*      m_Pipeline;
         Buffer*        m_IndexBuffer = nullptr;
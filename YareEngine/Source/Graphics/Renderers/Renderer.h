@@ -1,6 +1,7 @@
 #ifndef YARE_RENDERER_H
 #define YARE_RENDERER_H
 
+#include "Graphics/Renderers/DepthPyramid.h"
 #include "Graphics/Scene/Entity.h"
 #include "Graphics/Vulkan/CommandBuffer.h"
 #include "Graphics/Vulkan/Renderpass.h"
@@ -24,14 +25,29 @@ namespace Yare::Graphics {
         virtual ~Renderer() = default;
 
         virtual void prepareScene() = 0;
+        // Records compute work before the render pass begins, it may be recorded on the async compute queue so it
+        // must only touch resources that are shared with it
+        virtual void dispatch(CommandBuffer* commandBuffer) {}
+        // Records graphics queue work that has to happen outside of a render pass, before the first pass begins
+        virtual void recordPrePass(CommandBuffer* commandBuffer) {}
+        // Only called with occlusion culling. The early pass draws what was visible last frame, its depth is then
+        // reduced into the depth pyramid that dispatchLate tests against, and present draws the rest.
+        virtual void presentEarly(CommandBuffer* commandBuffer) {}
+        virtual void dispatchLate(CommandBuffer* commandBuffer, const DepthPyramid& depthPyramid) {}
         virtual void present(CommandBuffer* commandBuffer) = 0;
         virtual void onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) = 0;
+        // Called once the assets the renderer queued on the startup loader are uploaded
+        virtual void onAssetsLoaded(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {}
+
+        // Set by the render manager, which owns the passes, before the frame is recorded
+        void setOcclusionCulling(bool enabled) { m_OcclusionCulling = enabled; }
 
        protected:
         virtual void init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) = 0;
         virtual void resetCommandQueue();
         virtual void submit(Entity* instance);
         CommandQueue m_CommandQueue;
+        bool         m_OcclusionCulling = false;
     };
 }  // namespace Yare::Graphics
 #endif  // YARE_RENDERER_H
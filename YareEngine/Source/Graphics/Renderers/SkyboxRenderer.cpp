@@ -9,7 +9,7 @@
 
 namespace Yare::Graphics {
 
-    SkyboxRenderer::SkyboxRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
+    SkyboxRenderer::SkyboxRenderer(AssetLoader& assetLoader) : m_AssetLoader(&assetLoader) {
         std::vector<std::string> skyboxTextures1 = {
             "../Res/Textures/skybox/posx.jpg", "../Res/Textures/skybox/negx.jpg", "../Res/Textures/skybox/posy.jpg",
             "../Res/Textures/skybox/negy.jpg", "../Res/Textures/skybox/posz.jpg", "../Res/Textures/skybox/negz.jpg"};
@@ -17,11 +17,10 @@ namespace Yare::Graphics {
             "../Res/Textures/stormy_skybox/stormydays_ft.tga", "../Res/Textures/stormy_skybox/stormydays_bk.tga",
             "../Res/Textures/stormy_skybox/stormydays_up.tga", "../Res/Textures/stormy_skybox/stormydays_dn.tga",
             "../Res/Textures/stormy_skybox/stormydays_rt.tga", "../Res/Textures/stormy_skybox/stormydays_lf.tga"};
-        m_Material = std::make_shared<Material>(skyboxTextures, MaterialTexType::TextureCube);
-        m_CubeMesh = std::make_shared<Mesh>(*createMesh(PrimativeShape::CUBE));
-
-        m_SkyboxModel = new Entity(m_CubeMesh, m_Material);
-        init(renderPass, windowWidth, windowHeight);
+        // The six faces are decoded on the workers straight into the staging buffer
+        m_Cube = m_AssetLoader->loadTextureCube(skyboxTextures);
+        // The positions double as the directions into the cube map, so they stay unquantized
+        m_CubeMesh = std::make_shared<Mesh>(*createMesh(PrimativeShape::CUBE, PRECISE_VERTEX_LAYOUT));
     }
 
     SkyboxRenderer::~SkyboxRenderer() {
@@ -31,8 +30,17 @@ namespace Yare::Graphics {
         delete m_SkyboxModel;
     }
 
+    void SkyboxRenderer::onAssetsLoaded(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
+        m_Material = m_AssetLoader->wait(m_Cube);
+        if (!m_Material) {
+            YZ_CRITICAL("The skybox '" + m_Cube.getPath() + "' could not be loaded.");
+        }
+        m_Cube = {};
+        m_SkyboxModel = new Entity(m_CubeMesh, m_Material);
+        init(renderPass, windowWidth, windowHeight);
+    }
+
     void SkyboxRenderer::init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
-        m_Material->loadTextures();
         createGraphicsPipeline(renderPass, windowWidth, windowHeight);
         prepareUniformBuffer();
         createDescriptorSet();
@@ -43,32 +51,39 @@ namespace Yare::Graphics {
         submit(m_SkyboxModel);
     }
 
+    void SkyboxRenderer::presentEarly(CommandBuffer* commandBuffer) {
+        // The skybox ignores depth, so it has to be drawn before anything else in the first pass
+        drawSkybox(commandBuffer);
+    }
+
     void SkyboxRenderer::present(CommandBuffer* commandBuffer) {
+        if (!m_OcclusionCulling) {
+            drawSkybox(commandBuffer);
+        }
+    }
+
+    void SkyboxRenderer::drawSkybox(CommandBuffer* commandBuffer) {
         if (GlobalSettings::instance()->displayBackground) {
             for (auto command : m_CommandQueue) {
                 vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         m_Pipeline->getPipelineLayout(), 0, 1, &m_DescriptorSet->getDescriptorSet(0), 0,
                                         nullptr);
-                command.entity->getMesh()->getVertexBuffer()->bindVertex(commandBuffer, 0);
-                command.entity->getMesh()->getIndexBuffer()->bindIndex(commandBuffer, VK_INDEX_TYPE_UINT32);
+                const auto& mesh = command.entity->getMesh();
+                mesh->bindVertexStreams(commandBuffer, true);
+                mesh->getIndexBuffer()->bindIndex(commandBuffer, mesh->getIndexType());
                 m_Pipeline->setActive(*commandBuffer);
 
-                auto indexCount = command.entity->getMesh()->getIndexBuffer()->getSize() / sizeof(uint32_t);
-                vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), static_cast<uint32_t>(indexCount), 1, 0, 0, 0);
+                vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), mesh->getIndexCount(), 1, 0, 0, 0);
                 updateUniformBuffer(0);
             }
         }
     }
 
     void SkyboxRenderer::onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) {
-        // Cleanup
-        {
-            delete m_Pipeline;
-            delete m_UniformBuffer;
-        }
+        // The descriptor set and uniform buffer don't depend on the window size, only the pipeline does
+        Pipeline* oldPipeline = m_Pipeline;
         createGraphicsPipeline(renderPass, newWidth, newHeight);
-        prepareUniformBuffer();
-        createDescriptorSet();
+        delete oldPipeline;
     }
 
     void SkyboxRenderer::createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height) {
@@ -80,22 +95,20 @@ namespace Yare::Graphics {
         pipelineInfo.cullMode = VK_CULL_MODE_FRONT_BIT;
         pipelineInfo.depthTestEnable = VK_FALSE;
         pipelineInfo.depthWriteEnable = VK_FALSE;
-        pipelineInfo.maxObjects = 2;
 
-        // location, binding, format, offset
-        VkVertexInputAttributeDescription pos = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, pos)};
-        pipelineInfo.vertexInputAttributes = {pos};
+        // Only the position is read
+        pipelineInfo.vertexInputAttributes = m_CubeMesh->getVertexLayout().getPositionAttributeDescriptions();
 
         // binding, descriptorType, descriptorCount, stageFlags, pImmuatbleSamplers
         VkDescriptorSetLayoutBinding viewProj = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
                                                  nullptr};
         VkDescriptorSetLayoutBinding sampler = {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
                                                 VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
-        pipelineInfo.layoutBindings = {viewProj, sampler};
+        pipelineInfo.setLayoutBindings = {{viewProj, sampler}};
         pipelineInfo.width = width;
         pipelineInfo.height = height;
         pipelineInfo.pushConstants = {VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(int)};
-        pipelineInfo.bindingDescription = {0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX};
+        pipelineInfo.bindingDescriptions = m_CubeMesh->getVertexLayout().getPositionBindingDescriptions();
 
         m_Pipeline = new Pipeline();
         m_Pipeline->init(pipelineInfo);
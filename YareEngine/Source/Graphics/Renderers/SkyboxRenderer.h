@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "Graphics/AssetLoader.h"
 #include "Graphics/Renderers/Renderer.h"
 #include "Graphics/Vulkan/Buffer.h"
 #include "Graphics/Vulkan/DescriptorSet.h"
@@ -12,10 +13,14 @@ namespace Yare::Graphics {
 
     class SkyboxRenderer : public Renderer {
        public:
-        SkyboxRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight);
+        // Requests the cube map from the asset loader, the pipeline is created once it is loaded
+        SkyboxRenderer(AssetLoader& assetLoader);
         ~SkyboxRenderer() override;
 
+        void onAssetsLoaded(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) override;
+
         void prepareScene() override;
+        void presentEarly(CommandBuffer* commandBuffer) override;
         void present(CommandBuffer* commandBuffer) override;
         void onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) override;
 
@@ -23,13 +28,16 @@ namespace Yare::Graphics {
         void init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) override;
         void createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height);
         void createDescriptorSet();
+        void drawSkybox(CommandBuffer* commandBuffer);
         void prepareUniformBuffer();
         void updateUniformBuffer(uint32_t index);
 
        private:
         std::shared_ptr<Mesh>     m_CubeMesh;
+        AssetLoader*              m_AssetLoader;
+        AssetHandle<Material>     m_Cube;
         std::shared_ptr<Material> m_Material;
-        Entity*                   m_SkyboxModel;
+        Entity*                   m_SkyboxModel = nullptr;
         Pipeline*                 m_Pipeline;
         DescriptorSet*            m_DescriptorSet;
         Buffer*                   m_UniformBuffer;
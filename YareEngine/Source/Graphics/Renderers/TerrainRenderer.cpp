@@ -0,0 +1,255 @@
+#include "Graphics/Renderers/TerrainRenderer.h"
+
+#include <cmath>
+
+#include "Application/Application.h"
+#include "Application/GlobalSettings.h"
+#include "Graphics/Camera/Frustum.h"
+#include "Graphics/MeshFactory.h"
+#include "Graphics/Terrain/Heightfield.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        struct TerrainPushConstants {
+            glm::vec4 cameraPosition;
+            // World size, base height, grid resolution and one unused
+            glm::vec4 terrain;
+        };
+
+        constexpr uint32_t HEIGHTMAP_SIZE = 1025;
+        // The scene stands around the origin, the terrain only rises beyond it
+        constexpr float FLAT_RADIUS = 60.0f;
+
+        // Noise heights, flat around the origin
+        std::vector<float> generateHeights(uint32_t size, float worldSize) {
+            HeightfieldSettings settings;
+            settings.type = NoiseType::DOMAIN_WARP;
+            std::vector<float> heights = loadHeightfield("../Res/terrain.heightfield", size, worldSize, settings);
+            for (uint32_t z = 0; z < size; z++) {
+                for (uint32_t x = 0; x < size; x++) {
+                    glm::vec2 position = (glm::vec2(x, z) / float(size - 1) - 0.5f) * worldSize;
+                    float     rise = glm::smoothstep(FLAT_RADIUS, FLAT_RADIUS * 4.0f, glm::length(position));
+                    heights[size_t(z) * size + x] *= rise;
+                }
+            }
+            return heights;
+        }
+    }  // namespace
+
+    TerrainRenderer::TerrainRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
+        TerrainSettings settings;
+        // Just under the plane the scene stands on
+        settings.baseHeight = -0.6f;
+
+        m_HeightmapSize = HEIGHTMAP_SIZE;
+        std::vector<float> heights = generateHeights(m_HeightmapSize, settings.worldSize);
+        m_Quadtree = std::make_unique<TerrainQuadtree>(heights, m_HeightmapSize, settings);
+        // One float per texel, texelFetch'ed and filtered by hand since linear filtering of floats is optional
+        m_Heightmap = Image::createTexture2D(m_HeightmapSize, m_HeightmapSize, VK_FORMAT_R32_SFLOAT,
+                                             reinterpret_cast<unsigned char*>(heights.data()));
+
+        init(renderPass, windowWidth, windowHeight);
+    }
+
+    TerrainRenderer::~TerrainRenderer() {
+        delete m_Pipeline;
+        delete m_DescriptorSet;
+        delete m_Heightmap;
+        delete m_UniformBuffer;
+        delete m_NodeBuffer;
+        delete m_GridVertexBuffer;
+        delete m_GridIndexBuffer;
+    }
+
+    void TerrainRenderer::init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) {
+        createGrid();
+        createGraphicsPipeline(renderPass, windowWidth, windowHeight);
+        m_UniformBuffer = new Buffer(BufferUsage::UNIFORM, sizeof(UniformVS), nullptr);
+        m_NodeBuffer =
+            new Buffer(BufferUsage::STORAGE, m_Quadtree->getSettings().maxNodes * sizeof(TerrainNode), nullptr);
+        createDescriptorSet();
+    }
+
+    void TerrainRenderer::createGrid() {
+        uint32_t     resolution = m_Quadtree->getSettings().gridResolution;
+        GridSettings settings;
+        settings.columns = resolution + 1;
+        settings.rows = resolution + 1;
+        settings.spacing = 1.0f / resolution;
+
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        generateGrid(settings, vertices, indices);
+
+        std::vector<glm::vec2> positions;
+        positions.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            positions.emplace_back(vertex.pos.x, vertex.pos.z);
+        }
+
+        // Quarter by quarter, each keeping the row order of the grid
+        uint32_t              half = resolution / 2;
+        std::vector<uint16_t> quarterIndices;
+        quarterIndices.reserve(indices.size());
+        for (uint32_t quarter = 0; quarter < 4; quarter++) {
+            for (uint32_t row = 0; row < half; row++) {
+                for (uint32_t column = 0; column < half; column++) {
+                    size_t cell = size_t(row + half * (quarter / 2)) * resolution + column + half * (quarter % 2);
+                    quarterIndices.insert(quarterIndices.end(), indices.begin() + cell * 6,
+                                          indices.begin() + cell * 6 + 6);
+                }
+            }
+        }
+        m_QuarterIndexCount = static_cast<uint32_t>(quarterIndices.size() / 4);
+
+        m_GridVertexBuffer =
+            new Buffer(BufferUsage::VERTEX, positions.size() * sizeof(glm::vec2), positions.data());
+        m_GridIndexBuffer =
+            new Buffer(BufferUsage::INDEX, quarterIndices.size() * sizeof(uint16_t), quarterIndices.data());
+    }
+
+    void TerrainRenderer::prepareScene() {}
+
+    void TerrainRenderer::presentEarly(CommandBuffer* commandBuffer) {
+        // The terrain hides a lot of the scene, so it goes into the early pass with everything visible last frame
+        drawTerrain(commandBuffer);
+    }
+
+    void TerrainRenderer::present(CommandBuffer* commandBuffer) {
+        if (!m_OcclusionCulling) {
+            drawTerrain(commandBuffer);
+        }
+    }
+
+    void TerrainRenderer::drawTerrain(CommandBuffer* commandBuffer) {
+        if (!GlobalSettings::instance()->displayTerrain) {
+            GlobalSettings::instance()->terrainNodeCount = 0;
+            GlobalSettings::instance()->terrainTriangleCount = 0;
+            return;
+        }
+
+        auto      camera = Application::getAppInstance()->getWindow()->getCamera();
+        UniformVS view = {};
+        view.view = camera->getViewMatrix();
+        view.projection = camera->getProjectionMatrix();
+        view.projection[1][1] *= -1;
+        m_UniformBuffer->setData(sizeof(view), &view);
+
+        glm::vec3 cameraPosition = glm::vec3(glm::inverse(view.view)[3]);
+        m_Quadtree->select(cameraPosition, Frustum::fromMatrix(view.projection * view.view), m_Selection);
+
+        // Every part's nodes back to back, each draw finds its first one through firstInstance
+        std::vector<TerrainNode> nodes;
+        uint32_t                 firstNode[TERRAIN_PART_COUNT];
+        for (uint32_t part = 0; part < TERRAIN_PART_COUNT; part++) {
+            firstNode[part] = static_cast<uint32_t>(nodes.size());
+            nodes.insert(nodes.end(), m_Selection.nodes[part].begin(), m_Selection.nodes[part].end());
+        }
+        if (nodes.empty()) {
+            return;
+        }
+        m_NodeBuffer->setData(nodes.size() * sizeof(TerrainNode), nodes.data());
+
+        const TerrainSettings& settings = m_Quadtree->getSettings();
+        TerrainPushConstants   constants = {};
+        constants.cameraPosition = glm::vec4(cameraPosition, 1.0f);
+        constants.terrain = glm::vec4(settings.worldSize, settings.baseHeight,
+                                      static_cast<float>(settings.gridResolution), 0.0f);
+
+        m_Pipeline->setActive(*commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                m_Pipeline->getPipelineLayout(), 0, 1, &m_DescriptorSet->getDescriptorSet(0), 0,
+                                nullptr);
+        vkCmdPushConstants(commandBuffer->getCommandBuffer(), m_Pipeline->getPipelineLayout(),
+                           VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+        m_GridVertexBuffer->bindVertex(commandBuffer, 0);
+        m_GridIndexBuffer->bindIndex(commandBuffer, VK_INDEX_TYPE_UINT16);
+
+        uint32_t triangleCount = 0;
+        for (uint32_t part = 0; part < TERRAIN_PART_COUNT; part++) {
+            uint32_t nodeCount = static_cast<uint32_t>(m_Selection.nodes[part].size());
+            if (nodeCount == 0) {
+                continue;
+            }
+            // The quarters are consecutive ranges, so the whole grid is all four of them
+            bool     whole = part == TERRAIN_PART_WHOLE;
+            uint32_t indexCount = whole ? m_QuarterIndexCount * 4 : m_QuarterIndexCount;
+            uint32_t firstIndex = whole ? 0 : m_QuarterIndexCount * part;
+            vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), indexCount, nodeCount, firstIndex, 0,
+                             firstNode[part]);
+            triangleCount += indexCount / 3 * nodeCount;
+        }
+        GlobalSettings::instance()->terrainNodeCount = static_cast<int>(nodes.size());
+        GlobalSettings::instance()->terrainTriangleCount = static_cast<int>(triangleCount);
+    }
+
+    void TerrainRenderer::onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) {
+        // The set layouts come from the resource cache, so the descriptor set stays valid with the new pipeline
+        Pipeline* oldPipeline = m_Pipeline;
+        createGraphicsPipeline(renderPass, newWidth, newHeight);
+        delete oldPipeline;
+    }
+
+    void TerrainRenderer::createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height) {
+        Shader       shader("../Res/Shaders/Terrain", "terrain.shader");
+        PipelineInfo pInfo = {};
+        pInfo.shader = &shader;
+        pInfo.renderpass = renderPass;
+        pInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+        pInfo.depthTestEnable = VK_TRUE;
+        pInfo.depthWriteEnable = VK_TRUE;
+        pInfo.width = width;
+        pInfo.height = height;
+        pInfo.bindingDescriptions = {{0, sizeof(glm::vec2), VK_VERTEX_INPUT_RATE_VERTEX}};
+        pInfo.vertexInputAttributes = {{0, 0, VK_FORMAT_R32G32_SFLOAT, 0}};
+        pInfo.pushConstants = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(TerrainPushConstants)};
+
+        // binding, descriptorType, descriptorCount, stageFlags, pImmuatbleSamplers
+        VkDescriptorSetLayoutBinding viewProj = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                                 nullptr};
+        VkDescriptorSetLayoutBinding heightmap = {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                                                  VK_SHADER_STAGE_VERTEX_BIT, nullptr};
+        VkDescriptorSetLayoutBinding nodes = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT,
+                                              nullptr};
+        pInfo.setLayoutBindings = {{viewProj, heightmap, nodes}};
+
+        m_Pipeline = new Pipeline();
+        m_Pipeline->init(pInfo);
+    }
+
+    void TerrainRenderer::createDescriptorSet() {
+        DescriptorSetInfo descriptorSetInfo;
+        descriptorSetInfo.descriptorSetCount = 1;
+        descriptorSetInfo.pipeline = m_Pipeline;
+
+        m_DescriptorSet = new DescriptorSet();
+        m_DescriptorSet->init(descriptorSetInfo);
+
+        BufferInfo viewInfo = {};
+        viewInfo.buffer = m_UniformBuffer->getBuffer();
+        viewInfo.offset = 0;
+        viewInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        viewInfo.size = sizeof(UniformVS);
+        viewInfo.binding = 0;
+        viewInfo.descriptorCount = 1;
+
+        BufferInfo heightmapInfo = {};
+        heightmapInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        heightmapInfo.binding = 1;
+        heightmapInfo.descriptorCount = 1;
+        heightmapInfo.imageSamplers.push_back(m_Heightmap->getSampler());
+        heightmapInfo.imageViews.push_back(m_Heightmap->getImageView());
+
+        BufferInfo nodeInfo = {};
+        nodeInfo.buffer = m_NodeBuffer->getBuffer();
+        nodeInfo.offset = 0;
+        nodeInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        nodeInfo.size = static_cast<uint32_t>(m_NodeBuffer->getSize());
+        nodeInfo.binding = 2;
+        nodeInfo.descriptorCount = 1;
+
+        std::vector<BufferInfo> bufferInfos = {viewInfo, heightmapInfo, nodeInfo};
+        m_DescriptorSet->update(bufferInfos);
+    }
+}  // namespace Yare::Graphics
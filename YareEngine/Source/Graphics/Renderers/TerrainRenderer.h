@@ -0,0 +1,51 @@
+#ifndef YARE_TERRAIN_RENDERER_H
+#define YARE_TERRAIN_RENDERER_H
+
+#include <memory>
+
+#include "Graphics/Renderers/Renderer.h"
+#include "Graphics/Terrain/TerrainQuadtree.h"
+#include "Graphics/Vulkan/Buffer.h"
+#include "Graphics/Vulkan/DescriptorSet.h"
+#include "Graphics/Vulkan/Image.h"
+#include "Graphics/Vulkan/Pipeline.h"
+
+namespace Yare::Graphics {
+
+    // Draws the ground as a CDLOD terrain. Every selected node is an instance of one small grid mesh, which the
+    // vertex shader moves into place and displaces with the heightmap, so the whole terrain is five instanced draws.
+    class TerrainRenderer : public Renderer {
+       public:
+        TerrainRenderer(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight);
+        ~TerrainRenderer() override;
+
+        void prepareScene() override;
+        void presentEarly(CommandBuffer* commandBuffer) override;
+        void present(CommandBuffer* commandBuffer) override;
+        void onResize(RenderPass* renderPass, uint32_t newWidth, uint32_t newHeight) override;
+
+       private:
+        void init(RenderPass* renderPass, uint32_t windowWidth, uint32_t windowHeight) override;
+        void createGrid();
+        void createGraphicsPipeline(RenderPass* renderPass, uint32_t width, uint32_t height);
+        void createDescriptorSet();
+        void drawTerrain(CommandBuffer* commandBuffer);
+
+       private:
+        std::unique_ptr<TerrainQuadtree> m_Quadtree;
+        TerrainSelection                 m_Selection;
+        uint32_t                         m_HeightmapSize = 0;
+
+        Pipeline*      m_Pipeline = nullptr;
+        DescriptorSet* m_DescriptorSet = nullptr;
+        Image*         m_Heightmap = nullptr;
+        Buffer*        m_UniformBuffer = nullptr;
+        Buffer*        m_NodeBuffer = nullptr;
+        // The grid's xz in [0, 1], its indices ordered by quarter so each quarter is a range of its own
+        Buffer*  m_GridVertexBuffer = nullptr;
+        Buffer*  m_GridIndexBuffer = nullptr;
+        uint32_t m_QuarterIndexCount = 0;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_TERRAIN_RENDERER_H
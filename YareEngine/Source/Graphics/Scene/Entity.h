@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "Graphics/Components/Impostor.h"
 #include "Graphics/Components/Material.h"
 #include "Graphics/Components/Mesh.h"
 #include "Graphics/Components/Transform.h"
@@ -19,19 +20,27 @@ namespace Yare::Graphics {
         void setMesh(std::shared_ptr<Mesh> mesh) { m_Mesh = mesh; }
         void setMaterial(std::shared_ptr<Material> material) { m_Material = material; }
         void setTransform(Transform& transform) { m_Transform = transform; }
+        // Occluders are rasterized by the cpu occlusion culler, their mesh needs occluder geometry
+        void setOccluder(bool occluder) { m_Occluder = occluder; }
+        // Drawn in place of the mesh once it's far enough away, it has to be baked from the same mesh and material
+        void setImpostor(std::shared_ptr<Impostor> impostor) { m_Impostor = impostor; }
 
         // clang-format off
         const std::shared_ptr<Mesh>       getMesh()      const { return m_Mesh; }
         const std::shared_ptr<Material>   getMaterial()  const { return m_Material; }
         const Transform&                  getTransform() const { return m_Transform; }
+        bool                              isOccluder()   const { return m_Occluder; }
+        const std::shared_ptr<Impostor>   getImpostor()  const { return m_Impostor; }
         // clang-format on
 
        private:
         std::shared_ptr<Mesh>     m_Mesh;
         std::shared_ptr<Material> m_Material;
         Transform                 m_Transform;
+        std::shared_ptr<Impostor> m_Impostor;
 
-        int m_ImageIdx = 0;
+        int  m_ImageIdx = 0;
+        bool m_Occluder = false;
     };
 
 }  // namespace Yare::Graphics
@@ -0,0 +1,290 @@
+#include "Graphics/Scene/WorldPartition.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    WorldPartition::WorldPartition(AssetLoader& assets, const WorldPartitionSettings& settings)
+        : m_Settings(settings), m_Assets(&assets) {
+        m_Settings.unloadRadius = (std::max)(m_Settings.unloadRadius, m_Settings.loadRadius);
+    }
+
+    void WorldPartition::addCell(const CellManifest& manifest) {
+        m_Cells.push_back(std::make_unique<Cell>());
+        m_Cells.back()->manifest = manifest;
+        m_Stats.cellCount = static_cast<uint32_t>(m_Cells.size());
+    }
+
+    void WorldPartition::addResidentMesh(const std::string& path, std::shared_ptr<Mesh> mesh) {
+        m_ResidentMeshes[path] = mesh;
+    }
+
+    void WorldPartition::addResidentMaterial(const std::string& texturePath, std::shared_ptr<Material> material) {
+        m_ResidentMaterials[texturePath] = material;
+    }
+
+    bool WorldPartition::update(const glm::vec3& cameraPosition) {
+        bool               changed = false;
+        std::vector<Cell*> inRangeCells;
+        std::vector<Cell*> loadedCells;
+        for (auto& cell : m_Cells) {
+            cell->distance = getDistance(*cell, cameraPosition);
+            bool inRange = cell->distance < m_Settings.loadRadius;
+            bool outOfRange = cell->distance > m_Settings.unloadRadius;
+            switch (cell->state) {
+                case CellState::UNLOADED:
+                    if (inRange) {
+                        inRangeCells.push_back(cell.get());
+                    }
+                    break;
+                case CellState::LOADING:
+                    if (outOfRange) {
+                        cancelCell(*cell);
+                    } else if (isCellLoaded(*cell)) {
+                        loadedCells.push_back(cell.get());
+                    }
+                    break;
+                case CellState::RESIDENT:
+                    if (outOfRange) {
+                        unloadCell(*cell);
+                        changed = true;
+                    }
+                    break;
+            }
+        }
+
+        // The loader decodes in the order it is asked, so the nearest cells go first. Nothing new is requested while
+        // the budget is used up, or cells made room for would come straight back.
+        size_t residentBytes = getResidentBytes();
+        if (residentBytes < m_Settings.memoryBudget) {
+            std::sort(inRangeCells.begin(), inRangeCells.end(),
+                      [](const Cell* a, const Cell* b) { return a->distance < b->distance; });
+            for (Cell* cell : inRangeCells) {
+                requestCell(*cell);
+                // Everything may be resident already
+                if (isCellLoaded(*cell)) {
+                    loadedCells.push_back(cell);
+                }
+            }
+        }
+
+        std::sort(loadedCells.begin(), loadedCells.end(),
+                  [](const Cell* a, const Cell* b) { return a->distance < b->distance; });
+        uint32_t commitCount = 0;
+        for (Cell* cell : loadedCells) {
+            if (commitCount >= m_Settings.commitsPerFrame) {
+                break;
+            }
+
+            // Cells further away than this one make room for it, when that isn't enough it waits for the camera to
+            // move on
+            size_t cellBytes = getCellBytes(*cell);
+            while (residentBytes + cellBytes > m_Settings.memoryBudget) {
+                Cell* farthest = nullptr;
+                for (auto& other : m_Cells) {
+                    if (other->state == CellState::RESIDENT && other->distance > cell->distance &&
+                        (!farthest || other->distance > farthest->distance)) {
+                        farthest = other.get();
+                    }
+                }
+                if (!farthest) {
+                    break;
+                }
+                unloadCell(*farthest);
+                changed = true;
+                residentBytes = getResidentBytes();
+                cellBytes = getCellBytes(*cell);
+            }
+            if (residentBytes + cellBytes > m_Settings.memoryBudget) {
+                continue;
+            }
+
+            commitCell(*cell);
+            commitCount++;
+            changed = true;
+            residentBytes = getResidentBytes();
+        }
+
+        m_Stats.residentCellCount = 0;
+        m_Stats.loadingCellCount = 0;
+        for (const auto& cell : m_Cells) {
+            m_Stats.residentCellCount += cell->state == CellState::RESIDENT ? 1 : 0;
+            m_Stats.loadingCellCount += cell->state == CellState::LOADING ? 1 : 0;
+        }
+        m_Stats.residentBytes = residentBytes;
+        return changed;
+    }
+
+    std::vector<std::shared_ptr<Entity>> WorldPartition::getEntities() const {
+        std::vector<std::shared_ptr<Entity>> entities;
+        for (const auto& cell : m_Cells) {
+            if (cell->state == CellState::RESIDENT) {
+                entities.insert(entities.end(), cell->entities.begin(), cell->entities.end());
+            }
+        }
+        return entities;
+    }
+
+    std::vector<std::shared_ptr<Material>> WorldPartition::getMaterials() const {
+        std::vector<std::shared_ptr<Material>> materials;
+        for (const auto& cell : m_Cells) {
+            if (cell->state != CellState::RESIDENT) {
+                continue;
+            }
+            for (const auto& entity : cell->entities) {
+                const auto& material = entity->getMaterial();
+                if (std::find(materials.begin(), materials.end(), material) == materials.end() &&
+                    !isResidentMaterial(material.get())) {
+                    materials.push_back(material);
+                }
+            }
+        }
+        return materials;
+    }
+
+    void WorldPartition::requestCell(Cell& cell) {
+        // Assets the loader has already, the renderer's among them, are shared straight away
+        for (const auto& entity : cell.manifest.entities) {
+            if (!cell.meshes.count(entity.meshPath)) {
+                cell.meshes[entity.meshPath] = m_Assets->loadMesh(entity.meshPath);
+            }
+            if (!entity.texturePath.empty() && !cell.materials.count(entity.texturePath)) {
+                cell.materials[entity.texturePath] = m_Assets->loadTexture(entity.texturePath);
+            }
+        }
+        cell.state = CellState::LOADING;
+    }
+
+    bool WorldPartition::isCellLoaded(const Cell& cell) const {
+        for (const auto& mesh : cell.meshes) {
+            if (!mesh.second.isReady()) {
+                return false;
+            }
+        }
+        for (const auto& material : cell.materials) {
+            if (!material.second.isReady()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WorldPartition::commitCell(Cell& cell) {
+        auto defaultMaterial = m_ResidentMaterials.find("");
+        for (const auto& entity : cell.manifest.entities) {
+            // The loader already reported the meshes that failed, their entities are left out
+            std::shared_ptr<Mesh> mesh = cell.meshes[entity.meshPath].get();
+            if (!mesh) {
+                continue;
+            }
+
+            // A texture that fails to load falls back to the default material
+            std::shared_ptr<Material> material =
+                entity.texturePath.empty() ? nullptr : cell.materials[entity.texturePath].get();
+            if (!material && defaultMaterial != m_ResidentMaterials.end()) {
+                material = defaultMaterial->second;
+            }
+            if (!material) {
+                YZ_WARN("'" + entity.texturePath + "' could not be loaded and there is no default material.");
+                continue;
+            }
+
+            cell.entities.push_back(std::make_shared<Entity>(mesh, material, entity.transform));
+        }
+        cancelCell(cell);
+        cell.state = CellState::RESIDENT;
+    }
+
+    void WorldPartition::unloadCell(Cell& cell) {
+        // The assets go with the last entity using them, the loader keeps them a while within its budget
+        cell.entities.clear();
+        cell.state = CellState::UNLOADED;
+    }
+
+    void WorldPartition::cancelCell(Cell& cell) {
+        cell.meshes.clear();
+        cell.materials.clear();
+        cell.state = CellState::UNLOADED;
+    }
+
+    size_t WorldPartition::getCellBytes(const Cell& cell) const {
+        // Assets a resident cell uses already are counted with that cell
+        std::unordered_set<const Mesh*>     meshes;
+        std::unordered_set<const Material*> materials;
+        for (const auto& other : m_Cells) {
+            if (other->state != CellState::RESIDENT) {
+                continue;
+            }
+            for (const auto& entity : other->entities) {
+                meshes.insert(entity->getMesh().get());
+                materials.insert(entity->getMaterial().get());
+            }
+        }
+
+        size_t size = 0;
+        for (const auto& handle : cell.meshes) {
+            std::shared_ptr<Mesh> mesh = handle.second.get();
+            if (mesh && !isResidentMesh(mesh.get()) && meshes.insert(mesh.get()).second) {
+                size += mesh->getMemorySize();
+            }
+        }
+        for (const auto& handle : cell.materials) {
+            std::shared_ptr<Material> material = handle.second.get();
+            if (material && !isResidentMaterial(material.get()) && materials.insert(material.get()).second) {
+                size += material->getTextureImage()->getMemorySize();
+            }
+        }
+        return size;
+    }
+
+    size_t WorldPartition::getResidentBytes() const {
+        // Counted from the resident cells rather than from what is still alive, the renderer lets go of unloaded
+        // cells' assets only once update returns
+        std::unordered_set<const Mesh*>     meshes;
+        std::unordered_set<const Material*> materials;
+        size_t                              size = 0;
+        for (const auto& cell : m_Cells) {
+            if (cell->state != CellState::RESIDENT) {
+                continue;
+            }
+            for (const auto& entity : cell->entities) {
+                const Mesh* mesh = entity->getMesh().get();
+                if (!isResidentMesh(mesh) && meshes.insert(mesh).second) {
+                    size += mesh->getMemorySize();
+                }
+                const Material* material = entity->getMaterial().get();
+                if (!isResidentMaterial(material) && materials.insert(material).second) {
+                    size += material->getTextureImage()->getMemorySize();
+                }
+            }
+        }
+        return size;
+    }
+
+    bool WorldPartition::isResidentMesh(const Mesh* mesh) const {
+        for (const auto& resident : m_ResidentMeshes) {
+            if (resident.second.get() == mesh) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool WorldPartition::isResidentMaterial(const Material* material) const {
+        for (const auto& resident : m_ResidentMaterials) {
+            if (resident.second.get() == material) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float WorldPartition::getDistance(const Cell& cell, const glm::vec3& cameraPosition) const {
+        glm::vec2 min = glm::vec2(cell.manifest.x, cell.manifest.z) * m_Settings.cellSize;
+        glm::vec2 camera = glm::vec2(cameraPosition.x, cameraPosition.z);
+        return glm::distance(camera, glm::clamp(camera, min, min + m_Settings.cellSize));
+    }
+}  // namespace Yare::Graphics
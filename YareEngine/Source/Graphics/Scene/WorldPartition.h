@@ -0,0 +1,114 @@
+#ifndef YARE_WORLD_PARTITION_H
+#define YARE_WORLD_PARTITION_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/AssetLoader.h"
+#include "Graphics/Scene/Entity.h"
+
+namespace Yare::Graphics {
+
+    // One entity of a cell, its assets are referenced by path and shared with every other cell using them
+    struct CellEntity {
+        std::string meshPath;
+        // Empty for the default texture
+        std::string texturePath;
+        Transform   transform;
+    };
+
+    // Everything a cell loads, the cell covers [x, x + 1) cell sizes along world x and [z, z + 1) along world z
+    struct CellManifest {
+        int32_t                 x = 0;
+        int32_t                 z = 0;
+        std::vector<CellEntity> entities;
+    };
+
+    struct WorldPartitionSettings {
+        float cellSize = 32.0f;
+        // Cells closer to the camera than the load radius are loaded, they are only unloaded again past the unload
+        // radius so a camera moving back and forth over a cell edge doesn't keep reloading it
+        float loadRadius = 48.0f;
+        float unloadRadius = 72.0f;
+        // Bytes of meshes and textures the cells may keep resident, the farthest cells make room for nearer ones
+        size_t   memoryBudget = size_t(256) << 20;
+        // Cells made resident per frame at most, which spreads the uploads over several frames
+        uint32_t commitsPerFrame = 2;
+    };
+
+    struct WorldPartitionStats {
+        uint32_t cellCount = 0;
+        uint32_t residentCellCount = 0;
+        uint32_t loadingCellCount = 0;
+        size_t   residentBytes = 0;
+    };
+
+    // Divides the world into square cells, each with its own manifest of entities. The cells near the camera request
+    // their assets from the asset loader, nearest first, and are unloaded again once the camera moves away. The
+    // loader decodes them on the job system and uploads them between frames, a cell becomes resident in update once
+    // all of them are there. Cells share the assets with the rest of the scene, and one loaded again soon after its
+    // cell was unloaded may still be resident in the loader.
+    class WorldPartition {
+       public:
+        WorldPartition(AssetLoader& assets, const WorldPartitionSettings& settings = {});
+
+        void addCell(const CellManifest& manifest);
+        // Assets the renderer keeps resident anyway, the cells share them through the asset loader but don't count
+        // them against the budget
+        void addResidentMesh(const std::string& path, std::shared_ptr<Mesh> mesh);
+        void addResidentMaterial(const std::string& texturePath, std::shared_ptr<Material> material);
+
+        // Requests and cancels loads for the camera's position, then makes finished loads resident. Returns true
+        // when the resident entities changed.
+        bool update(const glm::vec3& cameraPosition);
+
+        // Entities of every resident cell
+        std::vector<std::shared_ptr<Entity>> getEntities() const;
+        // Materials the resident cells loaded, without the ones added with addResidentMaterial
+        std::vector<std::shared_ptr<Material>> getMaterials() const;
+        const WorldPartitionStats&             getStats() const { return m_Stats; }
+
+       private:
+        enum class CellState { UNLOADED, LOADING, RESIDENT };
+
+        struct Cell {
+            CellManifest manifest;
+            CellState    state = CellState::UNLOADED;
+            // From the camera to the nearest point of the cell, as of the last update, the request order
+            float distance = 0.0f;
+
+            // Held while loading, by path, so the loader keeps the assets until the cell is committed or canceled
+            std::unordered_map<std::string, AssetHandle<Mesh>>     meshes;
+            std::unordered_map<std::string, AssetHandle<Material>> materials;
+
+            // The entities hold on to the assets, which are released with the last resident cell using them
+            std::vector<std::shared_ptr<Entity>> entities;
+        };
+
+        void requestCell(Cell& cell);
+        bool isCellLoaded(const Cell& cell) const;
+        void commitCell(Cell& cell);
+        void unloadCell(Cell& cell);
+        // Drops the handles of a loading cell
+        void cancelCell(Cell& cell);
+        // What committing the loaded cell would add to the resident bytes
+        size_t getCellBytes(const Cell& cell) const;
+        size_t getResidentBytes() const;
+        // Added by the renderer, which keeps them whatever the cells do
+        bool  isResidentMesh(const Mesh* mesh) const;
+        bool  isResidentMaterial(const Material* material) const;
+        float getDistance(const Cell& cell, const glm::vec3& cameraPosition) const;
+
+        WorldPartitionSettings             m_Settings;
+        WorldPartitionStats                m_Stats;
+        std::vector<std::unique_ptr<Cell>> m_Cells;
+
+        AssetLoader*                                               m_Assets;
+        std::unordered_map<std::string, std::shared_ptr<Mesh>>     m_ResidentMeshes;
+        std::unordered_map<std::string, std::shared_ptr<Material>> m_ResidentMaterials;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_WORLD_PARTITION_H
@@ -0,0 +1,127 @@
+#include "Graphics/StartupLoader.h"
+
+#include <algorithm>
+
+#include "Core/JobSystem.h"
+#include "Graphics/Vulkan/Utilities.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        double millisecondsSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }  // namespace
+
+    StartupLoader::StartupLoader() : m_Start(Clock::now()) {}
+
+    StartupLoader::~StartupLoader() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_AssetDecoded.wait(lock, [this]() { return m_DecodingCount == 0; });
+    }
+
+    void StartupLoader::add(const std::string& name, std::function<void()> decode, std::function<void()> upload) {
+        m_Assets.push_back(std::make_unique<Asset>());
+        Asset* asset = m_Assets.back().get();
+        asset->name = name;
+        asset->decode = std::move(decode);
+        asset->upload = std::move(upload);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_DecodingCount++;
+        }
+        JobSystem::instance()->schedule([this, asset]() {
+            auto start = Clock::now();
+            try {
+                asset->decode();
+            } catch (...) {
+                asset->error = std::current_exception();
+            }
+            asset->decodeTime = millisecondsSince(start);
+
+            // Notified under the lock, the destructor may run as soon as the count reaches zero
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Decoded.push_back(asset);
+            m_DecodingCount--;
+            m_AssetDecoded.notify_all();
+        });
+    }
+
+    void StartupLoader::finish() {
+        size_t uploadedCount = 0;
+        while (uploadedCount < m_Assets.size()) {
+            // Everything that completed while the last batch was uploading goes in the next one. Until something
+            // did, this thread decodes too rather than wait.
+            std::vector<Asset*> batch;
+            while (batch.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    batch.swap(m_Decoded);
+                }
+                if (batch.empty() && !JobSystem::instance()->runPendingJob()) {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+                    m_AssetDecoded.wait(lock, [this]() { return !m_Decoded.empty(); });
+                }
+            }
+
+            for (Asset* asset : batch) {
+                if (asset->error) {
+                    std::rethrow_exception(asset->error);
+                }
+            }
+
+            // The copies and transitions of the whole batch are submitted together, and the captured data with its
+            // staging buffers is only freed once they completed
+            VkUtil::beginUploadBatch();
+            for (Asset* asset : batch) {
+                auto start = Clock::now();
+                asset->upload();
+                asset->uploadTime = millisecondsSince(start);
+                asset->decode = nullptr;
+                asset->upload = nullptr;
+            }
+            auto start = Clock::now();
+            VkUtil::endUploadBatch();
+            m_SubmitTime += millisecondsSince(start);
+            m_BatchCount++;
+            uploadedCount += batch.size();
+        }
+        m_LoadTime = millisecondsSince(m_Start);
+    }
+
+    void StartupLoader::addTiming(const std::string& name, double milliseconds) {
+        m_Timings.emplace_back(name, milliseconds);
+    }
+
+    void StartupLoader::report() const {
+        double decodeTime = 0.0;
+        double uploadTime = 0.0;
+        for (const auto& asset : m_Assets) {
+            decodeTime += asset->decodeTime;
+            uploadTime += asset->uploadTime;
+        }
+        YZ_INFO(std::to_string(m_Assets.size()) + " startup assets loaded in " + std::to_string(m_LoadTime) +
+                " ms, " + std::to_string(decodeTime) + " ms of decoding on " +
+                std::to_string(JobSystem::instance()->getWorkerCount() + 1) + " threads, " +
+                std::to_string(uploadTime) + " ms of uploads and " + std::to_string(m_SubmitTime) +
+                " ms waiting for them in " + std::to_string(m_BatchCount) + " submits.");
+        for (const auto& timing : m_Timings) {
+            YZ_INFO("  " + timing.first + ": " + std::to_string(timing.second) + " ms");
+        }
+
+        // Slowest first, those are the ones worth cooking or splitting up
+        std::vector<const Asset*> assets;
+        for (const auto& asset : m_Assets) {
+            assets.push_back(asset.get());
+        }
+        std::sort(assets.begin(), assets.end(), [](const Asset* a, const Asset* b) {
+            return a->decodeTime + a->uploadTime > b->decodeTime + b->uploadTime;
+        });
+        for (const Asset* asset : assets) {
+            YZ_INFO("  " + asset->name + ": decode " + std::to_string(asset->decodeTime) + " ms, upload " +
+                    std::to_string(asset->uploadTime) + " ms");
+        }
+    }
+}  // namespace Yare::Graphics
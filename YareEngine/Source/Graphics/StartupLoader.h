@@ -0,0 +1,65 @@
+#ifndef YARE_STARTUP_LOADER_H
+#define YARE_STARTUP_LOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Yare::Graphics {
+
+    // Loads what the renderers need before the first frame. Every asset's decode goes to the job system as soon as it
+    // is added, so the files are read and decoded side by side, while their uploads run on the thread that calls
+    // finish, a batch at a time as the decodes complete. Each batch is submitted once. The report at the end shows
+    // where the startup time went.
+    class StartupLoader {
+       public:
+        StartupLoader();
+        // Waits for decodes that are still running, they write to what their asset captured
+        ~StartupLoader();
+
+        // Decode runs on a worker and may only touch the cpu and staging buffers, upload runs once it is done on the
+        // thread calling finish and creates whatever needs the queue
+        void add(const std::string& name, std::function<void()> decode, std::function<void()> upload);
+        // Uploads the assets as their decodes complete, helping with the decodes while none is ready, and returns
+        // once every one is loaded. An exception thrown by a decode is thrown again from here.
+        void finish();
+
+        // Other startup work the report lists, like building the pipelines
+        void addTiming(const std::string& name, double milliseconds);
+        void report() const;
+
+       private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Asset {
+            std::string           name;
+            std::function<void()> decode;
+            std::function<void()> upload;
+            double                decodeTime = 0.0;
+            double                uploadTime = 0.0;
+            std::exception_ptr    error;
+        };
+
+        // Never move once added, the workers keep pointers to them
+        std::vector<std::unique_ptr<Asset>>         m_Assets;
+        std::vector<std::pair<std::string, double>> m_Timings;
+        Clock::time_point                           m_Start;
+        double                                      m_LoadTime = 0.0;
+        // Spent waiting for the batches' submits, the uploads only record their commands
+        double                                      m_SubmitTime = 0.0;
+        size_t                                      m_BatchCount = 0;
+
+        // Guards what is shared with the workers
+        std::mutex              m_Mutex;
+        std::condition_variable m_AssetDecoded;
+        std::vector<Asset*>     m_Decoded;
+        size_t                  m_DecodingCount = 0;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_STARTUP_LOADER_H
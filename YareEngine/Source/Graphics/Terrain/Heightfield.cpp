@@ -0,0 +1,225 @@
+#include "Graphics/Terrain/Heightfield.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include "Core/JobSystem.h"
+#include "Core/Simd.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        using namespace Simd;
+
+        struct CacheHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t size;
+            float    worldSize;
+            uint32_t seed;
+            uint32_t type;
+            uint32_t octaves;
+            float    frequency;
+            float    lacunarity;
+            float    gain;
+            float    amplitude;
+            float    warpStrength;
+        };
+
+        constexpr uint32_t CACHE_MAGIC = 0x46485953;  // "SYHF"
+        constexpr uint32_t CACHE_VERSION = 1;
+
+        // Skew and unskew factors between the square grid and the triangle grid of 2D simplex noise
+        constexpr float SKEW = 0.36602540378f;
+        constexpr float UNSKEW = 0.21132486540f;
+
+        // Corner hashes come from integer mixing rather than a permutation table, so the lanes need no gathers
+        // and the seed simply goes into the mix
+        IntLanes hashCorner(IntLanes x, IntLanes z, IntLanes seed) {
+            IntLanes hash = xorInt(xorInt(mulInt(x, splatInt(0x27D4EB2Du)), mulInt(z, splatInt(0x165667B1u))), seed);
+            hash = xorInt(hash, shiftRight(hash, 15));
+            hash = mulInt(hash, splatInt(0x2C1B3C6Du));
+            return xorInt(hash, shiftRight(hash, 12));
+        }
+
+        // Dot product with one of eight gradients picked by the low bits of the hash
+        Lanes gradient(IntLanes hash, Lanes x, Lanes z) {
+            Mask  swap = bitSet(hash, 4);
+            Lanes u = select(swap, z, x);
+            Lanes v = select(swap, x, z);
+            u = select(bitSet(hash, 1), sub(splat(0.0f), u), u);
+            v = select(bitSet(hash, 2), mul(splat(-2.0f), v), mul(splat(2.0f), v));
+            return add(u, v);
+        }
+
+        Lanes cornerContribution(IntLanes hash, Lanes x, Lanes z) {
+            Lanes falloff = maximum(sub(splat(0.5f), add(mul(x, x), mul(z, z))), splat(0.0f));
+            falloff = mul(falloff, falloff);
+            return mul(mul(falloff, falloff), gradient(hash, x, z));
+        }
+
+        // 2D simplex noise in about [-1, 1]
+        Lanes simplex(Lanes x, Lanes z, IntLanes seed) {
+            Lanes skew = mul(add(x, z), splat(SKEW));
+            Lanes cellX = floorLanes(add(x, skew));
+            Lanes cellZ = floorLanes(add(z, skew));
+            Lanes unskew = mul(add(cellX, cellZ), splat(UNSKEW));
+            Lanes x0 = sub(x, sub(cellX, unskew));
+            Lanes z0 = sub(z, sub(cellZ, unskew));
+
+            // The middle corner of the triangle the sample is in, one step along x or along z
+            Mask  lower = greater(x0, z0);
+            Lanes stepX = select(lower, splat(1.0f), splat(0.0f));
+            Lanes stepZ = select(lower, splat(0.0f), splat(1.0f));
+            Lanes x1 = add(sub(x0, stepX), splat(UNSKEW));
+            Lanes z1 = add(sub(z0, stepZ), splat(UNSKEW));
+            Lanes x2 = add(x0, splat(2.0f * UNSKEW - 1.0f));
+            Lanes z2 = add(z0, splat(2.0f * UNSKEW - 1.0f));
+
+            IntLanes i = toInt(cellX);
+            IntLanes j = toInt(cellZ);
+            IntLanes one = splatInt(1);
+            Lanes    noise = cornerContribution(hashCorner(i, j, seed), x0, z0);
+            noise = add(noise, cornerContribution(hashCorner(addInt(i, toInt(stepX)), addInt(j, toInt(stepZ)), seed),
+                                                  x1, z1));
+            noise = add(noise, cornerContribution(hashCorner(addInt(i, one), addInt(j, one), seed), x2, z2));
+            return mul(noise, splat(70.0f));
+        }
+
+        // Every octave gets a seed of its own so the octaves don't line up at the origin
+        Lanes fractal(Lanes x, Lanes z, const HeightfieldSettings& settings, uint32_t seed, bool ridged) {
+            Lanes sum = splat(0.0f);
+            float frequency = settings.frequency;
+            float amplitude = 1.0f;
+            float amplitudeSum = 0.0f;
+            for (uint32_t octave = 0; octave < settings.octaves; octave++) {
+                IntLanes octaveSeed = splatInt(seed + octave * 0x9E3779B9u);
+                Lanes    noise = simplex(mul(x, splat(frequency)), mul(z, splat(frequency)), octaveSeed);
+                if (ridged) {
+                    // Crests at 1 along the zero crossings, valleys down to -1 in between
+                    noise = sub(splat(1.0f), absolute(noise));
+                    noise = sub(mul(mul(noise, noise), splat(2.0f)), splat(1.0f));
+                }
+                sum = add(sum, mul(noise, splat(amplitude)));
+                amplitudeSum += amplitude;
+                frequency *= settings.lacunarity;
+                amplitude *= settings.gain;
+            }
+            return amplitudeSum > 0.0f ? mul(sum, splat(1.0f / amplitudeSum)) : sum;
+        }
+
+        Lanes sampleHeight(Lanes x, Lanes z, const HeightfieldSettings& settings) {
+            Lanes height;
+            switch (settings.type) {
+                case NoiseType::RIDGED:
+                    height = fractal(x, z, settings, settings.seed, true);
+                    break;
+                case NoiseType::DOMAIN_WARP: {
+                    Lanes warpX = fractal(x, z, settings, settings.seed ^ 0x68E31DA4u, false);
+                    Lanes warpZ = fractal(x, z, settings, settings.seed ^ 0xB5297A4Du, false);
+                    Lanes strength = splat(settings.warpStrength);
+                    height = fractal(add(x, mul(warpX, strength)), add(z, mul(warpZ, strength)), settings,
+                                     settings.seed, false);
+                    break;
+                }
+                default:
+                    height = fractal(x, z, settings, settings.seed, false);
+                    break;
+            }
+            return mul(height, splat(settings.amplitude));
+        }
+    }  // namespace
+
+    std::vector<float> generateHeightfield(uint32_t size, float worldSize, const HeightfieldSettings& settings,
+                                           HeightfieldStatistics* statistics) {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+
+        std::vector<float> heights(size_t(size) * size);
+        uint32_t           tileSize = (std::max)(settings.tileSize, LANE_COUNT);
+        uint32_t           tilesPerEdge = (size + tileSize - 1) / tileSize;
+        uint32_t           tileCount = tilesPerEdge * tilesPerEdge;
+        float              spacing = size > 1 ? worldSize / static_cast<float>(size - 1) : 0.0f;
+        float              origin = -worldSize * 0.5f;
+
+        JobSystem::instance()->parallelFor(tileCount, 1, [&](uint32_t tile) {
+            uint32_t firstX = tile % tilesPerEdge * tileSize;
+            uint32_t firstZ = tile / tilesPerEdge * tileSize;
+            uint32_t lastX = (std::min)(firstX + tileSize, size);
+            uint32_t lastZ = (std::min)(firstZ + tileSize, size);
+            float    row[LANE_COUNT];
+            for (uint32_t z = firstZ; z < lastZ; z++) {
+                Lanes worldZ = splat(origin + static_cast<float>(z) * spacing);
+                for (uint32_t x = firstX; x < lastX; x += LANE_COUNT) {
+                    Lanes columns = add(splat(static_cast<float>(x)), laneOffsets());
+                    Lanes worldX = add(splat(origin), mul(columns, splat(spacing)));
+                    store(row, sampleHeight(worldX, worldZ, settings));
+                    // Lanes past the edge of the tile are computed anyway and dropped
+                    std::copy(row, row + (std::min)(LANE_COUNT, lastX - x), &heights[size_t(z) * size + x]);
+                }
+            }
+        });
+
+        double   seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        uint32_t threadCount = JobSystem::instance()->getWorkerCount() + 1;
+        double   samplesPerSecondPerCore =
+            seconds > 0.0 ? static_cast<double>(heights.size()) / seconds / threadCount : 0.0;
+        YZ_INFO("Heightfield of " + std::to_string(size) + "x" + std::to_string(size) + " samples generated in " +
+                std::to_string(tileCount) + " tiles in " + std::to_string(seconds * 1000.0) + " ms, " +
+                std::to_string(samplesPerSecondPerCore / 1e6) + " million samples per second per core on " +
+                std::to_string(threadCount) + " threads with " + std::to_string(LANE_COUNT) + " lanes.");
+
+        if (statistics) {
+            statistics->tileCount = tileCount;
+            statistics->threadCount = threadCount;
+            statistics->seconds = seconds;
+            statistics->samplesPerSecondPerCore = samplesPerSecondPerCore;
+        }
+        return heights;
+    }
+
+    std::vector<float> loadHeightfield(const std::string& cachePath, uint32_t size, float worldSize,
+                                       const HeightfieldSettings& settings) {
+        CacheHeader header = {};
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.size = size;
+        header.worldSize = worldSize;
+        header.seed = settings.seed;
+        header.type = static_cast<uint32_t>(settings.type);
+        header.octaves = settings.octaves;
+        header.frequency = settings.frequency;
+        header.lacunarity = settings.lacunarity;
+        header.gain = settings.gain;
+        header.amplitude = settings.amplitude;
+        header.warpStrength = settings.warpStrength;
+
+        {
+            std::ifstream cacheFile(cachePath, std::ios::binary);
+            CacheHeader   cachedHeader = {};
+            if (cacheFile.read(reinterpret_cast<char*>(&cachedHeader), sizeof(cachedHeader)) &&
+                cachedHeader.magic == header.magic && cachedHeader.version == header.version &&
+                cachedHeader.size == header.size && cachedHeader.worldSize == header.worldSize &&
+                cachedHeader.seed == header.seed && cachedHeader.type == header.type &&
+                cachedHeader.octaves == header.octaves && cachedHeader.frequency == header.frequency &&
+                cachedHeader.lacunarity == header.lacunarity && cachedHeader.gain == header.gain &&
+                cachedHeader.amplitude == header.amplitude && cachedHeader.warpStrength == header.warpStrength) {
+                std::vector<float> heights(size_t(size) * size);
+                if (cacheFile.read(reinterpret_cast<char*>(heights.data()), heights.size() * sizeof(float))) {
+                    return heights;
+                }
+            }
+        }
+
+        std::vector<float> heights = generateHeightfield(size, worldSize, settings);
+        std::ofstream      cacheFile(cachePath, std::ios::binary | std::ios::trunc);
+        if (!cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !cacheFile.write(reinterpret_cast<const char*>(heights.data()), heights.size() * sizeof(float))) {
+            YZ_WARN("Heightfield cache '" + cachePath + "' could not be written.");
+        }
+        return heights;
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,57 @@
+#ifndef YARE_HEIGHTFIELD_H
+#define YARE_HEIGHTFIELD_H
+
+#include <string>
+#include <vector>
+
+#include "Core/DataStructures.h"
+
+namespace Yare::Graphics {
+
+    enum class NoiseType {
+        // Plain fractal sum of simplex octaves, rolling hills
+        FBM,
+        // Every octave folded around zero, sharp crests along the zero crossings
+        RIDGED,
+        // fBm sampled at positions offset by two more fBm fields, which bends the shapes into each other
+        DOMAIN_WARP
+    };
+
+    struct HeightfieldSettings {
+        // The same seed and settings give the same heights on every machine, whatever the tiling or thread count
+        uint32_t  seed = 1337;
+        NoiseType type = NoiseType::FBM;
+        uint32_t  octaves = 6;
+        // Of the first octave, in cycles per world unit
+        float frequency = 1.0f / 1024.0f;
+        // Frequency and amplitude multipliers from one octave to the next
+        float lacunarity = 2.0f;
+        float gain = 0.5f;
+        // Heights span about -amplitude to amplitude world units
+        float amplitude = 60.0f;
+        // How far domain warping moves the sample positions, in world units
+        float warpStrength = 300.0f;
+        // Samples along the edge of the square tiles the work is split into
+        uint32_t tileSize = 128;
+    };
+
+    struct HeightfieldStatistics {
+        uint32_t tileCount = 0;
+        uint32_t threadCount = 0;
+        double   seconds = 0.0;
+        double   samplesPerSecondPerCore = 0.0;
+    };
+
+    // size by size heights spanning a square of worldSize units centered on the origin, one row after the other.
+    // Noise is evaluated 4 or 8 samples at a time with SSE4.1 or AVX2 and the tiles are spread over the job
+    // system. The throughput is logged and written to statistics.
+    std::vector<float> generateHeightfield(uint32_t size, float worldSize, const HeightfieldSettings& settings,
+                                           HeightfieldStatistics* statistics = nullptr);
+
+    // Reads the heights from cachePath when it was written with the same parameters, otherwise generates them and
+    // writes the cache for the next launch
+    std::vector<float> loadHeightfield(const std::string& cachePath, uint32_t size, float worldSize,
+                                       const HeightfieldSettings& settings);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_HEIGHTFIELD_H
@@ -0,0 +1,145 @@
+#include "Graphics/Terrain/TerrainQuadtree.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Yare::Graphics {
+
+    namespace {
+        bool boxWithinDistance(const glm::vec3& min, const glm::vec3& max, const glm::vec3& point, float distance) {
+            glm::vec3 closest = glm::clamp(point, min, max);
+            glm::vec3 offset = closest - point;
+            return glm::dot(offset, offset) <= distance * distance;
+        }
+    }  // namespace
+
+    void TerrainSelection::clear() {
+        for (auto& part : nodes) {
+            part.clear();
+        }
+    }
+
+    uint32_t TerrainSelection::getNodeCount() const {
+        size_t count = 0;
+        for (const auto& part : nodes) {
+            count += part.size();
+        }
+        return static_cast<uint32_t>(count);
+    }
+
+    TerrainQuadtree::TerrainQuadtree(const std::vector<float>& heights, uint32_t heightmapSize,
+                                     const TerrainSettings& settings)
+        : m_Settings(settings) {
+        m_Settings.lodCount = glm::clamp(m_Settings.lodCount, 1u, 16u);
+        m_Settings.gridResolution = (std::max)(m_Settings.gridResolution / 2 * 2, 2u);
+        m_LeafSize = m_Settings.worldSize / static_cast<float>(getNodesPerEdge(0));
+
+        for (uint32_t level = 0; level < m_Settings.lodCount; level++) {
+            m_LodRanges.push_back(m_LeafSize * std::exp2(static_cast<float>(level)) * m_Settings.lodRangeRatio);
+        }
+
+        // The leaves take the bounds of every sample they touch, the bilinear filter never leaves those
+        m_Bounds.resize(m_Settings.lodCount);
+        uint32_t leavesPerEdge = getNodesPerEdge(0);
+        float    samplesPerLeaf = static_cast<float>(heightmapSize - 1) / leavesPerEdge;
+        m_Bounds[0].resize(size_t(leavesPerEdge) * leavesPerEdge);
+        for (uint32_t z = 0; z < leavesPerEdge; z++) {
+            for (uint32_t x = 0; x < leavesPerEdge; x++) {
+                uint32_t firstX = static_cast<uint32_t>(std::floor(x * samplesPerLeaf));
+                uint32_t lastX = (std::min)(static_cast<uint32_t>(std::ceil((x + 1) * samplesPerLeaf)),
+                                            heightmapSize - 1);
+                uint32_t firstZ = static_cast<uint32_t>(std::floor(z * samplesPerLeaf));
+                uint32_t lastZ = (std::min)(static_cast<uint32_t>(std::ceil((z + 1) * samplesPerLeaf)),
+                                            heightmapSize - 1);
+
+                Bounds bounds = {heights[size_t(firstZ) * heightmapSize + firstX],
+                                 heights[size_t(firstZ) * heightmapSize + firstX]};
+                for (uint32_t sampleZ = firstZ; sampleZ <= lastZ; sampleZ++) {
+                    for (uint32_t sampleX = firstX; sampleX <= lastX; sampleX++) {
+                        float height = heights[size_t(sampleZ) * heightmapSize + sampleX];
+                        bounds.minHeight = (std::min)(bounds.minHeight, height);
+                        bounds.maxHeight = (std::max)(bounds.maxHeight, height);
+                    }
+                }
+                m_Bounds[0][size_t(z) * leavesPerEdge + x] = bounds;
+            }
+        }
+
+        for (uint32_t level = 1; level < m_Settings.lodCount; level++) {
+            uint32_t nodesPerEdge = getNodesPerEdge(level);
+            uint32_t childrenPerEdge = nodesPerEdge * 2;
+            m_Bounds[level].resize(size_t(nodesPerEdge) * nodesPerEdge);
+            for (uint32_t z = 0; z < nodesPerEdge; z++) {
+                for (uint32_t x = 0; x < nodesPerEdge; x++) {
+                    Bounds bounds = m_Bounds[level - 1][size_t(z * 2) * childrenPerEdge + x * 2];
+                    for (uint32_t child = 1; child < 4; child++) {
+                        const Bounds& childBounds =
+                            m_Bounds[level - 1][size_t(z * 2 + child / 2) * childrenPerEdge + x * 2 + child % 2];
+                        bounds.minHeight = (std::min)(bounds.minHeight, childBounds.minHeight);
+                        bounds.maxHeight = (std::max)(bounds.maxHeight, childBounds.maxHeight);
+                    }
+                    m_Bounds[level][size_t(z) * nodesPerEdge + x] = bounds;
+                }
+            }
+        }
+    }
+
+    void TerrainQuadtree::select(const glm::vec3& cameraPosition, const Frustum& frustum,
+                                 TerrainSelection& selection) const {
+        selection.clear();
+        // The root covers the whole terrain, whatever is further away than its range isn't drawn at all
+        selectNode(m_Settings.lodCount - 1, 0, 0, cameraPosition, frustum, selection);
+    }
+
+    bool TerrainQuadtree::selectNode(uint32_t level, uint32_t x, uint32_t z, const glm::vec3& cameraPosition,
+                                     const Frustum& frustum, TerrainSelection& selection) const {
+        glm::vec3 min, max;
+        getNodeBox(level, x, z, min, max);
+        if (!boxWithinDistance(min, max, cameraPosition, m_LodRanges[level])) {
+            return false;
+        }
+        // Culled nodes count as handled, so the parent doesn't draw them either
+        if (!frustum.intersectsBox(min, max)) {
+            return true;
+        }
+        if (level == 0 || !boxWithinDistance(min, max, cameraPosition, m_LodRanges[level - 1])) {
+            addNode(level, x, z, TERRAIN_PART_WHOLE, selection);
+            return true;
+        }
+
+        // Children too far away for their own level are covered by this node's quarter of the grid instead
+        for (uint32_t quarter = 0; quarter < 4; quarter++) {
+            if (!selectNode(level - 1, x * 2 + quarter % 2, z * 2 + quarter / 2, cameraPosition, frustum,
+                            selection)) {
+                addNode(level, x, z, static_cast<TerrainPart>(quarter), selection);
+            }
+        }
+        return true;
+    }
+
+    void TerrainQuadtree::addNode(uint32_t level, uint32_t x, uint32_t z, TerrainPart part,
+                                  TerrainSelection& selection) const {
+        if (selection.getNodeCount() >= m_Settings.maxNodes) {
+            return;
+        }
+
+        float size = m_LeafSize * static_cast<float>(1u << level);
+        float rangeEnd = m_LodRanges[level];
+        float previousRange = level > 0 ? m_LodRanges[level - 1] : 0.0f;
+
+        TerrainNode node = {};
+        node.offset = glm::vec2(x, z) * size - m_Settings.worldSize * 0.5f;
+        node.size = size;
+        node.level = static_cast<float>(level);
+        node.morphRange = glm::vec2(previousRange + (rangeEnd - previousRange) * m_Settings.morphStart, rangeEnd);
+        selection.nodes[part].push_back(node);
+    }
+
+    void TerrainQuadtree::getNodeBox(uint32_t level, uint32_t x, uint32_t z, glm::vec3& min, glm::vec3& max) const {
+        float         size = m_LeafSize * static_cast<float>(1u << level);
+        const Bounds& bounds = m_Bounds[level][size_t(z) * getNodesPerEdge(level) + x];
+        glm::vec2     corner = glm::vec2(x, z) * size - m_Settings.worldSize * 0.5f;
+        min = glm::vec3(corner.x, m_Settings.baseHeight + bounds.minHeight, corner.y);
+        max = glm::vec3(corner.x + size, m_Settings.baseHeight + bounds.maxHeight, corner.y + size);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,94 @@
+#ifndef YARE_TERRAIN_QUADTREE_H
+#define YARE_TERRAIN_QUADTREE_H
+
+#include <vector>
+
+#include "Core/DataStructures.h"
+#include "Graphics/Camera/Frustum.h"
+
+namespace Yare::Graphics {
+
+    struct TerrainSettings {
+        // Edge length of the square terrain in world units, centered on the origin
+        float worldSize = 4096.0f;
+        // World height of a height of 0 in the heightmap
+        float baseHeight = -2.0f;
+        // Cells along the edge of the grid every node is drawn with, must be even
+        uint32_t gridResolution = 32;
+        // The root nodes are 2^(lodCount - 1) leaf nodes wide, the leaves cover the finest level
+        uint32_t lodCount = 8;
+        // Every level is drawn up to this many of its node sizes away from the camera, the next one after that
+        float lodRangeRatio = 2.0f;
+        // Where in a level's range its vertices start morphing into the next level's, as a fraction of the range
+        float morphStart = 0.7f;
+        // Nodes drawn per frame at most, the selection stops adding nodes past it
+        uint32_t maxNodes = 2048;
+    };
+
+    // One instance of the grid mesh, matches the Node struct of terrain.vert
+    struct TerrainNode {
+        // World xz of the node's corner with the smallest coordinates
+        glm::vec2 offset;
+        float     size;
+        float     level;
+        // Distances from the camera at which the morph starts and ends
+        glm::vec2 morphRange;
+        glm::vec2 padding;
+    };
+
+    // Nodes drawn whole or as one quarter of the grid, when the parent's other children are drawn finer
+    enum TerrainPart {
+        TERRAIN_PART_QUARTER_0 = 0,
+        TERRAIN_PART_QUARTER_1,
+        TERRAIN_PART_QUARTER_2,
+        TERRAIN_PART_QUARTER_3,
+        TERRAIN_PART_WHOLE,
+        TERRAIN_PART_COUNT
+    };
+
+    struct TerrainSelection {
+        std::vector<TerrainNode> nodes[TERRAIN_PART_COUNT];
+
+        void clear();
+        uint32_t getNodeCount() const;
+    };
+
+    // The continuous distance dependent level of detail of Strugar's CDLOD. The terrain is a quadtree of square
+    // nodes over a heightmap, each one drawn with the same grid mesh whatever its size. Every level has a distance
+    // range twice the size of the previous one, so about the same number of nodes cover every range and the
+    // triangle count stays roughly constant however large the terrain is. Near the end of its range a node's
+    // vertices morph into the next coarser level's grid, which leaves no seams between the levels.
+    class TerrainQuadtree {
+       public:
+        // heights is a square heightmap of heightmapSize samples per edge spanning the whole terrain
+        TerrainQuadtree(const std::vector<float>& heights, uint32_t heightmapSize, const TerrainSettings& settings);
+
+        void select(const glm::vec3& cameraPosition, const Frustum& frustum, TerrainSelection& selection) const;
+
+        const TerrainSettings& getSettings() const { return m_Settings; }
+        float                  getLodRange(uint32_t level) const { return m_LodRanges[level]; }
+        float                  getLeafSize() const { return m_LeafSize; }
+
+       private:
+        struct Bounds {
+            float minHeight;
+            float maxHeight;
+        };
+
+        // Returns false when the node is outside the range of its level, its parent has to cover it then
+        bool selectNode(uint32_t level, uint32_t x, uint32_t z, const glm::vec3& cameraPosition,
+                        const Frustum& frustum, TerrainSelection& selection) const;
+        void addNode(uint32_t level, uint32_t x, uint32_t z, TerrainPart part, TerrainSelection& selection) const;
+        void getNodeBox(uint32_t level, uint32_t x, uint32_t z, glm::vec3& min, glm::vec3& max) const;
+        uint32_t getNodesPerEdge(uint32_t level) const { return 1u << (m_Settings.lodCount - 1 - level); }
+
+        TerrainSettings m_Settings;
+        float           m_LeafSize = 0.0f;
+        // Where each level stops being drawn, indexed by level with the finest first
+        std::vector<float> m_LodRanges;
+        // Height bounds of every node, a grid per level
+        std::vector<std::vector<Bounds>> m_Bounds;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_TERRAIN_QUADTREE_H
@@ -0,0 +1,399 @@
+#include "Graphics/TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Core/JobSystem.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr uint32_t BLOCK_SIZE = 4;
+        constexpr uint32_t TEXEL_COUNT = BLOCK_SIZE * BLOCK_SIZE;
+        // Weights of the 16 interpolated colors of BC7's 4 bit indices, out of 64
+        constexpr uint32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        // How much of the first color the four BC1 indices take
+        constexpr float BC1_WEIGHTS[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+        struct Block {
+            float texels[TEXEL_COUNT][4];
+        };
+
+        // Least significant bit first, the way the BC7 fields are laid out
+        struct BitWriter {
+            unsigned char* bytes;
+            uint32_t       position = 0;
+
+            void write(uint32_t value, uint32_t bitCount) {
+                for (uint32_t bit = 0; bit < bitCount; bit++, position++) {
+                    if ((value >> bit) & 1) {
+                        bytes[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+                    }
+                }
+            }
+        };
+
+        float squaredDistance(const float* a, const float* b, uint32_t channelCount) {
+            float distance = 0.0f;
+            for (uint32_t channel = 0; channel < channelCount; channel++) {
+                distance += (a[channel] - b[channel]) * (a[channel] - b[channel]);
+            }
+            return distance;
+        }
+
+        // Mean and the direction the texels spread along the most, found by power iteration on their covariance.
+        // The axis is left at zero for a block of one color.
+        void fitLine(const Block& block, uint32_t channelCount, float mean[4], float axis[4]) {
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                mean[channel] = 0.0f;
+                axis[channel] = 0.0f;
+            }
+            for (const auto& texel : block.texels) {
+                for (uint32_t channel = 0; channel < channelCount; channel++) {
+                    mean[channel] += texel[channel] / TEXEL_COUNT;
+                }
+            }
+
+            float covariance[4][4] = {};
+            for (const auto& texel : block.texels) {
+                for (uint32_t row = 0; row < channelCount; row++) {
+                    for (uint32_t column = 0; column < channelCount; column++) {
+                        covariance[row][column] += (texel[row] - mean[row]) * (texel[column] - mean[column]);
+                    }
+                }
+            }
+
+            // Starting from the row of the channel that varies most keeps the start from being orthogonal to the axis
+            uint32_t widest = 0;
+            for (uint32_t channel = 1; channel < channelCount; channel++) {
+                if (covariance[channel][channel] > covariance[widest][widest]) {
+                    widest = channel;
+                }
+            }
+            if (covariance[widest][widest] < 1e-6f) {
+                return;
+            }
+            float vector[4] = {};
+            for (uint32_t channel = 0; channel < channelCount; channel++) {
+                vector[channel] = covariance[widest][channel];
+            }
+            for (int iteration = 0; iteration < 8; iteration++) {
+                float next[4] = {};
+                float length = 0.0f;
+                for (uint32_t row = 0; row < channelCount; row++) {
+                    for (uint32_t column = 0; column < channelCount; column++) {
+                        next[row] += covariance[row][column] * vector[column];
+                    }
+                    length += next[row] * next[row];
+                }
+                length = std::sqrt(length);
+                if (length < 1e-12f) {
+                    return;
+                }
+                for (uint32_t channel = 0; channel < channelCount; channel++) {
+                    vector[channel] = next[channel] / length;
+                }
+            }
+            std::memcpy(axis, vector, sizeof(vector));
+        }
+
+        // The points of the line through the first and last texel along it
+        void fitEndpoints(const Block& block, uint32_t channelCount, float first[4], float last[4]) {
+            float mean[4];
+            float axis[4];
+            fitLine(block, channelCount, mean, axis);
+
+            float minimum = 0.0f;
+            float maximum = 0.0f;
+            for (const auto& texel : block.texels) {
+                float t = 0.0f;
+                for (uint32_t channel = 0; channel < channelCount; channel++) {
+                    t += (texel[channel] - mean[channel]) * axis[channel];
+                }
+                minimum = (std::min)(minimum, t);
+                maximum = (std::max)(maximum, t);
+            }
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                first[channel] = (std::min)((std::max)(mean[channel] + axis[channel] * maximum, 0.0f), 255.0f);
+                last[channel] = (std::min)((std::max)(mean[channel] + axis[channel] * minimum, 0.0f), 255.0f);
+            }
+        }
+
+        uint16_t packColor565(const float color[3]) {
+            auto quantize = [](float value, float maximum) {
+                return static_cast<uint32_t>(std::lround((std::min)((std::max)(value, 0.0f), 255.0f) * maximum / 255));
+            };
+            return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) |
+                                         quantize(color[2], 31.0f));
+        }
+
+        void unpackColor565(uint16_t color, float rgb[3]) {
+            uint32_t red = (color >> 11) & 31;
+            uint32_t green = (color >> 5) & 63;
+            uint32_t blue = color & 31;
+            rgb[0] = static_cast<float>((red << 3) | (red >> 2));
+            rgb[1] = static_cast<float>((green << 2) | (green >> 4));
+            rgb[2] = static_cast<float>((blue << 3) | (blue >> 2));
+        }
+
+        // Picks the nearest of the four colors for every texel and returns the total squared error
+        float pickBC1Indices(const Block& block, uint16_t color0, uint16_t color1, uint32_t& indices) {
+            float palette[4][3];
+            unpackColor565(color0, palette[0]);
+            unpackColor565(color1, palette[1]);
+            for (uint32_t channel = 0; channel < 3; channel++) {
+                palette[2][channel] = (2.0f * palette[0][channel] + palette[1][channel]) / 3.0f;
+                palette[3][channel] = (palette[0][channel] + 2.0f * palette[1][channel]) / 3.0f;
+            }
+
+            float error = 0.0f;
+            indices = 0;
+            for (uint32_t i = 0; i < TEXEL_COUNT; i++) {
+                uint32_t best = 0;
+                float    bestDistance = squaredDistance(block.texels[i], palette[0], 3);
+                for (uint32_t entry = 1; entry < 4; entry++) {
+                    float distance = squaredDistance(block.texels[i], palette[entry], 3);
+                    if (distance < bestDistance) {
+                        best = entry;
+                        bestDistance = distance;
+                    }
+                }
+                indices |= best << (2 * i);
+                error += bestDistance;
+            }
+            return error;
+        }
+
+        // Least squares endpoints for the indices picked, which pulls them off the box the texels span
+        bool refineBC1Endpoints(const Block& block, uint32_t indices, float first[3], float last[3]) {
+            float alpha2 = 0.0f, beta2 = 0.0f, alphaBeta = 0.0f;
+            float alphaX[3] = {}, betaX[3] = {};
+            for (uint32_t i = 0; i < TEXEL_COUNT; i++) {
+                float alpha = BC1_WEIGHTS[(indices >> (2 * i)) & 3];
+                float beta = 1.0f - alpha;
+                alpha2 += alpha * alpha;
+                beta2 += beta * beta;
+                alphaBeta += alpha * beta;
+                for (uint32_t channel = 0; channel < 3; channel++) {
+                    alphaX[channel] += alpha * block.texels[i][channel];
+                    betaX[channel] += beta * block.texels[i][channel];
+                }
+            }
+
+            float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+            if (std::abs(determinant) < 1e-6f) {
+                return false;
+            }
+            for (uint32_t channel = 0; channel < 3; channel++) {
+                first[channel] = (alphaX[channel] * beta2 - betaX[channel] * alphaBeta) / determinant;
+                last[channel] = (betaX[channel] * alpha2 - alphaX[channel] * alphaBeta) / determinant;
+            }
+            return true;
+        }
+
+        void encodeBC1(const Block& block, unsigned char* output) {
+            float first[4];
+            float last[4];
+            fitEndpoints(block, 3, first, last);
+
+            uint16_t color0 = packColor565(first);
+            uint16_t color1 = packColor565(last);
+            uint32_t indices;
+            float    error = pickBC1Indices(block, color0, color1, indices);
+
+            if (refineBC1Endpoints(block, indices, first, last)) {
+                uint16_t refined0 = packColor565(first);
+                uint16_t refined1 = packColor565(last);
+                uint32_t refinedIndices;
+                if (pickBC1Indices(block, refined0, refined1, refinedIndices) < error) {
+                    color0 = refined0;
+                    color1 = refined1;
+                    indices = refinedIndices;
+                }
+            }
+
+            // The first color has to be the larger one for four colors, swapping them swaps the indices pairwise. Equal
+            // colors would select the three color mode, so every texel takes the first one.
+            if (color0 < color1) {
+                std::swap(color0, color1);
+                indices ^= 0x55555555;
+            } else if (color0 == color1) {
+                indices = 0;
+            }
+
+            output[0] = static_cast<unsigned char>(color0);
+            output[1] = static_cast<unsigned char>(color0 >> 8);
+            output[2] = static_cast<unsigned char>(color1);
+            output[3] = static_cast<unsigned char>(color1 >> 8);
+            for (uint32_t byte = 0; byte < 4; byte++) {
+                output[4 + byte] = static_cast<unsigned char>(indices >> (8 * byte));
+            }
+        }
+
+        // One channel of the block, in the eight value mode spanning its smallest and largest value
+        void encodeBC4(const Block& block, uint32_t channel, unsigned char* output) {
+            float minimum = 255.0f;
+            float maximum = 0.0f;
+            for (const auto& texel : block.texels) {
+                minimum = (std::min)(minimum, texel[channel]);
+                maximum = (std::max)(maximum, texel[channel]);
+            }
+            uint32_t value0 = static_cast<uint32_t>(std::lround(maximum));
+            uint32_t value1 = static_cast<uint32_t>(std::lround(minimum));
+
+            float palette[8];
+            palette[0] = static_cast<float>(value0);
+            palette[1] = static_cast<float>(value1);
+            for (uint32_t step = 1; step < 7; step++) {
+                palette[step + 1] = static_cast<float>(((7 - step) * value0 + step * value1) / 7);
+            }
+
+            uint64_t indices = 0;
+            if (value0 != value1) {
+                for (uint32_t i = 0; i < TEXEL_COUNT; i++) {
+                    uint64_t best = 0;
+                    float    bestDistance = 1e30f;
+                    for (uint32_t entry = 0; entry < 8; entry++) {
+                        float distance = std::abs(block.texels[i][channel] - palette[entry]);
+                        if (distance < bestDistance) {
+                            best = entry;
+                            bestDistance = distance;
+                        }
+                    }
+                    indices |= best << (3 * i);
+                }
+            }
+
+            output[0] = static_cast<unsigned char>(value0);
+            output[1] = static_cast<unsigned char>(value1);
+            for (uint32_t byte = 0; byte < 6; byte++) {
+                output[2 + byte] = static_cast<unsigned char>(indices >> (8 * byte));
+            }
+        }
+
+        // Mode 6 stores 7 bits per channel and a shared lowest bit per endpoint, whichever of the two is closer
+        void quantizeBC7Endpoint(const float endpoint[4], uint32_t quantized[4], uint32_t& pBit) {
+            float bestError = 1e30f;
+            for (uint32_t bit = 0; bit < 2; bit++) {
+                uint32_t candidate[4];
+                float    error = 0.0f;
+                for (uint32_t channel = 0; channel < 4; channel++) {
+                    long value = std::lround((endpoint[channel] - bit) / 2.0f);
+                    candidate[channel] = static_cast<uint32_t>((std::min)((std::max)(value, 0l), 127l));
+                    float decoded = static_cast<float>((candidate[channel] << 1) | bit);
+                    error += (decoded - endpoint[channel]) * (decoded - endpoint[channel]);
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    pBit = bit;
+                    std::memcpy(quantized, candidate, sizeof(candidate));
+                }
+            }
+        }
+
+        void encodeBC7(const Block& block, unsigned char* output) {
+            float first[4];
+            float last[4];
+            fitEndpoints(block, 4, first, last);
+
+            uint32_t endpoints[2][4];
+            uint32_t pBits[2];
+            quantizeBC7Endpoint(first, endpoints[0], pBits[0]);
+            quantizeBC7Endpoint(last, endpoints[1], pBits[1]);
+
+            float palette[16][4];
+            for (uint32_t entry = 0; entry < 16; entry++) {
+                for (uint32_t channel = 0; channel < 4; channel++) {
+                    uint32_t value0 = (endpoints[0][channel] << 1) | pBits[0];
+                    uint32_t value1 = (endpoints[1][channel] << 1) | pBits[1];
+                    palette[entry][channel] = static_cast<float>(
+                        ((64 - BC7_WEIGHTS[entry]) * value0 + BC7_WEIGHTS[entry] * value1 + 32) >> 6);
+                }
+            }
+
+            uint32_t indices[TEXEL_COUNT];
+            for (uint32_t i = 0; i < TEXEL_COUNT; i++) {
+                indices[i] = 0;
+                float bestDistance = squaredDistance(block.texels[i], palette[0], 4);
+                for (uint32_t entry = 1; entry < 16; entry++) {
+                    float distance = squaredDistance(block.texels[i], palette[entry], 4);
+                    if (distance < bestDistance) {
+                        indices[i] = entry;
+                        bestDistance = distance;
+                    }
+                }
+            }
+
+            // The first index is stored without its highest bit, so it has to be below 8
+            if (indices[0] >= 8) {
+                std::swap(endpoints[0], endpoints[1]);
+                std::swap(pBits[0], pBits[1]);
+                for (uint32_t& index : indices) {
+                    index = 15 - index;
+                }
+            }
+
+            std::memset(output, 0, 16);
+            BitWriter writer{output};
+            writer.write(1 << 6, 7);
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                writer.write(endpoints[0][channel], 7);
+                writer.write(endpoints[1][channel], 7);
+            }
+            writer.write(pBits[0], 1);
+            writer.write(pBits[1], 1);
+            writer.write(indices[0], 3);
+            for (uint32_t i = 1; i < TEXEL_COUNT; i++) {
+                writer.write(indices[i], 4);
+            }
+        }
+    }  // namespace
+
+    size_t getBlockBytes(BlockFormat format) { return format == BlockFormat::BC1 ? 8 : 16; }
+
+    size_t getCompressedLevelSize(BlockFormat format, size_t width, size_t height) {
+        return ((width + BLOCK_SIZE - 1) / BLOCK_SIZE) * ((height + BLOCK_SIZE - 1) / BLOCK_SIZE) *
+               getBlockBytes(format);
+    }
+
+    std::vector<unsigned char> compressLevel(const unsigned char* pixels, size_t width, size_t height,
+                                             BlockFormat format) {
+        size_t                     blocksWide = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t                     blocksHigh = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t                     blockBytes = getBlockBytes(format);
+        std::vector<unsigned char> blocks(blocksWide * blocksHigh * blockBytes);
+
+        JobSystem::instance()->parallelFor(static_cast<uint32_t>(blocksHigh), 1, [&](uint32_t blockY) {
+            for (size_t blockX = 0; blockX < blocksWide; blockX++) {
+                Block block;
+                for (uint32_t i = 0; i < TEXEL_COUNT; i++) {
+                    size_t x = (std::min)(blockX * BLOCK_SIZE + i % BLOCK_SIZE, width - 1);
+                    size_t y = (std::min)(size_t(blockY) * BLOCK_SIZE + i / BLOCK_SIZE, height - 1);
+                    for (uint32_t channel = 0; channel < 4; channel++) {
+                        block.texels[i][channel] = pixels[(y * width + x) * 4 + channel];
+                    }
+                }
+
+                unsigned char* output = blocks.data() + (blockY * blocksWide + blockX) * blockBytes;
+                switch (format) {
+                    case BlockFormat::BC1:
+                        encodeBC1(block, output);
+                        break;
+                    case BlockFormat::BC3:
+                        encodeBC4(block, 3, output);
+                        encodeBC1(block, output + 8);
+                        break;
+                    case BlockFormat::BC5:
+                        encodeBC4(block, 0, output);
+                        encodeBC4(block, 1, output + 8);
+                        break;
+                    case BlockFormat::BC7:
+                        encodeBC7(block, output);
+                        break;
+                }
+            }
+        });
+        return blocks;
+    }
+}  // namespace Yare::Graphics
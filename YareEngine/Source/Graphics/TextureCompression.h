@@ -0,0 +1,32 @@
+#ifndef YARE_TEXTURE_COMPRESSION_H
+#define YARE_TEXTURE_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Yare::Graphics {
+
+    // Every format stores 4x4 texel blocks
+    enum class BlockFormat {
+        // 8 bytes per block, two 565 colors and 2 bit indices, opaque color
+        BC1,
+        // 16 bytes, a BC4 alpha block followed by a BC1 color block
+        BC3,
+        // 16 bytes, BC4 blocks of red and green, for normal maps
+        BC5,
+        // 16 bytes, always written in mode 6, one rgba line with 7 bit endpoints and 4 bit indices
+        BC7
+    };
+
+    size_t getBlockBytes(BlockFormat format);
+    size_t getCompressedLevelSize(BlockFormat format, size_t width, size_t height);
+
+    // Encodes width by height rgba8 pixels into blocks, one row of blocks after the other. Blocks reaching past the
+    // edges repeat the last row and column. The endpoints are fit along the principal axis of each block's colors.
+    // Rows of blocks are spread over the job system.
+    std::vector<unsigned char> compressLevel(const unsigned char* pixels, size_t width, size_t height,
+                                             BlockFormat format);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_TEXTURE_COMPRESSION_H
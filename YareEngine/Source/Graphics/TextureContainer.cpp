@@ -0,0 +1,557 @@
+#include "Graphics/TextureContainer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+#include "Core/FileSystem.h"
+#include "Graphics/MipGenerator.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        constexpr unsigned char KTX2_IDENTIFIER[12] = {0xAB, 'K',  'T',  'X',  ' ',  '2',
+                                                       '0',  0xBB, '\r', '\n', 0x1A, '\n'};
+
+        struct Ktx2Header {
+            unsigned char identifier[12];
+            uint32_t      vkFormat;
+            uint32_t      typeSize;
+            uint32_t      pixelWidth;
+            uint32_t      pixelHeight;
+            uint32_t      pixelDepth;
+            uint32_t      layerCount;
+            uint32_t      faceCount;
+            uint32_t      levelCount;
+            uint32_t      supercompressionScheme;
+            uint32_t      dfdByteOffset;
+            uint32_t      dfdByteLength;
+            uint32_t      kvdByteOffset;
+            uint32_t      kvdByteLength;
+            uint64_t      sgdByteOffset;
+            uint64_t      sgdByteLength;
+        };
+        static_assert(sizeof(Ktx2Header) == 80, "The KTX2 header is read as it is laid out in the file");
+
+        struct Ktx2Level {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        struct DdsPixelFormat {
+            uint32_t size;
+            uint32_t flags;
+            uint32_t fourCC;
+            uint32_t rgbBitCount;
+            uint32_t redMask;
+            uint32_t greenMask;
+            uint32_t blueMask;
+            uint32_t alphaMask;
+        };
+
+        struct DdsHeader {
+            uint32_t       magic;
+            uint32_t       size;
+            uint32_t       flags;
+            uint32_t       height;
+            uint32_t       width;
+            uint32_t       pitchOrLinearSize;
+            uint32_t       depth;
+            uint32_t       mipMapCount;
+            uint32_t       reserved1[11];
+            DdsPixelFormat pixelFormat;
+            uint32_t       caps;
+            uint32_t       caps2;
+            uint32_t       caps3;
+            uint32_t       caps4;
+            uint32_t       reserved2;
+        };
+        static_assert(sizeof(DdsHeader) == 128, "The DDS header is read as it is laid out in the file");
+
+        struct DdsHeaderDx10 {
+            uint32_t dxgiFormat;
+            uint32_t resourceDimension;
+            uint32_t miscFlag;
+            uint32_t arraySize;
+            uint32_t miscFlags2;
+        };
+
+        constexpr uint32_t makeFourCC(char a, char b, char c, char d) {
+            return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) |
+                   (uint32_t(uint8_t(d)) << 24);
+        }
+
+        constexpr uint32_t DDS_MAGIC = makeFourCC('D', 'D', 'S', ' ');
+        constexpr uint32_t DDSD_REQUIRED = 0x1 | 0x2 | 0x4 | 0x1000;  // caps, height, width and pixel format
+        constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+        constexpr uint32_t DDPF_FOURCC = 0x4;
+        constexpr uint32_t DDPF_RGB = 0x40;
+        constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+        constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+        constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+        constexpr uint32_t DDSCAPS2_CUBEMAP_ALL_FACES = 0x200 | 0xFC00;
+        constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+        constexpr uint32_t DDS_MISC_TEXTURECUBE = 0x4;
+
+        // DXGI formats of the DX10 header
+        constexpr std::pair<uint32_t, VkFormat> DXGI_FORMATS[] = {
+            {28, VK_FORMAT_R8G8B8A8_UNORM},       {29, VK_FORMAT_R8G8B8A8_SRGB},
+            {71, VK_FORMAT_BC1_RGBA_UNORM_BLOCK}, {72, VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+            {77, VK_FORMAT_BC3_UNORM_BLOCK},      {78, VK_FORMAT_BC3_SRGB_BLOCK},
+            {83, VK_FORMAT_BC5_UNORM_BLOCK},      {98, VK_FORMAT_BC7_UNORM_BLOCK},
+            {99, VK_FORMAT_BC7_SRGB_BLOCK}};
+
+        // Khronos data format descriptor values, the reader relies on vkFormat alone but the spec asks for them
+        constexpr uint32_t KHR_DF_MODEL_RGBSDA = 1;
+        constexpr uint32_t KHR_DF_MODEL_BC1A = 128;
+        constexpr uint32_t KHR_DF_MODEL_BC3 = 130;
+        constexpr uint32_t KHR_DF_MODEL_BC5 = 132;
+        constexpr uint32_t KHR_DF_MODEL_BC7 = 134;
+        constexpr uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+        constexpr uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+        constexpr uint32_t KHR_DF_TRANSFER_SRGB = 2;
+        constexpr uint32_t KHR_DF_SAMPLE_DATATYPE_LINEAR = 0x10;
+
+        bool isSrgb(VkFormat format) {
+            return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ||
+                   format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK ||
+                   format == VK_FORMAT_BC7_SRGB_BLOCK;
+        }
+
+        std::string getExtension(const std::string& filePath) {
+            std::string extension = std::filesystem::path(filePath).extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return extension;
+        }
+
+        // Words of a basic data format descriptor block, with the total size in front
+        std::vector<uint32_t> makeDataFormatDescriptor(VkFormat format) {
+            struct Sample {
+                uint32_t bitOffset;
+                uint32_t bitLength;
+                uint32_t channel;
+                bool     alpha;
+            };
+
+            uint32_t            model = KHR_DF_MODEL_RGBSDA;
+            uint32_t            blockDimension = 3;
+            uint32_t            upper = 0xFFFFFFFF;
+            std::vector<Sample> samples;
+            switch (format) {
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                    model = KHR_DF_MODEL_BC1A;
+                    samples = {{0, 64, 0, false}};
+                    break;
+                case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                    model = KHR_DF_MODEL_BC1A;
+                    samples = {{0, 64, 1, true}};
+                    break;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                case VK_FORMAT_BC3_SRGB_BLOCK:
+                    model = KHR_DF_MODEL_BC3;
+                    samples = {{0, 64, 15, true}, {64, 64, 0, false}};
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    model = KHR_DF_MODEL_BC5;
+                    samples = {{0, 64, 0, false}, {64, 64, 1, false}};
+                    break;
+                case VK_FORMAT_BC7_UNORM_BLOCK:
+                case VK_FORMAT_BC7_SRGB_BLOCK:
+                    model = KHR_DF_MODEL_BC7;
+                    samples = {{0, 128, 0, false}};
+                    break;
+                default:
+                    blockDimension = 0;
+                    upper = 255;
+                    samples = {{0, 8, 0, false}, {8, 8, 1, false}, {16, 8, 2, false}, {24, 8, 15, true}};
+                    break;
+            }
+
+            bool                  srgb = isSrgb(format);
+            uint32_t              blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+            uint32_t              blockBytes = static_cast<uint32_t>(getTextureLevelSize(format, 1, 1));
+            std::vector<uint32_t> words = {4 + blockSize, 0, 2 | (blockSize << 16),
+                                           model | (KHR_DF_PRIMARIES_BT709 << 8) |
+                                               ((srgb ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR) << 16),
+                                           blockDimension | (blockDimension << 8), blockBytes, 0};
+            for (const Sample& sample : samples) {
+                uint32_t channelType = sample.channel | (srgb && sample.alpha ? KHR_DF_SAMPLE_DATATYPE_LINEAR : 0);
+                words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (channelType << 24));
+                words.push_back(0);
+                words.push_back(0);
+                words.push_back(upper);
+            }
+            return words;
+        }
+
+        // Where the levels of every layer go once the header is read, no memory fails the read
+        using DataDestination = std::function<unsigned char*(const TextureFile& file)>;
+
+        // Reads a mapped file like a stream, the bytes are copied from the mapping straight to their destination
+        struct FileReader {
+            const FileView& file;
+            uint64_t        offset = 0;
+
+            bool read(void* destination, size_t size) {
+                if (offset > file.size() || size > file.size() - offset) {
+                    return false;
+                }
+                std::memcpy(destination, file.data() + offset, size);
+                offset += size;
+                return true;
+            }
+        };
+
+        bool checkTexture(const std::string& filePath, const TextureFile& file) {
+            if (getTextureLevelSize(file.format, 1, 1) == 0) {
+                YZ_ERROR("'" + filePath + "' holds a texture format that isn't supported: " + STR(file.format));
+                return false;
+            }
+            if (file.width == 0 || file.height == 0 || file.layerCount == 0 || file.levelCount == 0) {
+                YZ_ERROR("'" + filePath + "' has no texels.");
+                return false;
+            }
+            // Levels past the 1x1 one have no size, the level table would be read and allocated for nothing
+            if (file.levelCount > getMipLevelCount(file.width, file.height)) {
+                YZ_ERROR("'" + filePath + "' has " + STR(file.levelCount) + " levels, more than its size allows.");
+                return false;
+            }
+            return true;
+        }
+
+        bool readKtx2(const std::string& filePath, FileReader& reader, TextureFile& file,
+                      std::vector<uint64_t>& levelOffsets, const DataDestination& destination) {
+            Ktx2Header header;
+            if (!reader.read(&header, sizeof(header)) ||
+                std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+                YZ_ERROR("'" + filePath + "' is not a KTX2 file.");
+                return false;
+            }
+            if (header.supercompressionScheme != 0 || header.pixelDepth > 1) {
+                YZ_ERROR("'" + filePath + "' is supercompressed or a 3d texture, neither is supported.");
+                return false;
+            }
+
+            file.format = static_cast<VkFormat>(header.vkFormat);
+            file.width = header.pixelWidth;
+            file.height = header.pixelHeight;
+            file.cube = header.faceCount == 6;
+            file.layerCount = (std::max)(header.layerCount, 1u) * header.faceCount;
+            file.levelCount = (std::max)(header.levelCount, 1u);
+            if (!checkTexture(filePath, file)) {
+                return false;
+            }
+
+            std::vector<Ktx2Level> levels(file.levelCount);
+            if (!reader.read(levels.data(), levels.size() * sizeof(Ktx2Level))) {
+                YZ_ERROR("'" + filePath + "' is truncated.");
+                return false;
+            }
+            levelOffsets.clear();
+            for (uint32_t level = 0; level < file.levelCount; level++) {
+                size_t levelSize = getTextureLevelsSize(file.format, file.width, file.height, level, level + 1);
+                if (levels[level].byteLength < levelSize * file.layerCount) {
+                    YZ_ERROR("Level " + STR(level) + " of '" + filePath + "' is smaller than its texels.");
+                    return false;
+                }
+                levelOffsets.push_back(levels[level].byteOffset);
+            }
+            unsigned char* data = destination ? destination(file) : nullptr;
+            if (!data) {
+                return !destination;
+            }
+
+            // Inside a level the layers follow each other, here every layer keeps its levels together
+            size_t layerSize = getTextureLevelsSize(file.format, file.width, file.height, 0, file.levelCount);
+            for (uint32_t layer = 0; layer < file.layerCount; layer++) {
+                size_t offset = layer * layerSize;
+                for (uint32_t level = 0; level < file.levelCount; level++) {
+                    size_t levelSize = getTextureLevelsSize(file.format, file.width, file.height, level, level + 1);
+                    reader.offset = levels[level].byteOffset + layer * levelSize;
+                    if (!reader.read(data + offset, levelSize)) {
+                        YZ_ERROR("'" + filePath + "' is truncated.");
+                        return false;
+                    }
+                    offset += levelSize;
+                }
+            }
+            return true;
+        }
+
+        bool readDds(const std::string& filePath, FileReader& reader, TextureFile& file,
+                     std::vector<uint64_t>& levelOffsets, const DataDestination& destination) {
+            DdsHeader header;
+            if (!reader.read(&header, sizeof(header)) || header.magic != DDS_MAGIC) {
+                YZ_ERROR("'" + filePath + "' is not a DDS file.");
+                return false;
+            }
+
+            file.width = header.width;
+            file.height = header.height;
+            file.levelCount = (std::max)(header.mipMapCount, 1u);
+            file.cube = (header.caps2 & DDSCAPS2_CUBEMAP_ALL_FACES) == DDSCAPS2_CUBEMAP_ALL_FACES;
+            file.layerCount = file.cube ? 6 : 1;
+
+            const DdsPixelFormat& pixelFormat = header.pixelFormat;
+            if ((pixelFormat.flags & DDPF_FOURCC) && pixelFormat.fourCC == makeFourCC('D', 'X', '1', '0')) {
+                DdsHeaderDx10 headerDx10;
+                if (!reader.read(&headerDx10, sizeof(headerDx10))) {
+                    YZ_ERROR("'" + filePath + "' is truncated.");
+                    return false;
+                }
+                for (const auto& dxgiFormat : DXGI_FORMATS) {
+                    if (dxgiFormat.first == headerDx10.dxgiFormat) {
+                        file.format = dxgiFormat.second;
+                    }
+                }
+                file.cube = (headerDx10.miscFlag & DDS_MISC_TEXTURECUBE) != 0;
+                file.layerCount = (std::max)(headerDx10.arraySize, 1u) * (file.cube ? 6 : 1);
+            } else if (pixelFormat.flags & DDPF_FOURCC) {
+                // Legacy files don't say whether they are srgb
+                if (pixelFormat.fourCC == makeFourCC('D', 'X', 'T', '1')) {
+                    file.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+                } else if (pixelFormat.fourCC == makeFourCC('D', 'X', 'T', '5')) {
+                    file.format = VK_FORMAT_BC3_UNORM_BLOCK;
+                } else if (pixelFormat.fourCC == makeFourCC('A', 'T', 'I', '2') ||
+                           pixelFormat.fourCC == makeFourCC('B', 'C', '5', 'U')) {
+                    file.format = VK_FORMAT_BC5_UNORM_BLOCK;
+                }
+            } else if ((pixelFormat.flags & DDPF_RGB) && pixelFormat.rgbBitCount == 32 &&
+                       pixelFormat.redMask == 0x000000FF && pixelFormat.greenMask == 0x0000FF00 &&
+                       pixelFormat.blueMask == 0x00FF0000) {
+                file.format = VK_FORMAT_R8G8B8A8_UNORM;
+            }
+            if (!checkTexture(filePath, file)) {
+                return false;
+            }
+
+            // Every layer keeps its levels together, finest first, just like TextureFile
+            uint64_t dataOffset = reader.offset;
+            levelOffsets.clear();
+            for (uint32_t level = 0; level < file.levelCount; level++) {
+                levelOffsets.push_back(dataOffset +
+                                       getTextureLevelsSize(file.format, file.width, file.height, 0, level));
+            }
+            unsigned char* data = destination ? destination(file) : nullptr;
+            if (!data) {
+                return !destination;
+            }
+
+            if (!reader.read(data, getTextureFileSize(file))) {
+                YZ_ERROR("'" + filePath + "' is truncated.");
+                return false;
+            }
+            return true;
+        }
+
+        bool readTextureFile(const std::string& filePath, TextureFile& file, std::vector<uint64_t>& levelOffsets,
+                             const DataDestination& destination) {
+            FileView view = FileSystem::instance()->open(filePath);
+            if (!view.isOpen()) {
+                YZ_ERROR("'" + filePath + "' could not be opened.");
+                return false;
+            }
+            file = {};
+            FileReader reader{view};
+            if (getExtension(filePath) == ".dds") {
+                return readDds(filePath, reader, file, levelOffsets, destination);
+            }
+            return readKtx2(filePath, reader, file, levelOffsets, destination);
+        }
+
+        bool writeKtx2(std::ofstream& stream, const TextureFile& file) {
+            uint32_t faceCount = file.cube ? 6 : 1;
+            uint32_t arraySize = file.layerCount / faceCount;
+
+            Ktx2Header header = {};
+            std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+            header.vkFormat = file.format;
+            header.typeSize = 1;
+            header.pixelWidth = file.width;
+            header.pixelHeight = file.height;
+            header.layerCount = arraySize > 1 ? arraySize : 0;
+            header.faceCount = faceCount;
+            header.levelCount = file.levelCount;
+
+            std::vector<uint32_t> descriptor = makeDataFormatDescriptor(file.format);
+            header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + file.levelCount * sizeof(Ktx2Level));
+            header.dfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+
+            // The levels go smallest first, each aligned to a block and to 4 bytes
+            size_t   alignment = (std::max)(getTextureLevelSize(file.format, 1, 1), size_t(4));
+            size_t   layerSize = getTextureLevelsSize(file.format, file.width, file.height, 0, file.levelCount);
+            uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+            std::vector<Ktx2Level> levels(file.levelCount);
+            for (uint32_t level = file.levelCount; level-- > 0;) {
+                offset = (offset + alignment - 1) / alignment * alignment;
+                size_t levelSize = getTextureLevelsSize(file.format, file.width, file.height, level, level + 1);
+                levels[level] = {offset, levelSize * file.layerCount, levelSize * file.layerCount};
+                offset += levelSize * file.layerCount;
+            }
+
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(Ktx2Level));
+            stream.write(reinterpret_cast<const char*>(descriptor.data()), header.dfdByteLength);
+            for (uint32_t level = file.levelCount; level-- > 0;) {
+                std::vector<char> padding(levels[level].byteOffset - static_cast<uint64_t>(stream.tellp()), 0);
+                stream.write(padding.data(), padding.size());
+                size_t levelOffset = getTextureLevelsSize(file.format, file.width, file.height, 0, level);
+                size_t levelSize = getTextureLevelsSize(file.format, file.width, file.height, level, level + 1);
+                for (uint32_t layer = 0; layer < file.layerCount; layer++) {
+                    stream.write(reinterpret_cast<const char*>(file.data.data() + layer * layerSize + levelOffset),
+                                 levelSize);
+                }
+            }
+            return static_cast<bool>(stream);
+        }
+
+        bool writeDds(const std::string& filePath, std::ofstream& stream, const TextureFile& file) {
+            DdsHeaderDx10 headerDx10 = {};
+            for (const auto& dxgiFormat : DXGI_FORMATS) {
+                if (dxgiFormat.second == file.format) {
+                    headerDx10.dxgiFormat = dxgiFormat.first;
+                }
+            }
+            if (file.format == VK_FORMAT_BC1_RGB_UNORM_BLOCK || file.format == VK_FORMAT_BC1_RGB_SRGB_BLOCK) {
+                headerDx10.dxgiFormat = file.format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ? 72 : 71;
+            }
+            if (headerDx10.dxgiFormat == 0) {
+                YZ_ERROR("'" + filePath + "' can't be written, DDS has no format for " + STR(file.format));
+                return false;
+            }
+            headerDx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+            headerDx10.miscFlag = file.cube ? DDS_MISC_TEXTURECUBE : 0;
+            headerDx10.arraySize = file.layerCount / (file.cube ? 6 : 1);
+
+            DdsHeader header = {};
+            header.magic = DDS_MAGIC;
+            header.size = sizeof(DdsHeader) - sizeof(header.magic);
+            header.flags = DDSD_REQUIRED | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+            header.width = file.width;
+            header.height = file.height;
+            header.pitchOrLinearSize = static_cast<uint32_t>(getTextureLevelSize(file.format, file.width, file.height));
+            header.mipMapCount = file.levelCount;
+            header.pixelFormat.size = sizeof(DdsPixelFormat);
+            header.pixelFormat.flags = DDPF_FOURCC;
+            header.pixelFormat.fourCC = makeFourCC('D', 'X', '1', '0');
+            header.caps = DDSCAPS_TEXTURE | (file.levelCount > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0) |
+                          (file.cube ? DDSCAPS_COMPLEX : 0);
+            header.caps2 = file.cube ? DDSCAPS2_CUBEMAP_ALL_FACES : 0;
+
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(&headerDx10), sizeof(headerDx10));
+            stream.write(reinterpret_cast<const char*>(file.data.data()), file.data.size());
+            return static_cast<bool>(stream);
+        }
+    }  // namespace
+
+    size_t getTextureLevelSize(VkFormat format, size_t width, size_t height) {
+        size_t blocks = ((width + 3) / 4) * ((height + 3) / 4);
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                return blocks * 8;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return blocks * 16;
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                return width * height * 4;
+            default:
+                return 0;
+        }
+    }
+
+    size_t getTextureLevelsSize(VkFormat format, size_t width, size_t height, uint32_t firstLevel, uint32_t endLevel) {
+        size_t size = 0;
+        for (uint32_t level = firstLevel; level < endLevel; level++) {
+            size += getTextureLevelSize(format, (std::max)(width >> level, size_t(1)),
+                                        (std::max)(height >> level, size_t(1)));
+        }
+        return size;
+    }
+
+    size_t getTextureFileSize(const TextureFile& file) {
+        return getTextureLevelsSize(file.format, file.width, file.height, 0, file.levelCount) * file.layerCount;
+    }
+
+    bool isBlockCompressed(VkFormat format) {
+        return format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB &&
+               getTextureLevelSize(format, 1, 1) != 0;
+    }
+
+    std::string findCookedTexture(const std::string& sourcePath) {
+        std::string extension = getExtension(sourcePath);
+        if (extension == ".ktx2" || extension == ".dds") {
+            return sourcePath;
+        }
+
+        std::error_code sourceError;
+        auto            sourceTime = std::filesystem::last_write_time(sourcePath, sourceError);
+        for (const char* cookedExtension : {".ktx2", ".dds"}) {
+            std::filesystem::path cookedPath(sourcePath);
+            cookedPath.replace_extension(cookedExtension);
+            if (FileSystem::instance()->isPacked(cookedPath.string())) {
+                return cookedPath.string();
+            }
+
+            std::error_code cookedError;
+            auto            cookedTime = std::filesystem::last_write_time(cookedPath, cookedError);
+            if (!cookedError && (sourceError || cookedTime >= sourceTime)) {
+                return cookedPath.string();
+            }
+        }
+        return "";
+    }
+
+    bool loadTextureFile(const std::string& filePath, TextureFile& file) {
+        std::vector<uint64_t> levelOffsets;
+        return readTextureFile(filePath, file, levelOffsets, [&file](const TextureFile&) {
+            file.data.resize(getTextureFileSize(file));
+            return file.data.data();
+        });
+    }
+
+    bool loadTextureFileHeader(const std::string& filePath, TextureFile& file, std::vector<uint64_t>& levelOffsets) {
+        return readTextureFile(filePath, file, levelOffsets, nullptr);
+    }
+
+    bool loadTextureFileData(const std::string& filePath, const TextureFile& file, unsigned char* data) {
+        TextureFile           read;
+        std::vector<uint64_t> levelOffsets;
+        return readTextureFile(filePath, read, levelOffsets, [&](const TextureFile& header) -> unsigned char* {
+            if (header.format != file.format || header.width != file.width || header.height != file.height ||
+                header.layerCount != file.layerCount || header.levelCount != file.levelCount) {
+                YZ_ERROR("'" + filePath + "' changed since its header was read.");
+                return nullptr;
+            }
+            return data;
+        });
+    }
+
+    bool saveTextureFile(const std::string& filePath, const TextureFile& file) {
+        std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            YZ_ERROR("'" + filePath + "' could not be opened for writing.");
+            return false;
+        }
+        if (getExtension(filePath) == ".dds") {
+            return writeDds(filePath, stream, file);
+        }
+        return writeKtx2(stream, file);
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,48 @@
+#ifndef YARE_TEXTURE_CONTAINER_H
+#define YARE_TEXTURE_CONTAINER_H
+
+#include <string>
+#include <vector>
+
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    // Prebuilt levels of a KTX2 or DDS file, in the layout the images are filled from. The layers follow each other,
+    // each with its levels packed finest first. The six faces of a cube are six layers.
+    struct TextureFile {
+        VkFormat                   format = VK_FORMAT_UNDEFINED;
+        uint32_t                   width = 0;
+        uint32_t                   height = 0;
+        uint32_t                   layerCount = 1;
+        uint32_t                   levelCount = 1;
+        bool                       cube = false;
+        std::vector<unsigned char> data;
+    };
+
+    // Bytes of one level of a BC1, BC3, BC5, BC7 or rgba8 texture, 0 for any other format
+    size_t getTextureLevelSize(VkFormat format, size_t width, size_t height);
+    size_t getTextureLevelsSize(VkFormat format, size_t width, size_t height, uint32_t firstLevel, uint32_t endLevel);
+    // Bytes of every level of every layer
+    size_t getTextureFileSize(const TextureFile& file);
+    bool   isBlockCompressed(VkFormat format);
+
+    // The cooked .ktx2 or .dds file next to a source texture, when there is one at least as new as the source.
+    // Paths that already are one are returned as they are, an empty path means there is nothing cooked. A cooked
+    // file in the asset pack is taken as it is, the pack only holds the ones that were up to date.
+    std::string findCookedTexture(const std::string& sourcePath);
+
+    // Reads a KTX2 or DDS file by its extension, from the asset pack when it is there. Supercompressed KTX2 files
+    // and formats getTextureLevelSize doesn't know are rejected.
+    bool loadTextureFile(const std::string& filePath, TextureFile& file);
+    // Only reads the header, with the offset in the file of every level of the first layer, for readers that load
+    // the levels on their own
+    bool loadTextureFileHeader(const std::string& filePath, TextureFile& file, std::vector<uint64_t>& levelOffsets);
+    // Reads the levels of a file whose header was read before straight into data, laid out like TextureFile::data.
+    // Data has to hold getTextureFileSize(file) bytes, a mapped staging buffer for one.
+    bool loadTextureFileData(const std::string& filePath, const TextureFile& file, unsigned char* data);
+    // Writes a KTX2 file, or a DDS file with a DX10 header when the path ends in .dds
+    bool saveTextureFile(const std::string& filePath, const TextureFile& file);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_TEXTURE_CONTAINER_H
@@ -0,0 +1,486 @@
+#include "Graphics/TextureStreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Graphics/MipGenerator.h"
+#include "Graphics/TextureContainer.h"
+#include "Graphics/Vulkan/Devices.h"
+#include "Graphics/Vulkan/Utilities.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        struct CacheHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t sourceSize;
+            int64_t  sourceTime;
+            uint32_t width;
+            uint32_t height;
+            uint32_t levelCount;
+            uint32_t padding;
+        };
+
+        constexpr uint32_t CACHE_MAGIC = 0x434D5459;  // "YTMC"
+        constexpr uint32_t CACHE_VERSION = 2;
+        constexpr uint32_t NO_REQUEST = 0xFFFFFFFF;
+
+        size_t levelWidth(size_t width, uint32_t level) { return (std::max)(width >> level, size_t(1)); }
+
+        void imageBarrier(VkCommandBuffer commandBuffer, VkImage image, uint32_t levelCount, VkImageLayout oldLayout,
+                          VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                          VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1};
+            vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+    }  // namespace
+
+    TextureStreamer::TextureStreamer(const TextureStreamerSettings& settings) : m_Settings(settings) {
+        Feedback feedback = {};
+        std::fill(std::begin(feedback.requestedLevels), std::end(feedback.requestedLevels), NO_REQUEST);
+        m_FeedbackBuffer = new Buffer(BufferUsage::STORAGE, sizeof(Feedback), &feedback);
+        m_Loader = std::thread(&TextureStreamer::loaderLoop, this);
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_LoadQueued.notify_all();
+        m_Loader.join();
+        delete m_FeedbackBuffer;
+    }
+
+    std::unique_ptr<TextureStreamer::StreamedTexture> TextureStreamer::prepareMaterial(
+        const std::shared_ptr<Material>& material) const {
+        // Nothing reports what the shaders sample when they can't store to the feedback buffer
+        if (material->getType() != MaterialTexType::Texture2D || material->getFilePaths().empty() ||
+            !Devices::instance()->hasFragmentStoresAndAtomics()) {
+            return nullptr;
+        }
+
+        auto texture = std::make_unique<StreamedTexture>();
+        texture->material = material;
+        std::string sourcePath = material->getFilePaths()[0];
+
+        // A cooked file already has every level, they stream from it in its own format. Otherwise they come from the
+        // cache when it is up to date, or the whole chain is built and written first.
+        std::string                cookedPath = findCookedTexture(sourcePath);
+        TextureFile                cooked;
+        std::vector<unsigned char> chain;
+        if (!cookedPath.empty() && loadTextureFileHeader(cookedPath, cooked, texture->levelOffsets) && !cooked.cube &&
+            cooked.layerCount == 1 && Image::canSampleFormat(cooked.format)) {
+            texture->levelPath = cookedPath;
+            texture->format = cooked.format;
+            texture->width = cooked.width;
+            texture->height = cooked.height;
+            texture->levelCount = cooked.levelCount;
+        } else {
+            texture->levelPath = sourcePath + ".mips";
+
+            CacheHeader     header = {};
+            std::error_code sizeError, timeError;
+            header.magic = CACHE_MAGIC;
+            header.version = CACHE_VERSION;
+            header.sourceSize = std::filesystem::file_size(sourcePath, sizeError);
+            header.sourceTime = static_cast<int64_t>(
+                std::filesystem::last_write_time(sourcePath, timeError).time_since_epoch().count());
+
+            std::ifstream cacheFile(texture->levelPath, std::ios::binary);
+            CacheHeader   cachedHeader = {};
+            bool cached = !sizeError && !timeError &&
+                          cacheFile.read(reinterpret_cast<char*>(&cachedHeader), sizeof(cachedHeader)) &&
+                          cachedHeader.magic == header.magic && cachedHeader.version == header.version &&
+                          cachedHeader.sourceSize == header.sourceSize && cachedHeader.sourceTime == header.sourceTime;
+            if (cached) {
+                header = cachedHeader;
+            } else {
+                TextureData source;
+                if (!Image::loadTextureData(sourcePath, source)) {
+                    return nullptr;
+                }
+                header.width = static_cast<uint32_t>(source.width);
+                header.height = static_cast<uint32_t>(source.height);
+                header.levelCount = getMipLevelCount(source.width, source.height);
+                chain = generateMipChain(source.pixels.data(), source.width, source.height, header.levelCount);
+
+                std::ofstream newCacheFile(texture->levelPath, std::ios::binary | std::ios::trunc);
+                if (!newCacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+                    !newCacheFile.write(reinterpret_cast<const char*>(chain.data()), chain.size())) {
+                    YZ_WARN("Mip cache '" + texture->levelPath + "' could not be written.");
+                }
+            }
+
+            texture->width = header.width;
+            texture->height = header.height;
+            texture->levelCount = header.levelCount;
+            for (uint32_t level = 0; level < texture->levelCount; level++) {
+                texture->levelOffsets.push_back(sizeof(CacheHeader) + getLevelsSize(*texture, 0, level));
+            }
+        }
+
+        texture->tailLevel = 0;
+        while (texture->tailLevel + 1 < texture->levelCount &&
+               (levelWidth(texture->width, texture->tailLevel) > m_Settings.tailSize ||
+                levelWidth(texture->height, texture->tailLevel) > m_Settings.tailSize)) {
+            texture->tailLevel++;
+        }
+        texture->requestedLevel = texture->tailLevel;
+
+        std::vector<unsigned char>& tail = texture->loadedData;
+        if (chain.empty()) {
+            FileView levelFile = FileSystem::instance()->open(texture->levelPath);
+            if (!readLevels(*texture, levelFile, texture->tailLevel, texture->levelCount, tail)) {
+                YZ_WARN("'" + texture->levelPath + "' is truncated.");
+            }
+        } else {
+            tail.assign(chain.begin() + getLevelsSize(*texture, 0, texture->tailLevel), chain.end());
+        }
+        return texture;
+    }
+
+    void TextureStreamer::addMaterial(const std::shared_ptr<Material>& material,
+                                      std::unique_ptr<StreamedTexture> texture) {
+        if (!texture) {
+            material->loadTextures();
+            return;
+        }
+
+        // Nothing is resident yet, so every level of the tail comes from the data
+        std::vector<unsigned char> tail = std::move(texture->loadedData);
+        texture->loadedData.clear();
+        texture->residentLevel = texture->levelCount;
+        replaceImage(*texture, texture->tailLevel, tail);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Textures.push_back(std::move(texture));
+    }
+
+    bool TextureStreamer::update() {
+        m_Frame++;
+        readFeedback();
+
+        // Levels that arrived go in first, the nearest request doesn't matter as much as getting them out of memory
+        bool     changed = false;
+        uint32_t commitCount = 0;
+        for (auto& texture : m_Textures) {
+            if (commitCount >= m_Settings.commitsPerFrame) {
+                break;
+            }
+            std::vector<unsigned char> data;
+            uint32_t                   loadLevel;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (!texture->loaded) {
+                    continue;
+                }
+                data = std::move(texture->loadedData);
+                loadLevel = texture->loadLevel;
+                texture->loading = false;
+                texture->loaded = false;
+            }
+            replaceImage(*texture, loadLevel, data);
+            commitCount++;
+            changed = true;
+        }
+
+        // Levels no frame sampled for a while are dropped. The images are swapped outside the lock, the loader only
+        // reads the resident level of textures that are loading, and those are left alone.
+        std::vector<StreamedTexture*> dropped;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (auto& texture : m_Textures) {
+                if (!texture->loading && texture->requestedLevel > texture->residentLevel) {
+                    dropped.push_back(texture.get());
+                }
+            }
+        }
+        for (StreamedTexture* texture : dropped) {
+            replaceImage(*texture, texture->requestedLevel, {});
+            changed = true;
+        }
+
+        size_t residentBytes = 0;
+        size_t fullBytes = 0;
+        size_t pendingBytes = 0;
+        std::vector<StreamedTexture*> candidates;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (auto& texture : m_Textures) {
+                if (texture->loading) {
+                    pendingBytes += getLevelsSize(*texture, texture->loadLevel, texture->residentLevel);
+                } else if (texture->requestedLevel < texture->residentLevel) {
+                    candidates.push_back(texture.get());
+                }
+                residentBytes += getLevelsSize(*texture, texture->residentLevel, texture->levelCount);
+                fullBytes += getLevelsSize(*texture, 0, texture->levelCount);
+            }
+        }
+
+        // Over the budget, or short of it for what the last frame sampled, the textures whose requests are oldest
+        // give up their finest levels first. Only those the last frame didn't sample do, so visible textures don't
+        // take turns.
+        size_t neededBytes = residentBytes + pendingBytes;
+        for (const StreamedTexture* texture : candidates) {
+            if (texture->requestedFrame == m_Frame) {
+                neededBytes += getLevelsSize(*texture, texture->requestedLevel, texture->residentLevel);
+            }
+        }
+        if (neededBytes > m_Settings.budget) {
+            std::vector<StreamedTexture*> evictable;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (auto& texture : m_Textures) {
+                    if (!texture->loading && texture->requestedFrame < m_Frame &&
+                        texture->residentLevel < texture->tailLevel) {
+                        evictable.push_back(texture.get());
+                    }
+                }
+            }
+            std::sort(evictable.begin(), evictable.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+                return a->requestedFrame < b->requestedFrame;
+            });
+            for (StreamedTexture* texture : evictable) {
+                if (neededBytes <= m_Settings.budget) {
+                    break;
+                }
+                uint32_t level = texture->residentLevel;
+                while (level < texture->tailLevel && neededBytes > m_Settings.budget) {
+                    size_t levelBytes = getLevelsSize(*texture, level, level + 1);
+                    neededBytes -= levelBytes;
+                    residentBytes -= levelBytes;
+                    level++;
+                }
+                // Forgotten as well, a frame that samples the texture again asks for the levels anew
+                texture->requestedLevel = (std::max)(texture->requestedLevel, level);
+                replaceImage(*texture, level, {});
+                changed = true;
+            }
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [](const StreamedTexture* texture) {
+                                                return texture->requestedLevel >= texture->residentLevel;
+                                            }),
+                             candidates.end());
+        }
+
+        // The textures furthest from what they need load first, each as far as the budget goes
+        std::sort(candidates.begin(), candidates.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+            return a->residentLevel - a->requestedLevel > b->residentLevel - b->requestedLevel;
+        });
+        for (StreamedTexture* texture : candidates) {
+            uint32_t level = texture->requestedLevel;
+            while (level < texture->residentLevel &&
+                   residentBytes + pendingBytes + getLevelsSize(*texture, level, texture->residentLevel) >
+                       m_Settings.budget) {
+                level++;
+            }
+            if (level == texture->residentLevel) {
+                continue;
+            }
+
+            pendingBytes += getLevelsSize(*texture, level, texture->residentLevel);
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            texture->loading = true;
+            texture->loadLevel = level;
+        }
+        m_LoadQueued.notify_all();
+
+        // Only now that every image is swapped do the levels match what the next frame samples
+        writeResidentLevels();
+
+        m_Stats.textureCount = static_cast<uint32_t>(m_Textures.size());
+        m_Stats.loadingCount = 0;
+        for (const auto& texture : m_Textures) {
+            m_Stats.loadingCount += texture->loading ? 1 : 0;
+        }
+        m_Stats.residentBytes = residentBytes;
+        m_Stats.fullBytes = fullBytes;
+        return changed;
+    }
+
+    void TextureStreamer::readFeedback() {
+        if (!m_FeedbackBuffer->mapMemory()) {
+            return;
+        }
+
+        auto* feedback = static_cast<Feedback*>(m_FeedbackBuffer->getMappedData());
+        for (auto& texture : m_Textures) {
+            int slot = texture->material->getImageIdx();
+            if (slot < 0 || slot >= static_cast<int>(MAX_TEXTURES)) {
+                continue;
+            }
+
+            // A finer request is taken at once, a coarser one only once the finer one is old enough
+            uint32_t requested = feedback->requestedLevels[slot];
+            bool     expired = m_Frame - texture->requestedFrame > m_Settings.keepFrames;
+            if (requested != NO_REQUEST && (requested <= texture->requestedLevel || expired)) {
+                texture->requestedLevel = (std::min)(requested, texture->tailLevel);
+                texture->requestedFrame = m_Frame;
+            } else if (expired) {
+                texture->requestedLevel = texture->tailLevel;
+            }
+        }
+        std::fill(std::begin(feedback->requestedLevels), std::end(feedback->requestedLevels), NO_REQUEST);
+        m_FeedbackBuffer->unmapMemory();
+    }
+
+    void TextureStreamer::writeResidentLevels() {
+        if (!m_FeedbackBuffer->mapMemory()) {
+            return;
+        }
+
+        // The shaders add these to the level they compute, which is relative to the image's own finest level
+        auto* feedback = static_cast<Feedback*>(m_FeedbackBuffer->getMappedData());
+        std::fill(std::begin(feedback->residentLevels), std::end(feedback->residentLevels), 0u);
+        for (const auto& texture : m_Textures) {
+            int slot = texture->material->getImageIdx();
+            if (slot >= 0 && slot < static_cast<int>(MAX_TEXTURES)) {
+                feedback->residentLevels[slot] = texture->residentLevel;
+            }
+        }
+        m_FeedbackBuffer->unmapMemory();
+    }
+
+    void TextureStreamer::loaderLoop() {
+        while (true) {
+            StreamedTexture* texture = nullptr;
+            uint32_t         firstLevel = 0;
+            uint32_t         endLevel = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_LoadQueued.wait(lock, [this, &texture]() {
+                    if (!m_Running) {
+                        return true;
+                    }
+                    for (auto& queued : m_Textures) {
+                        if (queued->loading && !queued->loaded) {
+                            texture = queued.get();
+                            return true;
+                        }
+                    }
+                    return false;
+                });
+                if (!m_Running) {
+                    return;
+                }
+                // The resident level only changes on the main thread while nothing is loading for the texture
+                firstLevel = texture->loadLevel;
+                endLevel = texture->residentLevel;
+            }
+
+            std::vector<unsigned char> data;
+            FileView                   levelFile = FileSystem::instance()->open(texture->levelPath);
+            if (!readLevels(*texture, levelFile, firstLevel, endLevel, data)) {
+                YZ_WARN("'" + texture->levelPath + "' could not be read.");
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            texture->loadedData = std::move(data);
+            texture->loaded = true;
+        }
+    }
+
+    void TextureStreamer::replaceImage(StreamedTexture& texture, uint32_t firstLevel,
+                                       const std::vector<unsigned char>& data) {
+        const Image* previous = texture.material->getTextureImage();
+        uint32_t     levelCount = texture.levelCount - firstLevel;
+        // Levels before copyLevel come from the data, the rest from the current image
+        uint32_t copyLevel = (std::max)(firstLevel, texture.residentLevel);
+        Image*   image = Image::createMippedTexture2D(levelWidth(texture.width, firstLevel),
+                                                      levelWidth(texture.height, firstLevel), levelCount,
+                                                      texture.format);
+
+        Buffer stagingBuffer;
+        if (!data.empty()) {
+            stagingBuffer.init(BufferUsage::TRANSFER, data.size(), data.data());
+        }
+
+        VkCommandBuffer commandBuffer = VkUtil::beginSingleTimeCommands();
+        imageBarrier(commandBuffer, image->getImage(), levelCount, VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        if (!data.empty() && firstLevel < copyLevel) {
+            std::vector<VkBufferImageCopy> regions;
+            VkDeviceSize                   offset = 0;
+            for (uint32_t level = firstLevel; level < copyLevel; level++) {
+                VkBufferImageCopy region = {};
+                region.bufferOffset = offset;
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - firstLevel, 0, 1};
+                region.imageExtent = {static_cast<uint32_t>(levelWidth(texture.width, level)),
+                                      static_cast<uint32_t>(levelWidth(texture.height, level)), 1};
+                regions.push_back(region);
+                offset += getLevelsSize(texture, level, level + 1);
+            }
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.getBuffer(), image->getImage(),
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+                                   regions.data());
+        }
+
+        if (previous && copyLevel < texture.levelCount) {
+            uint32_t previousLevelCount = texture.levelCount - texture.residentLevel;
+            imageBarrier(commandBuffer, previous->getImage(), previousLevelCount,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+            std::vector<VkImageCopy> regions;
+            for (uint32_t level = copyLevel; level < texture.levelCount; level++) {
+                VkImageCopy region = {};
+                region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - texture.residentLevel, 0, 1};
+                region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - firstLevel, 0, 1};
+                region.extent = {static_cast<uint32_t>(levelWidth(texture.width, level)),
+                                 static_cast<uint32_t>(levelWidth(texture.height, level)), 1};
+                regions.push_back(region);
+            }
+            vkCmdCopyImage(commandBuffer, previous->getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           image->getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+        }
+
+        imageBarrier(commandBuffer, image->getImage(), levelCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        VkUtil::endSingleTimeCommands(commandBuffer);
+
+        // Frames are synchronous, nothing still samples the previous image
+        texture.material->setTexture(image);
+        texture.residentLevel = firstLevel;
+    }
+
+    size_t TextureStreamer::getLevelsSize(const StreamedTexture& texture, uint32_t firstLevel,
+                                          uint32_t endLevel) const {
+        return getTextureLevelsSize(texture.format, texture.width, texture.height, firstLevel, endLevel);
+    }
+
+    bool TextureStreamer::readLevels(const StreamedTexture& texture, const FileView& file, uint32_t firstLevel,
+                                     uint32_t endLevel, std::vector<unsigned char>& data) const {
+        // Levels that can't be read stay grey, or whatever that makes of a compressed block
+        data.assign(getLevelsSize(texture, firstLevel, endLevel), static_cast<unsigned char>(0x80));
+        size_t offset = 0;
+        for (uint32_t level = firstLevel; level < endLevel; level++) {
+            size_t   levelSize = getLevelsSize(texture, level, level + 1);
+            uint64_t levelOffset = texture.levelOffsets[level];
+            if (levelOffset > file.size() || levelSize > file.size() - levelOffset) {
+                return false;
+            }
+            std::memcpy(data.data() + offset, file.data() + levelOffset, levelSize);
+            offset += levelSize;
+        }
+        return true;
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,132 @@
+#ifndef YARE_TEXTURE_STREAMER_H
+#define YARE_TEXTURE_STREAMER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/FileSystem.h"
+#include "Graphics/Components/Material.h"
+#include "Graphics/Vulkan/Buffer.h"
+
+namespace Yare::Graphics {
+
+    struct TextureStreamerSettings {
+        // Video memory the streamed textures may take together, the always resident levels count towards it too
+        size_t budget = size_t(64) << 20;
+        // Levels this many texels wide and high or smaller are always resident
+        uint32_t tailSize = 64;
+        // Levels stay resident this many frames after the last frame that sampled them
+        uint32_t keepFrames = 120;
+        // Textures that get new levels per frame at most, which spreads the uploads over several frames
+        uint32_t commitsPerFrame = 2;
+    };
+
+    struct TextureStreamerStats {
+        uint32_t textureCount = 0;
+        uint32_t loadingCount = 0;
+        size_t   residentBytes = 0;
+        // What every texture would take with its whole chain resident
+        size_t fullBytes = 0;
+    };
+
+    // Streams the mip chains of textures by what the fragment shaders sample. Every texture keeps its coarse levels
+    // resident and the shaders write the finest level they asked for to the feedback buffer. Finer levels are read
+    // on a background thread from a cooked KTX2 or DDS file next to the source, or otherwise from a cache of the whole
+    // chain written there the first time, and dropped again once no frame sampled them for a while or the budget
+    // needs the room.
+    //
+    // Without sparse residency the levels of an image can't be freed one by one, so a texture whose resident levels
+    // change is created again at the size of its finest resident level, the levels it keeps are copied on the gpu.
+    class TextureStreamer {
+       public:
+        // Slots of the feedback buffer, indexed by the materials' image index
+        static constexpr uint32_t MAX_TEXTURES = 256;
+
+        TextureStreamer(const TextureStreamerSettings& settings = {});
+        ~TextureStreamer();
+
+        // A material's texture and where its levels stream from, made by prepareMaterial
+        struct StreamedTexture {
+            std::shared_ptr<Material> material;
+            // The cooked file or the mip cache, with where every level starts in it
+            std::string               levelPath;
+            std::vector<uint64_t>     levelOffsets;
+            VkFormat                  format = VK_FORMAT_R8G8B8A8_SRGB;
+            size_t                    width = 0;
+            size_t                    height = 0;
+            uint32_t                  levelCount = 0;
+            // First level of the tail that never leaves
+            uint32_t tailLevel = 0;
+            // Finest level in the current image
+            uint32_t residentLevel = 0;
+            // Finest level sampled within the last keepFrames frames, and the last frame it was sampled
+            uint32_t requestedLevel = 0;
+            uint64_t requestedFrame = 0;
+
+            // Shared with the loader, the levels [loadLevel, residentLevel) packed finest first once loaded. Until
+            // the texture is added they hold the tail prepareMaterial read.
+            bool                       loading = false;
+            bool                       loaded = false;
+            uint32_t                   loadLevel = 0;
+            std::vector<unsigned char> loadedData;
+        };
+
+        // Reads the coarse levels of the material's file, building and caching its mip chain first when there is no
+        // cooked file or cache for it yet. Touches no queue so it can run on any thread, and returns nullptr when
+        // the material doesn't stream.
+        std::unique_ptr<StreamedTexture> prepareMaterial(const std::shared_ptr<Material>& material) const;
+        // Gives the material a texture with the levels prepareMaterial read, the rest streams in later. Without
+        // them the material is loaded whole.
+        void addMaterial(const std::shared_ptr<Material>& material, std::unique_ptr<StreamedTexture> texture);
+        void addMaterial(const std::shared_ptr<Material>& material) {
+            addMaterial(material, prepareMaterial(material));
+        }
+
+        // Reads what the last frame sampled, queues loads, drops levels no longer needed and swaps in the textures
+        // whose levels arrived. Runs between frames and returns true when any material got a new texture, its
+        // descriptors have to be written again.
+        bool update();
+
+        // Matches the TextureFeedback block of the shaders
+        Buffer*                     getFeedbackBuffer() const { return m_FeedbackBuffer; }
+        const TextureStreamerStats& getStats() const { return m_Stats; }
+
+       private:
+        struct Feedback {
+            // Finest level of the whole chain each slot's image starts at, written once its image is swapped
+            uint32_t residentLevels[MAX_TEXTURES];
+            // Finest level of the whole chain the fragments asked for, written by the shaders
+            uint32_t requestedLevels[MAX_TEXTURES];
+        };
+
+        void loaderLoop();
+        void readFeedback();
+        void writeResidentLevels();
+        // Creates the texture's image for the levels from firstLevel on, keeping what the current image has and
+        // uploading data for the levels it doesn't
+        void replaceImage(StreamedTexture& texture, uint32_t firstLevel, const std::vector<unsigned char>& data);
+        size_t getLevelsSize(const StreamedTexture& texture, uint32_t firstLevel, uint32_t endLevel) const;
+        // Reads the levels [firstLevel, endLevel) packed finest first
+        bool readLevels(const StreamedTexture& texture, const FileView& file, uint32_t firstLevel, uint32_t endLevel,
+                        std::vector<unsigned char>& data) const;
+
+        TextureStreamerSettings m_Settings;
+        TextureStreamerStats    m_Stats;
+        uint64_t                m_Frame = 0;
+        Buffer*                 m_FeedbackBuffer = nullptr;
+        // Never move once added, the loader keeps pointers to them
+        std::vector<std::unique_ptr<StreamedTexture>> m_Textures;
+
+        // Guards the loading state of the textures, shared with the loader thread
+        std::mutex              m_Mutex;
+        std::condition_variable m_LoadQueued;
+        std::thread             m_Loader;
+        bool                    m_Running = true;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_TEXTURE_STREAMER_H
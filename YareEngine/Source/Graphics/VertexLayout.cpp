@@ -0,0 +1,122 @@
+#include "Graphics/VertexLayout.h"
+
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+
+namespace Yare::Graphics {
+
+    namespace {
+        float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+    }  // namespace
+
+    std::vector<VkVertexInputBindingDescription> VertexLayout::getBindingDescriptions() const {
+        if (!separatePositions) {
+            return getPositionBindingDescriptions();
+        }
+        return {{0, getPositionStride(), VK_VERTEX_INPUT_RATE_VERTEX},
+                {1, getAttributeStride(), VK_VERTEX_INPUT_RATE_VERTEX}};
+    }
+
+    std::vector<VkVertexInputAttributeDescription> VertexLayout::getAttributeDescriptions() const {
+        // location, binding, format, offset
+        std::vector<VkVertexInputAttributeDescription> attributes = getPositionAttributeDescriptions();
+        uint32_t                                       binding = separatePositions ? 1 : 0;
+        if (color) {
+            attributes.push_back({1u, binding, VK_FORMAT_R8G8B8A8_UNORM, getColorOffset()});
+        }
+        attributes.push_back({2u, binding, VK_FORMAT_R16G16_SNORM, getNormalOffset()});
+        attributes.push_back({3u, binding, VK_FORMAT_R16G16_SFLOAT, getUvOffset()});
+        return attributes;
+    }
+
+    std::vector<VkVertexInputBindingDescription> VertexLayout::getPositionBindingDescriptions() const {
+        return {{0, getPositionStride(), VK_VERTEX_INPUT_RATE_VERTEX}};
+    }
+
+    std::vector<VkVertexInputAttributeDescription> VertexLayout::getPositionAttributeDescriptions() const {
+        VkFormat format =
+            position == PositionFormat::QUANTIZED ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
+        return {{0u, 0, format, 0}};
+    }
+
+    glm::vec4 VertexLayout::getPositionTransform(const glm::vec4& boundingSphere) const {
+        if (position == PositionFormat::FLOAT) {
+            return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+        return glm::vec4(glm::vec3(boundingSphere) - boundingSphere.w, 2.0f * boundingSphere.w);
+    }
+
+    std::vector<uint8_t> VertexLayout::pack(const std::vector<Vertex>& vertices,
+                                            const glm::vec4& boundingSphere) const {
+        std::vector<uint8_t> data(vertices.size() * getStride());
+        glm::vec4            transform = getPositionTransform(boundingSphere);
+        float                inverseScale = transform.w > 0.0f ? 1.0f / transform.w : 0.0f;
+
+        // Interleaved attribute offsets already count the position in front of them
+        for (size_t i = 0; i < vertices.size(); i++) {
+            const Vertex& vertex = vertices[i];
+            uint8_t*      positionDestination = data.data() + i * getPositionStride();
+            uint8_t*      destination = separatePositions ? data.data() + vertices.size() * getPositionStride() +
+                                                           i * getAttributeStride()
+                                                     : positionDestination;
+
+            if (position == PositionFormat::QUANTIZED) {
+                glm::vec3 normalized = (vertex.pos - glm::vec3(transform)) * inverseScale;
+                uint64_t  packed = glm::packUnorm4x16(glm::vec4(glm::clamp(normalized, 0.0f, 1.0f), 0.0f));
+                memcpy(positionDestination, &packed, sizeof(packed));
+            } else {
+                memcpy(positionDestination, &vertex.pos, sizeof(vertex.pos));
+            }
+            if (color) {
+                uint32_t packed = glm::packUnorm4x8(glm::vec4(glm::clamp(vertex.color, 0.0f, 1.0f), 1.0f));
+                memcpy(destination + getColorOffset(), &packed, sizeof(packed));
+            }
+            uint32_t normal = glm::packSnorm2x16(encodeOctahedral(vertex.normal));
+            uint32_t uv = glm::packHalf2x16(vertex.uv);
+            memcpy(destination + getNormalOffset(), &normal, sizeof(normal));
+            memcpy(destination + getUvOffset(), &uv, sizeof(uv));
+        }
+        return data;
+    }
+
+    std::vector<glm::vec3> VertexLayout::unpackPositions(const void* data, size_t vertexCount,
+                                                         const glm::vec4& boundingSphere) const {
+        std::vector<glm::vec3> positions(vertexCount);
+        glm::vec4              transform = getPositionTransform(boundingSphere);
+        const auto*            source = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < vertexCount; i++) {
+            const uint8_t* vertex = source + i * getPositionStride();
+            if (position == PositionFormat::QUANTIZED) {
+                uint64_t packed;
+                memcpy(&packed, vertex, sizeof(packed));
+                positions[i] = glm::vec3(transform) + transform.w * glm::vec3(glm::unpackUnorm4x16(packed));
+            } else {
+                memcpy(&positions[i], vertex, sizeof(glm::vec3));
+            }
+        }
+        return positions;
+    }
+
+    glm::vec2 encodeOctahedral(const glm::vec3& normal) {
+        float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length <= 0.0f) {
+            return glm::vec2(0.0f);
+        }
+        glm::vec3 n = normal / length;
+        if (n.z < 0.0f) {
+            return glm::vec2((1.0f - std::abs(n.y)) * signNotZero(n.x), (1.0f - std::abs(n.x)) * signNotZero(n.y));
+        }
+        return glm::vec2(n.x, n.y);
+    }
+
+    glm::vec3 decodeOctahedral(const glm::vec2& encoded) {
+        glm::vec3 n = glm::vec3(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        if (n.z < 0.0f) {
+            n = glm::vec3((1.0f - std::abs(encoded.y)) * signNotZero(encoded.x),
+                          (1.0f - std::abs(encoded.x)) * signNotZero(encoded.y), n.z);
+        }
+        return glm::normalize(n);
+    }
+}  // namespace Yare::Graphics
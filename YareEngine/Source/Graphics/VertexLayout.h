@@ -0,0 +1,76 @@
+#ifndef YARE_VERTEX_LAYOUT_H
+#define YARE_VERTEX_LAYOUT_H
+
+#include <vector>
+
+#include "Core/DataStructures.h"
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    enum class PositionFormat {
+        // Three 32 bit floats
+        FLOAT,
+        // Four unorm16s spanning the box around the mesh's bounding sphere, the fourth is padding
+        QUANTIZED
+    };
+
+    // How a mesh's vertices are stored on the gpu. Layouts are known at compile time and pipelines generate their
+    // vertex input from them instead of spelling out every attribute. The shader locations are the same in every
+    // layout: position 0, color 1, normal 2 and uv 3. Normals are always octahedral encoded into two snorm16s and
+    // uvs are half floats, only the position's precision, the color and the streams change.
+    //
+    // With separate positions the vertex buffer holds every position first and the other attributes after them.
+    // Positions are read through binding 0 and the rest through binding 1, so depth only passes can bind the
+    // position stream alone and fetch nothing else.
+    struct VertexLayout {
+        PositionFormat position = PositionFormat::QUANTIZED;
+        // The loaders only fill it with a copy of the normal, so most meshes leave it out
+        bool color = false;
+        bool separatePositions = false;
+
+        constexpr uint32_t getPositionSize() const { return position == PositionFormat::QUANTIZED ? 8 : 12; }
+        // Offsets within the stream the attribute lives in
+        constexpr uint32_t getColorOffset() const { return separatePositions ? 0 : getPositionSize(); }
+        constexpr uint32_t getNormalOffset() const { return getColorOffset() + (color ? 4 : 0); }
+        constexpr uint32_t getUvOffset() const { return getNormalOffset() + 4; }
+        // Bytes of a single vertex over all streams
+        constexpr uint32_t getStride() const { return getPositionSize() + (color ? 4 : 0) + 8; }
+        constexpr uint32_t getPositionStride() const { return separatePositions ? getPositionSize() : getStride(); }
+        constexpr uint32_t getAttributeStride() const {
+            return separatePositions ? getStride() - getPositionSize() : getStride();
+        }
+
+        constexpr bool operator==(const VertexLayout& other) const {
+            return position == other.position && color == other.color &&
+                   separatePositions == other.separatePositions;
+        }
+        constexpr bool operator!=(const VertexLayout& other) const { return !(*this == other); }
+
+        std::vector<VkVertexInputBindingDescription>   getBindingDescriptions() const;
+        std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() const;
+        // Binding 0 and location 0 alone, for passes that only need depth
+        std::vector<VkVertexInputBindingDescription>   getPositionBindingDescriptions() const;
+        std::vector<VkVertexInputAttributeDescription> getPositionAttributeDescriptions() const;
+
+        // What turns a stored position back into an object space one: xyz + w * stored. Float positions are
+        // stored as they are.
+        glm::vec4 getPositionTransform(const glm::vec4& boundingSphere) const;
+
+        // Both streams in one block, positions first when they are separate
+        std::vector<uint8_t>   pack(const std::vector<Vertex>& vertices, const glm::vec4& boundingSphere) const;
+        std::vector<glm::vec3> unpackPositions(const void* data, size_t vertexCount,
+                                               const glm::vec4& boundingSphere) const;
+    };
+
+    // 16 bytes instead of the 44 of a Vertex, for everything drawn lit and textured. Depth only passes read 8 of them.
+    constexpr VertexLayout COMPACT_VERTEX_LAYOUT = {PositionFormat::QUANTIZED, false, true};
+    // 24 bytes, for meshes that need exact positions or their color, like the skybox whose positions are directions
+    constexpr VertexLayout PRECISE_VERTEX_LAYOUT = {PositionFormat::FLOAT, true, false};
+
+    // Maps a unit vector onto the [-1, 1] square, the lower half folded over the corners
+    glm::vec2 encodeOctahedral(const glm::vec3& normal);
+    glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+}  // namespace Yare::Graphics
+
+#endif  // YARE_VERTEX_LAYOUT_H
@@ -1,6 +1,7 @@
 #include "Graphics/Vulkan/Buffer.h"
 
 #include "Graphics/Vulkan/Devices.h"
+#include "Graphics/Vulkan/Utilities.h"
 #include "Utilities/Logger.h"
 
 namespace Yare::Graphics {
@@ -9,11 +10,23 @@ namespace Yare::Graphics {
     Buffer::Buffer(BufferUsage usage, size_t size, const void* data) { init(usage, size, data); }
 
     Buffer::~Buffer() {
-        if (m_Buffer) {
-            vkDestroyBuffer(Devices::instance()->getDevice(), m_Buffer, nullptr);
+        VkBuffer       buffer = m_Buffer;
+        VkDeviceMemory bufferMemory = m_BufferMemory;
+        if (!buffer && !bufferMemory) {
+            return;
         }
-        if (m_BufferMemory) {
-            vkFreeMemory(Devices::instance()->getDevice(), m_BufferMemory, nullptr);
+
+        auto destroy = [buffer, bufferMemory]() {
+            if (buffer) {
+                vkDestroyBuffer(Devices::instance()->getDevice(), buffer, nullptr);
+            }
+            if (bufferMemory) {
+                vkFreeMemory(Devices::instance()->getDevice(), bufferMemory, nullptr);
+            }
+        };
+        // A staging buffer may still be read by the upload batch being recorded, it goes once that completed
+        if (!VkUtil::deferUntilUploaded(destroy)) {
+            destroy();
         }
     }
 
@@ -52,6 +65,24 @@ namespace Yare::Graphics {
                 usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
                 propFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
                 break;
+            case BufferUsage::STORAGE:
+                usageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                             VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                propFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+                break;
+            case BufferUsage::GPU_STORAGE:
+                usageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                propFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                break;
+            case BufferUsage::INDIRECT:
+                usageFlags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                             VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                propFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                break;
+            case BufferUsage::PREDICATE:
+                usageFlags = VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                propFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                break;
         }
 
         createBuffer(usageFlags, propFlags);
@@ -62,9 +93,8 @@ namespace Yare::Graphics {
     }
 
     void Buffer::setData(size_t size, const void* data, uint64_t offset) {
-        if (mapMemory(size, 0)) {
-            auto p = static_cast<char*>(m_MappedData) + offset;
-            memcpy((void*)p, data, size);
+        if (mapMemory(size, offset)) {
+            memcpy(m_MappedData, data, size);
             unmapMemory();
         } else {
             YZ_ERROR("Mapping failed - Not copying data to buffer");
@@ -91,11 +121,10 @@ namespace Yare::Graphics {
         }
     }
 
-    void Buffer::bindVertex(CommandBuffer* commandBuffer, VkDeviceSize offset) {
+    void Buffer::bindVertex(CommandBuffer* commandBuffer, VkDeviceSize offset, uint32_t binding) {
         // check that the vertex buffer bit was set inside the usageFlags before binding
         if (m_Usage == BufferUsage::VERTEX || m_Usage == BufferUsage::DYNAMIC_VERTEX) {
-            VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), 0, 1, &m_Buffer, &offset);
+            vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), binding, 1, &m_Buffer, &offset);
         } else {
             YZ_WARN("Buffer was not of type Vertex. Did you intend to bind in this way?");
         }
@@ -132,6 +161,19 @@ namespace Yare::Graphics {
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        // Storage buffers may be written on the async compute queue and read on the graphics queue, sharing them
+        // concurrently saves us from doing queue family ownership transfers every frame
+        uint32_t queueFamilies[2] = {};
+        if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) && Devices::instance()->hasAsyncCompute()) {
+            auto indices = Devices::instance()->getQueueFamilyIndicies();
+            queueFamilies[0] = static_cast<uint32_t>(indices.graphicsFamily);
+            queueFamilies[1] = static_cast<uint32_t>(indices.computeFamily);
+
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = queueFamilies;
+        }
+
         auto res = vkCreateBuffer(Devices::instance()->getDevice(), &bufferInfo, nullptr, &m_Buffer);
         if (res != VK_SUCCESS) {
             YZ_CRITICAL("Vulkan was unable to create a buffer.");
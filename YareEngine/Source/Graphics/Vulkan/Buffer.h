@@ -7,7 +7,22 @@
 
 namespace Yare::Graphics {
 
-    enum class BufferUsage { UNIFORM, DYNAMIC, VERTEX, DYNAMIC_VERTEX, INDEX, DYNAMIC_INDEX, TRANSFER };
+    // STORAGE buffers are written by the cpu and read by shaders, GPU_STORAGE buffers are only ever written by shaders.
+    // INDIRECT buffers are written by shaders and consumed by indirect draws and dispatches. PREDICATE buffers are
+    // written by transfers and read by conditional rendering
+    enum class BufferUsage {
+        UNIFORM,
+        DYNAMIC,
+        VERTEX,
+        DYNAMIC_VERTEX,
+        INDEX,
+        DYNAMIC_INDEX,
+        TRANSFER,
+        STORAGE,
+        GPU_STORAGE,
+        INDIRECT,
+        PREDICATE
+    };
 
     class Buffer {
        public:
@@ -19,7 +34,7 @@ namespace Yare::Graphics {
         void setData(size_t size, const void* data, uint64_t offset = 0);
         void setDynamicData(size_t size, const void* data, uint64_t offset = 0);
         void bindIndex(CommandBuffer* commandBuffer, VkIndexType type);
-        void bindVertex(CommandBuffer* commandBuffer, VkDeviceSize offset);
+        void bindVertex(CommandBuffer* commandBuffer, VkDeviceSize offset, uint32_t binding = 0);
         void flush(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
         bool mapMemory(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
         void unmapMemory();
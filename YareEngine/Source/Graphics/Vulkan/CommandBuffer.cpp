@@ -6,22 +6,25 @@
 
 namespace Yare::Graphics {
 
-    CommandBuffer::CommandBuffer() { init(); }
+    CommandBuffer::CommandBuffer() : m_CommandPool(VulkanContext::getContext()->getCommandPool()) { init(); }
+
+    CommandBuffer::CommandBuffer(const std::shared_ptr<CommandPool>& commandPool) : m_CommandPool(commandPool) {
+        init();
+    }
 
     CommandBuffer::~CommandBuffer() {
         if (m_Fence) {
             vkDestroyFence(Devices::instance()->getDevice(), m_Fence, nullptr);
         }
         if (m_CommandBuffer) {
-            vkFreeCommandBuffers(Devices::instance()->getDevice(),
-                                 VulkanContext::getContext()->getCommandPool()->getPool(), 1, &m_CommandBuffer);
+            vkFreeCommandBuffers(Devices::instance()->getDevice(), m_CommandPool->getPool(), 1, &m_CommandBuffer);
         }
     }
 
     void CommandBuffer::init() {
         VkCommandBufferAllocateInfo allocInfo = {};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = VulkanContext::getContext()->getCommandPool()->getPool();
+        allocInfo.commandPool = m_CommandPool->getPool();
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandBufferCount = 1;
 
@@ -58,4 +61,63 @@ namespace Yare::Graphics {
             YZ_CRITICAL("Vulkan failed to end recording command buffer.");
         }
     }
+
+    void CommandBuffer::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const {
+        vkCmdDispatch(m_CommandBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void CommandBuffer::dispatchIndirect(VkBuffer buffer, VkDeviceSize offset) const {
+        vkCmdDispatchIndirect(m_CommandBuffer, buffer, offset);
+    }
+
+    void CommandBuffer::drawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount,
+                                            uint32_t stride) const {
+        vkCmdDrawIndexedIndirect(m_CommandBuffer, buffer, offset, drawCount, stride);
+    }
+
+    void CommandBuffer::drawIndexedIndirectCount(VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer,
+                                                 VkDeviceSize countOffset, uint32_t maxDrawCount,
+                                                 uint32_t stride) const {
+        Devices::instance()->getDrawIndexedIndirectCount()(m_CommandBuffer, buffer, offset, countBuffer, countOffset,
+                                                           maxDrawCount, stride);
+    }
+
+    void CommandBuffer::beginConditionalRendering(VkBuffer buffer, VkDeviceSize offset) const {
+        VkConditionalRenderingBeginInfoEXT beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+        beginInfo.buffer = buffer;
+        beginInfo.offset = offset;
+        Devices::instance()->getBeginConditionalRendering()(m_CommandBuffer, &beginInfo);
+    }
+
+    void CommandBuffer::endConditionalRendering() const {
+        Devices::instance()->getEndConditionalRendering()(m_CommandBuffer);
+    }
+
+    void CommandBuffer::memoryBarrier(VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                                      VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) const {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+
+        vkCmdPipelineBarrier(m_CommandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void CommandBuffer::imageBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                     VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                                     VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) const {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+
+        vkCmdPipelineBarrier(m_CommandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
 }  // namespace Yare::Graphics
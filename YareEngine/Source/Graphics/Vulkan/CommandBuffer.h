@@ -7,19 +7,46 @@
 namespace Yare::Graphics {
     class CommandBuffer {
        public:
+        // Allocates from the contexts graphics command pool
         CommandBuffer();
+        CommandBuffer(const std::shared_ptr<CommandPool>& commandPool);
         ~CommandBuffer();
 
         void beginRecording();
         void endRecording();
 
+        // Compute helpers, the compute pipeline and its descriptor sets have to be bound first
+        void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const;
+        void dispatchIndirect(VkBuffer buffer, VkDeviceSize offset = 0) const;
+        // Indirect draws, drawIndexedIndirectCount needs Devices::hasDrawIndirectCount
+        void drawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride) const;
+        void drawIndexedIndirectCount(VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer,
+                                      VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride) const;
+        // Draws between the two are skipped when the 32 bit value at offset is zero, needs
+        // Devices::hasConditionalRendering
+        void beginConditionalRendering(VkBuffer buffer, VkDeviceSize offset) const;
+        void endConditionalRendering() const;
+        // Makes the writes from the source stages visible to the reads of the destination stages
+        void memoryBarrier(VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                           VkAccessFlags dstAccess) const;
+        // Same as memoryBarrier but also moves every mip level and layer of a color image to a new layout
+        void imageBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                          VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                          VkAccessFlags dstAccess) const;
+
+        // Number of workgroups needed to cover count invocations
+        static uint32_t getGroupCount(uint32_t count, uint32_t groupSize) {
+            return (count + groupSize - 1) / groupSize;
+        }
+
         const VkCommandBuffer& getCommandBuffer() const { return m_CommandBuffer; }
         const VkFence&         getFence() const { return m_Fence; }
 
        private:
-        void            init();
-        VkCommandBuffer m_CommandBuffer;
-        VkFence         m_Fence = VK_NULL_HANDLE;
+        void                         init();
+        std::shared_ptr<CommandPool> m_CommandPool;
+        VkCommandBuffer              m_CommandBuffer;
+        VkFence                      m_Fence = VK_NULL_HANDLE;
     };
 }  // namespace Yare::Graphics
 
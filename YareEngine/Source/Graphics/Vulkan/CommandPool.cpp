@@ -5,7 +5,11 @@
 
 namespace Yare::Graphics {
 
-    CommandPool::CommandPool() { init(); }
+    CommandPool::CommandPool() : m_QueueFamilyIndex(Devices::instance()->getQueueFamilyIndicies().graphicsFamily) {
+        init();
+    }
+
+    CommandPool::CommandPool(int queueFamilyIndex) : m_QueueFamilyIndex(queueFamilyIndex) { init(); }
 
     CommandPool::~CommandPool() {
         if (m_CommandPool) {
@@ -14,11 +18,9 @@ namespace Yare::Graphics {
     }
 
     void CommandPool::init() {
-        Graphics::QueueFamilyIndices queueFamilyIndices = Devices::instance()->getQueueFamilyIndicies();
-
         VkCommandPoolCreateInfo poolInfo = {};
         poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
+        poolInfo.queueFamilyIndex = m_QueueFamilyIndex;
         poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;  // Optional
 
         auto res = vkCreateCommandPool(Devices::instance()->getDevice(), &poolInfo, nullptr, &m_CommandPool);
@@ -7,13 +7,16 @@ namespace Yare::Graphics {
     class CommandPool {
        public:
         CommandPool();
+        CommandPool(int queueFamilyIndex);
         ~CommandPool();
 
         void                 init();
         const VkCommandPool& getPool() const { return m_CommandPool; }
+        int                  getQueueFamilyIndex() const { return m_QueueFamilyIndex; }
 
        private:
         VkCommandPool m_CommandPool;
+        int           m_QueueFamilyIndex;
     };
 }  // namespace Yare::Graphics
 #endif  // YARE_COMMANDPOOL_H
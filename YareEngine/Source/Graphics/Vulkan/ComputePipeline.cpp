@@ -0,0 +1,83 @@
+#include "Graphics/Vulkan/ComputePipeline.h"
+
+#include <chrono>
+
+#include "Graphics/Vulkan/Context.h"
+#include "Graphics/Vulkan/Devices.h"
+#include "Graphics/Vulkan/Pipeline.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    ComputePipeline::ComputePipeline() {}
+
+    ComputePipeline::~ComputePipeline() {
+        for (auto layout : m_DescriptorSetLayouts) {
+            VulkanContext::getContext()->getResourceCache()->releaseDescriptorSetLayout(layout);
+        }
+        if (m_PipelineLayout) {
+            vkDestroyPipelineLayout(Devices::instance()->getDevice(), m_PipelineLayout, nullptr);
+        }
+        if (m_ComputePipeline) {
+            vkDestroyPipeline(Devices::instance()->getDevice(), m_ComputePipeline, nullptr);
+        }
+    }
+
+    void ComputePipeline::init(ComputePipelineInfo& pipelineInfo) {
+        m_PipelineInfo = pipelineInfo;
+        createDescriptorSetLayouts();
+        createComputePipeline();
+    }
+
+    void ComputePipeline::setActive(const CommandBuffer& commandBuffer) {
+        vkCmdBindPipeline(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipeline);
+    }
+
+    void ComputePipeline::createDescriptorSetLayouts() {
+        m_DescriptorSetLayouts.clear();
+        for (const auto& bindings : m_PipelineInfo.setLayoutBindings) {
+            VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+            layoutInfo.pBindings = bindings.data();
+
+            m_DescriptorSetLayouts.push_back(
+                VulkanContext::getContext()->getResourceCache()->acquireDescriptorSetLayout(layoutInfo));
+        }
+    }
+
+    void ComputePipeline::createComputePipeline() {
+        if (m_PipelineInfo.shader->getStageCount() != 1 ||
+            m_PipelineInfo.shader->getShaderStages()[0].stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+            YZ_CRITICAL("A compute pipeline needs a shader with exactly one compute stage.");
+        }
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(m_DescriptorSetLayouts.size());
+        pipelineLayoutInfo.pSetLayouts = m_DescriptorSetLayouts.data();
+        pipelineLayoutInfo.pPushConstantRanges = &m_PipelineInfo.pushConstants;
+        pipelineLayoutInfo.pushConstantRangeCount = m_PipelineInfo.pushConstants.size > 0 ? 1 : 0;
+
+        auto res =
+            vkCreatePipelineLayout(Devices::instance()->getDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout);
+        if (res != VK_SUCCESS) {
+            YZ_CRITICAL("Vulkan Pipeline Layout was unable to be created.");
+        }
+
+        VkComputePipelineCreateInfo pipelineCreateInfo = {};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = m_PipelineInfo.shader->getShaderStages()[0];
+        pipelineCreateInfo.layout = m_PipelineLayout;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+        auto start = std::chrono::steady_clock::now();
+        res = vkCreateComputePipelines(Devices::instance()->getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo,
+                                       nullptr, &m_ComputePipeline);
+        Pipeline::addBuildTime(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        if (res != VK_SUCCESS) {
+            YZ_CRITICAL("Vulkan failed to create a compute pipeline.");
+        }
+    }
+}  // namespace Yare::Graphics
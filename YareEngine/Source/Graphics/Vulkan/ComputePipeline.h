@@ -0,0 +1,45 @@
+#ifndef YARE_COMPUTE_PIPELINE_H
+#define YARE_COMPUTE_PIPELINE_H
+
+#include "Graphics/Vulkan/CommandBuffer.h"
+#include "Graphics/Vulkan/Shader.h"
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    struct ComputePipelineInfo {
+        // Must contain a single //SHADER:COMPUTE stage
+        Shader*                                                shader;
+        // Bindings for each descriptor set, indexed by set number
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> setLayoutBindings;
+        VkPushConstantRange                                    pushConstants = {};
+    };
+
+    class ComputePipeline {
+       public:
+        ComputePipeline();
+        ~ComputePipeline();
+        void init(ComputePipelineInfo& pipelineInfo);
+        void setActive(const CommandBuffer& commandBuffer);
+
+        const VkPipelineLayout&      getPipelineLayout() const { return m_PipelineLayout; }
+        const VkPipeline&            getPipeline() const { return m_ComputePipeline; }
+        const VkDescriptorSetLayout& getDescriptorSetLayout(uint32_t set = 0) const {
+            return m_DescriptorSetLayouts[set];
+        }
+
+       private:
+        void createDescriptorSetLayouts();
+        void createComputePipeline();
+
+       private:
+        ComputePipelineInfo m_PipelineInfo;
+
+        // Layouts are owned by the contexts resource cache and shared between pipelines
+        std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
+        VkPipelineLayout                   m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline                         m_ComputePipeline = VK_NULL_HANDLE;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_COMPUTE_PIPELINE_H
@@ -45,8 +45,18 @@ namespace Yare::Graphics {
     VulkanContext::~VulkanContext() {
         m_ImageAvailableSemaphores.clear();
         m_RenderFinishedSemaphores.clear();
+        m_ComputeFinishedSemaphores.clear();
+
+        m_FrameDescriptorAllocators.clear();
+        m_DescriptorAllocator.reset();
+
+        // Run everything that is still waiting to be retired before the cache destroys what has leaked
+        m_RetirementQueue->flush();
+        m_ResourceCache.reset();
+        m_RetirementQueue.reset();
 
         m_Swapchain.reset();
+        m_ComputeCommandPool.reset();
         m_CommandPool.reset();
 
         Devices::release();
@@ -71,6 +81,18 @@ namespace Yare::Graphics {
         m_Devices->init(m_Instance);
 
         m_CommandPool = std::make_shared<CommandPool>();
+        if (m_Devices->hasAsyncCompute()) {
+            m_ComputeCommandPool = std::make_shared<CommandPool>(m_Devices->getQueueFamilyIndicies().computeFamily);
+        } else {
+            m_ComputeCommandPool = m_CommandPool;
+        }
+
+        m_RetirementQueue = std::make_unique<RetirementQueue>(MAX_FRAMES_IN_FLIGHT);
+        m_ResourceCache = std::make_unique<ResourceCache>();
+        m_DescriptorAllocator = std::make_unique<DescriptorAllocator>();
+        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            m_FrameDescriptorAllocators.push_back(std::make_unique<DescriptorAllocator>());
+        }
 
         // Create a swapchain, a swapchain is responsible for maintaining the images
         // that will be presented to the user.
@@ -78,6 +100,7 @@ namespace Yare::Graphics {
 
         m_ImageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
         m_RenderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+        m_ComputeFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
     }
 
     void VulkanContext::onResize(size_t width, size_t height) {
@@ -86,6 +109,11 @@ namespace Yare::Graphics {
     }
 
     bool VulkanContext::begin() {
+        // The previous submission using this frame slot has finished, so its transient sets can be recycled and
+        // anything retired during it can finally be destroyed
+        m_FrameDescriptorAllocators[m_CurrentFrame]->reset();
+        m_RetirementQueue->beginFrame(static_cast<uint32_t>(m_CurrentFrame));
+
         auto result = m_Swapchain->acquireNextImage(m_ImageAvailableSemaphores[m_CurrentFrame].getSemaphore());
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
@@ -111,18 +139,49 @@ namespace Yare::Graphics {
         return true;
     }
 
+    void VulkanContext::submitCompute(CommandBuffer* cmdBuffer) {
+        auto currentSignalSemaphore = m_ComputeFinishedSemaphores[m_CurrentFrame].getSemaphore();
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmdBuffer->getCommandBuffer();
+        submitInfo.pSignalSemaphores = &currentSignalSemaphore;
+        submitInfo.signalSemaphoreCount = 1;
+
+        // No fence, the graphics submission waits on the semaphore and we wait on its fence, so by the time this
+        // command buffer is recorded again the compute work has long finished
+        if (vkQueueSubmit(m_Devices->getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            YZ_ERROR("Vulkan failed to submit to the compute queue.");
+            return;
+        }
+        m_ComputeSubmitted = true;
+    }
+
     void VulkanContext::submitGfxQueue(CommandBuffer* cmdBuffer, bool waitFence) {
-        auto currentWaitSemaphore = m_ImageAvailableSemaphores[m_CurrentFrame].getSemaphore();
         auto currentSignalSemaphore = m_RenderFinishedSemaphores[m_CurrentFrame].getSemaphore();
 
+        std::vector<VkSemaphore>          waitSemaphores = {m_ImageAvailableSemaphores[m_CurrentFrame].getSemaphore()};
+        std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+
+        // Anything the compute queue produced this frame is consumed by indirect draws and vertex shaders. The depth
+        // pyramid and late cull dispatches on this queue read the transformed models and write the visibility the
+        // early cull reads, so compute and transfer wait for it too.
+        if (m_ComputeSubmitted) {
+            waitSemaphores.push_back(m_ComputeFinishedSemaphores[m_CurrentFrame].getSemaphore());
+            waitStages.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                 VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
+            m_ComputeSubmitted = false;
+        }
+
         VkSubmitInfo submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &cmdBuffer->getCommandBuffer();
-        VkPipelineStageFlags flags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        submitInfo.pWaitDstStageMask = &flags;
-        submitInfo.pWaitSemaphores = &currentWaitSemaphore;
-        submitInfo.waitSemaphoreCount = (uint32_t)(currentWaitSemaphore ? 1 : 0);
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
         submitInfo.pSignalSemaphores = &currentSignalSemaphore;
         submitInfo.signalSemaphoreCount = (uint32_t)(currentSignalSemaphore ? 1 : 0);
         submitInfo.pNext = VK_NULL_HANDLE;
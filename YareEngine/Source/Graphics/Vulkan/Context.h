@@ -3,7 +3,10 @@
 
 #include "Graphics/Vulkan/CommandBuffer.h"
 #include "Graphics/Vulkan/CommandPool.h"
+#include "Graphics/Vulkan/DescriptorAllocator.h"
 #include "Graphics/Vulkan/Devices.h"
+#include "Graphics/Vulkan/ResourceCache.h"
+#include "Graphics/Vulkan/RetirementQueue.h"
 #include "Graphics/Vulkan/Semaphore.h"
 #include "Graphics/Vulkan/Swapchain.h"
 #include "Graphics/Vulkan/Vk.h"
@@ -18,12 +21,22 @@ namespace Yare::Graphics {
         void onResize(size_t width, size_t height);
         bool begin();
         bool present(CommandBuffer* cmdBuffer);
+        // Submits compute work for this frame to the async compute queue, the next graphics submission waits on it
+        void submitCompute(CommandBuffer* cmdBuffer);
 
         const std::shared_ptr<Swapchain>&   getSwapchain() const { return m_Swapchain; }
         const std::shared_ptr<CommandPool>& getCommandPool() const { return m_CommandPool; }
+        const std::shared_ptr<CommandPool>& getComputeCommandPool() const { return m_ComputeCommandPool; }
         const VkInstance&                   getInstance() const { return m_Instance; }
         const static VulkanContext*         getContext() { return s_Context; }
 
+        // clang-format off
+        DescriptorAllocator*   getDescriptorAllocator()      const { return m_DescriptorAllocator.get(); }
+        DescriptorAllocator*   getFrameDescriptorAllocator() const { return m_FrameDescriptorAllocators[m_CurrentFrame].get(); }
+        ResourceCache*         getResourceCache()            const { return m_ResourceCache.get(); }
+        RetirementQueue*       getRetirementQueue()          const { return m_RetirementQueue.get(); }
+        // clang-format on
+
        private:
         void                     init(size_t width, size_t height);
         void                     createInstance();
@@ -41,10 +54,22 @@ namespace Yare::Graphics {
         static VulkanContext*        s_Context;
         Devices*                     m_Devices;
         std::shared_ptr<CommandPool> m_CommandPool;
+        // Same as the graphics pool unless the device has an async compute queue
+        std::shared_ptr<CommandPool> m_ComputeCommandPool;
         std::shared_ptr<Swapchain>   m_Swapchain;
 
+        // Persistent sets live for as long as their owner, transient sets are reset at the start of each frame
+        std::unique_ptr<DescriptorAllocator>              m_DescriptorAllocator;
+        std::vector<std::unique_ptr<DescriptorAllocator>> m_FrameDescriptorAllocators;
+
+        // Shared vulkan objects, anything released from the cache is destroyed through the retirement queue
+        std::unique_ptr<ResourceCache>   m_ResourceCache;
+        std::unique_ptr<RetirementQueue> m_RetirementQueue;
+
         std::vector<Semaphore> m_ImageAvailableSemaphores;
         std::vector<Semaphore> m_RenderFinishedSemaphores;
+        std::vector<Semaphore> m_ComputeFinishedSemaphores;
+        bool                   m_ComputeSubmitted = false;
         size_t                 m_CurrentFrame = 0;
 
         const std::vector<const char*> validationLayers = {"VK_LAYER_KHRONOS_validation"};
@@ -0,0 +1,108 @@
+#include "Graphics/Vulkan/DescriptorAllocator.h"
+
+#include <algorithm>
+
+#include "Graphics/Vulkan/Devices.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    // Number of descriptors of each type reserved per set in a pool. The combined image sampler ratio is large because
+    // the forward renderer binds its textures as one big sampler array.
+    static const std::pair<VkDescriptorType, float> s_PoolRatios[] = {
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 0.5f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 0.5f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
+        {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f},
+    };
+
+    // Pools grow each time we run out, up until this many sets per pool
+    static const uint32_t s_MaxSetsPerPool = 4096;
+
+    DescriptorAllocator::DescriptorAllocator(uint32_t setsPerPool) : m_SetsPerPool(setsPerPool) {}
+
+    DescriptorAllocator::~DescriptorAllocator() {
+        for (auto pool : m_UsedPools) {
+            vkDestroyDescriptorPool(Devices::instance()->getDevice(), pool, nullptr);
+        }
+        for (auto pool : m_FreePools) {
+            vkDestroyDescriptorPool(Devices::instance()->getDevice(), pool, nullptr);
+        }
+    }
+
+    VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+        if (!m_CurrentPool) {
+            m_CurrentPool = grabPool();
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_CurrentPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        auto            res = vkAllocateDescriptorSets(Devices::instance()->getDevice(), &allocInfo, &set);
+
+        // The current pool is full, move onto a new one and try again
+        if (res == VK_ERROR_FRAGMENTED_POOL || res == VK_ERROR_OUT_OF_POOL_MEMORY) {
+            m_CurrentPool = grabPool();
+            allocInfo.descriptorPool = m_CurrentPool;
+            res = vkAllocateDescriptorSets(Devices::instance()->getDevice(), &allocInfo, &set);
+        }
+
+        if (res != VK_SUCCESS) {
+            YZ_CRITICAL("Vulkan was unable to allocate a descriptor set.");
+        }
+        return set;
+    }
+
+    void DescriptorAllocator::reset() {
+        for (auto pool : m_UsedPools) {
+            vkResetDescriptorPool(Devices::instance()->getDevice(), pool, 0);
+            m_FreePools.push_back(pool);
+        }
+        m_UsedPools.clear();
+        m_CurrentPool = VK_NULL_HANDLE;
+    }
+
+    VkDescriptorPool DescriptorAllocator::grabPool() {
+        VkDescriptorPool pool;
+        if (!m_FreePools.empty()) {
+            pool = m_FreePools.back();
+            m_FreePools.pop_back();
+        } else {
+            pool = createPool(m_SetsPerPool);
+            m_SetsPerPool = std::min(m_SetsPerPool * 2, s_MaxSetsPerPool);
+        }
+        m_UsedPools.push_back(pool);
+        return pool;
+    }
+
+    VkDescriptorPool DescriptorAllocator::createPool(uint32_t maxSets) {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        for (const auto& ratio : s_PoolRatios) {
+            poolSizes.push_back({ratio.first, std::max(1u, static_cast<uint32_t>(ratio.second * maxSets))});
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.maxSets = maxSets;
+
+        VkDescriptorPool pool;
+        auto             res = vkCreateDescriptorPool(Devices::instance()->getDevice(), &poolInfo, nullptr, &pool);
+        if (res != VK_SUCCESS) {
+            YZ_CRITICAL("Vulkan creation of descriptor pool failed.");
+        }
+        return pool;
+    }
+}  // namespace Yare::Graphics
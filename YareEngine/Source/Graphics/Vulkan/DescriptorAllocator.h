@@ -0,0 +1,39 @@
+#ifndef YARE_DESCRIPTOR_ALLOCATOR_H
+#define YARE_DESCRIPTOR_ALLOCATOR_H
+
+#include <vector>
+
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    // Descriptor sets are split by how often their contents change, this way a draw only has to
+    // rebind the sets that actually changed since the previous draw.
+    enum DescriptorSetFrequency : uint32_t {
+        PER_FRAME = 0,     // view/projection and anything else that is constant for the frame
+        PER_MATERIAL = 1,  // per pass or per material data such as textures
+        PER_DRAW = 2,      // per object data, usually a dynamic offset into a shared buffer
+    };
+
+    class DescriptorAllocator {
+       public:
+        DescriptorAllocator(uint32_t setsPerPool = 128);
+        ~DescriptorAllocator();
+
+        // Allocate a set from the current pool, a new pool is grabbed if the current one is exhausted
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+        // Resets every pool, all sets allocated from this allocator become invalid
+        void reset();
+
+       private:
+        VkDescriptorPool grabPool();
+        VkDescriptorPool createPool(uint32_t maxSets);
+
+        uint32_t                      m_SetsPerPool;
+        VkDescriptorPool              m_CurrentPool = VK_NULL_HANDLE;
+        std::vector<VkDescriptorPool> m_UsedPools;
+        std::vector<VkDescriptorPool> m_FreePools;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_DESCRIPTOR_ALLOCATOR_H
@@ -1,26 +1,50 @@
 #include "Graphics/Vulkan/DescriptorSet.h"
 
+#include <algorithm>
+
+#include "Graphics/Vulkan/Context.h"
 #include "Graphics/Vulkan/Devices.h"
 #include "Utilities/Logger.h"
 
 namespace Yare::Graphics {
 
+    DescriptorUpdateTemplate::DescriptorUpdateTemplate(VkDescriptorSetLayout                               layout,
+                                                       const std::vector<VkDescriptorUpdateTemplateEntry>& entries) {
+        VkDescriptorUpdateTemplateCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        createInfo.pDescriptorUpdateEntries = entries.data();
+        createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        createInfo.descriptorSetLayout = layout;
+
+        auto res =
+            vkCreateDescriptorUpdateTemplate(Devices::instance()->getDevice(), &createInfo, nullptr, &m_Template);
+        if (res != VK_SUCCESS) {
+            YZ_CRITICAL("Vulkan was unable to create a descriptor update template.");
+        }
+    }
+
+    DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+        if (m_Template) {
+            vkDestroyDescriptorUpdateTemplate(Devices::instance()->getDevice(), m_Template, nullptr);
+        }
+    }
+
     DescriptorSet::DescriptorSet() {}
 
     DescriptorSet::~DescriptorSet() {}
 
     void DescriptorSet::init(const DescriptorSetInfo& descriptorSetInfo) {
-        VkDescriptorSetAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = descriptorSetInfo.pipeline->getDescriptorPool();
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSetInfo.descriptorSetCount);
-        allocInfo.pSetLayouts = &descriptorSetInfo.pipeline->getDescriptorSetLayout();
-
-        // This wont need to be cleaned up because it is auto cleaned up when the pool is destroyed
-        auto res = vkAllocateDescriptorSets(Devices::instance()->getDevice(), &allocInfo, &m_DescriptorSets);
-        if (res != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan was unable to allocate descriptor sets.");
+        auto allocator = descriptorSetInfo.transient ? VulkanContext::getContext()->getFrameDescriptorAllocator()
+                                                     : VulkanContext::getContext()->getDescriptorAllocator();
+
+        auto layout = descriptorSetInfo.layout;
+        if (!layout) {
+            layout = descriptorSetInfo.pipeline->getDescriptorSetLayout(descriptorSetInfo.setIndex);
         }
+
+        // This wont need to be cleaned up because it is released when the allocator resets or destroys its pools
+        m_DescriptorSets = allocator->allocate(layout);
     }
 
     void DescriptorSet::update(std::vector<BufferInfo>& newBufferInfo) {
@@ -31,28 +55,53 @@ namespace Yare::Graphics {
         std::vector<VkDescriptorBufferInfo> bInfo;
         std::vector<VkDescriptorImageInfo>  imageInfo;
         bInfo.resize(32);
-        imageInfo.resize(std::min(256u, Devices::instance()->getGPUProperties().limits.maxPerStageDescriptorSamplers));
+
+        // Every image write gets its own range of image infos, so a set can hold more than one image binding
+        size_t imageCount = 0;
+        for (const auto& bufferInfo : newBufferInfo) {
+            imageCount += bufferInfo.imageViews.size();
+        }
+        imageInfo.resize(imageCount);
 
         uint32_t bufferIndex = 0;
+        uint32_t imageIndex = 0;
 
         for (const auto& bufferInfo : newBufferInfo) {
-            if (bufferInfo.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-                for (int i = 0; i < bufferInfo.imageViews.size(); ++i) {
-                    imageInfo[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    imageInfo[i].imageView = bufferInfo.imageViews[i];
-                    imageInfo[i].sampler = bufferInfo.imageSamplers[i];
+            if (bufferInfo.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+                bufferInfo.type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+                bufferInfo.type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE) {
+                // Storage images are written by shaders, so they stay in the general layout
+                VkImageLayout layout = bufferInfo.type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                           ? VK_IMAGE_LAYOUT_GENERAL
+                                           : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                if (bufferInfo.imageLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                    layout = bufferInfo.imageLayout;
                 }
-                VkWriteDescriptorSet descriptorWrite = {};
-                descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptorWrite.dstSet = m_DescriptorSets;
-                descriptorWrite.dstBinding = bufferInfo.binding;
-                descriptorWrite.dstArrayElement = 0;
-                descriptorWrite.descriptorType = bufferInfo.type;
-                descriptorWrite.descriptorCount = bufferInfo.descriptorCount;
-                descriptorWrite.pImageInfo = imageInfo.data();
 
-                descriptorWrites.push_back(descriptorWrite);
+                for (size_t i = 0; i < bufferInfo.imageViews.size(); ++i) {
+                    imageInfo[imageIndex + i].imageLayout = layout;
+                    imageInfo[imageIndex + i].imageView = bufferInfo.imageViews[i];
+                    imageInfo[imageIndex + i].sampler =
+                        i < bufferInfo.imageSamplers.size() ? bufferInfo.imageSamplers[i] : VK_NULL_HANDLE;
+                }
+                // Only the elements that were given views are written, the rest of the binding keeps what it had
+                uint32_t writeCount =
+                    (std::min)(bufferInfo.descriptorCount, static_cast<uint32_t>(bufferInfo.imageViews.size()));
+                if (writeCount > 0) {
+                    VkWriteDescriptorSet descriptorWrite = {};
+                    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptorWrite.dstSet = m_DescriptorSets;
+                    descriptorWrite.dstBinding = bufferInfo.binding;
+                    descriptorWrite.dstArrayElement = 0;
+                    descriptorWrite.descriptorType = bufferInfo.type;
+                    descriptorWrite.descriptorCount = writeCount;
+                    descriptorWrite.pImageInfo = &imageInfo[imageIndex];
+
+                    descriptorWrites.push_back(descriptorWrite);
+                }
+                imageIndex += static_cast<uint32_t>(bufferInfo.imageViews.size());
             } else {
+                // Uniform and storage buffers, dynamic or not, all take the same buffer info
                 bInfo[bufferIndex].buffer = bufferInfo.buffer;
                 bInfo[bufferIndex].offset = bufferInfo.offset;
                 bInfo[bufferIndex].range = bufferInfo.size;
@@ -72,4 +121,9 @@ namespace Yare::Graphics {
         vkUpdateDescriptorSets(Devices::instance()->getDevice(), static_cast<uint32_t>(descriptorWrites.size()),
                                descriptorWrites.data(), 0, nullptr);
     }
+
+    void DescriptorSet::update(const DescriptorUpdateTemplate& updateTemplate, const void* data) {
+        vkUpdateDescriptorSetWithTemplate(Devices::instance()->getDevice(), m_DescriptorSets,
+                                          updateTemplate.getTemplate(), data);
+    }
 }  // namespace Yare::Graphics
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "Graphics/Vulkan/DescriptorAllocator.h"
 #include "Graphics/Vulkan/Pipeline.h"
 #include "Graphics/Vulkan/Vk.h"
 
@@ -12,6 +13,12 @@ namespace Yare {
         struct DescriptorSetInfo {
             Pipeline* pipeline;
             size_t    descriptorSetCount;
+            // Which of the pipelines set layouts this set is allocated with, see DescriptorSetFrequency
+            uint32_t setIndex = 0;
+            // Transient sets come from the per frame allocator and are only valid until the next frame
+            bool transient = false;
+            // Used instead of the pipelines layout when set, compute pipelines pass their layouts this way
+            VkDescriptorSetLayout layout = VK_NULL_HANDLE;
         };
 
         struct BufferInfo {
@@ -23,6 +30,22 @@ namespace Yare {
             uint32_t         size;
             int              binding;
             uint32_t         descriptorCount;
+            // Images are expected in the layout their descriptor type implies unless this is set
+            VkImageLayout imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        };
+
+        // An update template lets us write a whole set in one call from a tightly packed struct,
+        // it is used for the sets we rewrite every frame
+        class DescriptorUpdateTemplate {
+           public:
+            DescriptorUpdateTemplate(VkDescriptorSetLayout                               layout,
+                                     const std::vector<VkDescriptorUpdateTemplateEntry>& entries);
+            ~DescriptorUpdateTemplate();
+
+            const VkDescriptorUpdateTemplate& getTemplate() const { return m_Template; }
+
+           private:
+            VkDescriptorUpdateTemplate m_Template = VK_NULL_HANDLE;
         };
 
         class DescriptorSet {
@@ -32,6 +55,7 @@ namespace Yare {
 
             void init(const DescriptorSetInfo& descriptorSetInfo);
             void update(std::vector<BufferInfo>& newBufferInfo);
+            void update(const DescriptorUpdateTemplate& updateTemplate, const void* data);
 
             const VkDescriptorSet& getDescriptorSet(unsigned int index) const { return m_DescriptorSets; }
 
@@ -70,9 +70,11 @@ namespace Yare::Graphics {
 
     void Devices::createLogicalDevice() {
         QueueFamilyIndices indices = findQueueFamilies(m_PhysicalDevice);
+        m_QueueFamilyIndices = indices;
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<int>                        uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+        std::set<int>                        uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily,
+                                                 indices.computeFamily};
 
         float queuePriority = 1.0f;
         for (int queueFamily : uniqueQueueFamilies) {
@@ -84,17 +86,65 @@ namespace Yare::Graphics {
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        // Indirect draws carry the offset into the visible instance list in firstInstance, without it the gpu scene
+        // draws every batch directly over all of its slots
+        deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+        m_DrawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        m_MultiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+        // The depth pyramid is written as rg32f, which isn't one of the core storage image formats
+        deviceFeatures.shaderStorageImageExtendedFormats = supportedFeatures.shaderStorageImageExtendedFormats;
+        m_StorageImageExtendedFormats = supportedFeatures.shaderStorageImageExtendedFormats == VK_TRUE;
+        // The lit pass writes the mip levels it samples to the texture streamer's feedback buffer, without it the
+        // textures are loaded whole
+        deviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics;
+        m_FragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics == VK_TRUE;
+        // Cooked textures are only picked over their sources where the gpu samples block compressed formats
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        m_TextureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
 
         // Required for MacOS
+        bool drawIndirectCount = false;
+        bool conditionalRenderingExtension = false;
         auto availableExtensions = getAvailableDeviceExtensions(m_PhysicalDevice);
         for (auto extension : availableExtensions) {
             if (strcmp(extension.extensionName, "VK_KHR_portability_subset") == 0) m_DeviceExtensions.push_back("VK_KHR_portability_subset");
+            // A gpu side draw count is only useful when one call can issue more than one draw
+            if (m_MultiDrawIndirect &&
+                strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0) {
+                m_DeviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+                drawIndirectCount = true;
+            }
+            if (strcmp(extension.extensionName, VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME) == 0) {
+                conditionalRenderingExtension = true;
+            }
         }
+
+        // Occlusion query results can skip draws on the gpu itself when the extension's feature is there too
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures = {};
+        conditionalRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+        if (conditionalRenderingExtension) {
+            VkPhysicalDeviceFeatures2 supportedFeatures2 = {};
+            supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supportedFeatures2.pNext = &conditionalRenderingFeatures;
+            vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures2);
+            conditionalRenderingFeatures.pNext = nullptr;
+            conditionalRenderingFeatures.inheritedConditionalRendering = VK_FALSE;
+        }
+        bool conditionalRendering = conditionalRenderingFeatures.conditionalRendering == VK_TRUE;
+        if (conditionalRendering) {
+            m_DeviceExtensions.push_back(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME);
+        }
+
         VkDeviceCreateInfo createInfo = {};
 
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = conditionalRendering ? &conditionalRenderingFeatures : nullptr;
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.pEnabledFeatures = &deviceFeatures;
@@ -115,6 +165,24 @@ namespace Yare::Graphics {
 
         vkGetDeviceQueue(m_Device, indices.graphicsFamily, 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_Device, indices.presentFamily, 0, &m_PresentQueue);
+        vkGetDeviceQueue(m_Device, indices.computeFamily, 0, &m_ComputeQueue);
+
+        if (drawIndirectCount) {
+            m_DrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+                vkGetDeviceProcAddr(m_Device, "vkCmdDrawIndexedIndirectCountKHR"));
+        }
+        if (conditionalRendering) {
+            m_BeginConditionalRendering = reinterpret_cast<PFN_vkCmdBeginConditionalRenderingEXT>(
+                vkGetDeviceProcAddr(m_Device, "vkCmdBeginConditionalRenderingEXT"));
+            m_EndConditionalRendering = reinterpret_cast<PFN_vkCmdEndConditionalRenderingEXT>(
+                vkGetDeviceProcAddr(m_Device, "vkCmdEndConditionalRenderingEXT"));
+        }
+
+        // With a separate compute family, compute work can be submitted alongside graphics instead of in front of it
+        m_AsyncCompute = indices.computeFamily != indices.graphicsFamily;
+        if (m_AsyncCompute) {
+            YZ_INFO("Using async compute queue family " + std::to_string(indices.computeFamily));
+        }
     }
 
     bool Devices::isDeviceSuitable(VkPhysicalDevice device) {
@@ -130,7 +198,8 @@ namespace Yare::Graphics {
         VkPhysicalDeviceFeatures supportedFeatures;
         vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
-        return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+        return indices.isComplete() && extensionsSupported && swapChainAdequate &&
+               supportedFeatures.samplerAnisotropy;
     }
 
     std::vector<VkExtensionProperties> Devices::getAvailableDeviceExtensions(VkPhysicalDevice device) {
@@ -178,16 +247,23 @@ namespace Yare::Graphics {
                 indices.graphicsFamily = i;
             }
 
-            if (indices.isComplete()) break;
+            // Prefer a family that can do compute but not graphics, those queues run alongside the graphics queue
+            if (indices.computeFamily < 0 && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+                !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                indices.computeFamily = i;
+            }
 
             i++;
         }
 
+        // Every graphics family also supports compute, so fall back to it when there is no dedicated one
+        if (indices.computeFamily < 0) {
+            indices.computeFamily = indices.graphicsFamily;
+        }
+
         return indices;
     }
 
-    QueueFamilyIndices Devices::getQueueFamilyIndicies() { return findQueueFamilies(m_PhysicalDevice); }
-
     SwapChainSupportDetails Devices::getSwapChainSupport() { return querySwapChainSupport(m_PhysicalDevice); }
 
     SwapChainSupportDetails Devices::querySwapChainSupport(VkPhysicalDevice device) {
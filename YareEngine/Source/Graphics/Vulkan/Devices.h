@@ -11,6 +11,8 @@ namespace Yare::Graphics {
     struct QueueFamilyIndices {
         int graphicsFamily = -1;
         int presentFamily = -1;
+        // A compute only family when the gpu has one, otherwise the graphics family
+        int computeFamily = -1;
 
         bool isComplete() { return graphicsFamily >= 0 && presentFamily >= 0; }
     };
@@ -34,9 +36,26 @@ namespace Yare::Graphics {
         const VkPhysicalDevice&           getGPU() const { return m_PhysicalDevice; }
         const VkQueue&                    getGraphicsQueue() const { return m_GraphicsQueue; }
         const VkQueue&                    getPresentQueue() const { return m_PresentQueue; }
+        const VkQueue&                    getComputeQueue() const { return m_ComputeQueue; }
+        bool                              hasAsyncCompute() const { return m_AsyncCompute; }
+        bool                              hasMultiDrawIndirect() const { return m_MultiDrawIndirect; }
+        bool                              hasDrawIndirectCount() const { return m_DrawIndexedIndirectCount != nullptr; }
+        bool hasDrawIndirectFirstInstance() const { return m_DrawIndirectFirstInstance; }
+        bool hasStorageImageExtendedFormats() const { return m_StorageImageExtendedFormats; }
+        bool hasConditionalRendering() const { return m_BeginConditionalRendering != nullptr; }
+        bool hasTextureCompressionBC() const { return m_TextureCompressionBC; }
+        bool hasFragmentStoresAndAtomics() const { return m_FragmentStoresAndAtomics; }
         const VkPhysicalDeviceProperties& getGPUProperties() const { return m_PhysicalDeviceProperties; }
+        const QueueFamilyIndices&         getQueueFamilyIndicies() const { return m_QueueFamilyIndices; }
+
+        // Only set when VK_KHR_draw_indirect_count is available
+        PFN_vkCmdDrawIndexedIndirectCountKHR getDrawIndexedIndirectCount() const { return m_DrawIndexedIndirectCount; }
+        // Only set when VK_EXT_conditional_rendering is available
+        PFN_vkCmdBeginConditionalRenderingEXT getBeginConditionalRendering() const {
+            return m_BeginConditionalRendering;
+        }
+        PFN_vkCmdEndConditionalRenderingEXT getEndConditionalRendering() const { return m_EndConditionalRendering; }
 
-        QueueFamilyIndices      getQueueFamilyIndicies();
         SwapChainSupportDetails getSwapChainSupport();
 
        private:
@@ -56,6 +75,18 @@ namespace Yare::Graphics {
         VkPhysicalDeviceProperties m_PhysicalDeviceProperties{};
         VkQueue                    m_GraphicsQueue = VK_NULL_HANDLE;
         VkQueue                    m_PresentQueue = VK_NULL_HANDLE;
+        VkQueue                    m_ComputeQueue = VK_NULL_HANDLE;
+        bool                       m_AsyncCompute = false;
+        bool                       m_MultiDrawIndirect = false;
+        bool                       m_DrawIndirectFirstInstance = false;
+        bool                       m_StorageImageExtendedFormats = false;
+        bool                       m_TextureCompressionBC = false;
+        bool                       m_FragmentStoresAndAtomics = false;
+        QueueFamilyIndices         m_QueueFamilyIndices;
+
+        PFN_vkCmdDrawIndexedIndirectCountKHR  m_DrawIndexedIndirectCount = nullptr;
+        PFN_vkCmdBeginConditionalRenderingEXT m_BeginConditionalRendering = nullptr;
+        PFN_vkCmdEndConditionalRenderingEXT   m_EndConditionalRendering = nullptr;
 
         VkInstance m_InstanceRef = VK_NULL_HANDLE;
 
@@ -1,7 +1,6 @@
 #include "Graphics/Vulkan/Framebuffer.h"
 
-#include "Graphics/Vulkan/Devices.h"
-#include "Utilities/Logger.h"
+#include "Graphics/Vulkan/Context.h"
 
 namespace Yare::Graphics {
 
@@ -15,16 +14,9 @@ namespace Yare::Graphics {
         fbCreateInfo.height = fbInfo.height;
         fbCreateInfo.layers = fbInfo.layers;
 
-        auto res = vkCreateFramebuffer(Devices::instance()->getDevice(), &fbCreateInfo, nullptr, &m_Framebuffer);
-        if (res != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan failed to create a fb");
-        }
+        m_Framebuffer = VulkanContext::getContext()->getResourceCache()->acquireFramebuffer(fbCreateInfo);
     }
 
-    Framebuffer::~Framebuffer() {
-        if (m_Framebuffer) {
-            vkDestroyFramebuffer(Devices::instance()->getDevice(), m_Framebuffer, nullptr);
-        }
-    }
+    Framebuffer::~Framebuffer() { VulkanContext::getContext()->getResourceCache()->releaseFramebuffer(m_Framebuffer); }
 
 }  // namespace Yare::Graphics
@@ -1,48 +1,79 @@
 #include "Graphics/Vulkan/Image.h"
 
+#include <algorithm>
+#include <climits>
 #include <stb/stb_image.h>
 #include <stdlib.h>
 
+#include "Core/FileSystem.h"
+#include "Core/JobSystem.h"
+#include "Graphics/MipGenerator.h"
+#include "Graphics/Vulkan/Context.h"
 #include "Graphics/Vulkan/Devices.h"
 #include "Graphics/Vulkan/Utilities.h"
 #include "Utilities/Logger.h"
 
 namespace Yare::Graphics {
 
-    Image::~Image() {
-        if (m_ImageView) {
-            vkDestroyImageView(Devices::instance()->getDevice(), m_ImageView, nullptr);
-        }
-        if (m_Image) {
-            vkDestroyImage(Devices::instance()->getDevice(), m_Image, nullptr);
+    namespace {
+        // Decodes the file where it is mapped, null when it can't be opened or decoded
+        stbi_uc* loadPixels(const std::string& filePath, int& width, int& height, int& channels) {
+            FileView file = FileSystem::instance()->open(filePath);
+            if (file.empty() || file.size() > INT_MAX) {
+                return nullptr;
+            }
+            return stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &width, &height, &channels,
+                                         STBI_rgb_alpha);
         }
-        if (m_ImageMemory) {
-            vkFreeMemory(Devices::instance()->getDevice(), m_ImageMemory, nullptr);
+    }  // namespace
+
+    Image::~Image() {
+        // The view and sampler are shared through the resource cache, so they are released rather than destroyed
+        VulkanContext::getContext()->getResourceCache()->releaseImageView(m_ImageView);
+        for (auto mipImageView : m_MipImageViews) {
+            VulkanContext::getContext()->getResourceCache()->releaseImageView(mipImageView);
         }
-        if (m_Sampler) {
-            vkDestroySampler(Devices::instance()->getDevice(), m_Sampler, nullptr);
+        VulkanContext::getContext()->getResourceCache()->releaseSampler(m_Sampler);
+
+        // Retired behind its views, which may still be in flight, and destroyed after them
+        VkImage        image = m_Image;
+        VkDeviceMemory imageMemory = m_ImageMemory;
+        if (image || imageMemory) {
+            VulkanContext::getContext()->getRetirementQueue()->retire([image, imageMemory]() {
+                if (image) {
+                    vkDestroyImage(Devices::instance()->getDevice(), image, nullptr);
+                }
+                if (imageMemory) {
+                    vkFreeMemory(Devices::instance()->getDevice(), imageMemory, nullptr);
+                }
+            });
         }
     }
 
     void Image::createTexture2DFromFile(const std::string& filePath) {
-        Buffer stagingBuffer;
+        // A cooked file next to the source already has its levels, and usually takes a quarter of the memory
+        Buffer      stagingBuffer;
+        TextureFile layout;
+        if (loadCookedLayersIntoBuffer({filePath}, stagingBuffer, layout)) {
+            createTextureFromFile(layout, stagingBuffer);
+            createSampler(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            return;
+        }
+
         loadTextureFromFileIntoBuffer(filePath, stagingBuffer);
         createTexture2D(stagingBuffer, VK_FORMAT_R8G8B8A8_SRGB);
         createSampler(VK_SAMPLER_ADDRESS_MODE_REPEAT);
     }
 
-    void Image::createTextureCubeFromFile(const std::string& filePath) {
-        Buffer stagingBuffer;
-        loadTextureFromFileIntoBuffer(filePath, stagingBuffer);
-        createTextureCube(stagingBuffer);
-        createSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
-    }
-
-    void Image::createTextureCubeFromFiles(const std::vector<std::string>& filePaths) {
-        Buffer stagingBuffer;
-        loadTexturesFromFilesIntoBuffer(filePaths, stagingBuffer);
-        createTextureCube(stagingBuffer);
-        createSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    void Image::createTextureFromStaged(StagedTexture& staged) {
+        if (staged.prebuilt) {
+            createTextureFromFile(staged.layout, staged.buffer);
+        } else {
+            m_TextureWidth = staged.layout.width;
+            m_TextureHeight = staged.layout.height;
+            createTextureLayers(staged.buffer, staged.layout.format, staged.layout.layerCount, staged.layout.cube);
+        }
+        createSampler(staged.layout.cube ? VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE : VK_SAMPLER_ADDRESS_MODE_REPEAT);
     }
 
     void Image::createEmptyTexture(size_t width, size_t height, VkFormat format, VkImageTiling tiling,
@@ -51,7 +82,7 @@ namespace Yare::Graphics {
         m_TextureWidth = width;
         m_TextureHeight = height;
         createImage(VK_IMAGE_TYPE_2D, format, tiling, usage, 0, properties);
-        m_ImageView = VkUtil::createImageView(m_Image, VK_IMAGE_VIEW_TYPE_2D, format, 1, flagBits);
+        m_ImageView = createImageView(VK_IMAGE_VIEW_TYPE_2D, format, 1, flagBits);
     }
 
     void Image::createTexture2DFromData(size_t width, size_t height, VkFormat format, unsigned char* data) {
@@ -62,13 +93,42 @@ namespace Yare::Graphics {
         Buffer stagingBuffer;
         stagingBuffer.init(BufferUsage::TRANSFER, imageSize, data);
 
-        createTexture2D(stagingBuffer, format);
+        createTexture2D(stagingBuffer, format, false);
         createSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
     }
 
+    size_t Image::getMemorySize() const {
+        if (isBlockCompressed(m_Format)) {
+            return getTextureLevelsSize(m_Format, m_TextureWidth, m_TextureHeight, 0, m_MipLevels) * m_LayerCount;
+        }
+        return getMipLevelsSize(m_TextureWidth, m_TextureHeight, 0, m_MipLevels) * m_LayerCount;
+    }
+
+    void Image::createTexture2DFromTextureData(const TextureData& data) {
+        m_TextureWidth = data.width;
+        m_TextureHeight = data.height;
+
+        Buffer stagingBuffer;
+        stagingBuffer.init(BufferUsage::TRANSFER, data.pixels.size(), data.pixels.data());
+
+        if (data.levelCount > 1 || data.format != VK_FORMAT_R8G8B8A8_SRGB) {
+            TextureFile layout;
+            layout.format = data.format;
+            layout.width = static_cast<uint32_t>(data.width);
+            layout.height = static_cast<uint32_t>(data.height);
+            layout.levelCount = data.levelCount;
+            createTextureFromFile(layout, stagingBuffer);
+            createSampler(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            return;
+        }
+
+        createTexture2D(stagingBuffer, VK_FORMAT_R8G8B8A8_SRGB);
+        createSampler(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    }
+
     void Image::loadTextureFromFileIntoBuffer(const std::string& filePath, Buffer& buffer) {
         int          texWidth, texHeight, texChannels;
-        stbi_uc*     pixels = stbi_load(filePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        stbi_uc*     pixels = loadPixels(filePath, texWidth, texHeight, texChannels);
         VkDeviceSize imageSize = texWidth * texHeight * 4;
 
         m_TextureWidth = static_cast<size_t>(texWidth);
@@ -83,74 +143,243 @@ namespace Yare::Graphics {
         stbi_image_free(pixels);
     }
 
-    void Image::loadTexturesFromFilesIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer) {
-        // allocate some memory for us to store our images in sequence
-        // width * height * r/g/b/a * 20 images
-        uint32_t       max_size = 2048 * 2048 * 4 * 20;
-        unsigned char* images = (unsigned char*)malloc(max_size);
-        size_t         total_images_size = 0;
-
+    void Image::loadLayersFromFilesIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer,
+                                              TextureFile& layout) {
+        // The headers give the sizes without decoding anything, so the buffer is only as large as the layers
+        int width = 0, height = 0;
         for (const auto& filePath : filePaths) {
-            // Load each image into a buffer
-            int      texWidth, texHeight, texChannels;
-            stbi_uc* image = stbi_load(filePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-            if (!image) {
-                YZ_CRITICAL("stbi_load failed to load a texture from file.");
+            int      layerWidth, layerHeight, channels;
+            FileView file = FileSystem::instance()->open(filePath);
+            if (file.size() > INT_MAX ||
+                !stbi_info_from_memory(file.data(), static_cast<int>(file.size()), &layerWidth, &layerHeight,
+                                       &channels)) {
+                YZ_CRITICAL("stbi_info failed to read the header of the texture at :" + filePath);
             }
-            VkDeviceSize imageSize = texWidth * texHeight * 4 /* STBI_rgb_alpha */;
-            if (total_images_size + imageSize > max_size) {
-                YZ_CRITICAL("VK_Image: Not enough memory was allocated to store images");
+            if (&filePath == &filePaths[0]) {
+                width = layerWidth;
+                height = layerHeight;
+            } else if (layerWidth != width || layerHeight != height) {
+                YZ_CRITICAL("'" + filePath + "' is " + STR(layerWidth) + "x" + STR(layerHeight) +
+                            ", every layer has to be " + STR(width) + "x" + STR(height) + " like '" + filePaths[0] +
+                            "'.");
             }
-            // Copy the image into our buffer so we can access it later based on an offset
-            memcpy(images, image, imageSize);
-            // Increment the ptr to the starting address of the next image we want to store
-            images += imageSize;
+        }
+        layout = {};
+        layout.format = VK_FORMAT_R8G8B8A8_SRGB;
+        layout.width = static_cast<uint32_t>(width);
+        layout.height = static_cast<uint32_t>(height);
+        layout.layerCount = static_cast<uint32_t>(filePaths.size());
+
+        size_t layerSize = size_t(width) * height * 4;
+        buffer.init(BufferUsage::TRANSFER, layerSize * filePaths.size(), nullptr);
+        if (!buffer.mapMemory()) {
+            YZ_CRITICAL("The staging buffer of '" + filePaths[0] + "' could not be mapped.");
+        }
 
-            // Keep track of how many bytes were copied into the buffer
-            total_images_size += imageSize;
+        // Every layer is decoded on its own worker and copied once, into its place in the mapped buffer
+        auto*             layers = static_cast<unsigned char*>(buffer.getMappedData());
+        std::vector<char> decoded(filePaths.size(), 0);
+        JobSystem::instance()->parallelFor(static_cast<uint32_t>(filePaths.size()), 1, [&](uint32_t layer) {
+            int      layerWidth, layerHeight, channels;
+            stbi_uc* pixels = loadPixels(filePaths[layer], layerWidth, layerHeight, channels);
+            if (pixels && layerWidth == width && layerHeight == height) {
+                memcpy(layers + layer * layerSize, pixels, layerSize);
+                decoded[layer] = 1;
+            }
+            stbi_image_free(pixels);
+        });
+        buffer.unmapMemory();
 
-            // I dont know how to handle textures of different sizes yet
-            m_TextureWidth = static_cast<size_t>(texWidth);
-            m_TextureHeight = static_cast<size_t>(texHeight);
+        for (size_t layer = 0; layer < filePaths.size(); layer++) {
+            if (!decoded[layer]) {
+                YZ_CRITICAL("stbi_load failed to load a texture from file at :" + filePaths[layer]);
+            }
+        }
+    }
 
-            stbi_image_free(image);
+    bool Image::loadCookedLayersIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer,
+                                           TextureFile& layout) {
+        std::vector<std::string> cookedPaths;
+        for (const auto& filePath : filePaths) {
+            std::string           cookedPath = findCookedTexture(filePath);
+            TextureFile           header;
+            std::vector<uint64_t> levelOffsets;
+            if (cookedPath.empty() || !loadTextureFileHeader(cookedPath, header, levelOffsets) || header.cube ||
+                header.layerCount != 1 || !canSampleFormat(header.format)) {
+                return false;
+            }
+            if (cookedPaths.empty()) {
+                layout = header;
+            } else if (header.format != layout.format || header.width != layout.width ||
+                       header.height != layout.height || header.levelCount != layout.levelCount) {
+                YZ_WARN("'" + cookedPath + "' doesn't match '" + cookedPaths[0] + "', the sources are loaded instead.");
+                return false;
+            }
+            cookedPaths.push_back(cookedPath);
         }
 
-        images -= total_images_size;
+        size_t layerSize = getTextureFileSize(layout);
+        layout.layerCount = static_cast<uint32_t>(cookedPaths.size());
+        buffer.init(BufferUsage::TRANSFER, layerSize * cookedPaths.size(), nullptr);
+        if (!buffer.mapMemory()) {
+            YZ_CRITICAL("The staging buffer of '" + cookedPaths[0] + "' could not be mapped.");
+        }
 
-        buffer.init(BufferUsage::TRANSFER, total_images_size, images);
+        auto*             layers = static_cast<unsigned char*>(buffer.getMappedData());
+        std::vector<char> loaded(cookedPaths.size(), 0);
+        TextureFile       layerLayout = layout;
+        layerLayout.layerCount = 1;
+        JobSystem::instance()->parallelFor(static_cast<uint32_t>(cookedPaths.size()), 1, [&](uint32_t layer) {
+            loaded[layer] = loadTextureFileData(cookedPaths[layer], layerLayout, layers + layer * layerSize);
+        });
+        buffer.unmapMemory();
+
+        for (size_t layer = 0; layer < cookedPaths.size(); layer++) {
+            if (!loaded[layer]) {
+                YZ_CRITICAL("The levels of '" + cookedPaths[layer] + "' could not be read.");
+            }
+        }
+        return true;
     }
 
-    void Image::createTexture2D(const Buffer& buffer, VkFormat format) {
+    void Image::createTexture2D(Buffer& buffer, VkFormat format, bool wrap) {
+        m_MipLevels = getMipLevelCount(m_TextureWidth, m_TextureHeight);
         createImage(VK_IMAGE_TYPE_2D, format, VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 0,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 0,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        m_ImageView = VkUtil::createImageView(m_Image, VK_IMAGE_VIEW_TYPE_2D, format, 1, VK_IMAGE_ASPECT_COLOR_BIT);
+        m_ImageView = createImageView(VK_IMAGE_VIEW_TYPE_2D, format, 1, VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels);
 
-        transitionImageLayout(format, 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        copyBufferToImage(buffer, 1, 1);
-        transitionImageLayout(format, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        uploadMipChain(buffer, format, 1, wrap);
     }
 
-    void Image::createTextureCube(const Buffer& buffer) {
-        createImage(VK_IMAGE_TYPE_2D, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
-                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    void Image::createTextureLayers(Buffer& buffer, VkFormat format, uint32_t layerCount, bool cube) {
+        m_MipLevels = getMipLevelCount(m_TextureWidth, m_TextureHeight);
+        m_LayerCount = layerCount;
+        createImage(VK_IMAGE_TYPE_2D, format, VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                    cube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        m_ImageView = VkUtil::createImageView(m_Image, VK_IMAGE_VIEW_TYPE_CUBE, VK_FORMAT_R8G8B8A8_SRGB, 6,
-                                              VK_IMAGE_ASPECT_COLOR_BIT);
+        m_ImageView = createImageView(cube ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D_ARRAY, format, layerCount,
+                                      VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels);
+
+        uploadMipChain(buffer, format, layerCount, !cube);
+    }
 
-        transitionImageLayout(VK_FORMAT_R8G8B8A8_SRGB, 6, VK_IMAGE_LAYOUT_UNDEFINED,
+    void Image::createTextureFromFile(const TextureFile& layout, Buffer& buffer) {
+        m_TextureWidth = layout.width;
+        m_TextureHeight = layout.height;
+        m_MipLevels = layout.levelCount;
+        m_LayerCount = layout.layerCount;
+        createImage(VK_IMAGE_TYPE_2D, layout.format, VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                    layout.cube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+        if (layout.cube) {
+            viewType = VK_IMAGE_VIEW_TYPE_CUBE;
+        } else if (layout.layerCount > 1) {
+            viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+        }
+        m_ImageView = createImageView(viewType, layout.format, layout.layerCount, VK_IMAGE_ASPECT_COLOR_BIT, 0,
+                                      m_MipLevels);
+
+        transitionImageLayout(layout.format, layout.layerCount, VK_IMAGE_LAYOUT_UNDEFINED,
                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        copyBufferToImage(buffer, layout.layerCount, m_MipLevels);
+        transitionImageLayout(layout.format, layout.layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    void Image::uploadMipChain(Buffer& buffer, VkFormat format, uint32_t layerCount, bool wrap) {
+        transitionImageLayout(format, layerCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        if (VkUtil::supportsLinearBlit(format)) {
+            copyBufferToImage(buffer, layerCount, 1);
+            generateMipmaps(layerCount);
+            return;
+        }
 
-        copyBufferToImage(buffer, 6, 1);
+        // Without linear blits the levels are filtered on the cpu, which only knows four byte texels
+        MipChainSettings settings;
+        settings.srgb = format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+        settings.wrap = wrap;
+
+        size_t                     layerSize = m_TextureWidth * m_TextureHeight * 4;
+        std::vector<unsigned char> chains;
+        if (buffer.mapMemory()) {
+            for (uint32_t layer = 0; layer < layerCount; layer++) {
+                auto* pixels = static_cast<const unsigned char*>(buffer.getMappedData()) + layer * layerSize;
+                std::vector<unsigned char> chain =
+                    generateMipChain(pixels, m_TextureWidth, m_TextureHeight, m_MipLevels, settings);
+                chains.insert(chains.end(), chain.begin(), chain.end());
+            }
+            buffer.unmapMemory();
+        } else {
+            chains.resize(getMipLevelsSize(m_TextureWidth, m_TextureHeight, 0, m_MipLevels) * layerCount);
+        }
 
-        transitionImageLayout(VK_FORMAT_R8G8B8A8_SRGB, 6, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        Buffer chainBuffer;
+        chainBuffer.init(BufferUsage::TRANSFER, chains.size(), chains.data());
+        copyBufferToImage(chainBuffer, layerCount, m_MipLevels);
+        transitionImageLayout(format, layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 
+    void Image::generateMipmaps(uint32_t layerCount) {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_Image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount};
+
+        // Every level is blitted from the one before it, which is then done and moves on to be sampled. Blits of
+        // srgb formats filter in linear space.
+        VkCommandBuffer commandBuffer = VkUtil::beginSingleTimeCommands();
+        int32_t         width = static_cast<int32_t>(m_TextureWidth);
+        int32_t         height = static_cast<int32_t>(m_TextureHeight);
+        for (uint32_t level = 1; level < m_MipLevels; level++) {
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, 1, &barrier);
+
+            int32_t     levelWidth = (std::max)(width / 2, 1);
+            int32_t     levelHeight = (std::max)(height / 2, 1);
+            VkImageBlit blit = {};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, layerCount};
+            blit.srcOffsets[1] = {width, height, 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layerCount};
+            blit.dstOffsets[1] = {levelWidth, levelHeight, 1};
+            vkCmdBlitImage(commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            width = levelWidth;
+            height = levelHeight;
+        }
+
+        // The last level was only ever written
+        barrier.subresourceRange.baseMipLevel = m_MipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+        VkUtil::endSingleTimeCommands(commandBuffer);
+    }
+
     void Image::transitionImageLayout(VkFormat format, uint32_t layerCount, VkImageLayout oldLayout,
                                       VkImageLayout newLayout) {
         VkImageMemoryBarrier barrier = {};
@@ -162,7 +391,7 @@ namespace Yare::Graphics {
         barrier.image = m_Image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = m_MipLevels;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = layerCount;
 
@@ -197,19 +426,21 @@ namespace Yare::Graphics {
     void Image::copyBufferToImage(const Buffer& buffer, uint32_t faces, uint32_t mipLevels) {
         std::vector<VkBufferImageCopy> bufferCopyRegions;
 
+        VkDeviceSize offset = 0;
         for (uint32_t face = 0; face < faces; face++) {
             for (uint32_t level = 0; level < mipLevels; level++) {
-                // This assumes the buffer has only n required images and nothing more
-                uint32_t          offset = (static_cast<uint32_t>(buffer.getSize()) / faces) * face;
                 VkBufferImageCopy bufferCopyRegion = {};
                 bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
                 bufferCopyRegion.imageSubresource.mipLevel = level;
                 bufferCopyRegion.imageSubresource.baseArrayLayer = face;
                 bufferCopyRegion.imageSubresource.layerCount = 1;
-                bufferCopyRegion.imageExtent = {static_cast<uint32_t>(m_TextureWidth),
-                                                static_cast<uint32_t>(m_TextureHeight), 1};
+                bufferCopyRegion.imageExtent = {(std::max)(static_cast<uint32_t>(m_TextureWidth) >> level, 1u),
+                                                (std::max)(static_cast<uint32_t>(m_TextureHeight) >> level, 1u), 1};
                 bufferCopyRegion.bufferOffset = offset;
                 bufferCopyRegions.push_back(bufferCopyRegion);
+                offset += isBlockCompressed(m_Format)
+                              ? getTextureLevelsSize(m_Format, m_TextureWidth, m_TextureHeight, level, level + 1)
+                              : getMipLevelsSize(m_TextureWidth, m_TextureHeight, level, level + 1);
             }
         }
 
@@ -227,7 +458,7 @@ namespace Yare::Graphics {
         imageInfo.extent.width = static_cast<uint32_t>(m_TextureWidth);
         imageInfo.extent.height = static_cast<uint32_t>(m_TextureHeight);
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = m_MipLevels;
         imageInfo.format = format;
         imageInfo.tiling = tiling;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -235,12 +466,9 @@ namespace Yare::Graphics {
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.flags = flags;
+        m_Format = format;
 
-        if (flags == VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) {
-            imageInfo.arrayLayers = 6;
-        } else {
-            imageInfo.arrayLayers = 1;
-        }
+        imageInfo.arrayLayers = m_LayerCount;
 
         if (vkCreateImage(Devices::instance()->getDevice(), &imageInfo, nullptr, &m_Image) != VK_SUCCESS) {
             YZ_CRITICAL("Failed to create an image.");
@@ -264,35 +492,73 @@ namespace Yare::Graphics {
         }
     }
 
-    void Image::createSampler(VkSamplerAddressMode mode) {
+    void Image::createSampler(VkSamplerAddressMode mode, VkFilter filter) {
         VkSamplerCreateInfo samplerInfo = {};
         samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        samplerInfo.magFilter = VK_FILTER_LINEAR;
-        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.magFilter = filter;
+        samplerInfo.minFilter = filter;
         samplerInfo.addressModeU = mode;
         samplerInfo.addressModeV = mode;
         samplerInfo.addressModeW = mode;
-        samplerInfo.anisotropyEnable = VK_TRUE;
-        samplerInfo.maxAnisotropy = 16;
+        samplerInfo.anisotropyEnable = filter == VK_FILTER_LINEAR ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = filter == VK_FILTER_LINEAR ? 16.0f : 1.0f;
         samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_WHITE;
         samplerInfo.unnormalizedCoordinates = VK_FALSE;
         samplerInfo.compareEnable = VK_FALSE;
         samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.mipmapMode =
+            filter == VK_FILTER_LINEAR ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(m_MipLevels - 1);
+
+        // Nearly every texture asks for the same sampler, so they all end up sharing one
+        m_Sampler = VulkanContext::getContext()->getResourceCache()->acquireSampler(samplerInfo);
+    }
+
+    VkImageView Image::createImageView(VkImageViewType viewType, VkFormat format, uint32_t layerCount,
+                                       VkImageAspectFlags aspectFlags, uint32_t baseMipLevel, uint32_t levelCount) {
+        return VulkanContext::getContext()->getResourceCache()->acquireImageView(VkUtil::imageViewCreateInfo(
+            m_Image, viewType, format, layerCount, aspectFlags, baseMipLevel, levelCount));
+    }
 
-        if (vkCreateSampler(Devices::instance()->getDevice(), &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan failed to create a sampler.");
+    Image* Image::createDepthStencilBuffer(size_t width, size_t height, VkFormat format, bool sampled) {
+        Image*            image = new Image();
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        if (sampled) {
+            usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
         }
+        image->createEmptyTexture(width, height, format, VK_IMAGE_TILING_OPTIMAL, usage,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+        return image;
     }
 
-    Image* Image::createDepthStencilBuffer(size_t width, size_t height, VkFormat format) {
+    Image* Image::createStorageImage(size_t width, size_t height, VkFormat format, uint32_t mipLevels) {
+        Image* image = new Image();
+        image->m_TextureWidth = width;
+        image->m_TextureHeight = height;
+        image->m_MipLevels = mipLevels;
+        image->createImage(VK_IMAGE_TYPE_2D, format, VK_IMAGE_TILING_OPTIMAL,
+                           VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 0,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        image->m_ImageView =
+            image->createImageView(VK_IMAGE_VIEW_TYPE_2D, format, 1, VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels);
+        for (uint32_t level = 0; level < mipLevels; level++) {
+            image->m_MipImageViews.push_back(
+                image->createImageView(VK_IMAGE_VIEW_TYPE_2D, format, 1, VK_IMAGE_ASPECT_COLOR_BIT, level, 1));
+        }
+        // Storage images are read with texelFetch, so filtering never matters
+        image->createSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_FILTER_NEAREST);
+        return image;
+    }
+
+    Image* Image::createRenderTarget(size_t width, size_t height, VkFormat format) {
         Image* image = new Image();
         image->createEmptyTexture(width, height, format, VK_IMAGE_TILING_OPTIMAL,
-                                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                  VK_IMAGE_ASPECT_DEPTH_BIT);
+                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+        image->createSampler(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
         return image;
     }
 
@@ -302,22 +568,115 @@ namespace Yare::Graphics {
         return image;
     }
 
+    Image* Image::createMippedTexture2D(size_t width, size_t height, uint32_t mipLevels, VkFormat format) {
+        Image* image = new Image();
+        image->m_TextureWidth = width;
+        image->m_TextureHeight = height;
+        image->m_MipLevels = mipLevels;
+        image->createImage(VK_IMAGE_TYPE_2D, format, VK_IMAGE_TILING_OPTIMAL,
+                           VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                               VK_IMAGE_USAGE_SAMPLED_BIT,
+                           0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        image->m_ImageView =
+            image->createImageView(VK_IMAGE_VIEW_TYPE_2D, format, 1, VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels);
+        image->createSampler(VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        return image;
+    }
+
     Image* Image::createTexture2D(const std::string& filePath) {
         Image* image = new Image();
         image->createTexture2DFromFile(filePath);
         return image;
     }
 
-    Image* Image::createTextureCube(const std::vector<std::string>& filePaths) {
+    Image* Image::createTexture2D(const TextureData& data) {
         Image* image = new Image();
+        image->createTexture2DFromTextureData(data);
+        return image;
+    }
+
+    bool Image::loadTextureData(const std::string& filePath, TextureData& data) {
+        std::string cookedPath = findCookedTexture(filePath);
+        TextureFile cooked;
+        if (!cookedPath.empty() && loadTextureFile(cookedPath, cooked) && !cooked.cube && cooked.layerCount == 1 &&
+            canSampleFormat(cooked.format)) {
+            data.width = cooked.width;
+            data.height = cooked.height;
+            data.format = cooked.format;
+            data.levelCount = cooked.levelCount;
+            data.pixels = std::move(cooked.data);
+            return true;
+        }
+
+        int      texWidth, texHeight, texChannels;
+        stbi_uc* pixels = loadPixels(filePath, texWidth, texHeight, texChannels);
+        if (!pixels) {
+            YZ_ERROR("stbi_load failed to load a texture from file at :" + filePath);
+            return false;
+        }
+
+        data.width = static_cast<size_t>(texWidth);
+        data.height = static_cast<size_t>(texHeight);
+        data.format = VK_FORMAT_R8G8B8A8_SRGB;
+        data.levelCount = 1;
+        data.pixels.assign(pixels, pixels + data.width * data.height * 4);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    bool Image::canSampleFormat(VkFormat format) {
+        return !isBlockCompressed(format) || Devices::instance()->hasTextureCompressionBC();
+    }
+
+    Image* Image::createTextureCube(const std::vector<std::string>& filePaths) {
+        StagedTexture staged;
+        stageTextureLayers(filePaths, true, staged);
+        return createTexture(staged);
+    }
+
+    Image* Image::createTextureArray(const std::vector<std::string>& filePaths) {
+        StagedTexture staged;
+        stageTextureLayers(filePaths, false, staged);
+        return createTexture(staged);
+    }
+
+    void Image::stageTextureLayers(const std::vector<std::string>& filePaths, bool cube, StagedTexture& staged) {
         if (filePaths.empty()) {
-            YZ_ERROR("Texture Cube filepaths vector is empty.");
+            YZ_CRITICAL("A layered texture needs at least one file.");
         }
-        if (filePaths.size() == 1) {
-            image->createTextureCubeFromFile(filePaths[0]);
+
+        if (cube && filePaths.size() == 1) {
+            std::string           cookedPath = findCookedTexture(filePaths[0]);
+            std::vector<uint64_t> levelOffsets;
+            if (cookedPath.empty() || !loadTextureFileHeader(cookedPath, staged.layout, levelOffsets) ||
+                !staged.layout.cube || staged.layout.layerCount != 6 || !canSampleFormat(staged.layout.format)) {
+                YZ_CRITICAL("'" + filePaths[0] + "' is not a cube map, one file has to be a cooked KTX2 or DDS cube.");
+            }
+            staged.buffer.init(BufferUsage::TRANSFER, getTextureFileSize(staged.layout), nullptr);
+            bool loaded = staged.buffer.mapMemory() &&
+                          loadTextureFileData(cookedPath, staged.layout,
+                                              static_cast<unsigned char*>(staged.buffer.getMappedData()));
+            staged.buffer.unmapMemory();
+            if (!loaded) {
+                YZ_CRITICAL("The levels of '" + cookedPath + "' could not be read.");
+            }
+            staged.prebuilt = true;
+        } else if (cube && filePaths.size() != 6) {
+            YZ_CRITICAL("A cube map needs six faces, " + STR(filePaths.size()) + " were given.");
+        } else if (loadCookedLayersIntoBuffer(filePaths, staged.buffer, staged.layout)) {
+            staged.layout.cube = cube;
+            staged.prebuilt = true;
         } else {
-            image->createTextureCubeFromFiles(filePaths);
+            loadLayersFromFilesIntoBuffer(filePaths, staged.buffer, staged.layout);
+            staged.layout.cube = cube;
+            staged.prebuilt = false;
         }
+    }
+
+    Image* Image::createTexture(StagedTexture& staged) {
+        Image* image = new Image();
+        image->createTextureFromStaged(staged);
         return image;
     }
 }  // namespace Yare::Graphics
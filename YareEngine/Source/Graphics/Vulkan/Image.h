@@ -3,10 +3,30 @@
 
 #include <string>
 
+#include "Graphics/TextureContainer.h"
 #include "Graphics/Vulkan/Buffer.h"
 #include "Graphics/Vulkan/Vk.h"
 
 namespace Yare::Graphics {
+    // Pixels of a texture file decoded to rgba, on the cpu only so it can be loaded on any thread. Cooked files keep
+    // their format and every level they come with, packed finest first.
+    struct TextureData {
+        size_t                     width = 0;
+        size_t                     height = 0;
+        VkFormat                   format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t                   levelCount = 1;
+        std::vector<unsigned char> pixels;
+    };
+
+    // Layers of a texture read into a staging buffer by stageTextureLayers, on any thread, and uploaded by
+    // createTexture on the one that owns the queue
+    struct StagedTexture {
+        Buffer      buffer;
+        TextureFile layout;
+        // The levels came with cooked files, otherwise only the first level of every layer is staged
+        bool prebuilt = false;
+    };
+
     class Image {
        protected:
         // Only allow the static constructors
@@ -16,45 +36,99 @@ namespace Yare::Graphics {
         ~Image();
 
         void createTexture2DFromFile(const std::string& filePath);
-        void createTextureCubeFromFile(const std::string& filePath);
-        void createTextureCubeFromFiles(const std::vector<std::string>& filePaths);
+        void createTextureFromStaged(StagedTexture& staged);
         void createEmptyTexture(size_t width, size_t height, VkFormat format, VkImageTiling tiling,
                                 VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
                                 VkImageAspectFlagBits flagBits);
         void createTexture2DFromData(size_t width, size_t height, VkFormat format, unsigned char* data);
+        void createTexture2DFromTextureData(const TextureData& data);
 
         const VkImage&        getImage() const { return m_Image; }
         const VkDeviceMemory& getMemory() const { return m_ImageMemory; }
         const VkImageView&    getImageView() const { return m_ImageView; }
         const VkSampler&      getSampler() const { return m_Sampler; }
+        // One view per mip level, only created for storage images so each level can be written on its own
+        const VkImageView& getMipImageView(uint32_t level) const { return m_MipImageViews[level]; }
+        uint32_t           getMipLevels() const { return m_MipLevels; }
+        uint32_t           getLayerCount() const { return m_LayerCount; }
+        size_t             getWidth() const { return m_TextureWidth; }
+        size_t             getHeight() const { return m_TextureHeight; }
+        VkFormat           getFormat() const { return m_Format; }
+        // Bytes of every mip level of every layer
+        size_t getMemorySize() const;
 
        private:
         void loadTextureFromFileIntoBuffer(const std::string& filePath, Buffer& buffer);
-        void loadTexturesFromFilesIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer);
-        void createTexture2D(const Buffer& buffer, VkFormat format);
-        void createTextureCube(const Buffer& buffer);
+        // Decodes every file straight into its layer of the buffer, which is sized for them and nothing more. All
+        // of them have to be as large as the first.
+        static void loadLayersFromFilesIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer,
+                                                  TextureFile& layout);
+        // Reads the levels of cooked files into the buffer the same way, false when they don't all match the first
+        static bool loadCookedLayersIntoBuffer(const std::vector<std::string>& filePaths, Buffer& buffer,
+                                               TextureFile& layout);
+        // Wrap matches the sampler's address mode, the edges of the levels are filtered the same way
+        void createTexture2D(Buffer& buffer, VkFormat format, bool wrap = true);
+        // Fills every level of every layer from the buffer, or only the first ones and filters the rest
+        void createTextureLayers(Buffer& buffer, VkFormat format, uint32_t layerCount, bool cube);
+        // Uploads the prebuilt levels of a cooked file as they are, nothing is filtered. The layout has the file's
+        // header, the buffer the levels.
+        void createTextureFromFile(const TextureFile& layout, Buffer& buffer);
+        // Fills every level from the first level of each layer in the buffer, with blits on the gpu when the format
+        // allows it and on the cpu otherwise, and leaves the image ready to be sampled
+        void uploadMipChain(Buffer& buffer, VkFormat format, uint32_t layerCount, bool wrap);
+        void generateMipmaps(uint32_t layerCount);
         void transitionImageLayout(VkFormat format, uint32_t layerCount, VkImageLayout oldLayout,
                                    VkImageLayout newLayout);
+        // The buffer holds the layers one after the other, each with its levels packed finest first
         void copyBufferToImage(const Buffer& buffer, uint32_t faces, uint32_t mipLevels);
 
         void createImage(VkImageType type, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
                          VkImageCreateFlags flags, VkMemoryPropertyFlags properties);
-        void createSampler(VkSamplerAddressMode mode);
+        void        createSampler(VkSamplerAddressMode mode, VkFilter filter = VK_FILTER_LINEAR);
+        VkImageView createImageView(VkImageViewType viewType, VkFormat format, uint32_t layerCount,
+                                    VkImageAspectFlags aspectFlags, uint32_t baseMipLevel = 0,
+                                    uint32_t levelCount = 1);
 
         VkImage        m_Image = VK_NULL_HANDLE;
         VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
         VkImageView    m_ImageView = VK_NULL_HANDLE;
         VkSampler      m_Sampler = VK_NULL_HANDLE;
 
+        std::vector<VkImageView> m_MipImageViews;
+        uint32_t                 m_MipLevels = 1;
+        uint32_t                 m_LayerCount = 1;
+        VkFormat                 m_Format = VK_FORMAT_UNDEFINED;
+
         size_t m_TextureWidth = 0;
         size_t m_TextureHeight = 0;
         size_t m_TextureChannels = 0;
 
        public:
-        static Image* createDepthStencilBuffer(size_t width, size_t height, VkFormat format);
+        // A sampled depth buffer can be read by shaders once a pass is done writing it
+        static Image* createDepthStencilBuffer(size_t width, size_t height, VkFormat format, bool sampled = false);
+        // Written by compute shaders and sampled with texelFetch, it is left in the general layout
+        static Image* createStorageImage(size_t width, size_t height, VkFormat format, uint32_t mipLevels);
+        // Color attachment that is sampled once rendering to it is done, the caller moves it between the layouts
+        static Image* createRenderTarget(size_t width, size_t height, VkFormat format);
         static Image* createTexture2D(size_t width, size_t height, VkFormat format, unsigned char* data);
+        // Every level starts out undefined, the caller fills them with transfers and moves the whole image to the
+        // shader read layout. The levels can be copied out of it too.
+        static Image* createMippedTexture2D(size_t width, size_t height, uint32_t mipLevels, VkFormat format);
         static Image* createTexture2D(const std::string& filePath);
+        // Same texture as createTexture2D(filePath) makes, from pixels decoded by loadTextureData
+        static Image* createTexture2D(const TextureData& data);
+        // Prefers a cooked file next to the source when the gpu can sample its format
+        static bool   loadTextureData(const std::string& filePath, TextureData& data);
+        // Block compressed formats need the gpu to support them, anything else loaded from files always works
+        static bool   canSampleFormat(VkFormat format);
+        // Six faces in the order +x, -x, +y, -y, +z, -z, or one cooked KTX2 or DDS cube
         static Image* createTextureCube(const std::vector<std::string>& filePaths);
+        // Every file is one layer, or a single cooked file holds all six faces of a cube. Touches no queue, so the
+        // files can be read on any thread.
+        static void   stageTextureLayers(const std::vector<std::string>& filePaths, bool cube, StagedTexture& staged);
+        static Image* createTexture(StagedTexture& staged);
+        // Every file is one layer of a 2d array, they all need the same size
+        static Image* createTextureArray(const std::vector<std::string>& filePaths);
     };
 }  // namespace Yare::Graphics
 
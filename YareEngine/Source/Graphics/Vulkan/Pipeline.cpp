@@ -1,5 +1,8 @@
 #include "Graphics/Vulkan/Pipeline.h"
 
+#include <chrono>
+
+#include "Graphics/Vulkan/Context.h"
 #include "Graphics/Vulkan/Devices.h"
 #include "Utilities/Logger.h"
 
@@ -8,8 +11,8 @@ namespace Yare::Graphics {
     Pipeline::Pipeline() {}
 
     Pipeline::~Pipeline() {
-        if (m_DescriptorSetLayout) {
-            vkDestroyDescriptorSetLayout(Devices::instance()->getDevice(), m_DescriptorSetLayout, nullptr);
+        for (auto layout : m_DescriptorSetLayouts) {
+            VulkanContext::getContext()->getResourceCache()->releaseDescriptorSetLayout(layout);
         }
         if (m_PipelineLayout) {
             vkDestroyPipelineLayout(Devices::instance()->getDevice(), m_PipelineLayout, nullptr);
@@ -17,9 +20,6 @@ namespace Yare::Graphics {
         if (m_GraphicsPipeline) {
             vkDestroyPipeline(Devices::instance()->getDevice(), m_GraphicsPipeline, nullptr);
         }
-        if (m_DescriptorPool) {
-            vkDestroyDescriptorPool(Devices::instance()->getDevice(), m_DescriptorPool, nullptr);
-        }
     }
 
     void Pipeline::init(PipelineInfo& pipelineInfo) {
@@ -27,38 +27,36 @@ namespace Yare::Graphics {
         // A descriptor is a special opaque shader variable that shaders use to access buffer and image
         // resources in an indirect fashion. It can be thought of as a "pointer" to a resource.
         // The layout is used to describe the content of a list of descriptor sets
-        createDescriptorSetLayout();
+        createDescriptorSetLayouts();
 
         // Pipeline yay
         createGraphicsPipeline();
-
-        // Descriptor sets can't be created directly, they must be allocated from a pool like command buffers. We create
-        // those here.
-        createDescriptorPool();
     }
 
     void Pipeline::setActive(const CommandBuffer& commandBuffer) {
         vkCmdBindPipeline(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipeline);
     }
 
-    void Pipeline::createDescriptorSetLayout() {
-        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        layoutInfo.bindingCount = static_cast<uint32_t>(m_PipelineInfo.layoutBindings.size());
-        layoutInfo.pBindings = m_PipelineInfo.layoutBindings.data();
-
-        auto res =
-            vkCreateDescriptorSetLayout(Devices::instance()->getDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout);
-        if (res != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan was unable to create a descriptor set layout.");
+    void Pipeline::createDescriptorSetLayouts() {
+        // Pipelines with the same bindings for a set share the same layout, so sets allocated for one pipeline can be
+        // bound to any other compatible pipeline
+        m_DescriptorSetLayouts.clear();
+        for (const auto& bindings : m_PipelineInfo.setLayoutBindings) {
+            VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+            layoutInfo.pBindings = bindings.data();
+
+            m_DescriptorSetLayouts.push_back(
+                VulkanContext::getContext()->getResourceCache()->acquireDescriptorSetLayout(layoutInfo));
         }
     }
 
     void Pipeline::createGraphicsPipeline() {
         VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &m_PipelineInfo.bindingDescription;
+        vertexInputInfo.vertexBindingDescriptionCount = (uint32_t)m_PipelineInfo.bindingDescriptions.size();
+        vertexInputInfo.pVertexBindingDescriptions = m_PipelineInfo.bindingDescriptions.data();
 
         vertexInputInfo.vertexAttributeDescriptionCount = (uint32_t)m_PipelineInfo.vertexInputAttributes.size();
         vertexInputInfo.pVertexAttributeDescriptions = m_PipelineInfo.vertexInputAttributes.data();
@@ -117,7 +115,7 @@ namespace Yare::Graphics {
         depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
         depthStencil.depthTestEnable = m_PipelineInfo.depthTestEnable;
         depthStencil.depthWriteEnable = m_PipelineInfo.depthWriteEnable;
-        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencil.depthCompareOp = m_PipelineInfo.depthCompareOp;
         depthStencil.depthBoundsTestEnable = VK_FALSE;
         depthStencil.stencilTestEnable = VK_FALSE;
         depthStencil.minDepthBounds = 0.0f;  // Optional
@@ -127,8 +125,10 @@ namespace Yare::Graphics {
 
         VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
 
-        colorBlendAttachment.colorWriteMask =
-            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        if (m_PipelineInfo.colorWriteEnabled) {
+            colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                                  VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        }
         if (m_PipelineInfo.colorBlendingEnabled) {
             colorBlendAttachment.blendEnable = VK_TRUE;
             colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
@@ -154,10 +154,10 @@ namespace Yare::Graphics {
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = 1;
-        pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(m_DescriptorSetLayouts.size());
+        pipelineLayoutInfo.pSetLayouts = m_DescriptorSetLayouts.data();
         pipelineLayoutInfo.pPushConstantRanges = &m_PipelineInfo.pushConstants;
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pushConstantRangeCount = m_PipelineInfo.pushConstants.size > 0 ? 1 : 0;
 
         auto res =
             vkCreatePipelineLayout(Devices::instance()->getDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout);
@@ -165,10 +165,27 @@ namespace Yare::Graphics {
             YZ_CRITICAL("Vulkan Pipeline Layout was unable to be created.");
         }
 
+        // The shader's stages are shared with other pipelines, so the specialization goes on a copy of them
+        std::vector<VkPipelineShaderStageCreateInfo> stages(
+            m_PipelineInfo.shader->getShaderStages(),
+            m_PipelineInfo.shader->getShaderStages() + m_PipelineInfo.shader->getStageCount());
+        std::vector<VkSpecializationMapEntry> specializationEntries;
+        for (uint32_t i = 0; i < m_PipelineInfo.specializationConstants.size(); i++) {
+            specializationEntries.push_back({i, i * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t)});
+        }
+        VkSpecializationInfo specializationInfo = {};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+        specializationInfo.pMapEntries = specializationEntries.data();
+        specializationInfo.dataSize = specializationEntries.size() * sizeof(uint32_t);
+        specializationInfo.pData = m_PipelineInfo.specializationConstants.data();
+        for (auto& stage : stages) {
+            stage.pSpecializationInfo = specializationEntries.empty() ? nullptr : &specializationInfo;
+        }
+
         VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineCreateInfo.stageCount = m_PipelineInfo.shader->getStageCount();
-        pipelineCreateInfo.pStages = m_PipelineInfo.shader->getShaderStages();
+        pipelineCreateInfo.stageCount = static_cast<uint32_t>(stages.size());
+        pipelineCreateInfo.pStages = stages.data();
         pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
         pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
         pipelineCreateInfo.pViewportState = &viewportState;
@@ -191,32 +208,13 @@ namespace Yare::Graphics {
         pipelineCreateInfo.subpass = 0;
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+        auto start = std::chrono::steady_clock::now();
         res = vkCreateGraphicsPipelines(Devices::instance()->getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo,
                                         nullptr, &m_GraphicsPipeline);
+        Pipeline::addBuildTime(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
         if (res != VK_SUCCESS) {
             YZ_CRITICAL("Vulkan failed to create a graphics pipeline.");
         }
     }
-
-    void Pipeline::createDescriptorPool() {
-        std::vector<VkDescriptorPoolSize> poolSizes(m_PipelineInfo.layoutBindings.size());
-
-        int bindingIndex = 0;
-        for (auto binding : m_PipelineInfo.layoutBindings) {
-            poolSizes[bindingIndex].type = binding.descriptorType;
-            poolSizes[bindingIndex].descriptorCount = binding.descriptorCount;
-            bindingIndex++;
-        }
-
-        VkDescriptorPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-        poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.maxSets = m_PipelineInfo.maxObjects;
-
-        auto res = vkCreateDescriptorPool(Devices::instance()->getDevice(), &poolInfo, nullptr, &m_DescriptorPool);
-        if (res != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan creation of descriptor pool failed.");
-        }
-    }
 }  // namespace Yare::Graphics
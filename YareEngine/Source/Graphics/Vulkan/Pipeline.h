@@ -11,20 +11,27 @@
 namespace Yare::Graphics {
 
     struct PipelineInfo {
-        Shader*                                        shader;
-        RenderPass*                                    renderpass;
-        bool                                           depthWriteEnable;
-        bool                                           depthTestEnable;
-        VkCullModeFlags                                cullMode;
-        std::vector<VkDescriptorSetLayoutBinding>      layoutBindings;
-        std::vector<VkVertexInputAttributeDescription> vertexInputAttributes;
-        VkVertexInputBindingDescription                bindingDescription;
-        std::vector<VkDynamicState>                    dynamicStates;
-        uint32_t                                       maxObjects;
-        size_t                                         width;
-        size_t                                         height;
-        VkPushConstantRange                            pushConstants;
-        bool                                           colorBlendingEnabled = false;
+        Shader*                                                shader;
+        RenderPass*                                            renderpass;
+        bool                                                   depthWriteEnable;
+        bool                                                   depthTestEnable;
+        // Passes drawing over a depth prepass need LESS_OR_EQUAL to keep the fragments the prepass left
+        VkCompareOp                                            depthCompareOp = VK_COMPARE_OP_LESS;
+        VkCullModeFlags                                        cullMode;
+        // Bindings for each descriptor set, indexed by set number (see DescriptorSetFrequency)
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> setLayoutBindings;
+        std::vector<VkVertexInputAttributeDescription>         vertexInputAttributes;
+        // One per vertex stream, empty when every vertex comes from the vertex index
+        std::vector<VkVertexInputBindingDescription>           bindingDescriptions;
+        std::vector<VkDynamicState>                            dynamicStates;
+        size_t                                                 width;
+        size_t                                                 height;
+        VkPushConstantRange                                    pushConstants = {};
+        bool                                                   colorBlendingEnabled = false;
+        // Depth only pipelines, like occlusion query proxies, leave the color attachment untouched
+        bool                                                   colorWriteEnabled = true;
+        // Value of specialization constant i in every stage, stages without that constant ignore it
+        std::vector<uint32_t>                                  specializationConstants;
     };
 
     class Pipeline {
@@ -34,23 +41,29 @@ namespace Yare::Graphics {
         void init(PipelineInfo& pipelineInfo);
         void setActive(const CommandBuffer& commandBuffer);
 
-        const VkDescriptorPool&      getDescriptorPool() const { return m_DescriptorPool; }
-        const VkDescriptorSetLayout& getDescriptorSetLayout() const { return m_DescriptorSetLayout; }
         const VkPipelineLayout&      getPipelineLayout() const { return m_PipelineLayout; }
         const VkPipeline&            getPipeline() const { return m_GraphicsPipeline; }
+        const VkDescriptorSetLayout& getDescriptorSetLayout(uint32_t set = 0) const {
+            return m_DescriptorSetLayouts[set];
+        }
+
+        // Milliseconds the driver took to create every graphics and compute pipeline so far, for the startup report
+        static double getTotalBuildTime() { return m_TotalBuildTime; }
+        static void   addBuildTime(double milliseconds) { m_TotalBuildTime += milliseconds; }
 
        private:
-        void createDescriptorSetLayout();
+        void createDescriptorSetLayouts();
         void createGraphicsPipeline();
-        void createDescriptorPool();
 
        private:
         PipelineInfo m_PipelineInfo;
 
-        VkDescriptorPool      m_DescriptorPool = VK_NULL_HANDLE;
-        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
-        VkPipelineLayout      m_PipelineLayout = VK_NULL_HANDLE;
-        VkPipeline            m_GraphicsPipeline = VK_NULL_HANDLE;
+        // Layouts are owned by the contexts resource cache and shared between pipelines
+        std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
+        VkPipelineLayout                   m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline                         m_GraphicsPipeline = VK_NULL_HANDLE;
+
+        inline static double m_TotalBuildTime = 0.0;
     };
 }  // namespace Yare::Graphics
 
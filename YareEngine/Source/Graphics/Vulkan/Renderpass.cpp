@@ -1,31 +1,33 @@
 #include "Graphics/Vulkan/Renderpass.h"
 
+#include "Graphics/Vulkan/Context.h"
 #include "Graphics/Vulkan/Devices.h"
 #include "Graphics/Vulkan/Framebuffer.h"
 #include "Graphics/Vulkan/Utilities.h"
 #include "Utilities/Logger.h"
 #include <array>
+#include <vector>
 
 namespace Yare::Graphics {
 
     RenderPass::RenderPass(const RenderPassInfo& info) : m_Info(info) { init(); }
 
     RenderPass::~RenderPass() {
-        if (m_RenderPass) {
-            vkDestroyRenderPass(Devices::instance()->getDevice(), m_RenderPass, nullptr);
-        }
+        VulkanContext::getContext()->getResourceCache()->releaseRenderPass(m_RenderPass);
     }
 
     void RenderPass::init() {
         VkAttachmentDescription colorAttachment = {};
         colorAttachment.format = m_Info.imageFormat;
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.loadOp = m_Info.loadAttachments ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
         colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorAttachment.initialLayout =
+            m_Info.loadAttachments ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout =
+            m_Info.presentColor ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference colorAttachmentRef = {};
         colorAttachmentRef.attachment = 0;
@@ -34,12 +36,14 @@ namespace Yare::Graphics {
         VkAttachmentDescription depthAttachment = {};
         depthAttachment.format = VkUtil::findDepthFormat();
         depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.loadOp = m_Info.loadAttachments ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = m_Info.storeDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
         depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthAttachment.initialLayout =
+            m_Info.loadAttachments ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = m_Info.storeDepth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                                                        : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference depthAttachmentRef = {};
         depthAttachmentRef.attachment = 1;
@@ -51,13 +55,37 @@ namespace Yare::Graphics {
         subpass.pColorAttachments = &colorAttachmentRef;
         subpass.pDepthStencilAttachment = &depthAttachmentRef;
 
-        VkSubpassDependency dependency = {};
+        std::vector<VkSubpassDependency> dependencies(1);
+        VkSubpassDependency&             dependency = dependencies[0];
         dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
         dependency.dstSubpass = 0;
         dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         dependency.srcAccessMask = 0;
         dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        if (m_Info.loadAttachments) {
+            // Wait for the earlier pass's attachment writes, and for compute to finish sampling depth before the
+            // layout transition hands it back to the depth test
+            dependency.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            dependency.srcAccessMask =
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependency.dstStageMask |=
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependency.dstAccessMask |=
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        }
+        if (m_Info.storeDepth) {
+            // Depth is sampled by compute right after the pass ends
+            VkSubpassDependency depthRead = {};
+            depthRead.srcSubpass = 0;
+            depthRead.dstSubpass = VK_SUBPASS_EXTERNAL;
+            depthRead.srcStageMask =
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            depthRead.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            depthRead.dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            depthRead.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            dependencies.push_back(depthRead);
+        }
 
         std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
         VkRenderPassCreateInfo                 rpCreateInfo = {};
@@ -66,13 +94,11 @@ namespace Yare::Graphics {
         rpCreateInfo.pAttachments = attachments.data();
         rpCreateInfo.subpassCount = 1;
         rpCreateInfo.pSubpasses = &subpass;
-        rpCreateInfo.dependencyCount = 1;
-        rpCreateInfo.pDependencies = &dependency;
+        rpCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        rpCreateInfo.pDependencies = dependencies.data();
 
-        auto res = vkCreateRenderPass(Devices::instance()->getDevice(), &rpCreateInfo, nullptr, &m_RenderPass);
-        if (res != VK_SUCCESS) {
-            YZ_CRITICAL("Vulkan failed to create a render pass.");
-        }
+        // The extent isn't part of the vulkan render pass, so a resize gets the same render pass back from the cache
+        m_RenderPass = VulkanContext::getContext()->getResourceCache()->acquireRenderPass(rpCreateInfo);
     }
 
     void RenderPass::beginRenderPass(const CommandBuffer* commandBuffer, const Framebuffer* frameBuffer) {
@@ -83,7 +109,7 @@ namespace Yare::Graphics {
         renderPassInfo.renderArea.offset = {0, 0};
         renderPassInfo.renderArea.extent = m_Info.extent;
         std::array<VkClearValue, 2> clearValues = {};
-        clearValues[0].color = {0.7f, 0.8f, 0.9f, 1.0f};
+        clearValues[0].color = m_Info.clearColor;
         clearValues[1].depthStencil = {1.0f, 0};
         renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         renderPassInfo.pClearValues = clearValues.data();
@@ -11,6 +11,14 @@ namespace Yare::Graphics {
     struct RenderPassInfo {
         VkFormat   imageFormat;
         VkExtent2D extent;
+        // Continue from what an earlier pass left in the attachments instead of clearing them
+        bool loadAttachments = false;
+        // Keep the depth buffer so compute can sample it after the pass, it ends in DEPTH_STENCIL_READ_ONLY_OPTIMAL
+        bool storeDepth = false;
+        // Passes followed by another pass leave the color attachment ready to be rendered to again
+        bool presentColor = true;
+        // Offscreen targets that get sampled later usually want a transparent clear
+        VkClearColorValue clearColor = {{0.7f, 0.8f, 0.9f, 1.0f}};
     };
 
     class RenderPass {
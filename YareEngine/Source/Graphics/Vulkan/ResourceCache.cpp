@@ -0,0 +1,240 @@
+#include "Graphics/Vulkan/ResourceCache.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "Graphics/Vulkan/Context.h"
+#include "Graphics/Vulkan/Devices.h"
+#include "Utilities/Logger.h"
+
+namespace Yare::Graphics {
+
+    namespace {
+        // Builds a cache key by appending the raw bytes of create info fields. Only whole structs without padding
+        // (attachment descriptions, references, dependencies and so on) are written in one go, everything else is
+        // written field by field so pNext and padding never end up in the key.
+        class KeyWriter {
+           public:
+            template <typename T>
+            void write(const T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "Cache keys can only hold plain data");
+                m_Key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            template <typename T>
+            void writeArray(const T* values, uint32_t count) {
+                write(count);
+                for (uint32_t i = 0; values && i < count; i++) {
+                    write(values[i]);
+                }
+            }
+
+            const std::string& getKey() const { return m_Key; }
+
+           private:
+            std::string m_Key;
+        };
+
+        VkDevice device() { return Devices::instance()->getDevice(); }
+    }  // namespace
+
+    ResourceCache::~ResourceCache() {
+        // Anything still referenced at this point has leaked, the device is idle so destroy it right away
+        destroyAll(m_Framebuffers, [](VkFramebuffer fb) { vkDestroyFramebuffer(device(), fb, nullptr); });
+        destroyAll(m_RenderPasses, [](VkRenderPass rp) { vkDestroyRenderPass(device(), rp, nullptr); });
+        destroyAll(m_ImageViews, [](VkImageView view) { vkDestroyImageView(device(), view, nullptr); });
+        destroyAll(m_Samplers, [](VkSampler sampler) { vkDestroySampler(device(), sampler, nullptr); });
+        destroyAll(m_DescriptorSetLayouts,
+                   [](VkDescriptorSetLayout layout) { vkDestroyDescriptorSetLayout(device(), layout, nullptr); });
+    }
+
+    VkSampler ResourceCache::acquireSampler(const VkSamplerCreateInfo& createInfo) {
+        KeyWriter key;
+        key.write(createInfo.flags);
+        key.write(createInfo.magFilter);
+        key.write(createInfo.minFilter);
+        key.write(createInfo.mipmapMode);
+        key.write(createInfo.addressModeU);
+        key.write(createInfo.addressModeV);
+        key.write(createInfo.addressModeW);
+        key.write(createInfo.mipLodBias);
+        key.write(createInfo.anisotropyEnable);
+        key.write(createInfo.maxAnisotropy);
+        key.write(createInfo.compareEnable);
+        key.write(createInfo.compareOp);
+        key.write(createInfo.minLod);
+        key.write(createInfo.maxLod);
+        key.write(createInfo.borderColor);
+        key.write(createInfo.unnormalizedCoordinates);
+
+        return acquire(m_Samplers, key.getKey(), [&]() {
+            VkSampler sampler;
+            if (vkCreateSampler(device(), &createInfo, nullptr, &sampler) != VK_SUCCESS) {
+                YZ_CRITICAL("Vulkan failed to create a sampler.");
+            }
+            return sampler;
+        });
+    }
+
+    VkImageView ResourceCache::acquireImageView(const VkImageViewCreateInfo& createInfo) {
+        KeyWriter key;
+        key.write(createInfo.flags);
+        key.write(createInfo.image);
+        key.write(createInfo.viewType);
+        key.write(createInfo.format);
+        key.write(createInfo.components);
+        key.write(createInfo.subresourceRange);
+
+        return acquire(m_ImageViews, key.getKey(), [&]() {
+            VkImageView imageView;
+            if (vkCreateImageView(device(), &createInfo, nullptr, &imageView) != VK_SUCCESS) {
+                YZ_CRITICAL("failed to create an image view!");
+            }
+            return imageView;
+        });
+    }
+
+    VkRenderPass ResourceCache::acquireRenderPass(const VkRenderPassCreateInfo& createInfo) {
+        KeyWriter key;
+        key.write(createInfo.flags);
+        key.writeArray(createInfo.pAttachments, createInfo.attachmentCount);
+        key.write(createInfo.subpassCount);
+        for (uint32_t i = 0; i < createInfo.subpassCount; i++) {
+            const auto& subpass = createInfo.pSubpasses[i];
+            key.write(subpass.flags);
+            key.write(subpass.pipelineBindPoint);
+            key.writeArray(subpass.pInputAttachments, subpass.inputAttachmentCount);
+            key.writeArray(subpass.pColorAttachments, subpass.colorAttachmentCount);
+            key.writeArray(subpass.pResolveAttachments, subpass.pResolveAttachments ? subpass.colorAttachmentCount : 0);
+            key.writeArray(subpass.pDepthStencilAttachment, subpass.pDepthStencilAttachment ? 1 : 0);
+            key.writeArray(subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+        }
+        key.writeArray(createInfo.pDependencies, createInfo.dependencyCount);
+
+        return acquire(m_RenderPasses, key.getKey(), [&]() {
+            VkRenderPass renderPass;
+            if (vkCreateRenderPass(device(), &createInfo, nullptr, &renderPass) != VK_SUCCESS) {
+                YZ_CRITICAL("Vulkan failed to create a render pass.");
+            }
+            return renderPass;
+        });
+    }
+
+    VkFramebuffer ResourceCache::acquireFramebuffer(const VkFramebufferCreateInfo& createInfo) {
+        KeyWriter key;
+        key.write(createInfo.flags);
+        key.write(createInfo.renderPass);
+        key.writeArray(createInfo.pAttachments, createInfo.attachmentCount);
+        key.write(createInfo.width);
+        key.write(createInfo.height);
+        key.write(createInfo.layers);
+
+        return acquire(m_Framebuffers, key.getKey(), [&]() {
+            VkFramebuffer framebuffer;
+            if (vkCreateFramebuffer(device(), &createInfo, nullptr, &framebuffer) != VK_SUCCESS) {
+                YZ_CRITICAL("Vulkan failed to create a fb");
+            }
+            return framebuffer;
+        });
+    }
+
+    VkDescriptorSetLayout ResourceCache::acquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& createInfo) {
+        // Bindings are sorted so the same set of bindings in a different order still hits the cache
+        std::vector<VkDescriptorSetLayoutBinding> bindings(createInfo.pBindings,
+                                                           createInfo.pBindings + createInfo.bindingCount);
+        std::sort(bindings.begin(), bindings.end(),
+                  [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+                      return a.binding < b.binding;
+                  });
+
+        KeyWriter key;
+        key.write(createInfo.flags);
+        key.writeArray(bindings.data(), static_cast<uint32_t>(bindings.size()));
+
+        return acquire(m_DescriptorSetLayouts, key.getKey(), [&]() {
+            VkDescriptorSetLayoutCreateInfo sortedInfo = createInfo;
+            sortedInfo.pBindings = bindings.data();
+
+            VkDescriptorSetLayout layout;
+            if (vkCreateDescriptorSetLayout(device(), &sortedInfo, nullptr, &layout) != VK_SUCCESS) {
+                YZ_CRITICAL("Vulkan was unable to create a descriptor set layout.");
+            }
+            return layout;
+        });
+    }
+
+    void ResourceCache::releaseSampler(VkSampler sampler) {
+        release(m_Samplers, sampler, [](VkSampler handle) { vkDestroySampler(device(), handle, nullptr); });
+    }
+
+    void ResourceCache::releaseImageView(VkImageView imageView) {
+        release(m_ImageViews, imageView, [](VkImageView handle) { vkDestroyImageView(device(), handle, nullptr); });
+    }
+
+    void ResourceCache::releaseRenderPass(VkRenderPass renderPass) {
+        release(m_RenderPasses, renderPass,
+                [](VkRenderPass handle) { vkDestroyRenderPass(device(), handle, nullptr); });
+    }
+
+    void ResourceCache::releaseFramebuffer(VkFramebuffer framebuffer) {
+        release(m_Framebuffers, framebuffer,
+                [](VkFramebuffer handle) { vkDestroyFramebuffer(device(), handle, nullptr); });
+    }
+
+    void ResourceCache::releaseDescriptorSetLayout(VkDescriptorSetLayout layout) {
+        release(m_DescriptorSetLayouts, layout,
+                [](VkDescriptorSetLayout handle) { vkDestroyDescriptorSetLayout(device(), handle, nullptr); });
+    }
+
+    template <typename T, typename CreateFunc>
+    T ResourceCache::acquire(Cache<T>& cache, const std::string& key, CreateFunc create) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto cached = cache.entries.find(key);
+        if (cached != cache.entries.end()) {
+            cached->second.refCount++;
+            return cached->second.handle;
+        }
+
+        T handle = create();
+        cache.entries[key] = {handle, 1};
+        cache.keys[handle] = key;
+        return handle;
+    }
+
+    template <typename T, typename DestroyFunc>
+    void ResourceCache::release(Cache<T>& cache, T handle, DestroyFunc destroy) {
+        if (!handle) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto key = cache.keys.find(handle);
+        if (key == cache.keys.end()) {
+            YZ_ERROR("Tried to release a vulkan object that isn't owned by the resource cache.");
+            return;
+        }
+
+        auto entry = cache.entries.find(key->second);
+        if (--entry->second.refCount > 0) {
+            return;
+        }
+
+        // Drop it from the cache straight away, so a new object created from the same handles (a recreated
+        // swapchain view for example) can't be matched against it while it waits to be destroyed
+        cache.entries.erase(entry);
+        cache.keys.erase(key);
+        VulkanContext::getContext()->getRetirementQueue()->retire([handle, destroy]() { destroy(handle); });
+    }
+
+    template <typename T, typename DestroyFunc>
+    void ResourceCache::destroyAll(Cache<T>& cache, DestroyFunc destroy) {
+        for (auto& entry : cache.entries) {
+            destroy(entry.second.handle);
+        }
+        cache.entries.clear();
+        cache.keys.clear();
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,61 @@
+#ifndef YARE_RESOURCE_CACHE_H
+#define YARE_RESOURCE_CACHE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    // Deduplicates vulkan objects by the contents of their create info, so identical requests share one object.
+    // Every acquire has to be matched with a release, once the last reference is gone the object is handed to the
+    // contexts retirement queue and destroyed after the gpu is done with it.
+    // The pNext chain of a create info is not part of the key, objects that need one shouldn't come from here.
+    class ResourceCache {
+       public:
+        ResourceCache() {}
+        ~ResourceCache();
+
+        VkSampler             acquireSampler(const VkSamplerCreateInfo& createInfo);
+        VkImageView           acquireImageView(const VkImageViewCreateInfo& createInfo);
+        VkRenderPass          acquireRenderPass(const VkRenderPassCreateInfo& createInfo);
+        VkFramebuffer         acquireFramebuffer(const VkFramebufferCreateInfo& createInfo);
+        VkDescriptorSetLayout acquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& createInfo);
+
+        void releaseSampler(VkSampler sampler);
+        void releaseImageView(VkImageView imageView);
+        void releaseRenderPass(VkRenderPass renderPass);
+        void releaseFramebuffer(VkFramebuffer framebuffer);
+        void releaseDescriptorSetLayout(VkDescriptorSetLayout layout);
+
+       private:
+        template <typename T>
+        struct Cache {
+            struct Entry {
+                T        handle;
+                uint32_t refCount;
+            };
+            // Keyed by the serialised create info, plus a reverse lookup so release only needs the handle
+            std::unordered_map<std::string, Entry> entries;
+            std::unordered_map<T, std::string>     keys;
+        };
+
+        template <typename T, typename CreateFunc>
+        T acquire(Cache<T>& cache, const std::string& key, CreateFunc create);
+        template <typename T, typename DestroyFunc>
+        void release(Cache<T>& cache, T handle, DestroyFunc destroy);
+        template <typename T, typename DestroyFunc>
+        void destroyAll(Cache<T>& cache, DestroyFunc destroy);
+
+        std::mutex                   m_Mutex;
+        Cache<VkSampler>             m_Samplers;
+        Cache<VkImageView>           m_ImageViews;
+        Cache<VkRenderPass>          m_RenderPasses;
+        Cache<VkFramebuffer>         m_Framebuffers;
+        Cache<VkDescriptorSetLayout> m_DescriptorSetLayouts;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_RESOURCE_CACHE_H
@@ -0,0 +1,38 @@
+#include "Graphics/Vulkan/RetirementQueue.h"
+
+namespace Yare::Graphics {
+
+    RetirementQueue::RetirementQueue(uint32_t framesInFlight) : m_Retired(framesInFlight) {}
+
+    RetirementQueue::~RetirementQueue() { flush(); }
+
+    void RetirementQueue::retire(std::function<void()>&& destroy) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Retired[m_CurrentFrame].push_back(std::move(destroy));
+    }
+
+    void RetirementQueue::beginFrame(uint32_t frame) {
+        collect(frame);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_CurrentFrame = frame;
+    }
+
+    void RetirementQueue::flush() {
+        for (uint32_t frame = 0; frame < m_Retired.size(); frame++) {
+            collect(frame);
+        }
+    }
+
+    void RetirementQueue::collect(uint32_t frame) {
+        // Swap the list out first, a destroy call is allowed to retire something else
+        std::vector<std::function<void()>> retired;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            retired.swap(m_Retired[frame]);
+        }
+        for (auto& destroy : retired) {
+            destroy();
+        }
+    }
+}  // namespace Yare::Graphics
@@ -0,0 +1,36 @@
+#ifndef YARE_RETIREMENT_QUEUE_H
+#define YARE_RETIREMENT_QUEUE_H
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Graphics/Vulkan/Vk.h"
+
+namespace Yare::Graphics {
+
+    // Objects that may still be referenced by a submitted command buffer can't be destroyed straight away. Their
+    // destruction is queued against the current frame and run once that frame slot comes back around, at which
+    // point its previous submission is known to have completed.
+    class RetirementQueue {
+       public:
+        RetirementQueue(uint32_t framesInFlight);
+        ~RetirementQueue();
+
+        // Queue a destroy call against the current frame
+        void retire(std::function<void()>&& destroy);
+        // Runs everything retired the last time this frame slot was used, then makes it the current frame
+        void beginFrame(uint32_t frame);
+        // Runs everything immediately, the caller has to make sure the device is idle
+        void flush();
+
+       private:
+        void collect(uint32_t frame);
+
+        std::mutex                                      m_Mutex;
+        uint32_t                                        m_CurrentFrame = 0;
+        std::vector<std::vector<std::function<void()>>> m_Retired;
+    };
+}  // namespace Yare::Graphics
+
+#endif  // YARE_RETIREMENT_QUEUE_H
@@ -1,6 +1,6 @@
 #include "Graphics/Vulkan/Utilities.h"
 
-#include <fstream>
+#include <memory>
 
 #include "Graphics/Vulkan/Context.h"
 #include "Graphics/Vulkan/Devices.h"
@@ -8,6 +8,35 @@
 
 namespace Yare::Graphics::VkUtil {
 
+    namespace {
+        struct UploadBatch {
+            VkCommandBuffer                    commandBuffer = VK_NULL_HANDLE;
+            std::vector<std::function<void()>> completions;
+        };
+
+        // Per thread, only the thread that began a batch records into it
+        thread_local std::unique_ptr<UploadBatch> t_UploadBatch;
+
+        VkCommandBuffer allocateSingleTimeCommands() {
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = VulkanContext::getContext()->getCommandPool()->getPool();
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            vkAllocateCommandBuffers(Devices::instance()->getDevice(), &allocInfo, &commandBuffer);
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+            return commandBuffer;
+        }
+    }  // namespace
+
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
         VkPhysicalDeviceMemoryProperties memProperties;
         vkGetPhysicalDeviceMemoryProperties(Devices::instance()->getGPU(), &memProperties);
@@ -21,43 +50,31 @@ namespace Yare::Graphics::VkUtil {
         return 0;
     }
 
-    std::vector<char> readShaderFile(const std::string& filePath) {
-        std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+    FileView readShaderFile(const std::string& filePath) {
+        FileView file = FileSystem::instance()->open(filePath);
 
-        if (!file.is_open()) {
+        if (!file.isOpen()) {
             YZ_ERROR("File '" + filePath + "' was unable to open.");
         }
 
-        size_t            fileSize = (size_t)file.tellg();
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
+        return file;
     }
 
     VkCommandBuffer beginSingleTimeCommands() {
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = VulkanContext::getContext()->getCommandPool()->getPool();
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Devices::instance()->getDevice(), &allocInfo, &commandBuffer);
-
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-        return commandBuffer;
+        if (t_UploadBatch) {
+            if (!t_UploadBatch->commandBuffer) {
+                t_UploadBatch->commandBuffer = allocateSingleTimeCommands();
+            }
+            return t_UploadBatch->commandBuffer;
+        }
+        return allocateSingleTimeCommands();
     }
 
     void endSingleTimeCommands(VkCommandBuffer commandBuffer) {
+        // Submitted with the rest of the batch, the commands after these are ordered by their own barriers
+        if (t_UploadBatch && commandBuffer == t_UploadBatch->commandBuffer) {
+            return;
+        }
         vkEndCommandBuffer(commandBuffer);
 
         VkSubmitInfo submitInfo = {};
@@ -72,18 +89,74 @@ namespace Yare::Graphics::VkUtil {
                              1, &commandBuffer);
     }
 
-    VkImageView createImageView(VkImage image, VkImageViewType viewType, VkFormat format, uint32_t layerCount,
-                                VkImageAspectFlags aspectFlags) {
+    void beginUploadBatch() {
+        if (t_UploadBatch) {
+            YZ_CRITICAL("An upload batch is already being recorded on this thread.");
+        }
+        t_UploadBatch = std::make_unique<UploadBatch>();
+    }
+
+    void endUploadBatch() {
+        std::unique_ptr<UploadBatch> batch = std::move(t_UploadBatch);
+        if (!batch) {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = batch->commandBuffer;
+        if (commandBuffer) {
+            vkEndCommandBuffer(commandBuffer);
+
+            VkFenceCreateInfo fenceInfo = {};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VkFence fence;
+            if (vkCreateFence(Devices::instance()->getDevice(), &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+                YZ_CRITICAL("Vulkan failed to create the upload batch's fence.");
+            }
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            vkQueueSubmit(Devices::instance()->getGraphicsQueue(), 1, &submitInfo, fence);
+            vkWaitForFences(Devices::instance()->getDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+
+            vkDestroyFence(Devices::instance()->getDevice(), fence, nullptr);
+            vkFreeCommandBuffers(Devices::instance()->getDevice(),
+                                 VulkanContext::getContext()->getCommandPool()->getPool(), 1, &commandBuffer);
+        }
+
+        for (auto& completion : batch->completions) {
+            completion();
+        }
+    }
+
+    bool deferUntilUploaded(std::function<void()> function) {
+        if (!t_UploadBatch) {
+            return false;
+        }
+        t_UploadBatch->completions.push_back(std::move(function));
+        return true;
+    }
+
+    VkImageViewCreateInfo imageViewCreateInfo(VkImage image, VkImageViewType viewType, VkFormat format,
+                                              uint32_t layerCount, VkImageAspectFlags aspectFlags,
+                                              uint32_t baseMipLevel, uint32_t levelCount) {
         VkImageViewCreateInfo viewInfo = {};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = image;
         viewInfo.viewType = viewType;
         viewInfo.format = format;
         viewInfo.subresourceRange.aspectMask = aspectFlags;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+        viewInfo.subresourceRange.levelCount = levelCount;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount = layerCount;
+        return viewInfo;
+    }
+
+    VkImageView createImageView(VkImage image, VkImageViewType viewType, VkFormat format, uint32_t layerCount,
+                                VkImageAspectFlags aspectFlags) {
+        VkImageViewCreateInfo viewInfo = imageViewCreateInfo(image, viewType, format, layerCount, aspectFlags);
 
         VkImageView imageView;
         auto        res = vkCreateImageView(Devices::instance()->getDevice(), &viewInfo, nullptr, &imageView);
@@ -116,6 +189,15 @@ namespace Yare::Graphics::VkUtil {
                                    VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
     }
 
+    bool supportsLinearBlit(VkFormat format) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(Devices::instance()->getGPU(), format, &props);
+
+        VkFormatFeatureFlags features = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (props.optimalTilingFeatures & features) == features;
+    }
+
     bool hasStencilComponent(VkFormat format) {
         return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
     }
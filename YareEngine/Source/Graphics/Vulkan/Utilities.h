@@ -1,24 +1,39 @@
 #ifndef YARE_VK_UTILITIES_H
 #define YARE_VK_UTILITIES_H
 
+#include <functional>
 #include <string>
 #include <vector>
 
+#include "Core/FileSystem.h"
 #include "Graphics/Vulkan/Vk.h"
 
 namespace Yare::Graphics::VkUtil {
-    uint32_t          findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-    std::vector<char> readShaderFile(const std::string& filePath);
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    // Mapped, so the SPIR-V is handed to the driver as it is in the file or pack, which keeps it 4 byte aligned
+    FileView readShaderFile(const std::string& filePath);
 
     VkCommandBuffer beginSingleTimeCommands();
     void            endSingleTimeCommands(VkCommandBuffer commandBuffer);
 
-    VkImageView createImageView(VkImage image, VkImageViewType viewType, VkFormat format, uint32_t layerCount,
-                                VkImageAspectFlags aspectFlags);
+    // Between these two the single time commands the calling thread records all go into one command buffer, which is
+    // submitted once and waited for on one fence at the end instead of once per copy or transition
+    void beginUploadBatch();
+    void endUploadBatch();
+    // Runs the function once the thread's batch completed, and returns false without running it when there is none
+    bool deferUntilUploaded(std::function<void()> function);
+
+    VkImageViewCreateInfo imageViewCreateInfo(VkImage image, VkImageViewType viewType, VkFormat format,
+                                              uint32_t layerCount, VkImageAspectFlags aspectFlags,
+                                              uint32_t baseMipLevel = 0, uint32_t levelCount = 1);
+    VkImageView           createImageView(VkImage image, VkImageViewType viewType, VkFormat format, uint32_t layerCount,
+                                          VkImageAspectFlags aspectFlags);
 
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling,
                                  VkFormatFeatureFlags features);
     VkFormat findDepthFormat();
+    // Whether optimal tiling images of the format can be downsampled into their own mip levels with a linear blit
+    bool     supportsLinearBlit(VkFormat format);
     bool     hasStencilComponent(VkFormat format);
 }  // namespace Yare::Graphics::VkUtil
 
@@ -4,6 +4,7 @@
 #include <stb/stb_image.h>
 
 #include "Application/Application.h"
+#include "Core/FileSystem.h"
 #include "Graphics/Camera/FpsCamera.h"
 #include "Input/KeyHandler.h"
 #include "Input/MouseHandler.h"
@@ -142,7 +143,9 @@ namespace Yare::Graphics {
     void GlfwWindow::setIcon(const std::string& filePath) {
         GLFWimage image;
         int       imgWidth, imgHeight, imgChannels;
-        stbi_uc*  pixels = stbi_load(filePath.data(), &imgWidth, &imgHeight, &imgChannels, STBI_rgb_alpha);
+        FileView  file = FileSystem::instance()->open(filePath);
+        stbi_uc*  pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &imgWidth, &imgHeight,
+                                                 &imgChannels, STBI_rgb_alpha);
         image.height = imgHeight;
         image.width = imgWidth;
         image.pixels = pixels;
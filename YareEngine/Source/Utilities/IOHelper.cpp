@@ -1,5 +1,6 @@
 #include "Utilities/IOHelper.h"
 
+#include "Core/FileSystem.h"
 #include "Utilities/Logger.h"
 
 #define GLM_FORCE_RADIANS
@@ -7,9 +8,12 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <tinyobjloader/tiny_obj_loader.h>
 
+#include <algorithm>
+#include <cctype>
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
 #include <glm/gtx/string_cast.hpp>
+#include <istream>
 #include <unordered_map>
 
 namespace std {
@@ -24,18 +28,36 @@ namespace std {
 
 namespace Yare::Utilities {
 
+    namespace {
+        // Lets tinyobj parse a mapped file in place
+        class FileViewBuffer : public std::streambuf {
+           public:
+            FileViewBuffer(const FileView& file) {
+                char* data = const_cast<char*>(reinterpret_cast<const char*>(file.data()));
+                setg(data, data, data + file.size());
+            }
+        };
+    }  // namespace
+
     std::vector<std::string> readFile(const std::string& filename) {
-        std::ifstream file(filename);
+        FileView file = FileSystem::instance()->open(filename);
 
-        if (!file) {
+        if (!file.isOpen()) {
             YZ_ERROR("File '" + filename + "' was unable to open.");
             throw std::runtime_error("File '" + filename + "' was unable to open.");
         }
 
         // captures lines not separated by whitespace
         std::vector<std::string> myLines;
-        std::copy(std::istream_iterator<std::string>(file), std::istream_iterator<std::string>(),
-                  std::back_inserter(myLines));
+        auto                     isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
+        const unsigned char*     current = file.begin();
+        while (current != file.end()) {
+            const unsigned char* start = std::find_if_not(current, file.end(), isSpace);
+            current = std::find_if(start, file.end(), isSpace);
+            if (start != current) {
+                myLines.emplace_back(start, current);
+            }
+        }
 
         return myLines;
     }
@@ -46,7 +68,15 @@ namespace Yare::Utilities {
         std::vector<tinyobj::material_t> materials;
         std::string                      warn, err;
 
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str())) {
+        FileView file = FileSystem::instance()->open(filePath);
+        if (!file.isOpen()) {
+            YZ_ERROR("File '" + filePath + "' was unable to open.");
+            return;
+        }
+        FileViewBuffer buffer(file);
+        std::istream   stream(&buffer);
+        // Materials aren't used, so none are read
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream)) {
             YZ_ERROR(warn + err);
         }
 